@@ -69,6 +69,7 @@ extern int32_t tsNumOfVnodeSyncThreads;
 extern int32_t tsNumOfVnodeRsmaThreads;
 extern int32_t tsNumOfQnodeQueryThreads;
 extern int32_t tsNumOfQnodeFetchThreads;
+extern int32_t tsNumOfSortThreads;  // threads generating external sort runs, 0 means sort on the query thread
 extern int32_t tsNumOfSnodeSharedThreads;
 extern int32_t tsNumOfSnodeUniqueThreads;
 extern int64_t tsRpcQueueMemoryAllowed;
@@ -91,6 +92,13 @@ extern uint16_t tsTelemPort;
 extern int32_t tsQueryBufferSize;  // maximum allowed usage buffer size in MB for each data node during query processing
 extern int64_t tsQueryBufferSizeBytes;  // maximum allowed usage buffer size in byte for each data node
 
+// tsdb
+extern int32_t tsTsdbBlockCacheSize;  // size of the decompressed data block cache of each tsdb in MB
+extern int32_t tsRetentionSpeedLimitMB;  // max speed of moving files to lower tiers in MB/s, 0 means no limit
+
+// wal
+extern int32_t tsWalGroupCommitMs;  // max time a wal entry may wait to be written with its group, 0 means disabled
+
 // query client
 extern int32_t tsQueryPolicy;
 extern int32_t tsQuerySmaOptimize;
@@ -99,6 +107,7 @@ extern bool    tsQueryPlannerTrace;
 extern int32_t tsQueryNodeChunkSize;
 extern bool    tsQueryUseNodeAllocator;
 extern bool    tsKeepColumnName;
+extern int32_t tsQueryExchangePrefetch;  // max fetch requests in flight or buffered per exchange operator
 
 // client
 extern int32_t tsMinSlidingTime;
@@ -63,6 +63,17 @@ typedef enum {
   OPTR_EXEC_MODEL_QUEUE = 0x3,
 } EOPTR_EXEC_MODEL;
 
+/**
+ * Init the executor module, the workers shared by all queries of this node are created
+ * @return
+ */
+int32_t qExecutorInit();
+
+/**
+ * Clean up the executor module
+ */
+void qExecutorCleanUp();
+
 /**
  * Create the exec task for stream mode
  * @param pMsg
@@ -107,6 +107,7 @@ typedef struct SJoinLogicNode {
   SNode*     pMergeCondition;
   SNode*     pOnConditions;
   bool       isSingleTableJoin;
+  bool       isHashJoin;  // no primary key equal condition, pMergeCondition holds the equi-join keys
   EOrder     inputTsOrder;
 } SJoinLogicNode;
 
@@ -387,6 +388,15 @@ typedef struct SSortMergeJoinPhysiNode {
   EOrder     inputTsOrder;
 } SSortMergeJoinPhysiNode;
 
+typedef struct SHashJoinPhysiNode {
+  SPhysiNode node;
+  EJoinType  joinType;
+  SNodeList* pLeftKeys;   // SColumnNode of the left child, paired with pRightKeys
+  SNodeList* pRightKeys;  // SColumnNode of the right child
+  SNode*     pOnConditions;
+  SNodeList* pTargets;
+} SHashJoinPhysiNode;
+
 typedef struct SAggPhysiNode {
   SPhysiNode node;
   SNodeList* pExprs;  // these are expression list of group_by_clause and parameter expression of aggregate function
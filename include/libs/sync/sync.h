@@ -42,6 +42,10 @@ extern bool gRaftDetailLog;
 #define SYNC_INDEX_INVALID  -1
 #define SYNC_TERM_INVALID   0xFFFFFFFFFFFFFFFF
 
+#define SYNC_MAX_APPEND_BATCH_SIZE  64
+#define SYNC_MAX_APPEND_BATCH_BYTES (1024 * 1024)
+#define SYNC_MAX_INFLIGHT_BATCHES   4
+
 typedef enum {
   SYNC_STRATEGY_NO_SNAPSHOT = 0,
   SYNC_STRATEGY_STANDARD_SNAPSHOT = 1,
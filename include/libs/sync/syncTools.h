@@ -155,6 +155,7 @@ typedef enum ESyncTimeoutType {
   SYNC_TIMEOUT_PING = 100,
   SYNC_TIMEOUT_ELECTION,
   SYNC_TIMEOUT_HEARTBEAT,
+  SYNC_TIMEOUT_WAL_FLUSH,
 } ESyncTimeoutType;
 
 typedef struct SyncTimeout {
@@ -424,6 +425,7 @@ typedef struct SyncAppendEntriesReply {
   bool      success;
   SyncIndex matchIndex;
   int64_t   startTime;
+  int32_t   batchSize;  // max entries in one append entries the sender accepts, 0 if sent by a version before batching
 } SyncAppendEntriesReply;
 
 SyncAppendEntriesReply* syncAppendEntriesReplyBuild(int32_t vgId);
@@ -87,6 +87,26 @@ int32_t tfsGetLevel(STfs *pTfs);
  */
 int32_t tfsAllocDisk(STfs *pTfs, int32_t expLevel, SDiskID *pDiskId);
 
+/**
+ * @brief Allocate the disk with the most free space on a tier level for files of the given size.
+ *
+ * @param pTfs The fs object.
+ * @param expLevel Disk level want to allocate.
+ * @param size Bytes to be written.
+ * @param pDiskId The disk ID after allocation.
+ * @return int32_t 0 for success, -1 for failure.
+ */
+int32_t tfsAllocDiskBySize(STfs *pTfs, int32_t expLevel, int64_t size, SDiskID *pDiskId);
+
+/**
+ * @brief Reserve bytes from the free space of a disk until the next size update.
+ *
+ * @param pTfs The fs object.
+ * @param diskId The disk the bytes are written to.
+ * @param size Bytes to reserve, a negative size releases them.
+ */
+void tfsReserveDiskSize(STfs *pTfs, SDiskID diskId, int64_t size);
+
 /**
  * @brief Get the primary path.
  *
@@ -33,16 +33,17 @@ extern "C" {
 #define wTrace(...) { if (wDebugFlag & DEBUG_TRACE) { taosPrintLog("WAL ",       DEBUG_TRACE, wDebugFlag, __VA_ARGS__); }}
 // clang-format on
 
-#define WAL_PROTO_VER     0
-#define WAL_NOSUFFIX_LEN  20
-#define WAL_SUFFIX_AT     (WAL_NOSUFFIX_LEN + 1)
-#define WAL_LOG_SUFFIX    "log"
-#define WAL_INDEX_SUFFIX  "idx"
-#define WAL_REFRESH_MS    1000
-#define WAL_PATH_LEN      (TSDB_FILENAME_LEN + 12)
-#define WAL_FILE_LEN      (WAL_PATH_LEN + 32)
-#define WAL_MAGIC         0xFAFBFCFDF4F3F2F1ULL
-#define WAL_SCAN_BUF_SIZE (1024 * 1024 * 3)
+#define WAL_PROTO_VER      0
+#define WAL_NOSUFFIX_LEN   20
+#define WAL_SUFFIX_AT      (WAL_NOSUFFIX_LEN + 1)
+#define WAL_LOG_SUFFIX     "log"
+#define WAL_INDEX_SUFFIX   "idx"
+#define WAL_REFRESH_MS     1000
+#define WAL_PATH_LEN       (TSDB_FILENAME_LEN + 12)
+#define WAL_FILE_LEN       (WAL_PATH_LEN + 32)
+#define WAL_MAGIC          0xFAFBFCFDF4F3F2F1ULL
+#define WAL_SCAN_BUF_SIZE  (1024 * 1024 * 3)
+#define WAL_GROUP_BUF_SIZE (1024 * 1024 * 4)
 
 typedef enum {
   TAOS_WAL_WRITE = 1,
@@ -97,6 +98,9 @@ typedef struct {
 } SWalCkHead;
 #pragma pack(pop)
 
+// called when a group of buffered entries is written, entries up to ver are in the log file then
+typedef void (*FWalFlushCb)(void *param, int64_t ver);
+
 typedef struct SWal {
   // cfg
   SWalCfg cfg;
@@ -119,6 +123,17 @@ typedef struct SWal {
   char path[WAL_PATH_LEN];
   // reusable write head
   SWalCkHead writeHead;
+  // group commit, entries are buffered here and appended to the files in one write per group
+  uint8_t    *pLogBuf;
+  int64_t     nLogBuf;
+  uint8_t    *pIdxBuf;
+  int64_t     nIdxBuf;
+  int64_t     bufFirstVer;  // -1 if nothing is buffered
+  int64_t     bufFirstTs;
+  FWalFlushCb fpFlushCb;
+  void       *flushParam;
+  // stat
+  int64_t fsyncCnt;
 } SWal;
 
 typedef struct {
@@ -171,7 +186,8 @@ int32_t walWriteWithSyncInfo(SWal *, int64_t index, tmsg_t msgType, SWalSyncInfo
 // -1 will be returned for failed writes
 int64_t walAppendLog(SWal *, tmsg_t msgType, SWalSyncInfo syncMeta, const void *body, int32_t bodyLen);
 
-void walFsync(SWal *, bool force);
+int32_t walFsync(SWal *, bool force);
+void    walSetFlushCb(SWal *, FWalFlushCb fp, void *param);
 
 // apis for lifecycle management
 int32_t walCommit(SWal *, int64_t ver);
@@ -216,6 +232,7 @@ int64_t walGetSnapshotVer(SWal *);
 int64_t walGetLastVer(SWal *);
 int64_t walGetCommittedVer(SWal *);
 int64_t walGetAppliedVer(SWal *);
+int64_t walGetFlushedVer(SWal *);
 
 #ifdef __cplusplus
 }
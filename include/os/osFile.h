@@ -74,10 +74,20 @@ bool    taosCheckExistFile(const char *pathname);
 int64_t taosLSeekFile(TdFilePtr pFile, int64_t offset, int32_t whence);
 int32_t taosFtruncateFile(TdFilePtr pFile, int64_t length);
 int32_t taosFsyncFile(TdFilePtr pFile);
+// ask the os to start reading the range into the page cache in the background
+int32_t taosPrefetchFile(TdFilePtr pFile, int64_t offset, int64_t len);
 
 int64_t taosReadFile(TdFilePtr pFile, void *buf, int64_t count);
 int64_t taosPReadFile(TdFilePtr pFile, void *buf, int64_t count, int64_t offset);
 int64_t taosWriteFile(TdFilePtr pFile, const void *buf, int64_t count);
+
+#define TD_IOVEC_MAX 64
+typedef struct {
+  const void *base;
+  int64_t     len;
+} TdIoVec;
+// write all vectors in order with as few system calls as possible, returns the number of bytes written
+int64_t taosWritevFile(TdFilePtr pFile, const TdIoVec *iov, int32_t iovcnt);
 void    taosFprintfFile(TdFilePtr pFile, const char *format, ...);
 
 int64_t taosGetLineFile(TdFilePtr pFile, char **__restrict ptrBuf);
@@ -29,6 +29,7 @@ typedef dispatch_semaphore_t tsem_t;
 
 int tsem_init(tsem_t *sem, int pshared, unsigned int value);
 int tsem_wait(tsem_t *sem);
+int tsem_trywait(tsem_t *sem);
 int tsem_timewait(tsem_t *sim, int64_t nanosecs);
 int tsem_post(tsem_t *sem);
 int tsem_destroy(tsem_t *sem);
@@ -38,6 +39,7 @@ int tsem_destroy(tsem_t *sem);
 #define tsem_t       sem_t
 #define tsem_init    sem_init
 int tsem_wait(tsem_t *sem);
+#define tsem_trywait sem_trywait
 int tsem_timewait(tsem_t *sim, int64_t nanosecs);
 #define tsem_post    sem_post
 #define tsem_destroy sem_destroy
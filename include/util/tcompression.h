@@ -34,6 +34,10 @@ extern "C" {
 #define NO_COMPRESSION 0
 #define ONE_STAGE_COMP 1
 #define TWO_STAGE_COMP 2
+// same as TWO_STAGE_COMP but uses zstd instead of lz4 in the second stage
+#define TWO_STAGE_COMP_ZSTD 3
+
+#define IS_TWO_STAGE_COMP(alg) ((alg) == TWO_STAGE_COMP || (alg) == TWO_STAGE_COMP_ZSTD)
 
 //
 // compressed data first byte foramt
@@ -54,13 +58,25 @@ extern "C" {
 extern int32_t tsCompressINTImp(const char *const input, const int32_t nelements, char *const output, const char type);
 extern int32_t tsDecompressINTImp(const char *const input, const int32_t nelements, char *const output,
                                   const char type);
+extern int32_t tsDecompressINTImpScalar(const char *const input, const int32_t nelements, char *const output,
+                                        const char type);
+extern int32_t tsDecompressINTImpAVX2(const char *const input, const int32_t nelements, char *const output,
+                                      const char type);
 extern int32_t tsCompressBoolImp(const char *const input, const int32_t nelements, char *const output);
 extern int32_t tsDecompressBoolImp(const char *const input, const int32_t nelements, char *const output);
 extern int32_t tsCompressStringImp(const char *const input, int32_t inputSize, char *const output, int32_t outputSize);
 extern int32_t tsDecompressStringImp(const char *const input, int32_t compressedSize, char *const output,
                                      int32_t outputSize);
+extern int32_t tsCompressStringZstdImp(const char *const input, int32_t inputSize, char *const output,
+                                      int32_t outputSize);
+extern int32_t tsDecompressStringZstdImp(const char *const input, int32_t compressedSize, char *const output,
+                                        int32_t outputSize);
 extern int32_t tsCompressTimestampImp(const char *const input, const int32_t nelements, char *const output);
 extern int32_t tsDecompressTimestampImp(const char *const input, const int32_t nelements, char *const output);
+extern int32_t tsDecompressTimestampImpScalar(const char *const input, const int32_t nelements, char *const output);
+extern int32_t tsDecompressTimestampImpAVX2(const char *const input, const int32_t nelements, char *const output);
+// whether tsDecompressINTImp and tsDecompressTimestampImp dispatch to the AVX2 decoders
+extern bool    tsDecompressAVX2Supported(void);
 extern int32_t tsCompressDoubleImp(const char *const input, const int32_t nelements, char *const output);
 extern int32_t tsDecompressDoubleImp(const char *const input, const int32_t nelements, char *const output);
 extern int32_t tsCompressFloatImp(const char *const input, const int32_t nelements, char *const output);
@@ -73,6 +89,9 @@ extern int32_t tsCompressDoubleLossyImp(const char *input, const int32_t nelemen
 extern int32_t tsDecompressDoubleLossyImp(const char *input, int32_t compressedSize, const int32_t nelements,
                                           char *const output);
 
+// zstd compression level of TWO_STAGE_COMP_ZSTD
+extern int32_t tsZstdCompressLevel;
+
 #ifdef TD_TSZ
 extern bool lossyFloat;
 extern bool lossyDouble;
@@ -80,14 +99,31 @@ int32_t     tsCompressInit();
 void        tsCompressExit();
 #endif
 
+// second stage of the two stage compression
+static FORCE_INLINE int32_t tsCompressStage2(const char *const input, int32_t inputSize, char *const output,
+                                             int32_t outputSize, char algorithm) {
+  if (algorithm == TWO_STAGE_COMP_ZSTD) {
+    return tsCompressStringZstdImp(input, inputSize, output, outputSize);
+  }
+  return tsCompressStringImp(input, inputSize, output, outputSize);
+}
+
+static FORCE_INLINE int32_t tsDecompressStage2(const char *const input, int32_t compressedSize, char *const output,
+                                               int32_t outputSize, char algorithm) {
+  if (algorithm == TWO_STAGE_COMP_ZSTD) {
+    return tsDecompressStringZstdImp(input, compressedSize, output, outputSize);
+  }
+  return tsDecompressStringImp(input, compressedSize, output, outputSize);
+}
+
 static FORCE_INLINE int32_t tsCompressTinyint(const char *const input, int32_t inputSize, const int32_t nelements,
                                               char *const output, int32_t outputSize, char algorithm,
                                               char *const buffer, int32_t bufferSize) {
   if (algorithm == ONE_STAGE_COMP) {
     return tsCompressINTImp(input, nelements, output, TSDB_DATA_TYPE_TINYINT);
-  } else if (algorithm == TWO_STAGE_COMP) {
+  } else if (IS_TWO_STAGE_COMP(algorithm)) {
     int32_t len = tsCompressINTImp(input, nelements, buffer, TSDB_DATA_TYPE_TINYINT);
-    return tsCompressStringImp(buffer, len, output, outputSize);
+    return tsCompressStage2(buffer, len, output, outputSize, algorithm);
   } else {
     assert(0);
     return -1;
@@ -99,8 +135,8 @@ static FORCE_INLINE int32_t tsDecompressTinyint(const char *const input, int32_t
                                                 char algorithm, char *const buffer, int32_t bufferSize) {
   if (algorithm == ONE_STAGE_COMP) {
     return tsDecompressINTImp(input, nelements, output, TSDB_DATA_TYPE_TINYINT);
-  } else if (algorithm == TWO_STAGE_COMP) {
-    if (tsDecompressStringImp(input, compressedSize, buffer, bufferSize) < 0) return -1;
+  } else if (IS_TWO_STAGE_COMP(algorithm)) {
+    if (tsDecompressStage2(input, compressedSize, buffer, bufferSize, algorithm) < 0) return -1;
     return tsDecompressINTImp(buffer, nelements, output, TSDB_DATA_TYPE_TINYINT);
   } else {
     assert(0);
@@ -113,9 +149,9 @@ static FORCE_INLINE int32_t tsCompressSmallint(const char *const input, int32_t
                                                char *const buffer, int32_t bufferSize) {
   if (algorithm == ONE_STAGE_COMP) {
     return tsCompressINTImp(input, nelements, output, TSDB_DATA_TYPE_SMALLINT);
-  } else if (algorithm == TWO_STAGE_COMP) {
+  } else if (IS_TWO_STAGE_COMP(algorithm)) {
     int32_t len = tsCompressINTImp(input, nelements, buffer, TSDB_DATA_TYPE_SMALLINT);
-    return tsCompressStringImp(buffer, len, output, outputSize);
+    return tsCompressStage2(buffer, len, output, outputSize, algorithm);
   } else {
     assert(0);
     return -1;
@@ -127,8 +163,8 @@ static FORCE_INLINE int32_t tsDecompressSmallint(const char *const input, int32_
                                                  char algorithm, char *const buffer, int32_t bufferSize) {
   if (algorithm == ONE_STAGE_COMP) {
     return tsDecompressINTImp(input, nelements, output, TSDB_DATA_TYPE_SMALLINT);
-  } else if (algorithm == TWO_STAGE_COMP) {
-    if (tsDecompressStringImp(input, compressedSize, buffer, bufferSize) < 0) return -1;
+  } else if (IS_TWO_STAGE_COMP(algorithm)) {
+    if (tsDecompressStage2(input, compressedSize, buffer, bufferSize, algorithm) < 0) return -1;
     return tsDecompressINTImp(buffer, nelements, output, TSDB_DATA_TYPE_SMALLINT);
   } else {
     assert(0);
@@ -141,9 +177,9 @@ static FORCE_INLINE int32_t tsCompressInt(const char *const input, int32_t input
                                           int32_t bufferSize) {
   if (algorithm == ONE_STAGE_COMP) {
     return tsCompressINTImp(input, nelements, output, TSDB_DATA_TYPE_INT);
-  } else if (algorithm == TWO_STAGE_COMP) {
+  } else if (IS_TWO_STAGE_COMP(algorithm)) {
     int32_t len = tsCompressINTImp(input, nelements, buffer, TSDB_DATA_TYPE_INT);
-    return tsCompressStringImp(buffer, len, output, outputSize);
+    return tsCompressStage2(buffer, len, output, outputSize, algorithm);
   } else {
     assert(0);
     return -1;
@@ -155,8 +191,8 @@ static FORCE_INLINE int32_t tsDecompressInt(const char *const input, int32_t com
                                             int32_t bufferSize) {
   if (algorithm == ONE_STAGE_COMP) {
     return tsDecompressINTImp(input, nelements, output, TSDB_DATA_TYPE_INT);
-  } else if (algorithm == TWO_STAGE_COMP) {
-    if (tsDecompressStringImp(input, compressedSize, buffer, bufferSize) < 0) return -1;
+  } else if (IS_TWO_STAGE_COMP(algorithm)) {
+    if (tsDecompressStage2(input, compressedSize, buffer, bufferSize, algorithm) < 0) return -1;
     return tsDecompressINTImp(buffer, nelements, output, TSDB_DATA_TYPE_INT);
   } else {
     assert(0);
@@ -169,9 +205,9 @@ static FORCE_INLINE int32_t tsCompressBigint(const char *const input, int32_t in
                                              int32_t bufferSize) {
   if (algorithm == ONE_STAGE_COMP) {
     return tsCompressINTImp(input, nelements, output, TSDB_DATA_TYPE_BIGINT);
-  } else if (algorithm == TWO_STAGE_COMP) {
+  } else if (IS_TWO_STAGE_COMP(algorithm)) {
     int32_t len = tsCompressINTImp(input, nelements, buffer, TSDB_DATA_TYPE_BIGINT);
-    return tsCompressStringImp(buffer, len, output, outputSize);
+    return tsCompressStage2(buffer, len, output, outputSize, algorithm);
   } else {
     assert(0);
     return -1;
@@ -183,8 +219,8 @@ static FORCE_INLINE int32_t tsDecompressBigint(const char *const input, int32_t
                                                char *const buffer, int32_t bufferSize) {
   if (algorithm == ONE_STAGE_COMP) {
     return tsDecompressINTImp(input, nelements, output, TSDB_DATA_TYPE_BIGINT);
-  } else if (algorithm == TWO_STAGE_COMP) {
-    if (tsDecompressStringImp(input, compressedSize, buffer, bufferSize) < 0) return -1;
+  } else if (IS_TWO_STAGE_COMP(algorithm)) {
+    if (tsDecompressStage2(input, compressedSize, buffer, bufferSize, algorithm) < 0) return -1;
     return tsDecompressINTImp(buffer, nelements, output, TSDB_DATA_TYPE_BIGINT);
   } else {
     assert(0);
@@ -197,9 +233,9 @@ static FORCE_INLINE int32_t tsCompressBool(const char *const input, int32_t inpu
                                            int32_t bufferSize) {
   if (algorithm == ONE_STAGE_COMP) {
     return tsCompressBoolImp(input, nelements, output);
-  } else if (algorithm == TWO_STAGE_COMP) {
+  } else if (IS_TWO_STAGE_COMP(algorithm)) {
     int32_t len = tsCompressBoolImp(input, nelements, buffer);
-    return tsCompressStringImp(buffer, len, output, outputSize);
+    return tsCompressStage2(buffer, len, output, outputSize, algorithm);
   } else {
     assert(0);
     return -1;
@@ -211,8 +247,8 @@ static FORCE_INLINE int32_t tsDecompressBool(const char *const input, int32_t co
                                              int32_t bufferSize) {
   if (algorithm == ONE_STAGE_COMP) {
     return tsDecompressBoolImp(input, nelements, output);
-  } else if (algorithm == TWO_STAGE_COMP) {
-    if (tsDecompressStringImp(input, compressedSize, buffer, bufferSize) < 0) return -1;
+  } else if (IS_TWO_STAGE_COMP(algorithm)) {
+    if (tsDecompressStage2(input, compressedSize, buffer, bufferSize, algorithm) < 0) return -1;
     return tsDecompressBoolImp(buffer, nelements, output);
   } else {
     assert(0);
@@ -223,12 +259,18 @@ static FORCE_INLINE int32_t tsDecompressBool(const char *const input, int32_t co
 static FORCE_INLINE int32_t tsCompressString(const char *const input, int32_t inputSize, const int32_t nelements,
                                              char *const output, int32_t outputSize, char algorithm, char *const buffer,
                                              int32_t bufferSize) {
+  if (algorithm == TWO_STAGE_COMP_ZSTD) {
+    return tsCompressStringZstdImp(input, inputSize, output, outputSize);
+  }
   return tsCompressStringImp(input, inputSize, output, outputSize);
 }
 
 static FORCE_INLINE int32_t tsDecompressString(const char *const input, int32_t compressedSize, const int32_t nelements,
                                                char *const output, int32_t outputSize, char algorithm,
                                                char *const buffer, int32_t bufferSize) {
+  if (algorithm == TWO_STAGE_COMP_ZSTD) {
+    return tsDecompressStringZstdImp(input, compressedSize, output, outputSize);
+  }
   return tsDecompressStringImp(input, compressedSize, output, outputSize);
 }
 
@@ -244,9 +286,9 @@ static FORCE_INLINE int32_t tsCompressFloat(const char *const input, int32_t inp
 #endif
     if (algorithm == ONE_STAGE_COMP) {
       return tsCompressFloatImp(input, nelements, output);
-    } else if (algorithm == TWO_STAGE_COMP) {
+    } else if (IS_TWO_STAGE_COMP(algorithm)) {
       int32_t len = tsCompressFloatImp(input, nelements, buffer);
-      return tsCompressStringImp(buffer, len, output, outputSize);
+      return tsCompressStage2(buffer, len, output, outputSize, algorithm);
     } else {
       assert(0);
       return -1;
@@ -268,8 +310,8 @@ static FORCE_INLINE int32_t tsDecompressFloat(const char *const input, int32_t c
     // decompress lossless
     if (algorithm == ONE_STAGE_COMP) {
       return tsDecompressFloatImp(input, nelements, output);
-    } else if (algorithm == TWO_STAGE_COMP) {
-      if (tsDecompressStringImp(input, compressedSize, buffer, bufferSize) < 0) return -1;
+    } else if (IS_TWO_STAGE_COMP(algorithm)) {
+      if (tsDecompressStage2(input, compressedSize, buffer, bufferSize, algorithm) < 0) return -1;
       return tsDecompressFloatImp(buffer, nelements, output);
     } else {
       assert(0);
@@ -292,9 +334,9 @@ static FORCE_INLINE int32_t tsCompressDouble(const char *const input, int32_t in
     // lossless mode
     if (algorithm == ONE_STAGE_COMP) {
       return tsCompressDoubleImp(input, nelements, output);
-    } else if (algorithm == TWO_STAGE_COMP) {
+    } else if (IS_TWO_STAGE_COMP(algorithm)) {
       int32_t len = tsCompressDoubleImp(input, nelements, buffer);
-      return tsCompressStringImp(buffer, len, output, outputSize);
+      return tsCompressStage2(buffer, len, output, outputSize, algorithm);
     } else {
       assert(0);
       return -1;
@@ -316,8 +358,8 @@ static FORCE_INLINE int32_t tsDecompressDouble(const char *const input, int32_t
     // decompress lossless
     if (algorithm == ONE_STAGE_COMP) {
       return tsDecompressDoubleImp(input, nelements, output);
-    } else if (algorithm == TWO_STAGE_COMP) {
-      if (tsDecompressStringImp(input, compressedSize, buffer, bufferSize) < 0) return -1;
+    } else if (IS_TWO_STAGE_COMP(algorithm)) {
+      if (tsDecompressStage2(input, compressedSize, buffer, bufferSize, algorithm) < 0) return -1;
       return tsDecompressDoubleImp(buffer, nelements, output);
     } else {
       assert(0);
@@ -363,9 +405,9 @@ static FORCE_INLINE int32_t tsCompressTimestamp(const char *const input, int32_t
                                                 char *const buffer, int32_t bufferSize) {
   if (algorithm == ONE_STAGE_COMP) {
     return tsCompressTimestampImp(input, nelements, output);
-  } else if (algorithm == TWO_STAGE_COMP) {
+  } else if (IS_TWO_STAGE_COMP(algorithm)) {
     int32_t len = tsCompressTimestampImp(input, nelements, buffer);
-    return tsCompressStringImp(buffer, len, output, outputSize);
+    return tsCompressStage2(buffer, len, output, outputSize, algorithm);
   } else {
     assert(0);
     return -1;
@@ -377,8 +419,8 @@ static FORCE_INLINE int32_t tsDecompressTimestamp(const char *const input, int32
                                                   char algorithm, char *const buffer, int32_t bufferSize) {
   if (algorithm == ONE_STAGE_COMP) {
     return tsDecompressTimestampImp(input, nelements, output);
-  } else if (algorithm == TWO_STAGE_COMP) {
-    if (tsDecompressStringImp(input, compressedSize, buffer, bufferSize) < 0) return -1;
+  } else if (IS_TWO_STAGE_COMP(algorithm)) {
+    if (tsDecompressStage2(input, compressedSize, buffer, bufferSize, algorithm) < 0) return -1;
     return tsDecompressTimestampImp(buffer, nelements, output);
   } else {
     assert(0);
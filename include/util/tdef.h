@@ -330,7 +330,7 @@ typedef enum ELogicConditionType {
 #define TSDB_MAX_PRECISION              TSDB_TIME_PRECISION_NANO
 #define TSDB_DEFAULT_PRECISION          TSDB_TIME_PRECISION_MILLI
 #define TSDB_MIN_COMP_LEVEL             0
-#define TSDB_MAX_COMP_LEVEL             2
+#define TSDB_MAX_COMP_LEVEL             3
 #define TSDB_DEFAULT_COMP_LEVEL         2
 #define TSDB_MIN_DB_REPLICA             1
 #define TSDB_MAX_DB_REPLICA             3
@@ -78,6 +78,13 @@ SIDList getDataBufPagesIdList(SDiskbasedBuf* pBuf);
  */
 void* getBufPage(SDiskbasedBuf* pBuf, int32_t id);
 
+/**
+ * start loading the specified buffer page from disk in background, if it is not in memory
+ * @param pBuf
+ * @param id
+ */
+void prefetchBufPage(SDiskbasedBuf* pBuf, int32_t id);
+
 /**
  * release the referenced buf pages
  * @param pBuf
@@ -148,7 +155,7 @@ bool isAllDataInMemBuf(const SDiskbasedBuf* pBuf);
 void setBufPageDirty(void* pPage, bool dirty);
 
 /**
- * Set the compress/ no-compress flag for paged buffer, when flushing data in disk.
+ * Set the compress/ no-compress flag for paged buffer, when flushing data in disk. Pages are compressed by default.
  * @param pBuf
  */
 void setBufPageCompressOnDisk(SDiskbasedBuf* pBuf, bool comp);
@@ -179,6 +186,25 @@ SDiskbasedBufStatis getDBufStatis(const SDiskbasedBuf* pBuf);
  */
 void dBufPrintStatis(const SDiskbasedBuf* pBuf);
 
+/**
+ * Set the node level budget for the in-memory pages of all paged buffers. Once it is used up, each buffer spills its
+ * own pages to disk instead of allocating new ones.
+ * @param bytes negative value means no limit
+ */
+void dBufSetMemBudget(int64_t bytes);
+
+/**
+ * Return the size of in-memory pages of all paged buffers.
+ * @return
+ */
+int64_t dBufGetMemUsed();
+
+/**
+ * Check if the in-memory pages of all paged buffers have exceeded the node level budget.
+ * @return
+ */
+bool dBufIsMemBudgetExceeded();
+
 /**
  * Set all of page buffer are not need
  * @param pBuf
@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _TD_UTIL_ROARING_H_
+#define _TD_UTIL_ROARING_H_
+
+#include "os.h"
+#include "tarray.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * compressed bitmap of uint64 values, split by the high 48 bits into containers
+ * of 65536 values, each stored as a sorted uint16 array or as a plain bitmap
+ */
+typedef struct SRoaringCont SRoaringCont;
+
+typedef struct SRoaring {
+  int32_t       size;
+  int32_t       cap;
+  SRoaringCont *pConts;
+} SRoaring;
+
+SRoaring *tRoaringCreate();
+void      tRoaringDestroy(SRoaring *pRoaring);
+void      tRoaringClear(SRoaring *pRoaring);
+int32_t   tRoaringAdd(SRoaring *pRoaring, uint64_t val);
+int32_t   tRoaringAddArray(SRoaring *pRoaring, const SArray *pVals);
+bool      tRoaringContains(const SRoaring *pRoaring, uint64_t val);
+int64_t   tRoaringCardinality(const SRoaring *pRoaring);
+
+// in place set operations, the result is saved in pDst
+int32_t tRoaringAnd(SRoaring *pDst, const SRoaring *pSrc);
+int32_t tRoaringOr(SRoaring *pDst, const SRoaring *pSrc);
+int32_t tRoaringAndNot(SRoaring *pDst, const SRoaring *pSrc);
+
+// append all values to pVals(uint64_t) in ascending order
+int32_t tRoaringToArray(const SRoaring *pRoaring, SArray *pVals);
+
+int32_t tRoaringSerialSize(const SRoaring *pRoaring);
+int32_t tRoaringSerialize(const SRoaring *pRoaring, void *buf);
+int32_t tRoaringDeserializeOr(SRoaring *pRoaring, const void *buf, int32_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*_TD_UTIL_ROARING_H_*/
@@ -1937,12 +1937,52 @@ void resetConnectDB(STscObj* pTscObj) {
   taosThreadMutexUnlock(&pTscObj->mutex);
 }
 
+// the columns encoded by the server are decoded into a raw block in a new response, which the result set points to
+static int32_t doDecodeRspBlock(const SRetrieveTableRsp** ppRsp, bool freeAfterUse) {
+  const SRetrieveTableRsp* pRsp = *ppRsp;
+  SSDataBlock              block = {0};
+  int32_t                  code = TSDB_CODE_SUCCESS;
+
+  if (blockDecode(&block, pRsp->data) == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _end;
+  }
+
+  int32_t            len = 0;
+  SRetrieveTableRsp* pNewRsp = taosMemoryMalloc(sizeof(SRetrieveTableRsp) + blockGetEncodeSize(&block));
+  if (pNewRsp == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _end;
+  }
+
+  memcpy(pNewRsp, pRsp, sizeof(SRetrieveTableRsp));
+  blockEncode(&block, pNewRsp->data, &len, taosArrayGetSize(block.pDataBlock), false);
+  pNewRsp->compressed = 0;
+  pNewRsp->compLen = htonl(len);
+
+  if (freeAfterUse) {
+    taosMemoryFree((void*)pRsp);
+  }
+  *ppRsp = pNewRsp;
+
+_end:
+  blockDataFreeRes(&block);
+  return code;
+}
+
 int32_t setQueryResultFromRsp(SReqResultInfo* pResultInfo, const SRetrieveTableRsp* pRsp, bool convertUcs4,
                               bool freeAfterUse) {
   assert(pResultInfo != NULL && pRsp != NULL);
 
   if (freeAfterUse) taosMemoryFreeClear(pResultInfo->pRspMsg);
 
+  if (htonl(pRsp->numOfRows) > 0 && *(int32_t*)pRsp->data == BLOCK_VERSION_ENCODED) {
+    int32_t code = doDecodeRspBlock(&pRsp, freeAfterUse);
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
+  }
+
   pResultInfo->pRspMsg = (const char*)pRsp;
   pResultInfo->pData = (void*)pRsp->data;
   pResultInfo->numOfRows = htonl(pRsp->numOfRows);
@@ -1951,7 +1991,6 @@ int32_t setQueryResultFromRsp(SReqResultInfo* pResultInfo, const SRetrieveTableR
   pResultInfo->payloadLen = htonl(pRsp->compLen);
   pResultInfo->precision = pRsp->precision;
 
-  // TODO handle the compressed case
   pResultInfo->totalRows += pResultInfo->numOfRows;
   return setResultDataPtr(pResultInfo, pResultInfo->fields, pResultInfo->numOfCols, pResultInfo->numOfRows,
                           convertUcs4);
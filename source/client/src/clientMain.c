@@ -66,6 +66,7 @@ void taos_cleanup(void) {
 
   fmFuncMgtDestroy();
   qCleanupKeywordsTable();
+  qCleanupCsvParsePool();
   nodesDestroyAllocatorSet();
 
   id = clientConnRefPool;
@@ -64,6 +64,17 @@
     }                                        \
   }
 
+// test 8 bytes a time whether there is any delimiter of influx line, see smlSkipPlainBytes
+#define SML_ONES_U64             0x0101010101010101ULL
+#define SML_HAS_ZERO_BYTE(v)     (((v)-SML_ONES_U64) & ~(v)&0x8080808080808080ULL)
+#define SML_HAS_BYTE(v, c)       SML_HAS_ZERO_BYTE((v) ^ (SML_ONES_U64 * (uint8_t)(c)))
+#define SML_HAS_DELIMITER(v)                                                                               \
+  (SML_HAS_BYTE(v, COMMA) | SML_HAS_BYTE(v, SPACE) | SML_HAS_BYTE(v, EQUAL) | SML_HAS_BYTE(v, QUOTE) | \
+   SML_HAS_BYTE(v, SLASH))
+
+// keys of one line are few, a linear scan is cheaper than the hash until there are more keys than this
+#define SML_LINEAR_DUP_CHECK_NUM 16
+
 #define IS_INVALID_COL_LEN(len)   ((len) <= 0 || (len) >= TSDB_COL_NAME_LEN)
 #define IS_INVALID_TABLE_LEN(len) ((len) <= 0 || (len) >= TSDB_TABLE_NAME_LEN)
 
@@ -179,6 +190,12 @@ typedef struct {
   SSmlMsgBuf   msgBuf;
   SHashObj    *dumplicateKey;  // for dumplicate key
   SArray      *colsContainer;  // for cols parse, if dataFormat == false
+
+  // lines of one table usually come together, cache the table of the previous line to skip the hash lookup
+  const char     *preMeasureTag;
+  int32_t         preMeasureTagLen;
+  SSmlTableInfo  *preTable;
+  SSmlSTableMeta *preSTableMeta;
 } SSmlHandle;
 //=================================================================================================
 
@@ -208,6 +225,30 @@ static inline bool smlCheckDuplicateKey(const char *key, int32_t keyLen, SHashOb
   return false;
 }
 
+// skip the bytes before the first possible delimiter, the caller still checks the byte it stops at
+static FORCE_INLINE const char *smlSkipPlainBytes(const char *sql, const char *end) {
+  while (end - sql >= sizeof(uint64_t)) {
+    uint64_t v;
+    memcpy(&v, sql, sizeof(uint64_t));
+    if (SML_HAS_DELIMITER(v)) {
+      break;
+    }
+    sql += sizeof(uint64_t);
+  }
+  return sql;
+}
+
+static bool smlFindKvByKey(SArray *kvs, int32_t start, const char *key, int32_t keyLen) {
+  int32_t size = taosArrayGetSize(kvs);
+  for (int32_t i = start; i < size; ++i) {
+    SSmlKv *kv = (SSmlKv *)taosArrayGetP(kvs, i);
+    if (kv->keyLen == keyLen && memcmp(kv->key, key, keyLen) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
 static int32_t smlBuildInvalidDataMsg(SSmlMsgBuf *pBuf, const char *msg1, const char *msg2) {
   if(pBuf->buf){
     memset(pBuf->buf, 0, pBuf->len);
@@ -914,11 +955,17 @@ static int32_t smlParseInfluxString(const char *sql, SSmlLineInfo *elements, SSm
   JUMP_SPACE(sql)
   if (*sql == COMMA) return TSDB_CODE_SML_INVALID_DATA;
   elements->measure = sql;
+  const char *end = sql + strlen(sql);
 
   // parse measure
-  while (*sql != '\0') {
+  while (sql < end) {
+    sql = smlSkipPlainBytes(sql, end);
+    if (sql >= end) {
+      break;
+    }
     if ((sql != elements->measure) && IS_SLASH_LETTER(sql)) {
-      MOVE_FORWARD_ONE(sql, strlen(sql) + 1);
+      MOVE_FORWARD_ONE(sql, end - sql + 1);
+      end--;
       continue;
     }
     if (IS_COMMA(sql)) {
@@ -942,8 +989,9 @@ static int32_t smlParseInfluxString(const char *sql, SSmlLineInfo *elements, SSm
   } else {
     if (*sql == COMMA) sql++;
     elements->tags = sql;
-    while (*sql != '\0') {
-      if (IS_SPACE(sql)) {
+    while (sql < end) {
+      sql = smlSkipPlainBytes(sql, end);
+      if (sql >= end || IS_SPACE(sql)) {
         break;
       }
       sql++;
@@ -956,7 +1004,11 @@ static int32_t smlParseInfluxString(const char *sql, SSmlLineInfo *elements, SSm
   JUMP_SPACE(sql)
   elements->cols = sql;
   bool isInQuote = false;
-  while (*sql != '\0') {
+  while (sql < end) {
+    sql = smlSkipPlainBytes(sql, end);
+    if (sql >= end) {
+      break;
+    }
     if (IS_QUOTE(sql)) {
       isInQuote = !isInQuote;
     }
@@ -978,13 +1030,8 @@ static int32_t smlParseInfluxString(const char *sql, SSmlLineInfo *elements, SSm
   // parse timestamp
   JUMP_SPACE(sql)
   elements->timestamp = sql;
-  while (*sql != '\0') {
-    if (*sql == SPACE) {
-      break;
-    }
-    sql++;
-  }
-  elements->timestampLen = sql - elements->timestamp;
+  const char *tsEnd = memchr(sql, SPACE, end - sql);
+  elements->timestampLen = (tsEnd == NULL ? end : tsEnd) - elements->timestamp;
 
   return TSDB_CODE_SUCCESS;
 }
@@ -1145,13 +1192,21 @@ static int32_t smlParseCols(const char *data, int32_t len, SArray *cols, char *c
   }
 
   size_t      childTableNameLen = strlen(tsSmlChildTableName);
+  bool        hasChildTableName = false;
+  int32_t     start = taosArrayGetSize(cols);
+  int32_t     numOfKeys = 0;
+  const char *end = data + len;
   const char *sql = data;
-  while (sql < data + len) {
+  while (sql < end) {
     const char *key = sql;
     int32_t     keyLen = 0;
 
-    while (sql < data + len) {
+    while (sql < end) {
       // parse key
+      sql = smlSkipPlainBytes(sql, end);
+      if (sql >= end) {
+        break;
+      }
       if (IS_COMMA(sql)) {
         smlBuildInvalidDataMsg(msg, "invalid data", sql);
         return TSDB_CODE_SML_INVALID_DATA;
@@ -1168,17 +1223,17 @@ static int32_t smlParseCols(const char *data, int32_t len, SArray *cols, char *c
       smlBuildInvalidDataMsg(msg, "invalid key or key is too long than 64", key);
       return TSDB_CODE_TSC_INVALID_COLUMN_LENGTH;
     }
-    if (smlCheckDuplicateKey(key, keyLen, dumplicateKey)) {
-      smlBuildInvalidDataMsg(msg, "dumplicate key", key);
-      return TSDB_CODE_TSC_DUP_NAMES;
-    }
 
     // parse value
     const char *value = sql;
     int32_t     valueLen = 0;
     bool        isInQuote = false;
-    while (sql < data + len) {
+    while (sql < end) {
       // parse value
+      sql = smlSkipPlainBytes(sql, end);
+      if (sql >= end) {
+        break;
+      }
       if (!isTag && IS_QUOTE(sql)) {
         isInQuote = !isInQuote;
         sql++;
@@ -1204,16 +1259,45 @@ static int32_t smlParseCols(const char *data, int32_t len, SArray *cols, char *c
       smlBuildInvalidDataMsg(msg, "invalid value", value);
       return TSDB_CODE_SML_INVALID_DATA;
     }
-    PROCESS_SLASH(key, keyLen)
-    PROCESS_SLASH(value, valueLen)
+    if (memchr(key, SLASH, keyLen) != NULL) {
+      PROCESS_SLASH(key, keyLen)
+    }
+    if (memchr(value, SLASH, valueLen) != NULL) {
+      PROCESS_SLASH(value, valueLen)
+    }
 
     // handle child table name
     if (childTableName && childTableNameLen != 0 && strncmp(key, tsSmlChildTableName, keyLen) == 0) {
+      if (hasChildTableName) {
+        smlBuildInvalidDataMsg(msg, "dumplicate key", key);
+        return TSDB_CODE_TSC_DUP_NAMES;
+      }
+      hasChildTableName = true;
       memset(childTableName, 0, TSDB_TABLE_NAME_LEN);
       strncpy(childTableName, value, (valueLen < TSDB_TABLE_NAME_LEN ? valueLen : TSDB_TABLE_NAME_LEN));
       continue;
     }
 
+    // check dumplicate key, by scanning the parsed keys first and by the hash when there are many keys
+    if (cols && numOfKeys < SML_LINEAR_DUP_CHECK_NUM) {
+      if (smlFindKvByKey(cols, start, key, keyLen)) {
+        smlBuildInvalidDataMsg(msg, "dumplicate key", key);
+        return TSDB_CODE_TSC_DUP_NAMES;
+      }
+    } else {
+      if (cols && numOfKeys == SML_LINEAR_DUP_CHECK_NUM) {
+        for (int32_t i = start; i < taosArrayGetSize(cols); ++i) {
+          SSmlKv *pKv = (SSmlKv *)taosArrayGetP(cols, i);
+          smlCheckDuplicateKey(pKv->key, pKv->keyLen, dumplicateKey);
+        }
+      }
+      if (smlCheckDuplicateKey(key, keyLen, dumplicateKey)) {
+        smlBuildInvalidDataMsg(msg, "dumplicate key", key);
+        return TSDB_CODE_TSC_DUP_NAMES;
+      }
+    }
+    numOfKeys++;
+
     // add kv to SSmlKv
     SSmlKv *kv = (SSmlKv *)taosMemoryCalloc(sizeof(SSmlKv), 1);
     if (!kv) return TSDB_CODE_OUT_OF_MEMORY;
@@ -1243,9 +1327,21 @@ static int32_t smlUpdateMeta(SHashObj *metaHash, SArray *metaArray, SArray *cols
   for (int i = 0; i < taosArrayGetSize(cols); ++i) {
     SSmlKv *kv = (SSmlKv *)taosArrayGetP(cols, i);
 
-    int16_t *index = (int16_t *)taosHashGet(metaHash, kv->key, kv->keyLen);
-    if (index) {
-      SSmlKv **value = (SSmlKv **)taosArrayGet(metaArray, *index);
+    // keys of lines usually come in the same order, try the meta at the same position before the hash
+    SSmlKv **value = NULL;
+    if (i < taosArrayGetSize(metaArray)) {
+      SSmlKv **p = (SSmlKv **)taosArrayGet(metaArray, i);
+      if ((*p)->keyLen == kv->keyLen && memcmp((*p)->key, kv->key, kv->keyLen) == 0) {
+        value = p;
+      }
+    }
+    if (value == NULL) {
+      int16_t *index = (int16_t *)taosHashGet(metaHash, kv->key, kv->keyLen);
+      if (index) {
+        value = (SSmlKv **)taosArrayGet(metaArray, *index);
+      }
+    }
+    if (value) {
       if (kv->type != (*value)->type) {
         smlBuildInvalidDataMsg(msg, "the type is not the same like before", kv->key);
         return TSDB_CODE_SML_NOT_SAME_TYPE;
@@ -2063,6 +2159,8 @@ static int32_t smlParseInfluxLine(SSmlHandle *info, const char *sql) {
     uError("SML:0x%" PRIx64 " smlParseInfluxLine failed", info->id);
     return ret;
   }
+  // the escaped tags are changed in place later, never match them by content
+  bool cacheable = (memchr(elements.measure, SLASH, elements.measureTagsLen) == NULL);
 
   SArray *cols = NULL;
   if (info->dataFormat) {  // if dataFormat, cols need new memory to save data
@@ -2090,9 +2188,16 @@ static int32_t smlParseInfluxLine(SSmlHandle *info, const char *sql) {
   }
 
   bool            hasTable = true;
+  bool            sameTable = false;
   SSmlTableInfo  *tinfo = NULL;
-  SSmlTableInfo **oneTable =
-      (SSmlTableInfo **)taosHashGet(info->childTables, elements.measure, elements.measureTagsLen);
+  SSmlTableInfo **oneTable = NULL;
+  if (info->preTable && info->preMeasureTagLen == elements.measureTagsLen &&
+      memcmp(info->preMeasureTag, elements.measure, elements.measureTagsLen) == 0) {
+    oneTable = &info->preTable;
+    sameTable = true;
+  } else {
+    oneTable = (SSmlTableInfo **)taosHashGet(info->childTables, elements.measure, elements.measureTagsLen);
+  }
   if (!oneTable) {
     tinfo = smlBuildTableInfo();
     if (!tinfo) {
@@ -2115,6 +2220,13 @@ static int32_t smlParseInfluxLine(SSmlHandle *info, const char *sql) {
       uError("SML:0x%" PRIx64 " smlParseCols parse tag fields failed", info->id);
       return ret;
     }
+    for (int32_t i = 0; i < taosArrayGetSize((*oneTable)->tags); ++i) {
+      SSmlKv *tag = (SSmlKv *)taosArrayGetP((*oneTable)->tags, i);
+      if (smlFindKvByKey(cols, 1, tag->key, tag->keyLen)) {  // skip the timestamp
+        smlBuildInvalidDataMsg(&info->msgBuf, "dumplicate key", tag->key);
+        return TSDB_CODE_TSC_DUP_NAMES;
+      }
+    }
 
     if (taosArrayGetSize((*oneTable)->tags) > TSDB_MAX_TAGS) {
       smlBuildInvalidDataMsg(&info->msgBuf, "too many tags than 128", NULL);
@@ -2139,7 +2251,12 @@ static int32_t smlParseInfluxLine(SSmlHandle *info, const char *sql) {
     }
   }
 
-  SSmlSTableMeta **tableMeta = (SSmlSTableMeta **)taosHashGet(info->superTables, elements.measure, elements.measureLen);
+  SSmlSTableMeta **tableMeta = NULL;
+  if (sameTable && info->preSTableMeta) {
+    tableMeta = &info->preSTableMeta;
+  } else {
+    tableMeta = (SSmlSTableMeta **)taosHashGet(info->superTables, elements.measure, elements.measureLen);
+  }
   if (tableMeta) {  // update meta
     ret = smlUpdateMeta((*tableMeta)->colHash, (*tableMeta)->cols, cols, &info->msgBuf);
     if (!hasTable && ret == TSDB_CODE_SUCCESS) {
@@ -2154,12 +2271,22 @@ static int32_t smlParseInfluxLine(SSmlHandle *info, const char *sql) {
     smlInsertMeta(meta->tagHash, meta->tags, (*oneTable)->tags);
     smlInsertMeta(meta->colHash, meta->cols, cols);
     taosHashPut(info->superTables, elements.measure, elements.measureLen, &meta, POINTER_BYTES);
+    tableMeta = &meta;
+  }
+
+  if (!sameTable && cacheable) {
+    info->preMeasureTag = elements.measure;
+    info->preMeasureTagLen = elements.measureTagsLen;
+    info->preTable = *oneTable;
+    info->preSTableMeta = *tableMeta;
   }
 
   if (!info->dataFormat) {
     taosArrayClear(info->colsContainer);
   }
-  taosHashClear(info->dumplicateKey);
+  if (taosHashGetSize(info->dumplicateKey) > 0) {
+    taosHashClear(info->dumplicateKey);
+  }
   return TSDB_CODE_SUCCESS;
 }
 
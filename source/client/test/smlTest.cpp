@@ -476,6 +476,37 @@ TEST(testCase, smlParseCols_Test) {
   taosMemoryFree(sql);
 }
 
+TEST(testCase, smlParseCols_dumplicate_Test) {
+  char       msg[256] = {0};
+  SSmlMsgBuf msgBuf;
+  msgBuf.buf = msg;
+  msgBuf.len = 256;
+
+  SHashObj *dumplicateKey = taosHashInit(32, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY), false, HASH_NO_LOCK);
+  const char *data[] = {
+      "c\\=1=1,c=1=2",                                                                  // escaped key
+      "c0=0,c1=1,c2=2,c3=3,c4=4,c5=5,c6=6,c7=7,c8=8,c9=9,c10=10,c11=11,c12=12,c13=13,c14=14,c15=15,c16=16,c17=17",
+      "c0=0,c1=1,c2=2,c3=3,c4=4,c5=5,c6=6,c7=7,c8=8,c9=9,c10=10,c11=11,c12=12,c13=13,c14=14,c15=15,c16=16,c3=17",
+      "c0=0,c1=1,c2=2,c3=3,c4=4,c5=5,c6=6,c7=7,c8=8,c9=9,c10=10,c11=11,c12=12,c13=13,c14=14,c15=15,c16=16,c16=17",
+  };
+  int32_t expect[] = {TSDB_CODE_SUCCESS, TSDB_CODE_SUCCESS, TSDB_CODE_TSC_DUP_NAMES, TSDB_CODE_TSC_DUP_NAMES};
+  for (int i = 0; i < sizeof(data) / sizeof(data[0]); i++) {
+    int32_t len = strlen(data[i]);
+    char   *sql = (char *)taosMemoryCalloc(256, 1);
+    memcpy(sql, data[i], len + 1);
+    SArray *cols = taosArrayInit(8, POINTER_BYTES);
+    int32_t ret = smlParseCols(sql, len, cols, NULL, false, dumplicateKey, &msgBuf);
+    ASSERT_EQ(ret, expect[i]);
+    taosHashClear(dumplicateKey);
+    for (int j = 0; j < taosArrayGetSize(cols); j++) {
+      taosMemoryFree(taosArrayGetP(cols, j));
+    }
+    taosArrayDestroy(cols);
+    taosMemoryFree(sql);
+  }
+  taosHashCleanup(dumplicateKey);
+}
+
 TEST(testCase, smlGetTimestampLen_Test) {
   uint8_t len = smlGetTimestampLen(0);
   ASSERT_EQ(len, 1);
@@ -2114,10 +2114,482 @@ char* buildCtbNameByGroupId(const char* stbName, uint64_t groupId) {
   return rname.childTableName;
 }
 
+// column codecs of the encoded block, the data codec is in the low 4 bits of the codec byte of each column, and the
+// null bitmap codec in the high 4 bits
+#define BLOCK_COL_RAW     0  // the same as the raw block
+#define BLOCK_COL_BITPACK 1  // integers as offsets to the min value, packed in the bits required by the max offset
+#define BLOCK_COL_DELTA   2  // 8 bytes integers like timestamps as deltas to the previous value, packed as above
+#define BLOCK_COL_DICT    3  // variable length data of low cardinality as indexes into a dictionary of distinct values
+
+#define BLOCK_BITMAP_RAW 0
+#define BLOCK_BITMAP_RLE 1  // runs of identical bytes, as pairs of run length and byte
+
+typedef struct SBitWriter {
+  uint8_t* p;
+  uint64_t acc;
+  int32_t  nbits;
+} SBitWriter;
+
+typedef struct SBitReader {
+  const uint8_t* p;
+  uint64_t       acc;
+  int32_t        nbits;
+} SBitReader;
+
+static FORCE_INLINE int32_t bitWidth(uint64_t v) { return (v == 0) ? 0 : (64 - BUILDIN_CLZL(v)); }
+
+static FORCE_INLINE int32_t bitPackedLen(int32_t num, int32_t width) {
+  return (int32_t)(((int64_t)num * width + 7) >> 3);
+}
+
+static void bitWrite(SBitWriter* pWriter, uint64_t v, int32_t width) {
+  while (width > 0) {
+    int32_t n = TMIN(width, 32);
+    pWriter->acc |= (v & ((1ull << n) - 1)) << pWriter->nbits;
+    pWriter->nbits += n;
+    v >>= n;
+    width -= n;
+
+    while (pWriter->nbits >= 8) {
+      *(pWriter->p++) = (uint8_t)pWriter->acc;
+      pWriter->acc >>= 8;
+      pWriter->nbits -= 8;
+    }
+  }
+}
+
+static void bitFlush(SBitWriter* pWriter) {
+  if (pWriter->nbits > 0) {
+    *(pWriter->p++) = (uint8_t)pWriter->acc;
+    pWriter->acc = 0;
+    pWriter->nbits = 0;
+  }
+}
+
+static uint64_t bitRead(SBitReader* pReader, int32_t width) {
+  uint64_t v = 0;
+  int32_t  shift = 0;
+  while (width > 0) {
+    int32_t n = TMIN(width, 32);
+    while (pReader->nbits < n) {
+      pReader->acc |= ((uint64_t)(*(pReader->p++))) << pReader->nbits;
+      pReader->nbits += 8;
+    }
+
+    v |= (pReader->acc & ((1ull << n) - 1)) << shift;
+    pReader->acc >>= n;
+    pReader->nbits -= n;
+    shift += n;
+    width -= n;
+  }
+
+  return v;
+}
+
+// map the integer to an unsigned one of the same order, so signed and unsigned types are packed in the same way
+static FORCE_INLINE uint64_t colIntToKey(const char* p, int8_t type, int32_t bytes) {
+  switch (bytes) {
+    case 1:
+      return IS_SIGNED_NUMERIC_TYPE(type) ? ((uint64_t)(int64_t)(*(int8_t*)p) ^ (1ull << 63)) : *(uint8_t*)p;
+    case 2:
+      return IS_SIGNED_NUMERIC_TYPE(type) ? ((uint64_t)(int64_t)(*(int16_t*)p) ^ (1ull << 63)) : *(uint16_t*)p;
+    case 4:
+      return IS_SIGNED_NUMERIC_TYPE(type) ? ((uint64_t)(int64_t)(*(int32_t*)p) ^ (1ull << 63)) : *(uint32_t*)p;
+    default:
+      return IS_UNSIGNED_NUMERIC_TYPE(type) ? *(uint64_t*)p : (*(uint64_t*)p ^ (1ull << 63));
+  }
+}
+
+static FORCE_INLINE void colKeyToInt(char* p, uint64_t key, int8_t type, int32_t bytes) {
+  uint64_t v = (IS_UNSIGNED_NUMERIC_TYPE(type) || type == TSDB_DATA_TYPE_BOOL) ? key : (key ^ (1ull << 63));
+  switch (bytes) {
+    case 1:
+      *(uint8_t*)p = (uint8_t)v;
+      break;
+    case 2:
+      *(uint16_t*)p = (uint16_t)v;
+      break;
+    case 4:
+      *(uint32_t*)p = (uint32_t)v;
+      break;
+    default:
+      *(uint64_t*)p = v;
+      break;
+  }
+}
+
+static int32_t bitmapRleLen(const char* pBitmap, int32_t len) {
+  int32_t size = sizeof(int32_t);
+  for (int32_t i = 0; i < len;) {
+    int32_t j = i + 1;
+    while (j < len && j - i < UINT8_MAX && pBitmap[j] == pBitmap[i]) j++;
+    size += 2;
+    i = j;
+  }
+  return size;
+}
+
+static int32_t bitmapEncodeRle(const char* pBitmap, int32_t len, char* data) {
+  char* p = data + sizeof(int32_t);
+  for (int32_t i = 0; i < len;) {
+    int32_t j = i + 1;
+    while (j < len && j - i < UINT8_MAX && pBitmap[j] == pBitmap[i]) j++;
+    *(uint8_t*)(p++) = (uint8_t)(j - i);
+    *(p++) = pBitmap[i];
+    i = j;
+  }
+
+  *(int32_t*)data = (int32_t)(p - data);
+  return (int32_t)(p - data);
+}
+
+static int32_t bitmapDecodeRle(char* pBitmap, const char* data) {
+  int32_t     size = *(int32_t*)data;
+  const char* p = data + sizeof(int32_t);
+  const char* pEnd = data + size;
+  while (p < pEnd) {
+    uint8_t run = *(uint8_t*)(p++);
+    memset(pBitmap, *(p++), run);
+    pBitmap += run;
+  }
+  return size;
+}
+
+// encode the fixed length column, the codec of bitmap and data are chosen by their sizes
+static int32_t colEncodeFixed(const SColumnInfoData* pColInfoData, int32_t numOfRows, char* data) {
+  int8_t  type = pColInfoData->info.type;
+  int32_t bytes = pColInfoData->info.bytes;
+  char*   p = data + sizeof(int8_t);
+  int8_t  dataCodec = BLOCK_COL_RAW;
+  int8_t  bitmapCodec = BLOCK_BITMAP_RAW;
+
+  // null bitmap
+  int32_t bitmapLen = BitmapLen(numOfRows);
+  if (bitmapRleLen(pColInfoData->nullbitmap, bitmapLen) < bitmapLen) {
+    bitmapCodec = BLOCK_BITMAP_RLE;
+    p += bitmapEncodeRle(pColInfoData->nullbitmap, bitmapLen, p);
+  } else {
+    memcpy(p, pColInfoData->nullbitmap, bitmapLen);
+    p += bitmapLen;
+  }
+
+  // data
+  int32_t rawLen = bytes * numOfRows;
+  int32_t packLen = INT32_MAX;
+  int32_t deltaLen = INT32_MAX;
+  int32_t packWidth = 0, deltaWidth = 0;
+  uint64_t minKey = UINT64_MAX, maxKey = 0;
+  int64_t  minDelta = INT64_MAX, maxDelta = INT64_MIN;
+
+  if (IS_INTEGER_TYPE(type) || type == TSDB_DATA_TYPE_BOOL || type == TSDB_DATA_TYPE_TIMESTAMP) {
+    uint64_t prev = 0;
+    for (int32_t i = 0; i < numOfRows; ++i) {
+      uint64_t key = colIntToKey(pColInfoData->pData + i * bytes, type, bytes);
+      minKey = TMIN(minKey, key);
+      maxKey = TMAX(maxKey, key);
+      if (i > 0) {
+        int64_t delta = (int64_t)(key - prev);
+        minDelta = TMIN(minDelta, delta);
+        maxDelta = TMAX(maxDelta, delta);
+      }
+      prev = key;
+    }
+
+    packWidth = bitWidth(maxKey - minKey);
+    packLen = sizeof(uint64_t) + sizeof(int8_t) + bitPackedLen(numOfRows, packWidth);
+    if (bytes == sizeof(int64_t) && numOfRows > 1) {
+      deltaWidth = bitWidth((uint64_t)maxDelta - (uint64_t)minDelta);
+      deltaLen = sizeof(uint64_t) + sizeof(int64_t) + sizeof(int8_t) + bitPackedLen(numOfRows - 1, deltaWidth);
+    }
+  }
+
+  if (deltaLen < packLen && deltaLen < rawLen) {
+    dataCodec = BLOCK_COL_DELTA;
+    SBitWriter writer = {0};
+
+    uint64_t prev = colIntToKey(pColInfoData->pData, type, bytes);
+    *(uint64_t*)p = prev;
+    p += sizeof(uint64_t);
+    *(int64_t*)p = minDelta;
+    p += sizeof(int64_t);
+    *(int8_t*)p = (int8_t)deltaWidth;
+    p += sizeof(int8_t);
+
+    writer.p = (uint8_t*)p;
+    for (int32_t i = 1; i < numOfRows; ++i) {
+      uint64_t key = colIntToKey(pColInfoData->pData + i * bytes, type, bytes);
+      bitWrite(&writer, key - prev - (uint64_t)minDelta, deltaWidth);
+      prev = key;
+    }
+    bitFlush(&writer);
+    p = (char*)writer.p;
+  } else if (packLen < rawLen) {
+    dataCodec = BLOCK_COL_BITPACK;
+    SBitWriter writer = {0};
+
+    *(uint64_t*)p = minKey;
+    p += sizeof(uint64_t);
+    *(int8_t*)p = (int8_t)packWidth;
+    p += sizeof(int8_t);
+
+    writer.p = (uint8_t*)p;
+    for (int32_t i = 0; i < numOfRows; ++i) {
+      bitWrite(&writer, colIntToKey(pColInfoData->pData + i * bytes, type, bytes) - minKey, packWidth);
+    }
+    bitFlush(&writer);
+    p = (char*)writer.p;
+  } else {
+    memcpy(p, pColInfoData->pData, rawLen);
+    p += rawLen;
+  }
+
+  *(int8_t*)data = (int8_t)((bitmapCodec << 4) | dataCodec);
+  return (int32_t)(p - data);
+}
+
+static int32_t colDecodeFixed(SColumnInfoData* pColInfoData, int32_t numOfRows, const char* data) {
+  int8_t      type = pColInfoData->info.type;
+  int32_t     bytes = pColInfoData->info.bytes;
+  int8_t      dataCodec = (*(int8_t*)data) & 0x0F;
+  int8_t      bitmapCodec = ((*(uint8_t*)data) >> 4) & 0x0F;
+  const char* p = data + sizeof(int8_t);
+
+  if (bitmapCodec == BLOCK_BITMAP_RLE) {
+    p += bitmapDecodeRle(pColInfoData->nullbitmap, p);
+  } else {
+    memcpy(pColInfoData->nullbitmap, p, BitmapLen(numOfRows));
+    p += BitmapLen(numOfRows);
+  }
+
+  if (dataCodec == BLOCK_COL_DELTA) {
+    uint64_t prev = *(uint64_t*)p;
+    p += sizeof(uint64_t);
+    int64_t minDelta = *(int64_t*)p;
+    p += sizeof(int64_t);
+    int32_t width = *(int8_t*)p;
+    p += sizeof(int8_t);
+
+    SBitReader reader = {.p = (const uint8_t*)p};
+    colKeyToInt(pColInfoData->pData, prev, type, bytes);
+    for (int32_t i = 1; i < numOfRows; ++i) {
+      prev = prev + (uint64_t)minDelta + bitRead(&reader, width);
+      colKeyToInt(pColInfoData->pData + i * bytes, prev, type, bytes);
+    }
+    p += bitPackedLen(numOfRows - 1, width);
+  } else if (dataCodec == BLOCK_COL_BITPACK) {
+    uint64_t minKey = *(uint64_t*)p;
+    p += sizeof(uint64_t);
+    int32_t width = *(int8_t*)p;
+    p += sizeof(int8_t);
+
+    SBitReader reader = {.p = (const uint8_t*)p};
+    for (int32_t i = 0; i < numOfRows; ++i) {
+      colKeyToInt(pColInfoData->pData + i * bytes, minKey + bitRead(&reader, width), type, bytes);
+    }
+    p += bitPackedLen(numOfRows, width);
+  } else {
+    memcpy(pColInfoData->pData, p, bytes * numOfRows);
+    p += bytes * numOfRows;
+  }
+
+  return (int32_t)(p - data);
+}
+
+// encode the variable length column by a dictionary if there are only a few distinct values, otherwise keep it raw
+static int32_t colEncodeVar(const SColumnInfoData* pColInfoData, int32_t numOfRows, char* data) {
+  int32_t   rawLen = numOfRows * sizeof(int32_t) + pColInfoData->varmeta.length;
+  int32_t   nDict = 0;
+  int32_t   dictLen = 0;
+  int32_t*  pIndex = NULL;
+  int32_t*  pDictOffset = NULL;
+  SHashObj* pDict = NULL;
+  char*     p = data + sizeof(int8_t);
+
+  if (pColInfoData->info.type == TSDB_DATA_TYPE_JSON || numOfRows < 2) {
+    goto _raw;
+  }
+
+  pIndex = taosMemoryMalloc(numOfRows * sizeof(int32_t));
+  pDictOffset = taosMemoryMalloc((numOfRows / 2 + 1) * sizeof(int32_t));
+  pDict = taosHashInit(numOfRows, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY), false, HASH_NO_LOCK);
+  if (pIndex == NULL || pDictOffset == NULL || pDict == NULL) {
+    goto _raw;
+  }
+
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    int32_t offset = pColInfoData->varmeta.offset[i];
+    if (offset == -1) {
+      pIndex[i] = -1;
+      continue;
+    }
+
+    char*    pVal = pColInfoData->pData + offset;
+    int32_t* pIdx = taosHashGet(pDict, pVal, varDataTLen(pVal));
+    if (pIdx != NULL) {
+      pIndex[i] = *pIdx;
+      continue;
+    }
+
+    // not worth it if more than half of the values are distinct
+    if (nDict > numOfRows / 2) {
+      goto _raw;
+    }
+
+    if (taosHashPut(pDict, pVal, varDataTLen(pVal), &nDict, sizeof(int32_t)) != 0) {
+      goto _raw;
+    }
+    pDictOffset[nDict] = offset;
+    pIndex[i] = nDict++;
+    dictLen += varDataTLen(pVal);
+  }
+
+  // the index nDict is for null
+  int32_t width = bitWidth(nDict);
+  if (sizeof(int32_t) + sizeof(int8_t) + bitPackedLen(numOfRows, width) + sizeof(int32_t) + dictLen >= rawLen) {
+    goto _raw;
+  }
+
+  *(int32_t*)p = nDict;
+  p += sizeof(int32_t);
+  *(int8_t*)p = (int8_t)width;
+  p += sizeof(int8_t);
+
+  SBitWriter writer = {.p = (uint8_t*)p};
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    bitWrite(&writer, (pIndex[i] == -1) ? nDict : pIndex[i], width);
+  }
+  bitFlush(&writer);
+  p = (char*)writer.p;
+
+  *(int32_t*)p = dictLen;
+  p += sizeof(int32_t);
+  for (int32_t i = 0; i < nDict; ++i) {
+    char* pVal = pColInfoData->pData + pDictOffset[i];
+    memcpy(p, pVal, varDataTLen(pVal));
+    p += varDataTLen(pVal);
+  }
+
+  *(int8_t*)data = BLOCK_COL_DICT;
+  taosMemoryFree(pIndex);
+  taosMemoryFree(pDictOffset);
+  taosHashCleanup(pDict);
+  return (int32_t)(p - data);
+
+_raw:
+  taosMemoryFree(pIndex);
+  taosMemoryFree(pDictOffset);
+  taosHashCleanup(pDict);
+
+  *(int8_t*)data = BLOCK_COL_RAW;
+  memcpy(p, pColInfoData->varmeta.offset, numOfRows * sizeof(int32_t));
+  p += numOfRows * sizeof(int32_t);
+  memcpy(p, pColInfoData->pData, pColInfoData->varmeta.length);
+  p += pColInfoData->varmeta.length;
+  return (int32_t)(p - data);
+}
+
+static int32_t colEnsureVarCapacity(SColumnInfoData* pColInfoData, int32_t len) {
+  if (len > 0 && pColInfoData->varmeta.allocLen < len) {
+    char* tmp = taosMemoryRealloc(pColInfoData->pData, len);
+    if (tmp == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+
+    pColInfoData->pData = tmp;
+    pColInfoData->varmeta.allocLen = len;
+  }
+
+  pColInfoData->varmeta.length = len;
+  return TSDB_CODE_SUCCESS;
+}
+
+// each row gets a copy of its own value, since the rows of a var column are moved and trimmed as contiguous data
+static int32_t colDecodeVar(SColumnInfoData* pColInfoData, int32_t numOfRows, const char* data, int32_t len) {
+  const char* p = data + sizeof(int8_t);
+
+  if (*(int8_t*)data != BLOCK_COL_DICT) {
+    memcpy(pColInfoData->varmeta.offset, p, numOfRows * sizeof(int32_t));
+    p += numOfRows * sizeof(int32_t);
+
+    int32_t dataLen = len - (int32_t)(p - data);
+    if (colEnsureVarCapacity(pColInfoData, dataLen) != TSDB_CODE_SUCCESS) {
+      return -1;
+    }
+    if (dataLen > 0) {
+      memcpy(pColInfoData->pData, p, dataLen);
+    }
+    return len;
+  }
+
+  int32_t nDict = *(int32_t*)p;
+  p += sizeof(int32_t);
+  int32_t width = *(int8_t*)p;
+  p += sizeof(int8_t);
+
+  const char* pPacked = p;
+  p += bitPackedLen(numOfRows, width);
+
+  int32_t dictLen = *(int32_t*)p;
+  p += sizeof(int32_t);
+  const char* pDict = p;
+
+  int32_t* pDictOffset = taosMemoryMalloc((nDict + 1) * sizeof(int32_t));
+  if (pDictOffset == NULL) {
+    return -1;
+  }
+
+  int32_t offset = 0;
+  for (int32_t i = 0; i < nDict; ++i) {
+    pDictOffset[i] = offset;
+    offset += varDataTLen(pDict + offset);
+  }
+  pDictOffset[nDict] = -1;
+
+  // the offsets into the dictionary first, then the size of the copies
+  int32_t    dataLen = 0;
+  SBitReader reader = {.p = (const uint8_t*)pPacked};
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    int32_t dictOffset = pDictOffset[bitRead(&reader, width)];
+    pColInfoData->varmeta.offset[i] = dictOffset;
+    if (dictOffset != -1) {
+      dataLen += varDataTLen(pDict + dictOffset);
+    }
+  }
+  taosMemoryFree(pDictOffset);
+
+  if (colEnsureVarCapacity(pColInfoData, dataLen) != TSDB_CODE_SUCCESS) {
+    return -1;
+  }
+
+  offset = 0;
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    if (pColInfoData->varmeta.offset[i] == -1) {
+      continue;
+    }
+
+    const char* pVal = pDict + pColInfoData->varmeta.offset[i];
+    memcpy(pColInfoData->pData + offset, pVal, varDataTLen(pVal));
+    pColInfoData->varmeta.offset[i] = offset;
+    offset += varDataTLen(pVal);
+  }
+
+  return (int32_t)(p + dictLen - data);
+}
+
+static bool colDecodedHasNull(const SColumnInfoData* pColInfoData, int32_t numOfRows) {
+  bool isVar = IS_VAR_DATA_TYPE(pColInfoData->info.type);
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    if (isVar ? colDataIsNull_var(pColInfoData, i) : colDataIsNull_f(pColInfoData->nullbitmap, i)) {
+      return true;
+    }
+  }
+  return false;
+}
+
 void blockEncode(const SSDataBlock* pBlock, char* data, int32_t* dataLen, int32_t numOfCols, int8_t needCompress) {
   // todo extract method
   int32_t* version = (int32_t*)data;
-  *version = 1;
+  *version = needCompress ? BLOCK_VERSION_ENCODED : BLOCK_VERSION_1;
   data += sizeof(int32_t);
 
   int32_t* actualLen = (int32_t*)data;
@@ -2161,6 +2633,16 @@ void blockEncode(const SSDataBlock* pBlock, char* data, int32_t* dataLen, int32_
   for (int32_t col = 0; col < numOfCols; ++col) {
     SColumnInfoData* pColRes = (SColumnInfoData*)taosArrayGet(pBlock->pDataBlock, col);
 
+    // the length of each encoded column includes its codec, null bitmap or offsets
+    if (needCompress) {
+      colSizes[col] = IS_VAR_DATA_TYPE(pColRes->info.type) ? colEncodeVar(pColRes, numOfRows, data)
+                                                           : colEncodeFixed(pColRes, numOfRows, data);
+      data += colSizes[col];
+      (*dataLen) += colSizes[col];
+      colSizes[col] = htonl(colSizes[col]);
+      continue;
+    }
+
     // copy the null bitmap
     size_t metaSize = 0;
     if (IS_VAR_DATA_TYPE(pColRes->info.type)) {
@@ -2174,16 +2656,10 @@ void blockEncode(const SSDataBlock* pBlock, char* data, int32_t* dataLen, int32_
     data += metaSize;
     (*dataLen) += metaSize;
 
-    if (needCompress) {
-      colSizes[col] = blockCompressColData(pColRes, numOfRows, data, needCompress);
-      data += colSizes[col];
-      (*dataLen) += colSizes[col];
-    } else {
-      colSizes[col] = colDataGetLength(pColRes, numOfRows);
-      (*dataLen) += colSizes[col];
-      memmove(data, pColRes->pData, colSizes[col]);
-      data += colSizes[col];
-    }
+    colSizes[col] = colDataGetLength(pColRes, numOfRows);
+    (*dataLen) += colSizes[col];
+    memmove(data, pColRes->pData, colSizes[col]);
+    data += colSizes[col];
 
     colSizes[col] = htonl(colSizes[col]);
   }
@@ -2199,7 +2675,7 @@ const char* blockDecode(SSDataBlock* pBlock, const char* pData) {
 
   int32_t version = *(int32_t*)pStart;
   pStart += sizeof(int32_t);
-  ASSERT(version == 1);
+  ASSERT(version == BLOCK_VERSION_1 || version == BLOCK_VERSION_ENCODED);
 
   // total length sizeof(int32_t)
   int32_t dataLen = *(int32_t*)pStart;
@@ -2250,6 +2726,19 @@ const char* blockDecode(SSDataBlock* pBlock, const char* pData) {
     ASSERT(colLen[i] >= 0);
 
     SColumnInfoData* pColInfoData = taosArrayGet(pBlock->pDataBlock, i);
+    if (version == BLOCK_VERSION_ENCODED) {
+      int32_t len = IS_VAR_DATA_TYPE(pColInfoData->info.type) ? colDecodeVar(pColInfoData, numOfRows, pStart, colLen[i])
+                                                              : colDecodeFixed(pColInfoData, numOfRows, pStart);
+      if (len < 0) {
+        return NULL;
+      }
+
+      ASSERT(len == colLen[i]);
+      pColInfoData->hasNull = colDecodedHasNull(pColInfoData, numOfRows);
+      pStart += colLen[i];
+      continue;
+    }
+
     if (IS_VAR_DATA_TYPE(pColInfoData->info.type)) {
       memcpy(pColInfoData->varmeta.offset, pStart, sizeof(int32_t) * numOfRows);
       pStart += sizeof(int32_t) * numOfRows;
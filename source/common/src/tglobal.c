@@ -16,10 +16,12 @@
 #define _DEFAULT_SOURCE
 #include "tglobal.h"
 #include "tcompare.h"
+#include "tcompression.h"
 #include "tconfig.h"
 #include "tdatablock.h"
 #include "tgrant.h"
 #include "tlog.h"
+#include "tpagedbuf.h"
 
 GRANT_CFG_DECLARE;
 
@@ -64,6 +66,7 @@ int32_t tsNumOfVnodeSyncThreads = 2;
 int32_t tsNumOfVnodeRsmaThreads = 2;
 int32_t tsNumOfQnodeQueryThreads = 4;
 int32_t tsNumOfQnodeFetchThreads = 1;
+int32_t tsNumOfSortThreads = 2;
 int32_t tsNumOfSnodeSharedThreads = 2;
 int32_t tsNumOfSnodeUniqueThreads = 2;
 
@@ -96,6 +99,9 @@ int32_t tsQueryNodeChunkSize = 32 * 1024;
 bool    tsQueryUseNodeAllocator = true;
 bool    tsKeepColumnName = false;
 
+// max number of fetch requests in flight or buffered in each exchange operator, at most one per source
+int32_t tsQueryExchangePrefetch = 256;
+
 /*
  * denote if the server needs to compress response message at the application layer to client, including query rsp,
  * metricmeta rsp, and multi-meter query rsp message body. The client compress the submit message to server.
@@ -106,10 +112,11 @@ bool    tsKeepColumnName = false;
  */
 int32_t tsCompressMsgSize = -1;
 
-/* denote if server needs to compress the retrieved column data before adding to the rpc response message body.
- * 0: all data are compressed
- * -1: all data are not compressed
- * other values: if any retrieved column size is greater than the tsCompressColData, all data will be compressed.
+/* denote if server needs to encode the retrieved column data before adding to the rpc response message body, each
+ * column is encoded by the codec chosen for its data, e.g. delta for timestamps and dictionary for repeated strings.
+ * 0: all data are encoded
+ * -1: all data are not encoded
+ * other values: if any retrieved column size is greater than the tsCompressColData, all columns will be encoded.
  */
 int32_t tsCompressColData = -1;
 
@@ -132,6 +139,15 @@ int32_t tsMinIntervalTime = 1;
 int32_t tsQueryBufferSize = -1;
 int64_t tsQueryBufferSizeBytes = -1;
 
+// size of the decompressed data block cache of each tsdb, in MB, 0 means disabled
+int32_t tsTsdbBlockCacheSize = 16;
+
+// max speed of copying data files to lower tiers in retention, in MB per second, 0 means no limit
+int32_t tsRetentionSpeedLimitMB = 0;
+
+// wal entries arriving within this window (ms) are appended to the log files with one write, 0 means disabled
+int32_t tsWalGroupCommitMs = 0;
+
 int32_t  tsDiskCfgNum = 0;
 SDiskCfg tsDiskCfg[TFS_MAX_DISKS] = {0};
 
@@ -293,6 +309,7 @@ static int32_t taosAddClientCfg(SConfig *pCfg) {
   if (cfgAddInt32(pCfg, "queryNodeChunkSize", tsQueryNodeChunkSize, 1024, 128 * 1024, true) != 0) return -1;
   if (cfgAddBool(pCfg, "queryUseNodeAllocator", tsQueryUseNodeAllocator, true) != 0) return -1;
   if (cfgAddBool(pCfg, "keepColumnName", tsKeepColumnName, true) != 0) return -1;
+  if (cfgAddInt32(pCfg, "queryExchangePrefetch", tsQueryExchangePrefetch, 1, 65536, true) != 0) return -1;
   if (cfgAddString(pCfg, "smlChildTableName", "", 1) != 0) return -1;
   if (cfgAddString(pCfg, "smlTagName", tsSmlTagName, 1) != 0) return -1;
   if (cfgAddBool(pCfg, "smlDataFormat", tsSmlDataFormat, 1) != 0) return -1;
@@ -344,6 +361,10 @@ static int32_t taosAddServerCfg(SConfig *pCfg) {
   if (cfgAddInt32(pCfg, "maxNumOfDistinctRes", tsMaxNumOfDistinctResults, 10 * 10000, 10000 * 10000, 0) != 0) return -1;
   if (cfgAddInt32(pCfg, "countAlwaysReturnValue", tsCountAlwaysReturnValue, 0, 1, 0) != 0) return -1;
   if (cfgAddInt32(pCfg, "queryBufferSize", tsQueryBufferSize, -1, 500000000000, 0) != 0) return -1;
+  if (cfgAddInt32(pCfg, "tsdbBlockCacheSize", tsTsdbBlockCacheSize, 0, 65536, 0) != 0) return -1;
+  if (cfgAddInt32(pCfg, "retentionSpeedLimitMB", tsRetentionSpeedLimitMB, 0, 65536, 0) != 0) return -1;
+  if (cfgAddInt32(pCfg, "zstdCompressLevel", tsZstdCompressLevel, 1, 19, 0) != 0) return -1;
+  if (cfgAddInt32(pCfg, "walGroupCommitMs", tsWalGroupCommitMs, 0, 1000, 0) != 0) return -1;
   if (cfgAddBool(pCfg, "printAuth", tsPrintAuth, 0) != 0) return -1;
 
   if (cfgAddInt32(pCfg, "multiProcess", tsMultiProcess, 0, 2, 0) != 0) return -1;
@@ -393,6 +414,10 @@ static int32_t taosAddServerCfg(SConfig *pCfg) {
   tsNumOfQnodeQueryThreads = TMAX(tsNumOfQnodeQueryThreads, 4);
   if (cfgAddInt32(pCfg, "numOfQnodeQueryThreads", tsNumOfQnodeQueryThreads, 1, 1024, 0) != 0) return -1;
 
+  tsNumOfSortThreads = tsNumOfCores / 4;
+  tsNumOfSortThreads = TRANGE(tsNumOfSortThreads, 1, 8);
+  if (cfgAddInt32(pCfg, "numOfSortThreads", tsNumOfSortThreads, 0, 1024, 0) != 0) return -1;
+
   //  tsNumOfQnodeFetchThreads = tsNumOfCores / 2;
   //  tsNumOfQnodeFetchThreads = TMAX(tsNumOfQnodeFetchThreads, 4);
   //  if (cfgAddInt32(pCfg, "numOfQnodeFetchThreads", tsNumOfQnodeFetchThreads, 1, 1024, 0) != 0) return -1;
@@ -537,6 +562,14 @@ static int32_t taosUpdateServerCfg(SConfig *pCfg) {
     pItem->stype = stype;
   }
 
+  pItem = cfgGetItem(tsCfg, "numOfSortThreads");
+  if (pItem != NULL && pItem->stype == CFG_STYPE_DEFAULT) {
+    tsNumOfSortThreads = numOfCores / 4;
+    tsNumOfSortThreads = TRANGE(tsNumOfSortThreads, 1, 8);
+    pItem->i32 = tsNumOfSortThreads;
+    pItem->stype = stype;
+  }
+
   /*
     pItem = cfgGetItem(tsCfg, "numOfQnodeFetchThreads");
     if (pItem != NULL && pItem->stype == CFG_STYPE_DEFAULT) {
@@ -656,6 +689,7 @@ static int32_t taosSetClientCfg(SConfig *pCfg) {
   tsQueryNodeChunkSize = cfgGetItem(pCfg, "queryNodeChunkSize")->i32;
   tsQueryUseNodeAllocator = cfgGetItem(pCfg, "queryUseNodeAllocator")->bval;
   tsKeepColumnName = cfgGetItem(pCfg, "keepColumnName")->bval;
+  tsQueryExchangePrefetch = cfgGetItem(pCfg, "queryExchangePrefetch")->i32;
   return 0;
 }
 
@@ -687,6 +721,10 @@ static int32_t taosSetServerCfg(SConfig *pCfg) {
   tsMaxNumOfDistinctResults = cfgGetItem(pCfg, "maxNumOfDistinctRes")->i32;
   tsCountAlwaysReturnValue = cfgGetItem(pCfg, "countAlwaysReturnValue")->i32;
   tsQueryBufferSize = cfgGetItem(pCfg, "queryBufferSize")->i32;
+  tsTsdbBlockCacheSize = cfgGetItem(pCfg, "tsdbBlockCacheSize")->i32;
+  tsRetentionSpeedLimitMB = cfgGetItem(pCfg, "retentionSpeedLimitMB")->i32;
+  tsZstdCompressLevel = cfgGetItem(pCfg, "zstdCompressLevel")->i32;
+  tsWalGroupCommitMs = cfgGetItem(pCfg, "walGroupCommitMs")->i32;
   tsPrintAuth = cfgGetItem(pCfg, "printAuth")->bval;
 
 #if !defined(WINDOWS) && !defined(DARWIN)
@@ -708,6 +746,7 @@ static int32_t taosSetServerCfg(SConfig *pCfg) {
   tsNumOfVnodeSyncThreads = cfgGetItem(pCfg, "numOfVnodeSyncThreads")->i32;
   tsNumOfVnodeRsmaThreads = cfgGetItem(pCfg, "numOfVnodeRsmaThreads")->i32;
   tsNumOfQnodeQueryThreads = cfgGetItem(pCfg, "numOfQnodeQueryThreads")->i32;
+  tsNumOfSortThreads = cfgGetItem(pCfg, "numOfSortThreads")->i32;
   //  tsNumOfQnodeFetchThreads = cfgGetItem(pCfg, "numOfQnodeFetchThreads")->i32;
   tsNumOfSnodeSharedThreads = cfgGetItem(pCfg, "numOfSnodeSharedThreads")->i32;
   tsNumOfSnodeUniqueThreads = cfgGetItem(pCfg, "numOfSnodeUniqueThreads")->i32;
@@ -738,6 +777,7 @@ static int32_t taosSetServerCfg(SConfig *pCfg) {
   if (tsQueryBufferSize >= 0) {
     tsQueryBufferSizeBytes = tsQueryBufferSize * 1048576UL;
   }
+  dBufSetMemBudget(tsQueryBufferSizeBytes);
   GRANT_CFG_GET;
   return 0;
 }
@@ -991,7 +1031,10 @@ int32_t taosSetCfg(SConfig *pCfg, char *name) {
         tsQueryBufferSize = cfgGetItem(pCfg, "queryBufferSize")->i32;
         if (tsQueryBufferSize >= 0) {
           tsQueryBufferSizeBytes = tsQueryBufferSize * 1048576UL;
+        } else {
+          tsQueryBufferSizeBytes = -1;
         }
+        dBufSetMemBudget(tsQueryBufferSizeBytes);
       } else if (strcasecmp("qnodeShmSize", name) == 0) {
         tsQnodeShmSize = cfgGetItem(pCfg, "qnodeShmSize")->i32;
       } else if (strcasecmp("qDebugFlag", name) == 0) {
@@ -1002,6 +1045,8 @@ int32_t taosSetCfg(SConfig *pCfg, char *name) {
         tsQueryNodeChunkSize = cfgGetItem(pCfg, "queryNodeChunkSize")->i32;
       } else if (strcasecmp("queryUseNodeAllocator", name) == 0) {
         tsQueryUseNodeAllocator = cfgGetItem(pCfg, "queryUseNodeAllocator")->bval;
+      } else if (strcasecmp("queryExchangePrefetch", name) == 0) {
+        tsQueryExchangePrefetch = cfgGetItem(pCfg, "queryExchangePrefetch")->i32;
       } else if (strcasecmp("queryRsmaTolerance", name) == 0) {
         tsQueryRsmaTolerance = cfgGetItem(pCfg, "queryRsmaTolerance")->i32;
       }
@@ -260,4 +260,161 @@ TEST(testCase, var_dataBlock_split_test) {
   }
 }
 
+TEST(testCase, encoded_dataBlock_test) {
+  int32_t numOfRows = 4000;
+
+  SSDataBlock* b = createDataBlock();
+
+  SColumnInfoData infoData = createColumnInfoData(TSDB_DATA_TYPE_TIMESTAMP, 8, 1);
+  blockDataAppendColInfo(b, &infoData);
+
+  SColumnInfoData infoData1 = createColumnInfoData(TSDB_DATA_TYPE_INT, 4, 2);
+  blockDataAppendColInfo(b, &infoData1);
+
+  SColumnInfoData infoData2 = createColumnInfoData(TSDB_DATA_TYPE_BINARY, 40, 3);
+  blockDataAppendColInfo(b, &infoData2);
+
+  SColumnInfoData infoData3 = createColumnInfoData(TSDB_DATA_TYPE_DOUBLE, 8, 4);
+  blockDataAppendColInfo(b, &infoData3);
+
+  blockDataEnsureCapacity(b, numOfRows);
+
+  char buf[41] = {0};
+  char varbuf[64] = {0};
+
+  SColumnInfoData* p0 = (SColumnInfoData*)taosArrayGet(b->pDataBlock, 0);
+  SColumnInfoData* p1 = (SColumnInfoData*)taosArrayGet(b->pDataBlock, 1);
+  SColumnInfoData* p2 = (SColumnInfoData*)taosArrayGet(b->pDataBlock, 2);
+  SColumnInfoData* p3 = (SColumnInfoData*)taosArrayGet(b->pDataBlock, 3);
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    int64_t ts = 1660000000000 + i * 1000;
+    int32_t v = (i * 7) % 100 - 50;
+    double  d = i * 0.5;
+
+    sprintf(buf, "device_%d", i % 10);
+    STR_TO_VARSTR(varbuf, buf)
+
+    colDataAppend(p0, i, (const char*)&ts, false);
+    colDataAppend(p1, i, (const char*)&v, (i % 13) == 0);
+    colDataAppend(p2, i, varbuf, (i % 11) == 0);
+    colDataAppend(p3, i, (const char*)&d, false);
+    b->info.rows++;
+  }
+
+  int32_t numOfCols = taosArrayGetSize(b->pDataBlock);
+  int32_t rawLen = 0;
+  char*   pRaw = (char*)taosMemoryCalloc(1, blockGetEncodeSize(b));
+  blockEncode(b, pRaw, &rawLen, numOfCols, false);
+
+  int32_t encLen = 0;
+  char*   pEnc = (char*)taosMemoryCalloc(1, blockGetEncodeSize(b) + numOfCols);
+  blockEncode(b, pEnc, &encLen, numOfCols, true);
+  ASSERT_EQ(*(int32_t*)pEnc, BLOCK_VERSION_ENCODED);
+  ASSERT_LT(encLen, rawLen / 2);
+
+  SSDataBlock decoded = {0};
+  ASSERT_EQ(blockDecode(&decoded, pEnc), pEnc + encLen);
+  ASSERT_EQ(decoded.info.rows, numOfRows);
+
+  SColumnInfoData* q0 = (SColumnInfoData*)taosArrayGet(decoded.pDataBlock, 0);
+  SColumnInfoData* q1 = (SColumnInfoData*)taosArrayGet(decoded.pDataBlock, 1);
+  SColumnInfoData* q2 = (SColumnInfoData*)taosArrayGet(decoded.pDataBlock, 2);
+  SColumnInfoData* q3 = (SColumnInfoData*)taosArrayGet(decoded.pDataBlock, 3);
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    ASSERT_EQ(*(int64_t*)colDataGetData(q0, i), *(int64_t*)colDataGetData(p0, i));
+    ASSERT_EQ(colDataIsNull_f(q1->nullbitmap, i), colDataIsNull_f(p1->nullbitmap, i));
+    if (!colDataIsNull_f(p1->nullbitmap, i)) {
+      ASSERT_EQ(*(int32_t*)colDataGetData(q1, i), *(int32_t*)colDataGetData(p1, i));
+    }
+    ASSERT_EQ(colDataIsNull_var(q2, i), colDataIsNull_var(p2, i));
+    if (!colDataIsNull_var(p2, i)) {
+      ASSERT_EQ(memcmp(colDataGetData(q2, i), colDataGetData(p2, i), varDataTLen(colDataGetData(p2, i))), 0);
+    }
+    ASSERT_EQ(*(double*)colDataGetData(q3, i), *(double*)colDataGetData(p3, i));
+  }
+
+  blockDataFreeRes(&decoded);
+  taosMemoryFree(pEnc);
+  taosMemoryFree(pRaw);
+  blockDataDestroy(b);
+}
+
+TEST(testCase, encoded_dict_trim_keep_test) {
+  int32_t numOfRows = 4000;
+  int32_t trimRows = 1234;
+  int32_t keepRows = 2345;
+
+  SSDataBlock* b = createDataBlock();
+
+  SColumnInfoData infoData = createColumnInfoData(TSDB_DATA_TYPE_INT, 4, 1);
+  blockDataAppendColInfo(b, &infoData);
+
+  SColumnInfoData infoData1 = createColumnInfoData(TSDB_DATA_TYPE_BINARY, 40, 2);
+  blockDataAppendColInfo(b, &infoData1);
+
+  blockDataEnsureCapacity(b, numOfRows);
+
+  char buf[41] = {0};
+  char varbuf[64] = {0};
+
+  SColumnInfoData* p0 = (SColumnInfoData*)taosArrayGet(b->pDataBlock, 0);
+  SColumnInfoData* p1 = (SColumnInfoData*)taosArrayGet(b->pDataBlock, 1);
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    int32_t v = i % 100;
+    sprintf(buf, "device_%d", i % 10);
+    STR_TO_VARSTR(varbuf, buf)
+
+    colDataAppend(p0, i, (const char*)&v, false);
+    colDataAppend(p1, i, varbuf, (i % 11) == 0);
+    b->info.rows++;
+  }
+
+  int32_t numOfCols = taosArrayGetSize(b->pDataBlock);
+  int32_t encLen = 0;
+  char*   pEnc = (char*)taosMemoryCalloc(1, blockGetEncodeSize(b) + numOfCols);
+  blockEncode(b, pEnc, &encLen, numOfCols, true);
+  ASSERT_EQ(*(int32_t*)pEnc, BLOCK_VERSION_ENCODED);
+
+  // the rows of a dictionary column are moved as contiguous data by trim and keep
+  SSDataBlock trimmed = {0};
+  ASSERT_EQ(blockDecode(&trimmed, pEnc), pEnc + encLen);
+  ASSERT_FALSE(((SColumnInfoData*)taosArrayGet(trimmed.pDataBlock, 0))->hasNull);
+  ASSERT_TRUE(((SColumnInfoData*)taosArrayGet(trimmed.pDataBlock, 1))->hasNull);
+  blockDataTrimFirstNRows(&trimmed, trimRows);
+  ASSERT_EQ(trimmed.info.rows, numOfRows - trimRows);
+
+  // the lengths are converted in place by blockDecode
+  blockEncode(b, pEnc, &encLen, numOfCols, true);
+  SSDataBlock kept = {0};
+  ASSERT_EQ(blockDecode(&kept, pEnc), pEnc + encLen);
+  blockDataKeepFirstNRows(&kept, keepRows);
+  ASSERT_EQ(kept.info.rows, keepRows);
+
+  SColumnInfoData* q1 = (SColumnInfoData*)taosArrayGet(trimmed.pDataBlock, 1);
+  ASSERT_LE(q1->varmeta.length, q1->varmeta.allocLen);
+  for (int32_t i = 0; i < trimmed.info.rows; ++i) {
+    int32_t src = i + trimRows;
+    ASSERT_EQ(colDataIsNull_var(q1, i), colDataIsNull_var(p1, src));
+    if (!colDataIsNull_var(p1, src)) {
+      ASSERT_LE(q1->varmeta.offset[i] + varDataTLen(colDataGetData(q1, i)), q1->varmeta.length);
+      ASSERT_EQ(memcmp(colDataGetData(q1, i), colDataGetData(p1, src), varDataTLen(colDataGetData(p1, src))), 0);
+    }
+  }
+
+  SColumnInfoData* k1 = (SColumnInfoData*)taosArrayGet(kept.pDataBlock, 1);
+  ASSERT_LE(k1->varmeta.length, k1->varmeta.allocLen);
+  for (int32_t i = 0; i < kept.info.rows; ++i) {
+    ASSERT_EQ(colDataIsNull_var(k1, i), colDataIsNull_var(p1, i));
+    if (!colDataIsNull_var(p1, i)) {
+      ASSERT_LE(k1->varmeta.offset[i] + varDataTLen(colDataGetData(k1, i)), k1->varmeta.length);
+      ASSERT_EQ(memcmp(colDataGetData(k1, i), colDataGetData(p1, i), varDataTLen(colDataGetData(p1, i))), 0);
+    }
+  }
+
+  blockDataFreeRes(&trimmed);
+  blockDataFreeRes(&kept);
+  taosMemoryFree(pEnc);
+  blockDataDestroy(b);
+}
+
 #pragma GCC diagnostic pop
\ No newline at end of file
@@ -934,4 +934,149 @@ TEST_F(MndTestSdb, 01_Read_Str) {
   sdbCleanup(pSdb);
   ASSERT_EQ(mnode.insertTimes, 9);
   ASSERT_EQ(mnode.deleteTimes, 9);
-}
\ No newline at end of file
+}
+#define DELTA_TEST_PATH TD_TMP_DIR_PATH "mnode_test_sdb_delta"
+#define DELTA_FILE      DELTA_TEST_PATH TD_DIRSEP "data" TD_DIRSEP "sdb.delta"
+// ver, index, term, config, maxId and tableVer of SDB_TABLE_SIZE tables, SDB_RESERVE_SIZE bytes reserved
+#define DELTA_HEAD_SIZE (4 * sizeof(int64_t) + 2 * 24 * sizeof(int64_t) + 512)
+
+SSdb *deltaSdbInit(SMnode *pMnode) {
+  SSdbOpt opt = {0};
+  opt.pMnode = pMnode;
+  opt.path = DELTA_TEST_PATH;
+
+  SSdbTable strTable;
+  memset(&strTable, 0, sizeof(SSdbTable));
+  strTable.sdbType = SDB_USER;
+  strTable.keyType = SDB_KEY_BINARY;
+  strTable.deployFp = (SdbDeployFp)strDefault;
+  strTable.encodeFp = (SdbEncodeFp)strEncode;
+  strTable.decodeFp = (SdbDecodeFp)strDecode;
+  strTable.insertFp = (SdbInsertFp)strInsert;
+  strTable.updateFp = (SdbUpdateFp)strUpdate;
+  strTable.deleteFp = (SdbDeleteFp)strDelete;
+
+  SSdb *pSdb = sdbInit(&opt);
+  if (pSdb == NULL) return NULL;
+  pMnode->pSdb = pSdb;
+  if (sdbSetTable(pSdb, strTable) != 0) {
+    sdbCleanup(pSdb);
+    return NULL;
+  }
+  return pSdb;
+}
+
+void deltaCheckData(SSdb *pSdb) {
+  ASSERT_EQ(sdbGetSize(pSdb, SDB_USER), 2);
+
+  SStrObj *pObj = (SStrObj *)sdbAcquire(pSdb, SDB_USER, "k1000");
+  ASSERT_NE(pObj, nullptr);
+  ASSERT_EQ(pObj->v32, 1001);
+  sdbRelease(pSdb, pObj);
+
+  pObj = (SStrObj *)sdbAcquire(pSdb, SDB_USER, "k2000");
+  ASSERT_EQ(pObj, nullptr);
+
+  pObj = (SStrObj *)sdbAcquire(pSdb, SDB_USER, "k3000");
+  ASSERT_NE(pObj, nullptr);
+  EXPECT_STREQ(pObj->vstr, "v3000");
+  ASSERT_EQ(pObj->v32, 3000);
+  sdbRelease(pSdb, pObj);
+
+  int64_t index, term, config;
+  sdbGetCommitInfo(pSdb, &index, &term, &config);
+  ASSERT_EQ(index, 3);
+}
+
+TEST_F(MndTestSdb, 02_Write_Delta) {
+  SMnode   mnode = {0};
+  SStrObj  strObj = {0};
+  SSdbRaw *pRaw = NULL;
+  int64_t  dataSize = 0;
+  int64_t  deltaSize = 0;
+
+  taosRemoveDir(DELTA_TEST_PATH);
+  SSdb *pSdb = deltaSdbInit(&mnode);
+  ASSERT_NE(pSdb, nullptr);
+  ASSERT_EQ(sdbDeploy(pSdb), 0);
+
+  // the first checkpoint writes the data file
+  sdbSetApplyInfo(pSdb, 1, 0, 0);
+  ASSERT_EQ(sdbWriteFile(pSdb, 0), 0);
+  ASSERT_FALSE(taosCheckExistFile(DELTA_FILE));
+
+  // the later ones append the changed rows only
+  strSetDefault(&strObj, 3);
+  pRaw = strEncode(&strObj);
+  sdbSetRawStatus(pRaw, SDB_STATUS_READY);
+  ASSERT_EQ(sdbWrite(pSdb, pRaw), 0);
+  sdbSetApplyInfo(pSdb, 2, 0, 0);
+  ASSERT_EQ(sdbWriteFile(pSdb, 0), 0);
+  ASSERT_EQ(taosStatFile(DELTA_FILE, &deltaSize, NULL), 0);
+  ASSERT_GT(deltaSize, (int64_t)DELTA_HEAD_SIZE);
+
+  strSetDefault(&strObj, 1);
+  strObj.v32 = 1001;
+  pRaw = strEncode(&strObj);
+  sdbSetRawStatus(pRaw, SDB_STATUS_READY);
+  ASSERT_EQ(sdbWrite(pSdb, pRaw), 0);
+  strSetDefault(&strObj, 2);
+  pRaw = strEncode(&strObj);
+  sdbSetRawStatus(pRaw, SDB_STATUS_DROPPED);
+  ASSERT_EQ(sdbWrite(pSdb, pRaw), 0);
+  sdbSetApplyInfo(pSdb, 3, 0, 0);
+  ASSERT_EQ(sdbWriteFile(pSdb, 0), 0);
+
+  int64_t newSize = 0;
+  ASSERT_EQ(taosStatFile(DELTA_FILE, &newSize, NULL), 0);
+  ASSERT_GT(newSize, deltaSize);
+
+  deltaCheckData(pSdb);
+  sdbCleanup(pSdb);
+}
+
+TEST_F(MndTestSdb, 02_Read_Delta) {
+  SMnode mnode = {0};
+
+  SSdb *pSdb = deltaSdbInit(&mnode);
+  ASSERT_NE(pSdb, nullptr);
+  ASSERT_EQ(sdbReadFile(pSdb), 0);
+
+  deltaCheckData(pSdb);
+  sdbCleanup(pSdb);
+}
+
+TEST_F(MndTestSdb, 02_Truncate_Torn_Delta) {
+  int64_t validSize = 0;
+  ASSERT_EQ(taosStatFile(DELTA_FILE, &validSize, NULL), 0);
+
+  // a valid batch head taken from the file, followed by a garbage size
+  char      head[DELTA_HEAD_SIZE];
+  TdFilePtr pFile = taosOpenFile(DELTA_FILE, TD_FILE_READ);
+  ASSERT_NE(pFile, nullptr);
+  ASSERT_EQ(taosReadFile(pFile, head, sizeof(head)), (int64_t)sizeof(head));
+  taosCloseFile(&pFile);
+
+  int64_t sizes[] = {-1, INT64_MAX, 1LL << 40, 64};
+  for (int32_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+    pFile = taosOpenFile(DELTA_FILE, TD_FILE_WRITE | TD_FILE_APPEND);
+    ASSERT_NE(pFile, nullptr);
+    ASSERT_EQ(taosWriteFile(pFile, head, sizeof(head)), (int64_t)sizeof(head));
+    ASSERT_EQ(taosWriteFile(pFile, &sizes[i], sizeof(int64_t)), (int64_t)sizeof(int64_t));
+    // fewer bytes than the size claims
+    char tail[16] = {0};
+    ASSERT_EQ(taosWriteFile(pFile, tail, sizeof(tail)), (int64_t)sizeof(tail));
+    taosCloseFile(&pFile);
+
+    SMnode mnode = {0};
+    SSdb  *pSdb = deltaSdbInit(&mnode);
+    ASSERT_NE(pSdb, nullptr);
+    ASSERT_EQ(sdbReadFile(pSdb), 0);
+    deltaCheckData(pSdb);
+    sdbCleanup(pSdb);
+
+    int64_t size = 0;
+    ASSERT_EQ(taosStatFile(DELTA_FILE, &size, NULL), 0);
+    ASSERT_EQ(size, validSize);
+  }
+}
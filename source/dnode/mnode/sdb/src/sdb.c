@@ -99,8 +99,10 @@ void sdbCleanup(SSdb *pSdb) {
 
     taosHashClear(hash);
     taosHashCleanup(hash);
+    taosHashCleanup(pSdb->dirtyObjs[i]);
     taosThreadRwlockDestroy(&pSdb->locks[i]);
     pSdb->hashObjs[i] = NULL;
+    pSdb->dirtyObjs[i] = NULL;
     memset(&pSdb->locks[i], 0, sizeof(pSdb->locks[i]));
 
     mInfo("sdb table:%s is cleaned up", sdbTableName(i));
@@ -111,6 +113,30 @@ void sdbCleanup(SSdb *pSdb) {
   mInfo("sdb is cleaned up");
 }
 
+static void sdbFreeDirtyRaw(void *p) { sdbFreeRaw(*(SSdbRaw **)p); }
+
+static int32_t sdbGetHashType(EKeyType keyType) {
+  if (keyType == SDB_KEY_INT32) {
+    return TSDB_DATA_TYPE_INT;
+  } else if (keyType == SDB_KEY_INT64) {
+    return TSDB_DATA_TYPE_BIGINT;
+  } else {
+    return TSDB_DATA_TYPE_BINARY;
+  }
+}
+
+SHashObj *sdbInitDirtyHash(EKeyType keyType) {
+  // key -> copy of the drop raw, or NULL if the row is still in the table
+  SHashObj *dirty = taosHashInit(64, taosGetDefaultHashFunction(sdbGetHashType(keyType)), true, HASH_NO_LOCK);
+  if (dirty == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return NULL;
+  }
+
+  taosHashSetFreeFp(dirty, sdbFreeDirtyRaw);
+  return dirty;
+}
+
 int32_t sdbSetTable(SSdb *pSdb, SSdbTable table) {
   ESdbType sdbType = table.sdbType;
   EKeyType keyType = table.keyType;
@@ -122,23 +148,22 @@ int32_t sdbSetTable(SSdb *pSdb, SSdbTable table) {
   pSdb->encodeFps[sdbType] = table.encodeFp;
   pSdb->decodeFps[sdbType] = table.decodeFp;
 
-  int32_t hashType = 0;
-  if (keyType == SDB_KEY_INT32) {
-    hashType = TSDB_DATA_TYPE_INT;
-  } else if (keyType == SDB_KEY_INT64) {
-    hashType = TSDB_DATA_TYPE_BIGINT;
-  } else {
-    hashType = TSDB_DATA_TYPE_BINARY;
-  }
-
+  int32_t   hashType = sdbGetHashType(keyType);
   SHashObj *hash = taosHashInit(64, taosGetDefaultHashFunction(hashType), true, HASH_ENTRY_LOCK);
   if (hash == NULL) {
     terrno = TSDB_CODE_OUT_OF_MEMORY;
     return -1;
   }
 
+  SHashObj *dirty = sdbInitDirtyHash(keyType);
+  if (dirty == NULL) {
+    taosHashCleanup(hash);
+    return -1;
+  }
+
   pSdb->maxId[sdbType] = 0;
   pSdb->hashObjs[sdbType] = hash;
+  pSdb->dirtyObjs[sdbType] = dirty;
   mInfo("sdb table:%s is initialized", sdbTableName(sdbType));
 
   return 0;
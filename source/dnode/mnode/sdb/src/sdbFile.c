@@ -62,6 +62,7 @@ static void sdbResetData(SSdb *pSdb) {
     if (hash == NULL) continue;
 
     taosHashClear(pSdb->hashObjs[i]);
+    taosHashClear(pSdb->dirtyObjs[i]);
     pSdb->tableVer[i] = 0;
     pSdb->maxId[i] = 0;
     mInfo("sdb:%s is reset", sdbTableName(i));
@@ -73,6 +74,7 @@ static void sdbResetData(SSdb *pSdb) {
   pSdb->commitIndex = -1;
   pSdb->commitTerm = -1;
   pSdb->commitConfig = -1;
+  pSdb->dirtyLost = false;
   mInfo("sdb reset success");
 }
 
@@ -317,27 +319,175 @@ _OVER:
   return code;
 }
 
+static int32_t sdbCheckDeltaBatch(const char *pBuf, int64_t size) {
+  int64_t pos = 0;
+  while (pos < size) {
+    if (size - pos < (int64_t)sizeof(SSdbRaw)) return -1;
+
+    SSdbRaw *pRaw = (SSdbRaw *)(pBuf + pos);
+    if (pRaw->dataLen < 0) return -1;
+
+    int64_t totalLen = sizeof(SSdbRaw) + pRaw->dataLen + sizeof(int32_t);
+    if (size - pos < totalLen) return -1;
+    if (!taosCheckChecksumWhole((const uint8_t *)pRaw, totalLen)) return -1;
+
+    pos += totalLen;
+  }
+
+  return 0;
+}
+
+static int32_t sdbReadDeltaImp(SSdb *pSdb) {
+  int32_t code = 0;
+  int64_t offset = 0;
+  int32_t batches = 0;
+  char   *pBuf = NULL;
+  int64_t bufLen = 0;
+  char    datafile[PATH_MAX] = {0};
+  char    file[PATH_MAX] = {0};
+
+  snprintf(datafile, sizeof(datafile), "%s%ssdb.data", pSdb->currDir, TD_DIRSEP);
+  snprintf(file, sizeof(file), "%s%ssdb.delta", pSdb->currDir, TD_DIRSEP);
+  if (!taosCheckExistFile(file)) return 0;
+
+  if (!taosCheckExistFile(datafile)) {
+    mWarn("sdb delta file:%s is ignored since no data file", file);
+    (void)taosRemoveFile(file);
+    return 0;
+  }
+
+  TdFilePtr pFile = taosOpenFile(file, TD_FILE_READ | TD_FILE_WRITE);
+  if (pFile == NULL) {
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    mError("failed to open sdb delta file:%s since %s", file, terrstr());
+    return -1;
+  }
+
+  int64_t fileSize = 0;
+  if (taosFStatFile(pFile, &fileSize, NULL) != 0) {
+    code = TAOS_SYSTEM_ERROR(errno);
+    mError("failed to stat sdb delta file:%s since %s", file, tstrerror(code));
+    goto _OVER;
+  }
+
+  mInfo("start to read sdb delta file:%s", file);
+  int64_t dataIndex = pSdb->applyIndex;
+
+  while (1) {
+    int64_t applyIndex = pSdb->applyIndex;
+    int64_t applyTerm = pSdb->applyTerm;
+    int64_t applyConfig = pSdb->applyConfig;
+    int64_t maxId[SDB_MAX] = {0};
+    int64_t tableVer[SDB_MAX] = {0};
+    memcpy(maxId, pSdb->maxId, sizeof(maxId));
+    memcpy(tableVer, pSdb->tableVer, sizeof(tableVer));
+
+    // a torn batch at the tail is left by a crash during append, drop it and everything after. Its size may be
+    // garbage, so it is bounded by the rest of the file before any buffer is sized by it. A batch without rows has
+    // only the head and the size 0
+    bool    valid = false;
+    int64_t size = 0;
+    if (sdbReadFileHead(pSdb, pFile) == 0 && taosReadFile(pFile, &size, sizeof(int64_t)) == sizeof(int64_t) &&
+        size >= 0 && size <= fileSize - taosLSeekFile(pFile, 0, SEEK_CUR)) {
+      if (size > bufLen) {
+        char *pNew = taosMemoryRealloc(pBuf, size);
+        if (pNew == NULL) {
+          code = TSDB_CODE_OUT_OF_MEMORY;
+          goto _OVER;
+        }
+        pBuf = pNew;
+        bufLen = size;
+      }
+      valid = (taosReadFile(pFile, pBuf, size) == size) && (sdbCheckDeltaBatch(pBuf, size) == 0);
+    }
+
+    if (!valid || pSdb->applyIndex <= dataIndex) {
+      pSdb->applyIndex = applyIndex;
+      pSdb->applyTerm = applyTerm;
+      pSdb->applyConfig = applyConfig;
+      memcpy(pSdb->maxId, maxId, sizeof(maxId));
+      memcpy(pSdb->tableVer, tableVer, sizeof(tableVer));
+      if (!valid) break;
+
+      // written before the data file was rewritten
+      offset = taosLSeekFile(pFile, 0, SEEK_CUR);
+      continue;
+    }
+
+    memcpy(tableVer, pSdb->tableVer, sizeof(tableVer));
+    for (int64_t pos = 0; pos < size;) {
+      SSdbRaw *pRaw = (SSdbRaw *)(pBuf + pos);
+      pos += sizeof(SSdbRaw) + pRaw->dataLen + sizeof(int32_t);
+
+      code = sdbWriteWithoutFree(pSdb, pRaw);
+      if (code == TSDB_CODE_SDB_OBJ_NOT_THERE && pRaw->status == SDB_STATUS_DROPPED) {
+        code = 0;
+      }
+      if (code != 0) {
+        mError("failed to read sdb delta file:%s since %s", file, terrstr());
+        goto _OVER;
+      }
+    }
+    memcpy(pSdb->tableVer, tableVer, sizeof(tableVer));
+
+    offset = taosLSeekFile(pFile, 0, SEEK_CUR);
+    batches++;
+  }
+
+  if (fileSize > offset) {
+    mWarn("sdb delta file:%s is truncated from %" PRId64 " to %" PRId64, file, fileSize, offset);
+    if (taosFtruncateFile(pFile, offset) != 0 || taosFsyncFile(pFile) != 0) {
+      code = TAOS_SYSTEM_ERROR(errno);
+      mError("failed to truncate sdb delta file:%s since %s", file, tstrerror(code));
+      goto _OVER;
+    }
+  }
+
+  pSdb->commitIndex = pSdb->applyIndex;
+  pSdb->commitTerm = pSdb->applyTerm;
+  pSdb->commitConfig = pSdb->applyConfig;
+  mInfo("read sdb delta file:%s success, batches:%d commit index:%" PRId64 " term:%" PRId64 " config:%" PRId64, file,
+        batches, pSdb->commitIndex, pSdb->commitTerm, pSdb->commitConfig);
+
+_OVER:
+  taosCloseFile(&pFile);
+  taosMemoryFree(pBuf);
+
+  terrno = code;
+  return code;
+}
+
 int32_t sdbReadFile(SSdb *pSdb) {
   taosThreadMutexLock(&pSdb->filelock);
 
   sdbResetData(pSdb);
   int32_t code = sdbReadFileImp(pSdb);
+  if (code == 0) {
+    code = sdbReadDeltaImp(pSdb);
+  }
   if (code != 0) {
     mError("failed to read sdb file since %s", terrstr());
     sdbResetData(pSdb);
   }
 
+  for (ESdbType i = 0; i < SDB_MAX; ++i) {
+    if (pSdb->dirtyObjs[i] != NULL) taosHashClear(pSdb->dirtyObjs[i]);
+  }
+  pSdb->dirtyLost = false;
+
   taosThreadMutexUnlock(&pSdb->filelock);
   return code;
 }
 
-static int32_t sdbWriteFileImp(SSdb *pSdb) {
+static int32_t sdbWriteDataImp(SSdb *pSdb) {
   int32_t code = 0;
 
   char tmpfile[PATH_MAX] = {0};
   snprintf(tmpfile, sizeof(tmpfile), "%s%ssdb.data", pSdb->tmpDir, TD_DIRSEP);
   char curfile[PATH_MAX] = {0};
   snprintf(curfile, sizeof(curfile), "%s%ssdb.data", pSdb->currDir, TD_DIRSEP);
+  char deltafile[PATH_MAX] = {0};
+  snprintf(deltafile, sizeof(deltafile), "%s%ssdb.delta", pSdb->currDir, TD_DIRSEP);
 
   mInfo("start to write sdb file, apply index:%" PRId64 " term:%" PRId64 " config:%" PRId64 ", commit index:%" PRId64
          " term:%" PRId64 " config:%" PRId64 ", file:%s",
@@ -357,6 +507,7 @@ static int32_t sdbWriteFileImp(SSdb *pSdb) {
     return -1;
   }
 
+  pSdb->dirtyLost = false;
   for (int32_t i = SDB_MAX - 1; i >= 0; --i) {
     SdbEncodeFp encodeFp = pSdb->encodeFps[i];
     if (encodeFp == NULL) continue;
@@ -410,6 +561,7 @@ static int32_t sdbWriteFileImp(SSdb *pSdb) {
       sdbFreeRaw(pRaw);
       ppRow = taosHashIterate(hash, ppRow);
     }
+    taosHashClear(pSdb->dirtyObjs[i]);
     taosThreadRwlockUnlock(pLock);
   }
 
@@ -431,7 +583,15 @@ static int32_t sdbWriteFileImp(SSdb *pSdb) {
     }
   }
 
+  if (code == 0 && taosCheckExistFile(deltafile)) {
+    if (taosRemoveFile(deltafile) != 0) {
+      code = TAOS_SYSTEM_ERROR(errno);
+      mError("failed to remove sdb delta file:%s since %s", deltafile, tstrerror(code));
+    }
+  }
+
   if (code != 0) {
+    pSdb->dirtyLost = true;
     mError("failed to write sdb file:%s since %s", curfile, tstrerror(code));
   } else {
     pSdb->commitIndex = pSdb->applyIndex;
@@ -445,22 +605,214 @@ static int32_t sdbWriteFileImp(SSdb *pSdb) {
   return code;
 }
 
-int32_t sdbWriteFile(SSdb *pSdb, int32_t delta) {
-  int32_t code = 0;
-  if (pSdb->applyIndex == pSdb->commitIndex) {
-    return 0;
+static int32_t sdbWriteDeltaImp(SSdb *pSdb) {
+  int32_t   code = 0;
+  int64_t   size = 0;
+  int64_t   offset = 0;
+  TdFilePtr pFile = NULL;
+  SHashObj *dirtyObjs[SDB_MAX] = {0};
+  char      file[PATH_MAX] = {0};
+
+  snprintf(file, sizeof(file), "%s%ssdb.delta", pSdb->currDir, TD_DIRSEP);
+  mInfo("start to write sdb delta, apply index:%" PRId64 " term:%" PRId64 " config:%" PRId64 ", commit index:%" PRId64
+        " term:%" PRId64 " config:%" PRId64 ", file:%s",
+        pSdb->applyIndex, pSdb->applyTerm, pSdb->applyConfig, pSdb->commitIndex, pSdb->commitTerm, pSdb->commitConfig,
+        file);
+
+  SArray *pRaws = taosArrayInit(64, sizeof(SSdbRaw *));
+  if (pRaws == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _OVER;
   }
 
-  if (pSdb->applyIndex - pSdb->commitIndex < delta) {
-    return 0;
+  for (int32_t i = SDB_MAX - 1; i >= 0; --i) {
+    SdbEncodeFp encodeFp = pSdb->encodeFps[i];
+    if (encodeFp == NULL || pSdb->dirtyObjs[i] == NULL) continue;
+
+    SHashObj *dirty = sdbInitDirtyHash(pSdb->keyTypes[i]);
+    if (dirty == NULL) {
+      code = terrno;
+      goto _OVER;
+    }
+
+    SHashObj       *hash = pSdb->hashObjs[i];
+    TdThreadRwlock *pLock = &pSdb->locks[i];
+    taosThreadRwlockWrlock(pLock);
+
+    // rows changed from now on belong to the next checkpoint
+    dirtyObjs[i] = pSdb->dirtyObjs[i];
+    pSdb->dirtyObjs[i] = dirty;
+
+    SSdbRaw **ppDrop = taosHashIterate(dirtyObjs[i], NULL);
+    while (ppDrop != NULL) {
+      size_t    keyLen = 0;
+      void     *pKey = taosHashGetKey(ppDrop, &keyLen);
+      SSdbRow **ppRow = taosHashGet(hash, pKey, keyLen);
+      SSdbRow  *pRow = (ppRow != NULL) ? *ppRow : NULL;
+      SSdbRaw  *pRaw = NULL;
+
+      if (pRow != NULL && (pRow->status == SDB_STATUS_READY || pRow->status == SDB_STATUS_DROPPING)) {
+        sdbPrintOper(pSdb, pRow, "write-delta");
+        pRaw = (*encodeFp)(pRow->pObj);
+        if (pRaw == NULL) {
+          code = TSDB_CODE_SDB_APP_ERROR;
+        } else {
+          pRaw->status = pRow->status;
+        }
+      } else if (*ppDrop != NULL) {
+        int32_t rawLen = sizeof(SSdbRaw) + (*ppDrop)->dataLen;
+        pRaw = taosMemoryMalloc(rawLen);
+        if (pRaw == NULL) {
+          code = TSDB_CODE_OUT_OF_MEMORY;
+        } else {
+          memcpy(pRaw, *ppDrop, rawLen);
+        }
+      }
+
+      if (pRaw != NULL) {
+        if (taosArrayPush(pRaws, &pRaw) == NULL) {
+          sdbFreeRaw(pRaw);
+          code = TSDB_CODE_OUT_OF_MEMORY;
+        } else {
+          size += sizeof(SSdbRaw) + pRaw->dataLen + sizeof(int32_t);
+        }
+      }
+
+      if (code != 0) {
+        taosHashCancelIterate(dirtyObjs[i], ppDrop);
+        break;
+      }
+      ppDrop = taosHashIterate(dirtyObjs[i], ppDrop);
+    }
+    taosThreadRwlockUnlock(pLock);
+
+    if (code != 0) goto _OVER;
   }
 
-  taosThreadMutexLock(&pSdb->filelock);
+  pFile = taosOpenFile(file, TD_FILE_CREATE | TD_FILE_WRITE | TD_FILE_APPEND);
+  if (pFile == NULL) {
+    code = TAOS_SYSTEM_ERROR(errno);
+    mError("failed to open sdb delta file:%s for write since %s", file, tstrerror(code));
+    goto _OVER;
+  }
+
+  if (taosFStatFile(pFile, &offset, NULL) != 0) {
+    code = TAOS_SYSTEM_ERROR(errno);
+    goto _OVER;
+  }
+
+  if (sdbWriteFileHead(pSdb, pFile) != 0) {
+    code = terrno;
+    goto _OVER;
+  }
+
+  if (taosWriteFile(pFile, &size, sizeof(int64_t)) != sizeof(int64_t)) {
+    code = TAOS_SYSTEM_ERROR(errno);
+    goto _OVER;
+  }
+
+  for (int32_t i = 0; i < taosArrayGetSize(pRaws); ++i) {
+    SSdbRaw *pRaw = *(SSdbRaw **)taosArrayGet(pRaws, i);
+    int32_t  writeLen = sizeof(SSdbRaw) + pRaw->dataLen;
+    if (taosWriteFile(pFile, pRaw, writeLen) != writeLen) {
+      code = TAOS_SYSTEM_ERROR(errno);
+      goto _OVER;
+    }
+
+    int32_t cksum = taosCalcChecksum(0, (const uint8_t *)pRaw, writeLen);
+    if (taosWriteFile(pFile, &cksum, sizeof(int32_t)) != sizeof(int32_t)) {
+      code = TAOS_SYSTEM_ERROR(errno);
+      goto _OVER;
+    }
+  }
+
+  if (taosFsyncFile(pFile) != 0) {
+    code = TAOS_SYSTEM_ERROR(errno);
+    goto _OVER;
+  }
+
+_OVER:
+  if (pFile != NULL) {
+    if (code != 0) {
+      (void)taosFtruncateFile(pFile, offset);
+    }
+    taosCloseFile(&pFile);
+  }
+
+  int32_t rows = taosArrayGetSize(pRaws);
+  for (int32_t i = 0; i < rows; ++i) {
+    sdbFreeRaw(*(SSdbRaw **)taosArrayGet(pRaws, i));
+  }
+  taosArrayDestroy(pRaws);
+
+  for (int32_t i = 0; i < SDB_MAX; ++i) {
+    if (dirtyObjs[i] == NULL) continue;
+
+    // give the keys back so the next checkpoint writes them again
+    if (code != 0) {
+      TdThreadRwlock *pLock = &pSdb->locks[i];
+      taosThreadRwlockWrlock(pLock);
+      SSdbRaw **ppDrop = taosHashIterate(dirtyObjs[i], NULL);
+      while (ppDrop != NULL) {
+        size_t    keyLen = 0;
+        void     *pKey = taosHashGetKey(ppDrop, &keyLen);
+        SSdbRaw **ppNew = taosHashGet(pSdb->dirtyObjs[i], pKey, keyLen);
+        if (ppNew == NULL || (*ppNew == NULL && *ppDrop != NULL)) {
+          if (taosHashPut(pSdb->dirtyObjs[i], pKey, keyLen, ppDrop, sizeof(void *)) == 0) {
+            *ppDrop = NULL;
+          } else {
+            pSdb->dirtyLost = true;
+          }
+        }
+        ppDrop = taosHashIterate(dirtyObjs[i], ppDrop);
+      }
+      taosThreadRwlockUnlock(pLock);
+    }
+
+    taosHashCleanup(dirtyObjs[i]);
+  }
+
+  if (code != 0) {
+    mError("failed to write sdb delta file:%s since %s", file, tstrerror(code));
+  } else {
+    pSdb->commitIndex = pSdb->applyIndex;
+    pSdb->commitTerm = pSdb->applyTerm;
+    pSdb->commitConfig = pSdb->applyConfig;
+    mInfo("write sdb delta success, rows:%d size:%" PRId64 " commit index:%" PRId64 " term:%" PRId64
+          " config:%" PRId64 " file:%s",
+          rows, size, pSdb->commitIndex, pSdb->commitTerm, pSdb->commitConfig, file);
+  }
+
+  terrno = code;
+  return code;
+}
+
+static int32_t sdbWriteFileImp(SSdb *pSdb, bool compact) {
+  char datafile[PATH_MAX] = {0};
+  snprintf(datafile, sizeof(datafile), "%s%ssdb.data", pSdb->currDir, TD_DIRSEP);
+  char deltafile[PATH_MAX] = {0};
+  snprintf(deltafile, sizeof(deltafile), "%s%ssdb.delta", pSdb->currDir, TD_DIRSEP);
+
+  // fold the delta back into the data file once it has grown as large as the data file itself
+  int64_t dataSize = 0;
+  int64_t deltaSize = 0;
+  if (!compact && !pSdb->dirtyLost && taosStatFile(datafile, &dataSize, NULL) == 0) {
+    if (taosStatFile(deltafile, &deltaSize, NULL) != 0) deltaSize = 0;
+    if (deltaSize < dataSize) {
+      return sdbWriteDeltaImp(pSdb);
+    }
+  }
+
+  return sdbWriteDataImp(pSdb);
+}
+
+static int32_t sdbDoWriteFile(SSdb *pSdb, bool compact) {
+  int32_t code = 0;
   if (pSdb->pWal != NULL) {
     code = walBeginSnapshot(pSdb->pWal, pSdb->applyIndex);
   }
   if (code == 0) {
-    code = sdbWriteFileImp(pSdb);
+    code = sdbWriteFileImp(pSdb, compact);
   }
   if (code == 0) {
     if (pSdb->pWal != NULL) {
@@ -470,6 +822,21 @@ int32_t sdbWriteFile(SSdb *pSdb, int32_t delta) {
   if (code != 0) {
     mError("failed to write sdb file since %s", terrstr());
   }
+  return code;
+}
+
+int32_t sdbWriteFile(SSdb *pSdb, int32_t delta) {
+  int32_t code = 0;
+  if (pSdb->applyIndex == pSdb->commitIndex) {
+    return 0;
+  }
+
+  if (pSdb->applyIndex - pSdb->commitIndex < delta) {
+    return 0;
+  }
+
+  taosThreadMutexLock(&pSdb->filelock);
+  code = sdbDoWriteFile(pSdb, false);
   taosThreadMutexUnlock(&pSdb->filelock);
   return code;
 }
@@ -529,8 +896,18 @@ int32_t sdbStartRead(SSdb *pSdb, SSdbIter **ppIter, int64_t *index, int64_t *ter
 
   char datafile[PATH_MAX] = {0};
   snprintf(datafile, sizeof(datafile), "%s%ssdb.data", pSdb->currDir, TD_DIRSEP);
+  char deltafile[PATH_MAX] = {0};
+  snprintf(deltafile, sizeof(deltafile), "%s%ssdb.delta", pSdb->currDir, TD_DIRSEP);
 
   taosThreadMutexLock(&pSdb->filelock);
+  // the snapshot only carries the data file, so fold the delta into it first
+  if (taosCheckExistFile(deltafile) && sdbDoWriteFile(pSdb, true) != 0) {
+    taosThreadMutexUnlock(&pSdb->filelock);
+    mError("failed to compact sdb file before snapshot since %s", terrstr());
+    sdbCloseIter(pIter);
+    return -1;
+  }
+
   int64_t commitIndex = pSdb->commitIndex;
   int64_t commitTerm = pSdb->commitTerm;
   int64_t commitConfig = pSdb->commitConfig;
@@ -630,6 +1007,8 @@ int32_t sdbStopWrite(SSdb *pSdb, SSdbIter *pIter, bool isApply, int64_t index, i
 
   char datafile[PATH_MAX] = {0};
   snprintf(datafile, sizeof(datafile), "%s%ssdb.data", pSdb->currDir, TD_DIRSEP);
+  char deltafile[PATH_MAX] = {0};
+  snprintf(deltafile, sizeof(deltafile), "%s%ssdb.delta", pSdb->currDir, TD_DIRSEP);
   if (taosRenameFile(pIter->name, datafile) != 0) {
     terrno = TAOS_SYSTEM_ERROR(errno);
     mError("sdbiter:%p, failed to rename file %s to %s since %s", pIter, pIter->name, datafile, terrstr());
@@ -637,6 +1016,13 @@ int32_t sdbStopWrite(SSdb *pSdb, SSdbIter *pIter, bool isApply, int64_t index, i
     return -1;
   }
 
+  if (taosCheckExistFile(deltafile) && taosRemoveFile(deltafile) != 0) {
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    mError("sdbiter:%p, failed to remove file %s since %s", pIter, deltafile, terrstr());
+    sdbCloseIter(pIter);
+    return -1;
+  }
+
   if (sdbReadFile(pSdb) != 0) {
     mError("sdbiter:%p, failed to read from %s since %s", pIter, datafile, terrstr());
     sdbCloseIter(pIter);
@@ -132,6 +132,32 @@ static int32_t sdbGetkeySize(SSdb *pSdb, ESdbType type, const void *pKey) {
   return keySize;
 }
 
+// called with the table write lock held, records the key for the next incremental checkpoint
+static void sdbSetDirty(SSdb *pSdb, ESdbType type, const void *pKey, int32_t keySize, SSdbRaw *pDropRaw) {
+  SHashObj *dirty = pSdb->dirtyObjs[type];
+  if (dirty == NULL) return;
+
+  // keep a pending drop so that a row re-created before the checkpoint still removes the persisted one
+  SSdbRaw **ppRaw = taosHashGet(dirty, pKey, keySize);
+  if (ppRaw != NULL && pDropRaw == NULL) return;
+
+  SSdbRaw *pRaw = NULL;
+  if (pDropRaw != NULL) {
+    int32_t size = sizeof(SSdbRaw) + pDropRaw->dataLen;
+    pRaw = taosMemoryMalloc(size);
+    if (pRaw == NULL) {
+      pSdb->dirtyLost = true;
+      return;
+    }
+    memcpy(pRaw, pDropRaw, size);
+  }
+
+  if (taosHashPut(dirty, pKey, keySize, &pRaw, sizeof(void *)) != 0) {
+    sdbFreeRaw(pRaw);
+    pSdb->dirtyLost = true;
+  }
+}
+
 static int32_t sdbInsertRow(SSdb *pSdb, SHashObj *hash, SSdbRaw *pRaw, SSdbRow *pRow, int32_t keySize) {
   TdThreadRwlock *pLock = &pSdb->locks[pRow->type];
   taosThreadRwlockWrlock(pLock);
@@ -169,6 +195,7 @@ static int32_t sdbInsertRow(SSdb *pSdb, SHashObj *hash, SSdbRaw *pRaw, SSdbRow *
     }
   }
 
+  sdbSetDirty(pSdb, pRow->type, pRow->pObj, keySize, NULL);
   taosThreadRwlockUnlock(pLock);
 
   if (pSdb->keyTypes[pRow->type] == SDB_KEY_INT32) {
@@ -202,6 +229,7 @@ static int32_t sdbUpdateRow(SSdb *pSdb, SHashObj *hash, SSdbRaw *pRaw, SSdbRow *
     code = (*updateFp)(pSdb, pOldRow->pObj, pNewRow->pObj);
   }
 
+  sdbSetDirty(pSdb, pOldRow->type, pOldRow->pObj, keySize, NULL);
   taosThreadRwlockUnlock(pLock);
   sdbFreeRow(pSdb, pNewRow, false);
 
@@ -226,6 +254,7 @@ static int32_t sdbDeleteRow(SSdb *pSdb, SHashObj *hash, SSdbRaw *pRaw, SSdbRow *
   atomic_add_fetch_32(&pOldRow->refCount, 1);
   sdbPrintOper(pSdb, pOldRow, "delete");
 
+  sdbSetDirty(pSdb, pOldRow->type, pOldRow->pObj, keySize, pRaw);
   taosHashRemove(hash, pOldRow->pObj, keySize);
   pSdb->tableVer[pOldRow->type]++;
   taosThreadRwlockUnlock(pLock);
@@ -24,6 +24,7 @@
 #include "sync.h"
 #include "tarray.h"
 #include "tfs.h"
+#include "troaring.h"
 #include "wal.h"
 
 #include "tcommon.h"
@@ -109,6 +110,7 @@ typedef struct SMetaFltParam {
 } SMetaFltParam;
 
 int32_t metaFilterTableIds(SMeta *pMeta, SMetaFltParam *param, SArray *results);
+int32_t metaFilterTableBitmap(SMeta *pMeta, SMetaFltParam *param, SRoaring *results);
 
 #if 1  // refact APIs below (TODO)
 typedef SVCreateTbReq   STbCfg;
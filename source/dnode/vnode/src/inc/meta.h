@@ -62,10 +62,15 @@ static FORCE_INLINE tb_uid_t metaGenerateUid(SMeta* pMeta) { return tGenIdPI64()
 int metaHandleEntry(SMeta* pMeta, const SMetaEntry* pME);
 
 // metaCache ==================
+#define META_SKM_CACHE_SIZE (4 * 1024 * 1024)  // bytes of decoded schemas cached per vnode
+
 int32_t metaCacheOpen(SMeta* pMeta);
 void    metaCacheClose(SMeta* pMeta);
 int32_t metaCacheUpsert(SMeta* pMeta, SMetaInfo* pInfo);
 int32_t metaCacheDrop(SMeta* pMeta, int64_t uid);
+int32_t metaCacheGetTSchema(SMeta* pMeta, tb_uid_t uid, int32_t sver, STSchema** ppTSchema);
+int32_t metaCachePutTSchema(SMeta* pMeta, tb_uid_t uid, const STSchema* pTSchema);
+void    metaCacheDropTSchema(SMeta* pMeta, tb_uid_t uid);
 
 struct SMeta {
   TdThreadRwlock lock;
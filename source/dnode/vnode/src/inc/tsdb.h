@@ -268,7 +268,7 @@ int32_t tsdbWriteSttBlk(SDataFWriter *pWriter, SArray *aSttBlk);
 int32_t tsdbWriteBlockData(SDataFWriter *pWriter, SBlockData *pBlockData, SBlockInfo *pBlkInfo, SSmaInfo *pSmaInfo,
                            int8_t cmprAlg, int8_t toLast);
 
-int32_t tsdbDFileSetCopy(STsdb *pTsdb, SDFileSet *pSetFrom, SDFileSet *pSetTo);
+int32_t tsdbDFileSetCopy(STsdb *pTsdb, SDFileSet *pSetFrom, SDFileSet *pSetTo, int64_t speed);
 // SDataFReader
 int32_t tsdbDataFReaderOpen(SDataFReader **ppReader, STsdb *pTsdb, SDFileSet *pSet);
 int32_t tsdbDataFReaderClose(SDataFReader **ppReader);
@@ -318,6 +318,25 @@ size_t tsdbCacheGetCapacity(SVnode *pVnode);
 
 int32_t tsdbCacheLastArray2Row(SArray *pLastArray, STSRow **ppRow, STSchema *pSchema);
 
+// tsdbCache (decompressed data block cache)
+typedef struct {
+  int64_t commitID;  // commit ID of the file
+  int64_t offset;    // block offset in the file
+  int32_t fid;
+  int16_t cid;    // 0 for the block header and keys
+  int8_t  ftype;  // 0: .data file, 1: .stt file
+  int8_t  reserved;
+} SBlockCacheKey;
+
+int32_t tsdbOpenBlockCache(STsdb *pTsdb);
+void    tsdbCloseBlockCache(STsdb *pTsdb);
+int32_t tsdbBCacheGetBlockKey(SLRUCache *pCache, SBlockCacheKey *pKey, SDiskDataHdr *pHdr, SBlockData *pBlockData,
+                              uint8_t **ppBlkCol, bool *hit);
+void    tsdbBCachePutBlockKey(SLRUCache *pCache, SBlockCacheKey *pKey, SDiskDataHdr *pHdr, SBlockData *pBlockData,
+                              uint8_t *pBlkCol);
+int32_t tsdbBCacheGetColData(SLRUCache *pCache, SBlockCacheKey *pKey, SColData *pColData, bool *hit);
+void    tsdbBCachePutColData(SLRUCache *pCache, SBlockCacheKey *pKey, SColData *pColData);
+
 // structs =======================
 struct STsdbFS {
   SDelFile *pDelFile;
@@ -334,6 +353,8 @@ struct STsdb {
   STsdbFS        fs;
   SLRUCache     *lruCache;
   TdThreadMutex  lruMutex;
+  SLRUCache     *blkCache;
+  SArray        *aRetention;  // SArray<SDFileSet>, file sets copied by retention and not committed yet
 };
 
 struct TSDBKEY {
@@ -18,6 +18,7 @@
 
 #include "sync.h"
 #include "syncTools.h"
+#include "tsched.h"
 #include "ttrace.h"
 #include "vnodeInt.h"
 
@@ -51,6 +52,7 @@ int32_t vnodeDecodeConfig(const SJson* pJson, void* pObj);
 
 // vnodeModule.c
 int32_t vnodeScheduleTask(int32_t (*execute)(void*), void* arg);
+int32_t vnodeScheduleTrimTask(void (*fp)(SSchedMsg*), void* arg);
 
 // vnodeBufPool.c
 typedef struct SVBufPoolNode SVBufPoolNode;
@@ -51,6 +51,7 @@ extern "C" {
 #endif
 
 typedef struct SVnodeInfo         SVnodeInfo;
+typedef struct SCommitInfo        SCommitInfo;
 typedef struct SMeta              SMeta;
 typedef struct SSma               SSma;
 typedef struct STsdb              STsdb;
@@ -140,11 +141,17 @@ typedef struct SMetaInfo {
 int32_t metaGetInfo(SMeta* pMeta, int64_t uid, SMetaInfo* pInfo);
 
 // tsdb
+int32_t     tsdbInit();
+void        tsdbCleanUp();
 int         tsdbOpen(SVnode* pVnode, STsdb** ppTsdb, const char* dir, STsdbKeepCfg* pKeepCfg);
 int         tsdbClose(STsdb** pTsdb);
 int32_t     tsdbBegin(STsdb* pTsdb);
-int32_t     tsdbCommit(STsdb* pTsdb);
+int32_t     tsdbPrepareCommit(STsdb* pTsdb);
+int32_t     tsdbCommit(STsdb* pTsdb, SCommitInfo* pInfo);
 int32_t     tsdbDoRetention(STsdb* pTsdb, int64_t now);
+int32_t     tsdbCommitRetention(STsdb* pTsdb, int64_t now);
+bool        tsdbShouldCompact(STsdb* pTsdb);
+int32_t     tsdbCompact(STsdb* pTsdb, int64_t commitID);
 int         tsdbScanAndConvertSubmitMsg(STsdb* pTsdb, SSubmitReq* pMsg);
 int         tsdbInsertData(STsdb* pTsdb, int64_t version, SSubmitReq* pMsg, SSubmitRsp* pRsp);
 int32_t     tsdbInsertTableData(STsdb* pTsdb, int64_t version, SSubmitMsgIter* pMsgIter, SSubmitBlk* pBlock,
@@ -200,6 +207,7 @@ int32_t smaAsyncPreCommit(SSma* pSma);
 int32_t smaAsyncCommit(SSma* pSma);
 int32_t smaAsyncPostCommit(SSma* pSma);
 int32_t smaDoRetention(SSma* pSma, int64_t now);
+int32_t smaCommitRetention(SSma* pSma, int64_t now);
 
 int32_t tdProcessTSmaCreate(SSma* pSma, int64_t version, const char* msg);
 int32_t tdProcessTSmaInsert(SSma* pSma, int64_t indexUid, const char* msg);
@@ -286,6 +294,13 @@ struct SVnodeInfo {
   SVState   state;
 };
 
+// state of one commit, frozen on the write thread and finished on a commit thread
+struct SCommitInfo {
+  SVnodeInfo info;
+  SVnode*    pVnode;
+  int64_t    compactID;  // commit ID reserved for compaction, 0 if no file set needs it
+};
+
 typedef enum {
   TSDB_TYPE_TSDB = 0,     // TSDB
   TSDB_TYPE_TSMA = 1,     // TSMA
@@ -319,6 +334,8 @@ struct SVnode {
   STQ*          pTq;
   SSink*        pSink;
   tsem_t        canCommit;
+  tsem_t        canTrim;
+  int8_t        stopTrim;
   int64_t       sync;
   TdThreadMutex lock;
   bool          blocked;
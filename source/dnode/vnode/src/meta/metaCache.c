@@ -25,10 +25,28 @@ struct SMetaCacheEntry {
   SMetaInfo        info;
 };
 
+// (uid, sver) : decoded schema of a super table or normal table
+typedef struct SSkmCacheEntry SSkmCacheEntry;
+struct SSkmCacheEntry {
+  SSkmCacheEntry* next;
+  SSkmCacheEntry* lruPrev;
+  SSkmCacheEntry* lruNext;
+  tb_uid_t        uid;
+  STSchema*       pTSchema;
+};
+
 struct SMetaCache {
   int32_t           nEntry;
   int32_t           nBucket;
   SMetaCacheEntry** aBucket;
+
+  // schema cache, filled by readers so it has its own lock
+  TdThreadMutex    skmLock;
+  int32_t          nSkmEntry;
+  int32_t          nSkmBucket;
+  SSkmCacheEntry** aSkmBucket;
+  int64_t          skmSize;  // bytes of the cached schemas, kept under META_SKM_CACHE_SIZE
+  SSkmCacheEntry   skmLru;   // list head, the most recently used first
 };
 
 int32_t metaCacheOpen(SMeta* pMeta) {
@@ -50,6 +68,20 @@ int32_t metaCacheOpen(SMeta* pMeta) {
     goto _err;
   }
 
+  pCache->nSkmEntry = 0;
+  pCache->nSkmBucket = META_CACHE_BASE_BUCKET;
+  pCache->aSkmBucket = (SSkmCacheEntry**)taosMemoryCalloc(pCache->nSkmBucket, sizeof(SSkmCacheEntry*));
+  if (pCache->aSkmBucket == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    taosMemoryFree(pCache->aBucket);
+    taosMemoryFree(pCache);
+    goto _err;
+  }
+  pCache->skmSize = 0;
+  pCache->skmLru.lruPrev = &pCache->skmLru;
+  pCache->skmLru.lruNext = &pCache->skmLru;
+  taosThreadMutexInit(&pCache->skmLock, NULL);
+
   pMeta->pCache = pCache;
 
 _exit:
@@ -71,6 +103,19 @@ void metaCacheClose(SMeta* pMeta) {
       }
     }
     taosMemoryFree(pMeta->pCache->aBucket);
+
+    for (int32_t iBucket = 0; iBucket < pMeta->pCache->nSkmBucket; iBucket++) {
+      SSkmCacheEntry* pEntry = pMeta->pCache->aSkmBucket[iBucket];
+      while (pEntry) {
+        SSkmCacheEntry* tEntry = pEntry->next;
+        taosMemoryFree(pEntry->pTSchema);
+        taosMemoryFree(pEntry);
+        pEntry = tEntry;
+      }
+    }
+    taosMemoryFree(pMeta->pCache->aSkmBucket);
+    taosThreadMutexDestroy(&pMeta->pCache->skmLock);
+
     taosMemoryFree(pMeta->pCache);
     pMeta->pCache = NULL;
   }
@@ -204,3 +249,175 @@ int32_t metaCacheGet(SMeta* pMeta, int64_t uid, SMetaInfo* pInfo) {
 
   return code;
 }
+
+#define META_TSCHEMA_SIZE(s) (sizeof(STSchema) + sizeof(STColumn) * (s)->numOfCols)
+
+static STSchema* metaDupTSchema(const STSchema* pTSchema) {
+  int32_t   size = META_TSCHEMA_SIZE(pTSchema);
+  STSchema* pNew = (STSchema*)taosMemoryMalloc(size);
+  if (pNew) {
+    memcpy(pNew, pTSchema, size);
+  }
+  return pNew;
+}
+
+static void metaSkmLruRemove(SSkmCacheEntry* pEntry) {
+  pEntry->lruPrev->lruNext = pEntry->lruNext;
+  pEntry->lruNext->lruPrev = pEntry->lruPrev;
+}
+
+static void metaSkmLruPushFront(SMetaCache* pCache, SSkmCacheEntry* pEntry) {
+  pEntry->lruNext = pCache->skmLru.lruNext;
+  pEntry->lruPrev = &pCache->skmLru;
+  pCache->skmLru.lruNext->lruPrev = pEntry;
+  pCache->skmLru.lruNext = pEntry;
+}
+
+// unlink the entry from its bucket and the lru list, and free it
+static void metaSkmCacheRemove(SMetaCache* pCache, SSkmCacheEntry** ppEntry) {
+  SSkmCacheEntry* pEntry = *ppEntry;
+
+  *ppEntry = pEntry->next;
+  metaSkmLruRemove(pEntry);
+  pCache->skmSize -= META_TSCHEMA_SIZE(pEntry->pTSchema);
+  pCache->nSkmEntry--;
+  taosMemoryFree(pEntry->pTSchema);
+  taosMemoryFree(pEntry);
+}
+
+// evict the least recently used schemas until the cache fits its size
+static void metaSkmCacheEvict(SMetaCache* pCache) {
+  while (pCache->skmSize > META_SKM_CACHE_SIZE && pCache->skmLru.lruPrev != &pCache->skmLru) {
+    SSkmCacheEntry*  pVictim = pCache->skmLru.lruPrev;
+    SSkmCacheEntry** ppEntry = &pCache->aSkmBucket[TABS(pVictim->uid) % pCache->nSkmBucket];
+    while (*ppEntry != pVictim) {
+      ppEntry = &(*ppEntry)->next;
+    }
+    metaSkmCacheRemove(pCache, ppEntry);
+  }
+}
+
+static int32_t metaRehashSkmCache(SMetaCache* pCache) {
+  int32_t code = 0;
+  int32_t nBucket = pCache->nSkmBucket * 2;
+
+  SSkmCacheEntry** aBucket = (SSkmCacheEntry**)taosMemoryCalloc(nBucket, sizeof(SSkmCacheEntry*));
+  if (aBucket == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _exit;
+  }
+
+  // rehash
+  for (int32_t iBucket = 0; iBucket < pCache->nSkmBucket; iBucket++) {
+    SSkmCacheEntry* pEntry = pCache->aSkmBucket[iBucket];
+
+    while (pEntry) {
+      SSkmCacheEntry* pTEntry = pEntry->next;
+
+      pEntry->next = aBucket[TABS(pEntry->uid) % nBucket];
+      aBucket[TABS(pEntry->uid) % nBucket] = pEntry;
+
+      pEntry = pTEntry;
+    }
+  }
+
+  // final set
+  taosMemoryFree(pCache->aSkmBucket);
+  pCache->nSkmBucket = nBucket;
+  pCache->aSkmBucket = aBucket;
+
+_exit:
+  return code;
+}
+
+int32_t metaCacheGetTSchema(SMeta* pMeta, tb_uid_t uid, int32_t sver, STSchema** ppTSchema) {
+  int32_t     code = 0;
+  SMetaCache* pCache = pMeta->pCache;
+
+  taosThreadMutexLock(&pCache->skmLock);
+
+  SSkmCacheEntry* pEntry = pCache->aSkmBucket[TABS(uid) % pCache->nSkmBucket];
+  while (pEntry && (pEntry->uid != uid || pEntry->pTSchema->version != sver)) {
+    pEntry = pEntry->next;
+  }
+
+  if (pEntry) {
+    metaSkmLruRemove(pEntry);
+    metaSkmLruPushFront(pCache, pEntry);
+
+    *ppTSchema = metaDupTSchema(pEntry->pTSchema);
+    if (*ppTSchema == NULL) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+    }
+  } else {
+    code = TSDB_CODE_NOT_FOUND;
+  }
+
+  taosThreadMutexUnlock(&pCache->skmLock);
+  return code;
+}
+
+int32_t metaCachePutTSchema(SMeta* pMeta, tb_uid_t uid, const STSchema* pTSchema) {
+  int32_t     code = 0;
+  SMetaCache* pCache = pMeta->pCache;
+
+  taosThreadMutexLock(&pCache->skmLock);
+
+  int32_t         iBucket = TABS(uid) % pCache->nSkmBucket;
+  SSkmCacheEntry* pEntry = pCache->aSkmBucket[iBucket];
+  while (pEntry && (pEntry->uid != uid || pEntry->pTSchema->version != pTSchema->version)) {
+    pEntry = pEntry->next;
+  }
+
+  if (pEntry) goto _exit;  // already cached by another reader
+
+  if (pCache->nSkmEntry >= pCache->nSkmBucket) {
+    code = metaRehashSkmCache(pCache);
+    if (code) goto _exit;
+
+    iBucket = TABS(uid) % pCache->nSkmBucket;
+  }
+
+  SSkmCacheEntry* pEntryNew = (SSkmCacheEntry*)taosMemoryMalloc(sizeof(*pEntryNew));
+  if (pEntryNew == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _exit;
+  }
+
+  pEntryNew->uid = uid;
+  pEntryNew->pTSchema = metaDupTSchema(pTSchema);
+  if (pEntryNew->pTSchema == NULL) {
+    taosMemoryFree(pEntryNew);
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _exit;
+  }
+
+  pEntryNew->next = pCache->aSkmBucket[iBucket];
+  pCache->aSkmBucket[iBucket] = pEntryNew;
+  metaSkmLruPushFront(pCache, pEntryNew);
+  pCache->skmSize += META_TSCHEMA_SIZE(pTSchema);
+  pCache->nSkmEntry++;
+
+  metaSkmCacheEvict(pCache);
+
+_exit:
+  taosThreadMutexUnlock(&pCache->skmLock);
+  return code;
+}
+
+void metaCacheDropTSchema(SMeta* pMeta, tb_uid_t uid) {
+  SMetaCache* pCache = pMeta->pCache;
+
+  taosThreadMutexLock(&pCache->skmLock);
+
+  SSkmCacheEntry** ppEntry = &pCache->aSkmBucket[TABS(uid) % pCache->nSkmBucket];
+  while (*ppEntry) {
+    if ((*ppEntry)->uid == uid) {
+      metaSkmCacheRemove(pCache, ppEntry);
+    } else {
+      ppEntry = &(*ppEntry)->next;
+    }
+  }
+
+  taosThreadMutexUnlock(&pCache->skmLock);
+}
@@ -540,6 +540,19 @@ STSchema *metaGetTbTSchema(SMeta *pMeta, tb_uid_t uid, int32_t sver) {
   SSchemaWrapper *pSW = NULL;
   STSchemaBuilder sb = {0};
   SSchema        *pSchema;
+  SMetaInfo       info;
+  tb_uid_t        skmUid = 0;
+
+  // child tables share the decoded schema of their super table
+  if (metaGetInfo(pMeta, uid, &info) == 0) {
+    skmUid = info.suid ? info.suid : uid;
+    if (sver == -1 && skmUid != uid && metaGetInfo(pMeta, skmUid, &info) < 0) {
+      skmUid = 0;
+    }
+    if (skmUid && metaCacheGetTSchema(pMeta, skmUid, sver == -1 ? info.skmVer : sver, &pTSchema) == 0) {
+      return pTSchema;
+    }
+  }
 
   pSW = metaGetTableSchema(pMeta, uid, sver, 0);
   if (!pSW) return NULL;
@@ -553,6 +566,10 @@ STSchema *metaGetTbTSchema(SMeta *pMeta, tb_uid_t uid, int32_t sver) {
 
   tdDestroyTSchemaBuilder(&sb);
 
+  if (pTSchema && skmUid) {
+    metaCachePutTSchema(pMeta, skmUid, pTSchema);
+  }
+
   taosMemoryFree(pSW->pSchema);
   taosMemoryFree(pSW);
   return pTSchema;
@@ -611,6 +628,10 @@ int32_t metaGetTbTSchemaEx(SMeta *pMeta, tb_uid_t suid, tb_uid_t uid, int32_t sv
 
   ASSERT(sver > 0);
 
+  if (metaCacheGetTSchema(pMeta, suid ? suid : uid, sver, ppTSchema) == 0) {
+    goto _exit;
+  }
+
   skmDbKey.uid = suid ? suid : uid;
   skmDbKey.sver = sver;
   metaRLock(pMeta);
@@ -642,6 +663,10 @@ int32_t metaGetTbTSchemaEx(SMeta *pMeta, tb_uid_t suid, tb_uid_t uid, int32_t sv
   STSchema *pTSchema = tdGetSchemaFromBuilder(&sb);
   tdDestroyTSchemaBuilder(&sb);
 
+  if (pTSchema) {
+    metaCachePutTSchema(pMeta, skmDbKey.uid, pTSchema);
+  }
+
   *ppTSchema = pTSchema;
   taosMemoryFree(pSchemaWrapper->pSchema);
 
@@ -1102,6 +1127,23 @@ END:
   return ret;
 }
 
+int32_t metaFilterTableBitmap(SMeta *pMeta, SMetaFltParam *param, SRoaring *pUids) {
+  // the tag index returns uids in tag order, collect them first and let the bitmap sort them once
+  SArray *pArr = taosArrayInit(256, sizeof(tb_uid_t));
+  if (pArr == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return -1;
+  }
+
+  int32_t ret = metaFilterTableIds(pMeta, param, pArr);
+  if (ret == 0) {
+    ret = tRoaringAddArray(pUids, pArr);
+  }
+
+  taosArrayDestroy(pArr);
+  return ret;
+}
+
 int32_t metaGetTableTags(SMeta *pMeta, uint64_t suid, SArray *uidList, SHashObj *tags) {
   SMCtbCursor *pCur = metaOpenCtbCursor(pMeta, suid);
 
@@ -291,6 +291,9 @@ _drop_super_table:
   tdbTbDelete(pMeta->pUidIdx, &pReq->suid, sizeof(tb_uid_t), &pMeta->txn);
   tdbTbDelete(pMeta->pSuidIdx, &pReq->suid, sizeof(tb_uid_t), &pMeta->txn);
 
+  metaCacheDrop(pMeta, pReq->suid);
+  metaCacheDropTSchema(pMeta, pReq->suid);
+
   metaULock(pMeta);
 
 _exit:
@@ -354,6 +357,7 @@ int metaAlterSTable(SMeta *pMeta, int64_t version, SVCreateStbReq *pReq) {
   // compare two entry
   if (oStbEntry.stbEntry.schemaRow.version != pReq->schemaRow.version) {
     metaSaveToSkmDb(pMeta, &nStbEntry);
+    metaCacheDropTSchema(pMeta, pReq->suid);
   }
 
   // update table.db
@@ -619,6 +623,7 @@ static int metaDropTableByUid(SMeta *pMeta, tb_uid_t uid, int *type) {
   }
 
   metaCacheDrop(pMeta, uid);
+  if (e.type != TSDB_CHILD_TABLE) metaCacheDropTSchema(pMeta, uid);
 
   tDecoderClear(&dc);
   tdbFree(pData);
@@ -780,6 +785,8 @@ static int metaAlterTableColumn(SMeta *pMeta, int64_t version, SVAlterTbReq *pAl
 
   metaSaveToSkmDb(pMeta, &entry);
 
+  metaCacheDropTSchema(pMeta, uid);
+
   metaULock(pMeta);
 
   metaUpdateMetaRsp(uid, pAlterTbReq->tbName, pSchema, pMetaRsp);
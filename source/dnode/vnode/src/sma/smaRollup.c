@@ -682,6 +682,29 @@ _end:
   return code;
 }
 
+/**
+ * @brief commit the retention of rsma1/rsma2, the caller holds the commit lock
+ *
+ * @param pSma
+ * @param now
+ * @return int32_t
+ */
+int32_t smaCommitRetention(SSma *pSma, int64_t now) {
+  int32_t code = TSDB_CODE_SUCCESS;
+  if (!VND_IS_RSMA(pSma->pVnode)) {
+    return code;
+  }
+
+  for (int32_t i = 0; i < TSDB_RETENTION_L2; ++i) {
+    if (pSma->pRSmaTsdb[i]) {
+      int32_t ret = tsdbCommitRetention(pSma->pRSmaTsdb[i], now);
+      if (ret) code = ret;
+    }
+  }
+
+  return code;
+}
+
 static int32_t tdRSmaExecAndSubmitResult(SSma *pSma, qTaskInfo_t taskInfo, SRSmaInfoItem *pItem, STSchema *pTSchema,
                                          int64_t suid) {
   SArray *pResList = taosArrayInit(1, POINTER_BYTES);
@@ -1342,3 +1342,158 @@ void tsdbCacheSetCapacity(SVnode *pVnode, size_t capacity) {
 size_t tsdbCacheGetCapacity(SVnode *pVnode) { return taosLRUCacheGetCapacity(pVnode->pTsdb->lruCache); }
 
 size_t tsdbCacheGetUsage(SVnode *pVnode) { return taosLRUCacheGetUsage(pVnode->pTsdb->lruCache); }
+
+// decompressed data block cache ==================================================================
+typedef struct {
+  SDiskDataHdr hdr;
+  int64_t     *aUid;
+  int64_t     *aVersion;
+  TSKEY       *aTSKEY;
+  uint8_t     *pBlkCol;
+} SBCacheBlockKey;
+
+int32_t tsdbOpenBlockCache(STsdb *pTsdb) {
+  int32_t    code = 0;
+  SLRUCache *pCache = NULL;
+  size_t     cfgCapacity = (size_t)tsTsdbBlockCacheSize * 1024 * 1024;
+
+  if (cfgCapacity == 0) goto _exit;
+
+  pCache = taosLRUCacheInit(cfgCapacity, -1, .5);
+  if (pCache == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _exit;
+  }
+
+  taosLRUCacheSetStrictCapacity(pCache, true);
+
+_exit:
+  pTsdb->blkCache = pCache;
+  return code;
+}
+
+void tsdbCloseBlockCache(STsdb *pTsdb) {
+  SLRUCache *pCache = pTsdb->blkCache;
+  if (pCache) {
+    taosLRUCacheEraseUnrefEntries(pCache);
+
+    taosLRUCacheCleanup(pCache);
+
+    pTsdb->blkCache = NULL;
+  }
+}
+
+static void deleteBCacheBlockKey(const void *key, size_t keyLen, void *value) { taosMemoryFree(value); }
+
+static void deleteBCacheColData(const void *key, size_t keyLen, void *value) {
+  tColDataDestroy(value);
+  taosMemoryFree(value);
+}
+
+int32_t tsdbBCacheGetBlockKey(SLRUCache *pCache, SBlockCacheKey *pKey, SDiskDataHdr *pHdr, SBlockData *pBlockData,
+                              uint8_t **ppBlkCol, bool *hit) {
+  int32_t code = 0;
+
+  *hit = false;
+
+  LRUHandle *h = taosLRUCacheLookup(pCache, pKey, sizeof(*pKey));
+  if (h == NULL) return code;
+
+  SBCacheBlockKey *pValue = (SBCacheBlockKey *)taosLRUCacheValue(pCache, h);
+  int32_t          nRow = pValue->hdr.nRow;
+
+  *pHdr = pValue->hdr;
+  if (pValue->aUid) {
+    code = tRealloc((uint8_t **)&pBlockData->aUid, sizeof(int64_t) * nRow);
+    if (code) goto _exit;
+    memcpy(pBlockData->aUid, pValue->aUid, sizeof(int64_t) * nRow);
+  }
+
+  code = tRealloc((uint8_t **)&pBlockData->aVersion, sizeof(int64_t) * nRow);
+  if (code) goto _exit;
+  memcpy(pBlockData->aVersion, pValue->aVersion, sizeof(int64_t) * nRow);
+
+  code = tRealloc((uint8_t **)&pBlockData->aTSKEY, sizeof(TSKEY) * nRow);
+  if (code) goto _exit;
+  memcpy(pBlockData->aTSKEY, pValue->aTSKEY, sizeof(TSKEY) * nRow);
+
+  if (pValue->hdr.szBlkCol > 0) {
+    code = tRealloc(ppBlkCol, pValue->hdr.szBlkCol);
+    if (code) goto _exit;
+    memcpy(*ppBlkCol, pValue->pBlkCol, pValue->hdr.szBlkCol);
+  }
+
+  *hit = true;
+
+_exit:
+  taosLRUCacheRelease(pCache, h, false);
+  return code;
+}
+
+void tsdbBCachePutBlockKey(SLRUCache *pCache, SBlockCacheKey *pKey, SDiskDataHdr *pHdr, SBlockData *pBlockData,
+                           uint8_t *pBlkCol) {
+  int32_t nRow = pHdr->nRow;
+  int64_t size = sizeof(SBCacheBlockKey) + sizeof(int64_t) * nRow * (pHdr->uid ? 2 : 3) + pHdr->szBlkCol;
+
+  // failing to cache is not an error, the block is read from file next time
+  SBCacheBlockKey *pValue = (SBCacheBlockKey *)taosMemoryMalloc(size);
+  if (pValue == NULL) return;
+
+  uint8_t *p = (uint8_t *)&pValue[1];
+
+  pValue->hdr = *pHdr;
+  if (pHdr->uid == 0) {
+    pValue->aUid = (int64_t *)p;
+    memcpy(p, pBlockData->aUid, sizeof(int64_t) * nRow);
+    p += sizeof(int64_t) * nRow;
+  } else {
+    pValue->aUid = NULL;
+  }
+  pValue->aVersion = (int64_t *)p;
+  memcpy(p, pBlockData->aVersion, sizeof(int64_t) * nRow);
+  p += sizeof(int64_t) * nRow;
+  pValue->aTSKEY = (TSKEY *)p;
+  memcpy(p, pBlockData->aTSKEY, sizeof(TSKEY) * nRow);
+  p += sizeof(TSKEY) * nRow;
+  pValue->pBlkCol = p;
+  if (pHdr->szBlkCol > 0) {
+    memcpy(p, pBlkCol, pHdr->szBlkCol);
+  }
+
+  taosLRUCacheInsert(pCache, pKey, sizeof(*pKey), pValue, size, deleteBCacheBlockKey, NULL, TAOS_LRU_PRIORITY_LOW);
+}
+
+int32_t tsdbBCacheGetColData(SLRUCache *pCache, SBlockCacheKey *pKey, SColData *pColData, bool *hit) {
+  int32_t code = 0;
+
+  *hit = false;
+
+  LRUHandle *h = taosLRUCacheLookup(pCache, pKey, sizeof(*pKey));
+  if (h == NULL) return code;
+
+  code = tColDataCopy((SColData *)taosLRUCacheValue(pCache, h), pColData);
+  if (code == 0) *hit = true;
+
+  taosLRUCacheRelease(pCache, h, false);
+  return code;
+}
+
+void tsdbBCachePutColData(SLRUCache *pCache, SBlockCacheKey *pKey, SColData *pColData) {
+  SColData *pValue = (SColData *)taosMemoryCalloc(1, sizeof(*pValue));
+  if (pValue == NULL) return;
+
+  tColDataInit(pValue, pColData->cid, pColData->type, pColData->smaOn);
+  if (tColDataCopy(pColData, pValue)) {
+    tColDataDestroy(pValue);
+    taosMemoryFree(pValue);
+    return;
+  }
+
+  size_t charge = sizeof(*pValue) + pValue->nData;
+  if (IS_VAR_DATA_TYPE(pValue->type)) charge += sizeof(int32_t) * pValue->nVal;
+  if (pValue->flag != HAS_NONE && pValue->flag != HAS_NULL && pValue->flag != HAS_VALUE) {
+    charge += BIT2_SIZE(pValue->nVal);
+  }
+
+  taosLRUCacheInsert(pCache, pKey, sizeof(*pKey), pValue, charge, deleteBCacheColData, NULL, TAOS_LRU_PRIORITY_LOW);
+}
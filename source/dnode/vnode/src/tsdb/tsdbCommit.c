@@ -14,6 +14,9 @@
  */
 
 #include "tsdb.h"
+#include "tsched.h"
+
+#define TSDB_COMMIT_QUEUE_SIZE 1024
 
 typedef enum { MEMORY_DATA_ITER = 0, STT_DATA_ITER } EDataIterT;
 
@@ -36,7 +39,18 @@ typedef struct {
   };
 } SDataIter;
 
+// output of one file set commit, published to the fs once all file sets are done
 typedef struct {
+  int32_t   fid;
+  SDFileSet wSet;
+  SHeadFile fHead;
+  SDataFile fData;
+  SSmaFile  fSma;
+  SSttFile  aSttF[TSDB_MAX_STT_TRIGGER];
+} SCommitFSet;
+
+typedef struct SCommitter SCommitter;
+struct SCommitter {
   STsdb *pTsdb;
   /* commit data */
   int64_t commitID;
@@ -85,9 +99,16 @@ typedef struct {
   SArray      *aDelIdx;   // SArray<SDelIdx>
   SArray      *aDelIdxN;  // SArray<SDelIdx>
   SArray      *aDelData;  // SArray<SDelData>
-} SCommitter;
-
-static int32_t tsdbStartCommit(STsdb *pTsdb, SCommitter *pCommitter);
+  /* parallel file set commit */
+  SCommitter      *pParent;
+  SCommitFSet     *pFSet;
+  SArray          *aFSet;  // SArray<SCommitFSet>
+  volatile int32_t iFSet;
+  volatile int32_t fsetCode;
+  tsem_t           workerSem;  // posted by each worker when it is done
+};
+
+static int32_t tsdbStartCommit(STsdb *pTsdb, SCommitter *pCommitter, SCommitInfo *pInfo);
 static int32_t tsdbCommitData(SCommitter *pCommitter);
 static int32_t tsdbCommitDel(SCommitter *pCommitter);
 static int32_t tsdbCommitCache(SCommitter *pCommitter);
@@ -145,17 +166,31 @@ _err:
   return code;
 }
 
-int32_t tsdbCommit(STsdb *pTsdb) {
+// freeze the mem table on the write thread, readers keep seeing it as imem until the commit ends
+int32_t tsdbPrepareCommit(STsdb *pTsdb) {
+  if (!pTsdb) return 0;
+
+  ASSERT(pTsdb->mem && pTsdb->imem == NULL);
+
+  taosThreadRwlockWrlock(&pTsdb->rwLock);
+  pTsdb->imem = pTsdb->mem;
+  pTsdb->mem = NULL;
+  taosThreadRwlockUnlock(&pTsdb->rwLock);
+
+  return 0;
+}
+
+int32_t tsdbCommit(STsdb *pTsdb, SCommitInfo *pInfo) {
   if (!pTsdb) return 0;
 
   int32_t    code = 0;
   SCommitter commith;
-  SMemTable *pMemTable = pTsdb->mem;
+  SMemTable *pMemTable = pTsdb->imem;
 
   // check
   if (pMemTable->nRow == 0 && pMemTable->nDel == 0) {
     taosThreadRwlockWrlock(&pTsdb->rwLock);
-    pTsdb->mem = NULL;
+    pTsdb->imem = NULL;
     taosThreadRwlockUnlock(&pTsdb->rwLock);
 
     tsdbUnrefMemTable(pMemTable);
@@ -163,7 +198,7 @@ int32_t tsdbCommit(STsdb *pTsdb) {
   }
 
   // start commit
-  code = tsdbStartCommit(pTsdb, &commith);
+  code = tsdbStartCommit(pTsdb, &commith, pInfo);
   if (code) goto _err;
 
   // commit impl
@@ -474,7 +509,7 @@ static int32_t tsdbCommitFileDataStart(SCommitter *pCommitter) {
   SDFileSet *pRSet = NULL;
 
   // memory
-  pCommitter->commitFid = tsdbKeyFid(pCommitter->nextKey, pCommitter->minutes, pCommitter->precision);
+  pCommitter->commitFid = pCommitter->pFSet->fid;
   tsdbFidKeyRange(pCommitter->commitFid, pCommitter->minutes, pCommitter->precision, &pCommitter->minKey,
                   &pCommitter->maxKey);
   pCommitter->nextKey = TSKEY_MAX;
@@ -644,6 +679,22 @@ _err:
   return code;
 }
 
+static void tsdbCommitKeepFSet(SCommitFSet *pFSet, const SDFileSet *pSet) {
+  pFSet->fHead = *pSet->pHeadF;
+  pFSet->fData = *pSet->pDataF;
+  pFSet->fSma = *pSet->pSmaF;
+  pFSet->wSet = (SDFileSet){.diskId = pSet->diskId,
+                            .fid = pSet->fid,
+                            .pHeadF = &pFSet->fHead,
+                            .pDataF = &pFSet->fData,
+                            .pSmaF = &pFSet->fSma,
+                            .nSttF = pSet->nSttF};
+  for (int32_t iStt = 0; iStt < pSet->nSttF; iStt++) {
+    pFSet->aSttF[iStt] = *pSet->aSttF[iStt];
+    pFSet->wSet.aSttF[iStt] = &pFSet->aSttF[iStt];
+  }
+}
+
 static int32_t tsdbCommitFileDataEnd(SCommitter *pCommitter) {
   int32_t code = 0;
 
@@ -659,9 +710,8 @@ static int32_t tsdbCommitFileDataEnd(SCommitter *pCommitter) {
   code = tsdbUpdateDFileSetHeader(pCommitter->dWriter.pWriter);
   if (code) goto _err;
 
-  // upsert SDFileSet
-  code = tsdbFSUpsertFSet(&pCommitter->fs, &pCommitter->dWriter.pWriter->wSet);
-  if (code) goto _err;
+  // keep SDFileSet
+  tsdbCommitKeepFSet(pCommitter->pFSet, &pCommitter->dWriter.pWriter->wSet);
 
   // close and sync
   code = tsdbDataFWriterClose(&pCommitter->dWriter.pWriter, 1);
@@ -732,19 +782,14 @@ _err:
 }
 
 // ----------------------------------------------------------------------------
-static int32_t tsdbStartCommit(STsdb *pTsdb, SCommitter *pCommitter) {
+static int32_t tsdbStartCommit(STsdb *pTsdb, SCommitter *pCommitter, SCommitInfo *pInfo) {
   int32_t code = 0;
 
   memset(pCommitter, 0, sizeof(*pCommitter));
-  ASSERT(pTsdb->mem && pTsdb->imem == NULL);
-
-  taosThreadRwlockWrlock(&pTsdb->rwLock);
-  pTsdb->imem = pTsdb->mem;
-  pTsdb->mem = NULL;
-  taosThreadRwlockUnlock(&pTsdb->rwLock);
+  ASSERT(pTsdb->imem);
 
   pCommitter->pTsdb = pTsdb;
-  pCommitter->commitID = pTsdb->pVnode->state.commitID;
+  pCommitter->commitID = pInfo->info.state.commitID;
   pCommitter->minutes = pTsdb->keepCfg.days;
   pCommitter->precision = pTsdb->keepCfg.precision;
   pCommitter->minRow = pTsdb->pVnode->config.tsdbCfg.minRows;
@@ -838,34 +883,174 @@ static void tsdbCommitDataEnd(SCommitter *pCommitter) {
   tTSchemaDestroy(pCommitter->skmRow.pTSchema);
 }
 
+// find the file sets the mem table spans, in fid order
+static int32_t tsdbCommitCollectFSet(SCommitter *pCommitter, SMemTable *pMemTable) {
+  int32_t code = 0;
+  TSKEY   nextKey = pMemTable->minKey;
+
+  while (nextKey < TSKEY_MAX) {
+    SCommitFSet fSet = {.fid = tsdbKeyFid(nextKey, pCommitter->minutes, pCommitter->precision)};
+    TSKEY       minKey, maxKey;
+
+    if (taosArrayPush(pCommitter->aFSet, &fSet) == NULL) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      goto _exit;
+    }
+
+    tsdbFidKeyRange(fSet.fid, pCommitter->minutes, pCommitter->precision, &minKey, &maxKey);
+    if (maxKey >= TSKEY_MAX) break;
+
+    nextKey = TSKEY_MAX;
+    TSDBKEY tKey = {.ts = maxKey + 1, .version = VERSION_MIN};
+    for (int32_t iTbData = 0; iTbData < taosArrayGetSize(pCommitter->aTbDataP); iTbData++) {
+      STbDataIter iter;
+      tsdbTbDataIterOpen((STbData *)taosArrayGetP(pCommitter->aTbDataP, iTbData), &tKey, 0, &iter);
+      TSDBROW *pRow = tsdbTbDataIterGet(&iter);
+      if (pRow) nextKey = TMIN(nextKey, TSDBROW_TS(pRow));
+    }
+  }
+
+_exit:
+  return code;
+}
+
+// commit workers shared by all vnodes, so no thread is created per commit
+static void *tsdbCommitQHandle = NULL;
+
+int32_t tsdbInit() {
+  tsdbCommitQHandle = taosInitScheduler(TSDB_COMMIT_QUEUE_SIZE, TMAX(tsNumOfCommitThreads, 1), "tsdb", NULL);
+  if (tsdbCommitQHandle == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return -1;
+  }
+  return 0;
+}
+
+void tsdbCleanUp() {
+  if (tsdbCommitQHandle) {
+    taosCleanUpScheduler(tsdbCommitQHandle);
+    taosMemoryFreeClear(tsdbCommitQHandle);
+  }
+}
+
+static void tsdbCommitFileDataLoop(SCommitter *pCommitter) {
+  SCommitter *pParent = pCommitter->pParent;
+
+  while (atomic_load_32(&pParent->fsetCode) == 0) {
+    int32_t iFSet = atomic_fetch_add_32(&pParent->iFSet, 1);
+    if (iFSet >= taosArrayGetSize(pParent->aFSet)) break;
+
+    pCommitter->pFSet = (SCommitFSet *)taosArrayGet(pParent->aFSet, iFSet);
+    int32_t code = tsdbCommitFileData(pCommitter);
+    if (code) {
+      atomic_val_compare_exchange_32(&pParent->fsetCode, 0, code);
+    }
+  }
+}
+
+static void tsdbCommitFileDataTask(SSchedMsg *pMsg) {
+  SCommitter *pCommitter = (SCommitter *)pMsg->ahandle;
+
+  tsdbCommitFileDataLoop(pCommitter);
+  tsem_post(&pCommitter->pParent->workerSem);
+}
+
 static int32_t tsdbCommitData(SCommitter *pCommitter) {
-  int32_t    code = 0;
-  STsdb     *pTsdb = pCommitter->pTsdb;
-  SMemTable *pMemTable = pTsdb->imem;
+  int32_t     code = 0;
+  STsdb      *pTsdb = pCommitter->pTsdb;
+  SMemTable  *pMemTable = pTsdb->imem;
+  SCommitter *aCommitter = NULL;
+  int32_t     nCommitter = 0;
+  int32_t     nWorker = 0;
 
   // check
   if (pMemTable->nRow == 0) goto _exit;
 
-  // start ====================
-  code = tsdbCommitDataStart(pCommitter);
+  pCommitter->aFSet = taosArrayInit(0, sizeof(SCommitFSet));
+  if (pCommitter->aFSet == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _err;
+  }
+
+  code = tsdbCommitCollectFSet(pCommitter, pMemTable);
   if (code) goto _err;
 
+  // start ====================
+  // file sets do not share files, so each committer merges its own and only reads the fs copy
+  nCommitter = TMIN(taosArrayGetSize(pCommitter->aFSet), TMAX(tsNumOfCommitThreads, 1));
+  aCommitter = (SCommitter *)taosMemoryCalloc(nCommitter, sizeof(SCommitter));
+  if (aCommitter == NULL) {
+    nCommitter = 0;
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _err;
+  }
+
+  for (int32_t iCommitter = 0; iCommitter < nCommitter; iCommitter++) {
+    SCommitter *pSub = &aCommitter[iCommitter];
+
+    pSub->pTsdb = pTsdb;
+    pSub->commitID = pCommitter->commitID;
+    pSub->minutes = pCommitter->minutes;
+    pSub->precision = pCommitter->precision;
+    pSub->minRow = pCommitter->minRow;
+    pSub->maxRow = pCommitter->maxRow;
+    pSub->cmprAlg = pCommitter->cmprAlg;
+    pSub->sttTrigger = pCommitter->sttTrigger;
+    pSub->aTbDataP = pCommitter->aTbDataP;
+    pSub->fs = pCommitter->fs;
+    pSub->pParent = pCommitter;
+
+    code = tsdbCommitDataStart(pSub);
+    if (code) {
+      nCommitter = iCommitter + 1;
+      goto _err;
+    }
+  }
+
   // impl ====================
-  pCommitter->nextKey = pMemTable->minKey;
-  while (pCommitter->nextKey < TSKEY_MAX) {
-    code = tsdbCommitFileData(pCommitter);
-    if (code) goto _err;
+  // this thread is the first committer, the others are drawn from the commit workers
+  tsem_init(&pCommitter->workerSem, 0, 0);
+  for (int32_t iCommitter = 1; iCommitter < nCommitter; iCommitter++) {
+    SSchedMsg schedMsg = {.fp = tsdbCommitFileDataTask, .ahandle = &aCommitter[iCommitter]};
+    if (taosScheduleTask(tsdbCommitQHandle, &schedMsg) != 0) break;
+    nWorker++;
+  }
+  tsdbCommitFileDataLoop(&aCommitter[0]);
+  for (int32_t iWorker = 0; iWorker < nWorker; iWorker++) {
+    tsem_wait(&pCommitter->workerSem);
   }
+  tsem_destroy(&pCommitter->workerSem);
+
+  code = pCommitter->fsetCode;
+  if (code) goto _err;
 
   // end ====================
-  tsdbCommitDataEnd(pCommitter);
+  for (int32_t iFSet = 0; iFSet < taosArrayGetSize(pCommitter->aFSet); iFSet++) {
+    SCommitFSet *pFSet = (SCommitFSet *)taosArrayGet(pCommitter->aFSet, iFSet);
+    code = tsdbFSUpsertFSet(&pCommitter->fs, &pFSet->wSet);
+    if (code) goto _err;
+  }
+
+  for (int32_t iCommitter = 0; iCommitter < nCommitter; iCommitter++) {
+    tsdbCommitDataEnd(&aCommitter[iCommitter]);
+  }
 
 _exit:
+  taosMemoryFree(aCommitter);
+  taosArrayDestroy(pCommitter->aFSet);
+  pCommitter->aFSet = NULL;
   tsdbInfo("vgId:%d, commit data done, nRow:%" PRId64, TD_VID(pTsdb->pVnode), pMemTable->nRow);
   return code;
 
 _err:
-  tsdbCommitDataEnd(pCommitter);
+  if (pCommitter->fsetCode == 0) pCommitter->fsetCode = code;
+  code = pCommitter->fsetCode;
+  for (int32_t iCommitter = 0; iCommitter < nCommitter; iCommitter++) {
+    tsdbCommitDataEnd(&aCommitter[iCommitter]);
+  }
+  taosMemoryFree(aCommitter);
+  taosArrayDestroy(pCommitter->aFSet);
+  pCommitter->aFSet = NULL;
   tsdbError("vgId:%d, commit data failed since %s", TD_VID(pTsdb->pVnode), tstrerror(code));
   return code;
 }
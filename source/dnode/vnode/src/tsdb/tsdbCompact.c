@@ -15,13 +15,723 @@
 
 #include "tsdb.h"
 
+typedef enum { COMPACT_DATA_FILE_ITER = 0, COMPACT_STT_FILE_ITER } ECompactIterT;
+
+typedef struct {
+  SRBTreeNode   n;
+  SRowInfo      rInfo;
+  ECompactIterT type;
+  union {
+    struct {
+      SArray    *aBlockIdx;  // SArray<SBlockIdx>
+      int32_t    iBlockIdx;
+      SBlockIdx *pBlockIdx;
+      SMapData   mDataBlk;  // SMapData<SDataBlk>
+      int32_t    iDataBlk;
+    };  // .data file
+    struct {
+      int32_t iStt;
+      SArray *aSttBlk;  // SArray<SSttBlk>
+      int32_t iSttBlk;
+    };  // .stt file
+  };
+  SBlockData bData;
+  int32_t    iRow;
+} SCompactIter;
+
 typedef struct {
   STsdb  *pTsdb;
+  int64_t commitID;
+  int8_t  cmprAlg;
+  int32_t minRow;
+  int32_t maxRow;
   STsdbFS fs;
+  int32_t fid;
+  // reader
+  SDataFReader *pReader;
+  SCompactIter *pIter;
+  SRBTree       rbt;
+  SCompactIter  aIter[TSDB_MAX_STT_TRIGGER + 1];
+  // del
+  SDelFReader *pDelFReader;
+  SArray      *aDelIdx;   // SArray<SDelIdx>
+  SArray      *aDelData;  // SArray<SDelData>
+  SArray      *aSkyline;  // SArray<TSDBKEY>
+  int32_t      iSkyline;
+  // writer
+  SDataFWriter *pWriter;
+  SArray       *aBlockIdx;  // SArray<SBlockIdx>
+  SArray       *aSttBlk;    // SArray<SSttBlk>
+  SMapData      mDataBlk;   // SMapData<SDataBlk>
+  SBlockData    bData;
+  SBlockData    bDataM;  // bData with duplicate keys merged
+  SBlockData    sData;
+  SSkmInfo      skmTable;
 } STsdbCompactor;
 
-int32_t tsdbCompact(STsdb *pTsdb) {
+extern int32_t tRowInfoCmprFn(const void *p1, const void *p2);
+extern int32_t tsdbReadDataBlockEx(SDataFReader *pReader, SDataBlk *pDataBlk, SBlockData *pBlockData);
+extern int32_t tsdbUpdateTableSchema(SMeta *pMeta, int64_t suid, int64_t uid, SSkmInfo *pSkmInfo);
+extern int32_t tsdbWriteDataBlock(SDataFWriter *pWriter, SBlockData *pBlockData, SMapData *mDataBlk, int8_t cmprAlg);
+extern int32_t tsdbWriteSttBlock(SDataFWriter *pWriter, SBlockData *pBlockData, SArray *aSttBlk, int8_t cmprAlg);
+
+// a file set is worth compacting when readers have to merge several overlapping .stt files for it: either it
+// is no longer the file set taking new writes, or it holds at least half of the .stt files a commit tolerates
+static bool tsdbFSetShouldCompact(SDFileSet *pSet, int32_t maxFid, int8_t sttTrigger) {
+  if (pSet->nSttF <= 1) return false;
+  if (pSet->fid < maxFid) return true;
+  return pSet->nSttF >= TMAX(sttTrigger / 2, 2);
+}
+
+static SDFileSet *tsdbCompactPickFSet(STsdbFS *pFS, int8_t sttTrigger) {
+  SDFileSet *pSetPick = NULL;
+  int32_t    nSet = taosArrayGetSize(pFS->aDFileSet);
+
+  if (nSet == 0) return NULL;
+
+  int32_t maxFid = ((SDFileSet *)taosArrayGet(pFS->aDFileSet, nSet - 1))->fid;
+  for (int32_t iSet = 0; iSet < nSet; iSet++) {
+    SDFileSet *pSet = (SDFileSet *)taosArrayGet(pFS->aDFileSet, iSet);
+
+    if (!tsdbFSetShouldCompact(pSet, maxFid, sttTrigger)) continue;
+    if (pSetPick == NULL || pSet->nSttF > pSetPick->nSttF) {
+      pSetPick = pSet;
+    }
+  }
+
+  return pSetPick;
+}
+
+bool tsdbShouldCompact(STsdb *pTsdb) {
+  if (pTsdb == NULL) return false;
+  return tsdbCompactPickFSet(&pTsdb->fs, pTsdb->pVnode->config.sttTrigger) != NULL;
+}
+
+// compactor ==============================================================================================
+static int32_t tsdbCompactorOpen(STsdb *pTsdb, int64_t commitID, STsdbCompactor *pCompactor) {
+  int32_t code = 0;
+  int32_t lino = 0;
+
+  memset(pCompactor, 0, sizeof(*pCompactor));
+  pCompactor->pTsdb = pTsdb;
+  pCompactor->commitID = commitID;
+  pCompactor->cmprAlg = pTsdb->pVnode->config.tsdbCfg.compression;
+  pCompactor->minRow = pTsdb->pVnode->config.tsdbCfg.minRows;
+  pCompactor->maxRow = pTsdb->pVnode->config.tsdbCfg.maxRows;
+
+  code = tsdbFSCopy(pTsdb, &pCompactor->fs);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  // reader
+  pCompactor->aIter[0].aBlockIdx = taosArrayInit(0, sizeof(SBlockIdx));
+  if (pCompactor->aIter[0].aBlockIdx == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+  for (int32_t iIter = 0; iIter < TSDB_MAX_STT_TRIGGER + 1; iIter++) {
+    if (iIter > 0) {
+      pCompactor->aIter[iIter].aSttBlk = taosArrayInit(0, sizeof(SSttBlk));
+      if (pCompactor->aIter[iIter].aSttBlk == NULL) {
+        code = TSDB_CODE_OUT_OF_MEMORY;
+        TSDB_CHECK_CODE(code, lino, _exit);
+      }
+    }
+
+    code = tBlockDataCreate(&pCompactor->aIter[iIter].bData);
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+  // del
+  pCompactor->aDelIdx = taosArrayInit(0, sizeof(SDelIdx));
+  pCompactor->aDelData = taosArrayInit(0, sizeof(SDelData));
+  pCompactor->aSkyline = taosArrayInit(0, sizeof(TSDBKEY));
+  if (pCompactor->aDelIdx == NULL || pCompactor->aDelData == NULL || pCompactor->aSkyline == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+  if (pCompactor->fs.pDelFile) {
+    code = tsdbDelFReaderOpen(&pCompactor->pDelFReader, pCompactor->fs.pDelFile, pTsdb);
+    TSDB_CHECK_CODE(code, lino, _exit);
+
+    code = tsdbReadDelIdx(pCompactor->pDelFReader, pCompactor->aDelIdx);
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+  // writer
+  pCompactor->aBlockIdx = taosArrayInit(0, sizeof(SBlockIdx));
+  pCompactor->aSttBlk = taosArrayInit(0, sizeof(SSttBlk));
+  if (pCompactor->aBlockIdx == NULL || pCompactor->aSttBlk == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+  code = tBlockDataCreate(&pCompactor->bData);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  code = tBlockDataCreate(&pCompactor->bDataM);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  code = tBlockDataCreate(&pCompactor->sData);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+_exit:
+  if (code) {
+    tsdbError("vgId:%d %s failed at %d since %s", TD_VID(pTsdb->pVnode), __func__, lino, tstrerror(code));
+  }
+  return code;
+}
+
+static void tsdbCompactorClose(STsdbCompactor *pCompactor) {
+  tsdbDataFReaderClose(&pCompactor->pReader);
+  tsdbDataFWriterClose(&pCompactor->pWriter, 0);
+  tsdbDelFReaderClose(&pCompactor->pDelFReader);
+
+  // reader
+  taosArrayDestroy(pCompactor->aIter[0].aBlockIdx);
+  tMapDataClear(&pCompactor->aIter[0].mDataBlk);
+  for (int32_t iIter = 0; iIter < TSDB_MAX_STT_TRIGGER + 1; iIter++) {
+    if (iIter > 0) taosArrayDestroy(pCompactor->aIter[iIter].aSttBlk);
+    tBlockDataDestroy(&pCompactor->aIter[iIter].bData, 1);
+  }
+
+  // del
+  taosArrayDestroy(pCompactor->aDelIdx);
+  taosArrayDestroy(pCompactor->aDelData);
+  taosArrayDestroy(pCompactor->aSkyline);
+
+  // writer
+  taosArrayDestroy(pCompactor->aBlockIdx);
+  taosArrayDestroy(pCompactor->aSttBlk);
+  tMapDataClear(&pCompactor->mDataBlk);
+  tBlockDataDestroy(&pCompactor->bData, 1);
+  tBlockDataDestroy(&pCompactor->bDataM, 1);
+  tBlockDataDestroy(&pCompactor->sData, 1);
+  tTSchemaDestroy(pCompactor->skmTable.pTSchema);
+
+  tsdbFSDestroy(&pCompactor->fs);
+}
+
+// merge iterator over .data and all .stt files of a file set ==============================================
+static int32_t tsdbCompactIterFindRow(STsdbCompactor *pCompactor, SCompactIter *pIter, bool *hasRow) {
+  int32_t code = 0;
+  int32_t lino = 0;
+
+  *hasRow = false;
+  while (true) {
+    if (pIter->iRow < pIter->bData.nRow) {
+      pIter->rInfo.suid = pIter->bData.suid;
+      pIter->rInfo.uid = pIter->bData.uid ? pIter->bData.uid : pIter->bData.aUid[pIter->iRow];
+      pIter->rInfo.row = tsdbRowFromBlockData(&pIter->bData, pIter->iRow);
+      *hasRow = true;
+      break;
+    }
+
+    if (pIter->type == COMPACT_DATA_FILE_ITER) {
+      pIter->iDataBlk++;
+      while (pIter->iDataBlk >= pIter->mDataBlk.nItem && pIter->iBlockIdx + 1 < taosArrayGetSize(pIter->aBlockIdx)) {
+        pIter->iBlockIdx++;
+        pIter->pBlockIdx = (SBlockIdx *)taosArrayGet(pIter->aBlockIdx, pIter->iBlockIdx);
+        code = tsdbReadDataBlk(pCompactor->pReader, pIter->pBlockIdx, &pIter->mDataBlk);
+        TSDB_CHECK_CODE(code, lino, _exit);
+        pIter->iDataBlk = 0;
+      }
+      if (pIter->iDataBlk >= pIter->mDataBlk.nItem) break;
+
+      SDataBlk dataBlk;
+      tMapDataGetItemByIdx(&pIter->mDataBlk, pIter->iDataBlk, &dataBlk, tGetDataBlk);
+      code = tsdbReadDataBlockEx(pCompactor->pReader, &dataBlk, &pIter->bData);
+      TSDB_CHECK_CODE(code, lino, _exit);
+    } else {
+      pIter->iSttBlk++;
+      if (pIter->iSttBlk >= taosArrayGetSize(pIter->aSttBlk)) break;
+
+      SSttBlk *pSttBlk = (SSttBlk *)taosArrayGet(pIter->aSttBlk, pIter->iSttBlk);
+      code = tsdbReadSttBlockEx(pCompactor->pReader, pIter->iStt, pSttBlk, &pIter->bData);
+      TSDB_CHECK_CODE(code, lino, _exit);
+    }
+    pIter->iRow = 0;
+  }
+
+_exit:
+  if (code) {
+    tsdbError("vgId:%d %s failed at %d since %s", TD_VID(pCompactor->pTsdb->pVnode), __func__, lino, tstrerror(code));
+  }
+  return code;
+}
+
+static int32_t tsdbCompactOpenIter(STsdbCompactor *pCompactor, SDFileSet *pSet) {
+  int32_t code = 0;
+  int32_t lino = 0;
+  bool    hasRow;
+
+  pCompactor->pIter = NULL;
+  tRBTreeCreate(&pCompactor->rbt, tRowInfoCmprFn);
+
+  // .data file
+  SCompactIter *pIter = &pCompactor->aIter[0];
+  pIter->type = COMPACT_DATA_FILE_ITER;
+  code = tsdbReadBlockIdx(pCompactor->pReader, pIter->aBlockIdx);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  tBlockDataReset(&pIter->bData);
+  pIter->iRow = 0;
+  pIter->iBlockIdx = -1;
+  pIter->pBlockIdx = NULL;
+  tMapDataReset(&pIter->mDataBlk);
+  pIter->iDataBlk = -1;
+  code = tsdbCompactIterFindRow(pCompactor, pIter, &hasRow);
+  TSDB_CHECK_CODE(code, lino, _exit);
+  if (hasRow) tRBTreePut(&pCompactor->rbt, (SRBTreeNode *)pIter);
+
+  // .stt files
+  pIter = &pCompactor->aIter[1];
+  for (int32_t iStt = 0; iStt < pSet->nSttF; iStt++) {
+    pIter->type = COMPACT_STT_FILE_ITER;
+    pIter->iStt = iStt;
+    code = tsdbReadSttBlk(pCompactor->pReader, iStt, pIter->aSttBlk);
+    TSDB_CHECK_CODE(code, lino, _exit);
+
+    tBlockDataReset(&pIter->bData);
+    pIter->iRow = 0;
+    pIter->iSttBlk = -1;
+    code = tsdbCompactIterFindRow(pCompactor, pIter, &hasRow);
+    TSDB_CHECK_CODE(code, lino, _exit);
+    if (hasRow) {
+      tRBTreePut(&pCompactor->rbt, (SRBTreeNode *)pIter);
+      pIter++;
+    }
+  }
+
+  pCompactor->pIter = (SCompactIter *)tRBTreeMin(&pCompactor->rbt);
+  if (pCompactor->pIter) {
+    tRBTreeDrop(&pCompactor->rbt, (SRBTreeNode *)pCompactor->pIter);
+  }
+
+_exit:
+  if (code) {
+    tsdbError("vgId:%d %s failed at %d since %s", TD_VID(pCompactor->pTsdb->pVnode), __func__, lino, tstrerror(code));
+  }
+  return code;
+}
+
+static FORCE_INLINE SRowInfo *tsdbCompactGetRow(STsdbCompactor *pCompactor) {
+  return pCompactor->pIter ? &pCompactor->pIter->rInfo : NULL;
+}
+
+static int32_t tsdbCompactNextRow(STsdbCompactor *pCompactor) {
+  int32_t code = 0;
+  bool    hasRow;
+
+  if (pCompactor->pIter) {
+    SCompactIter *pIter = pCompactor->pIter;
+
+    pIter->iRow++;
+    code = tsdbCompactIterFindRow(pCompactor, pIter, &hasRow);
+    if (code) return code;
+    if (!hasRow) pCompactor->pIter = NULL;
+
+    pIter = (SCompactIter *)tRBTreeMin(&pCompactor->rbt);
+    if (pCompactor->pIter && pIter) {
+      int32_t c = tRowInfoCmprFn(&pCompactor->pIter->rInfo, &pIter->rInfo);
+      if (c > 0) {
+        tRBTreePut(&pCompactor->rbt, (SRBTreeNode *)pCompactor->pIter);
+        pCompactor->pIter = NULL;
+      } else if (c == 0) {
+        // the same row in two files, the file set is broken and is left as it is
+        return TSDB_CODE_FILE_CORRUPTED;
+      }
+    }
+  }
+
+  if (pCompactor->pIter == NULL) {
+    pCompactor->pIter = (SCompactIter *)tRBTreeMin(&pCompactor->rbt);
+    if (pCompactor->pIter) {
+      tRBTreeDrop(&pCompactor->rbt, (SRBTreeNode *)pCompactor->pIter);
+    }
+  }
+
+  return code;
+}
+
+// delete skyline ==========================================================================================
+static int32_t tsdbCompactLoadSkyline(STsdbCompactor *pCompactor, TABLEID *pId) {
+  int32_t code = 0;
+
+  taosArrayClear(pCompactor->aSkyline);
+  pCompactor->iSkyline = 0;
+
+  SDelIdx  delIdx = {.suid = pId->suid, .uid = pId->uid};
+  SDelIdx *pDelIdx = (SDelIdx *)taosArraySearch(pCompactor->aDelIdx, &delIdx, tCmprDelIdx, TD_EQ);
+  if (pDelIdx == NULL) return code;
+
+  code = tsdbReadDelData(pCompactor->pDelFReader, pDelIdx, pCompactor->aDelData);
+  if (code) return code;
+
+  int32_t nDelData = taosArrayGetSize(pCompactor->aDelData);
+  if (nDelData > 0) {
+    code = tsdbBuildDeleteSkyline(pCompactor->aDelData, 0, nDelData - 1, pCompactor->aSkyline);
+  }
+
+  return code;
+}
+
+// rows of a table come in ascending key order, so the skyline is only walked forward
+static bool tsdbCompactRowIsDeleted(STsdbCompactor *pCompactor, TSDBKEY *pKey) {
+  SArray *aSkyline = pCompactor->aSkyline;
+  int32_t nSkyline = taosArrayGetSize(aSkyline);
+
+  while (pCompactor->iSkyline + 1 < nSkyline &&
+         ((TSDBKEY *)taosArrayGet(aSkyline, pCompactor->iSkyline + 1))->ts < pKey->ts) {
+    pCompactor->iSkyline++;
+  }
+
+  for (int32_t iSkyline = pCompactor->iSkyline; iSkyline + 1 < nSkyline; iSkyline++) {
+    TSDBKEY *pKey1 = (TSDBKEY *)taosArrayGet(aSkyline, iSkyline);
+    TSDBKEY *pKey2 = (TSDBKEY *)taosArrayGet(aSkyline, iSkyline + 1);
+
+    if (pKey1->ts > pKey->ts) break;
+    if (pKey2->ts >= pKey->ts && pKey1->version >= pKey->version) return true;
+  }
+
+  return false;
+}
+
+// writer ==================================================================================================
+static int32_t tsdbCompactMergeDupRows(STsdbCompactor *pCompactor, SBlockData **ppBlockData) {
+  int32_t     code = 0;
+  int32_t     lino = 0;
+  SBlockData *pBData = &pCompactor->bData;
+  SBlockData *pBDataM = &pCompactor->bDataM;
+  STSchema   *pTSchema = pCompactor->skmTable.pTSchema;
+  TABLEID     id = {.suid = pBData->suid, .uid = pBData->uid};
+
+  *ppBlockData = pBData;
+
+  int32_t iRow = 1;
+  for (; iRow < pBData->nRow; iRow++) {
+    if (pBData->aTSKEY[iRow] == pBData->aTSKEY[iRow - 1]) break;
+  }
+  if (iRow >= pBData->nRow) goto _exit;
+
+  code = tBlockDataInit(pBDataM, &id, pTSchema, NULL, 0);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  for (iRow = 0; iRow < pBData->nRow;) {
+    int32_t jRow = iRow + 1;
+    while (jRow < pBData->nRow && pBData->aTSKEY[jRow] == pBData->aTSKEY[iRow]) jRow++;
+
+    TSDBROW row = tsdbRowFromBlockData(pBData, iRow);
+    if (jRow - iRow == 1) {
+      code = tBlockDataAppendRow(pBDataM, &row, NULL, id.uid);
+      TSDB_CHECK_CODE(code, lino, _exit);
+    } else {
+      SRowMerger merger = {0};
+      STSRow    *pTSRow = NULL;
+
+      code = tRowMergerInit2(&merger, pTSchema, &row, pTSchema);
+      for (int32_t kRow = iRow + 1; code == 0 && kRow < jRow; kRow++) {
+        row = tsdbRowFromBlockData(pBData, kRow);
+        code = tRowMergerAdd(&merger, &row, pTSchema);
+      }
+      if (code == 0) code = tRowMergerGetRow(&merger, &pTSRow);
+      tRowMergerClear(&merger);
+      TSDB_CHECK_CODE(code, lino, _exit);
+
+      row = tsdbRowFromTSRow(pBData->aVersion[jRow - 1], pTSRow);
+      code = tBlockDataAppendRow(pBDataM, &row, pTSchema, id.uid);
+      taosMemoryFree(pTSRow);
+      TSDB_CHECK_CODE(code, lino, _exit);
+    }
+
+    iRow = jRow;
+  }
+
+  tBlockDataClear(pBData);
+  *ppBlockData = pBDataM;
+
+_exit:
+  if (code) {
+    tsdbError("vgId:%d %s failed at %d since %s", TD_VID(pCompactor->pTsdb->pVnode), __func__, lino, tstrerror(code));
+  }
+  return code;
+}
+
+static int32_t tsdbCompactWriteSttRows(STsdbCompactor *pCompactor, SBlockData *pBData) {
+  int32_t     code = 0;
+  int32_t     lino = 0;
+  SBlockData *pSData = &pCompactor->sData;
+  TABLEID     id = {.suid = pBData->suid, .uid = pBData->uid};
+
+  if (pSData->suid || pSData->uid) {
+    if (pSData->suid != id.suid || id.suid == 0) {
+      code = tsdbWriteSttBlock(pCompactor->pWriter, pSData, pCompactor->aSttBlk, pCompactor->cmprAlg);
+      TSDB_CHECK_CODE(code, lino, _exit);
+      tBlockDataReset(pSData);
+    }
+  }
+
+  if (!pSData->suid && !pSData->uid) {
+    TABLEID tid = {.suid = id.suid, .uid = id.suid ? 0 : id.uid};
+    code = tBlockDataInit(pSData, &tid, pCompactor->skmTable.pTSchema, NULL, 0);
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+  for (int32_t iRow = 0; iRow < pBData->nRow; iRow++) {
+    TSDBROW row = tsdbRowFromBlockData(pBData, iRow);
+    code = tBlockDataAppendRow(pSData, &row, NULL, id.uid);
+    TSDB_CHECK_CODE(code, lino, _exit);
+
+    if (pSData->nRow >= pCompactor->maxRow) {
+      code = tsdbWriteSttBlock(pCompactor->pWriter, pSData, pCompactor->aSttBlk, pCompactor->cmprAlg);
+      TSDB_CHECK_CODE(code, lino, _exit);
+    }
+  }
+  tBlockDataClear(pBData);
+
+_exit:
+  if (code) {
+    tsdbError("vgId:%d %s failed at %d since %s", TD_VID(pCompactor->pTsdb->pVnode), __func__, lino, tstrerror(code));
+  }
+  return code;
+}
+
+static int32_t tsdbCompactFlushTableRows(STsdbCompactor *pCompactor, bool tableEnd) {
+  int32_t     code = 0;
+  int32_t     lino = 0;
+  SBlockData *pBData;
+
+  if (pCompactor->bData.nRow == 0) return code;
+
+  code = tsdbCompactMergeDupRows(pCompactor, &pBData);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  if (tableEnd && pBData->nRow < pCompactor->minRow && pCompactor->mDataBlk.nItem == 0) {
+    // small tables go to the .stt file, as a commit would do
+    code = tsdbCompactWriteSttRows(pCompactor, pBData);
+    TSDB_CHECK_CODE(code, lino, _exit);
+  } else {
+    code = tsdbWriteDataBlock(pCompactor->pWriter, pBData, &pCompactor->mDataBlk, pCompactor->cmprAlg);
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+_exit:
+  if (code) {
+    tsdbError("vgId:%d %s failed at %d since %s", TD_VID(pCompactor->pTsdb->pVnode), __func__, lino, tstrerror(code));
+  }
+  return code;
+}
+
+static int32_t tsdbCompactTableData(STsdbCompactor *pCompactor, TABLEID id) {
+  int32_t   code = 0;
+  int32_t   lino = 0;
+  SRowInfo *pRowInfo = tsdbCompactGetRow(pCompactor);
+  SMetaInfo info;
+
+  // rows of dropped tables are not carried over
+  bool dropped = (metaGetInfo(pCompactor->pTsdb->pVnode->pMeta, id.uid, &info) != 0);
+
+  if (!dropped) {
+    code = tsdbUpdateTableSchema(pCompactor->pTsdb->pVnode->pMeta, id.suid, id.uid, &pCompactor->skmTable);
+    TSDB_CHECK_CODE(code, lino, _exit);
+
+    code = tBlockDataInit(&pCompactor->bData, &id, pCompactor->skmTable.pTSchema, NULL, 0);
+    TSDB_CHECK_CODE(code, lino, _exit);
+
+    code = tsdbCompactLoadSkyline(pCompactor, &id);
+    TSDB_CHECK_CODE(code, lino, _exit);
+
+    tMapDataReset(&pCompactor->mDataBlk);
+  }
+
+  while (pRowInfo && pRowInfo->suid == id.suid && pRowInfo->uid == id.uid) {
+    TSDBKEY key = TSDBROW_KEY(&pRowInfo->row);
+
+    if (!dropped && !tsdbCompactRowIsDeleted(pCompactor, &key)) {
+      SBlockData *pBData = &pCompactor->bData;
+
+      // never split rows of the same timestamp across blocks, they are merged into one before writing
+      if (pBData->nRow >= pCompactor->maxRow && pBData->aTSKEY[pBData->nRow - 1] != key.ts) {
+        code = tsdbCompactFlushTableRows(pCompactor, false);
+        TSDB_CHECK_CODE(code, lino, _exit);
+      }
+
+      code = tBlockDataAppendRow(pBData, &pRowInfo->row, NULL, id.uid);
+      TSDB_CHECK_CODE(code, lino, _exit);
+    }
+
+    code = tsdbCompactNextRow(pCompactor);
+    TSDB_CHECK_CODE(code, lino, _exit);
+    pRowInfo = tsdbCompactGetRow(pCompactor);
+  }
+
+  if (dropped) goto _exit;
+
+  code = tsdbCompactFlushTableRows(pCompactor, true);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  if (pCompactor->mDataBlk.nItem > 0) {
+    SBlockIdx blockIdx = {.suid = id.suid, .uid = id.uid};
+    code = tsdbWriteDataBlk(pCompactor->pWriter, &pCompactor->mDataBlk, &blockIdx);
+    TSDB_CHECK_CODE(code, lino, _exit);
+
+    if (taosArrayPush(pCompactor->aBlockIdx, &blockIdx) == NULL) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      TSDB_CHECK_CODE(code, lino, _exit);
+    }
+  }
+
+_exit:
+  if (code) {
+    tsdbError("vgId:%d %s failed at %d since %s", TD_VID(pCompactor->pTsdb->pVnode), __func__, lino, tstrerror(code));
+  }
+  return code;
+}
+
+// the files written by compaction all carry its own commit ID, so they can be removed without touching the file set
+// in use
+static void tsdbCompactRemoveFSet(STsdb *pTsdb, SDFileSet *pSet) {
+  char fname[TSDB_FILENAME_LEN];
+
+  tsdbHeadFileName(pTsdb, pSet->diskId, pSet->fid, pSet->pHeadF, fname);
+  taosRemoveFile(fname);
+  tsdbDataFileName(pTsdb, pSet->diskId, pSet->fid, pSet->pDataF, fname);
+  taosRemoveFile(fname);
+  tsdbSmaFileName(pTsdb, pSet->diskId, pSet->fid, pSet->pSmaF, fname);
+  taosRemoveFile(fname);
+  tsdbSttFileName(pTsdb, pSet->diskId, pSet->fid, pSet->aSttF[pSet->nSttF - 1], fname);
+  taosRemoveFile(fname);
+}
+
+static void tsdbCompactDropWriter(STsdbCompactor *pCompactor) {
+  SDataFWriter *pWriter = pCompactor->pWriter;
+  SHeadFile     fHead = *pWriter->wSet.pHeadF;
+  SDataFile     fData = *pWriter->wSet.pDataF;
+  SSmaFile      fSma = *pWriter->wSet.pSmaF;
+  SSttFile      fStt = *pWriter->wSet.aSttF[pWriter->wSet.nSttF - 1];
+  SDFileSet     wSet = {.diskId = pWriter->wSet.diskId,
+                        .fid = pWriter->wSet.fid,
+                        .pHeadF = &fHead,
+                        .pDataF = &fData,
+                        .pSmaF = &fSma,
+                        .nSttF = 1,
+                        .aSttF[0] = &fStt};
+
+  tsdbDataFWriterClose(&pCompactor->pWriter, 0);
+  tsdbCompactRemoveFSet(pCompactor->pTsdb, &wSet);
+}
+
+static int32_t tsdbCompactFileSet(STsdbCompactor *pCompactor, SDFileSet *pSet) {
   int32_t code = 0;
-  // TODO
+  int32_t lino = 0;
+  STsdb  *pTsdb = pCompactor->pTsdb;
+
+  pCompactor->fid = pSet->fid;
+
+  // reader
+  code = tsdbDataFReaderOpen(&pCompactor->pReader, pTsdb, pSet);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  code = tsdbCompactOpenIter(pCompactor, pSet);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  // writer, all files of the new file set carry the compaction commit ID
+  SHeadFile fHead = {.commitID = pCompactor->commitID};
+  SDataFile fData = {.commitID = pCompactor->commitID};
+  SSmaFile  fSma = {.commitID = pCompactor->commitID};
+  SSttFile  fStt = {.commitID = pCompactor->commitID};
+  SDFileSet wSet = {.diskId = pSet->diskId,
+                    .fid = pSet->fid,
+                    .pHeadF = &fHead,
+                    .pDataF = &fData,
+                    .pSmaF = &fSma,
+                    .nSttF = 1,
+                    .aSttF[0] = &fStt};
+  code = tsdbDataFWriterOpen(&pCompactor->pWriter, pTsdb, &wSet);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  taosArrayClear(pCompactor->aBlockIdx);
+  taosArrayClear(pCompactor->aSttBlk);
+  tBlockDataReset(&pCompactor->sData);
+
+  // merge
+  SRowInfo *pRowInfo;
+  while ((pRowInfo = tsdbCompactGetRow(pCompactor)) != NULL) {
+    TABLEID id = {.suid = pRowInfo->suid, .uid = pRowInfo->uid};
+    code = tsdbCompactTableData(pCompactor, id);
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+  code = tsdbWriteSttBlock(pCompactor->pWriter, &pCompactor->sData, pCompactor->aSttBlk, pCompactor->cmprAlg);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  // end
+  code = tsdbWriteBlockIdx(pCompactor->pWriter, pCompactor->aBlockIdx);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  code = tsdbWriteSttBlk(pCompactor->pWriter, pCompactor->aSttBlk);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  code = tsdbUpdateDFileSetHeader(pCompactor->pWriter);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  code = tsdbFSUpsertFSet(&pCompactor->fs, &pCompactor->pWriter->wSet);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  code = tsdbDataFWriterClose(&pCompactor->pWriter, 1);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  code = tsdbDataFReaderClose(&pCompactor->pReader);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+_exit:
+  if (code) {
+    tsdbError("vgId:%d %s failed at %d since %s", TD_VID(pTsdb->pVnode), __func__, lino, tstrerror(code));
+    if (pCompactor->pWriter) {
+      tsdbCompactDropWriter(pCompactor);
+    }
+  } else {
+    tsdbInfo("vgId:%d, tsdb compact file set done, fid:%d nStt:%d commit ID:%" PRId64, TD_VID(pTsdb->pVnode),
+             pSet->fid, pSet->nSttF, pCompactor->commitID);
+  }
+  return code;
+}
+
+int32_t tsdbCompact(STsdb *pTsdb, int64_t commitID) {
+  int32_t        code = 0;
+  int32_t        lino = 0;
+  STsdbCompactor compactor;
+
+  if (pTsdb == NULL) return code;
+
+  code = tsdbCompactorOpen(pTsdb, commitID, &compactor);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  // one file set per round to bound the time the next commit waits for it
+  SDFileSet *pSet = tsdbCompactPickFSet(&compactor.fs, pTsdb->pVnode->config.sttTrigger);
+  if (pSet == NULL) goto _exit;
+
+  int32_t fid = pSet->fid;
+  code = tsdbCompactFileSet(&compactor, pSet);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  // swap the file set
+  code = tsdbFSCommit1(pTsdb, &compactor.fs);
+  if (code) {
+    pSet = (SDFileSet *)taosArraySearch(compactor.fs.aDFileSet, &(SDFileSet){.fid = fid}, tDFileSetCmprFn, TD_EQ);
+    if (pSet) tsdbCompactRemoveFSet(pTsdb, pSet);
+  }
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  taosThreadRwlockWrlock(&pTsdb->rwLock);
+  code = tsdbFSCommit2(pTsdb, &compactor.fs);
+  taosThreadRwlockUnlock(&pTsdb->rwLock);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+_exit:
+  if (code) {
+    tsdbError("vgId:%d %s failed at %d since %s", TD_VID(pTsdb->pVnode), __func__, lino, tstrerror(code));
+  }
+  tsdbCompactorClose(&compactor);
   return code;
 }
@@ -71,6 +71,10 @@ int tsdbOpen(SVnode *pVnode, STsdb **ppTsdb, const char *dir, STsdbKeepCfg *pKee
     goto _err;
   }
 
+  if (tsdbOpenBlockCache(pTsdb) < 0) {
+    goto _err;
+  }
+
   tsdbDebug("vgId:%d, tsdb is opened at %s, days:%d, keep:%d,%d,%d", TD_VID(pVnode), pTsdb->path, pTsdb->keepCfg.days,
             pTsdb->keepCfg.keep0, pTsdb->keepCfg.keep1, pTsdb->keepCfg.keep2);
 
@@ -89,6 +93,7 @@ int tsdbClose(STsdb **pTsdb) {
     (*pTsdb)->mem = NULL;
     tsdbFSClose(*pTsdb);
     tsdbCloseCache(*pTsdb);
+    tsdbCloseBlockCache(*pTsdb);
     taosMemoryFreeClear(*pTsdb);
   }
   return 0;
@@ -607,100 +607,100 @@ _err:
   return code;
 }
 
-int32_t tsdbDFileSetCopy(STsdb *pTsdb, SDFileSet *pSetFrom, SDFileSet *pSetTo) {
+#define TSDB_COPY_STEP        (4 * 1024 * 1024)
+#define TSDB_COPY_SLEEP_SLICE 100
+
+// copy by sendfile in steps, and sleep between the steps to keep under the speed limit(bytes per second, 0 no limit).
+// Gives up once *stop is set
+static int32_t tsdbCopyFile(const char *fNameFrom, const char *fNameTo, int64_t size, int64_t speed,
+                            const int8_t *stop) {
   int32_t   code = 0;
-  int64_t   n;
-  int64_t   size;
   TdFilePtr pOutFD = NULL;
-  TdFilePtr PInFD = NULL;
-  int32_t   szPage = pTsdb->pVnode->config.szPage;
-  char      fNameFrom[TSDB_FILENAME_LEN];
-  char      fNameTo[TSDB_FILENAME_LEN];
+  TdFilePtr pInFD = NULL;
+  int64_t   st = taosGetTimestampMs();
 
-  // head
-  tsdbHeadFileName(pTsdb, pSetFrom->diskId, pSetFrom->fid, pSetFrom->pHeadF, fNameFrom);
-  tsdbHeadFileName(pTsdb, pSetTo->diskId, pSetTo->fid, pSetTo->pHeadF, fNameTo);
   pOutFD = taosOpenFile(fNameTo, TD_FILE_WRITE | TD_FILE_CREATE | TD_FILE_TRUNC);
   if (pOutFD == NULL) {
     code = TAOS_SYSTEM_ERROR(errno);
-    goto _err;
+    goto _exit;
   }
-  PInFD = taosOpenFile(fNameFrom, TD_FILE_READ);
-  if (PInFD == NULL) {
+  pInFD = taosOpenFile(fNameFrom, TD_FILE_READ);
+  if (pInFD == NULL) {
     code = TAOS_SYSTEM_ERROR(errno);
-    goto _err;
+    goto _exit;
   }
-  n = taosFSendFile(pOutFD, PInFD, 0, tsdbLogicToFileSize(pSetFrom->pHeadF->size, szPage));
-  if (n < 0) {
+
+  int64_t copied = 0;
+  while (copied < size) {
+    if (atomic_load_8(stop)) {
+      code = TSDB_CODE_VND_IS_CLOSING;
+      goto _exit;
+    }
+
+    int64_t offset = copied;
+    int64_t n = taosFSendFile(pOutFD, pInFD, &offset, TMIN(TSDB_COPY_STEP, size - copied));
+    if (n < 0) {
+      code = TAOS_SYSTEM_ERROR(errno);
+      goto _exit;
+    } else if (n == 0) {
+      break;
+    }
+    copied += n;
+
+    if (speed > 0) {
+      // sleep in slices, a step may take seconds under a low limit
+      int64_t expect = copied * 1000 / speed;
+      int64_t elapsed = taosGetTimestampMs() - st;
+      while (expect > elapsed && !atomic_load_8(stop)) {
+        taosMsleep(TMIN(expect - elapsed, TSDB_COPY_SLEEP_SLICE));
+        elapsed = taosGetTimestampMs() - st;
+      }
+    }
+  }
+
+  if (taosFsyncFile(pOutFD) < 0) {
     code = TAOS_SYSTEM_ERROR(errno);
-    goto _err;
+    goto _exit;
   }
+
+_exit:
   taosCloseFile(&pOutFD);
-  taosCloseFile(&PInFD);
+  taosCloseFile(&pInFD);
+  return code;
+}
+
+// stopped by closing the vnode
+int32_t tsdbDFileSetCopy(STsdb *pTsdb, SDFileSet *pSetFrom, SDFileSet *pSetTo, int64_t speed) {
+  int32_t       code = 0;
+  int32_t       szPage = pTsdb->pVnode->config.szPage;
+  const int8_t *stop = &pTsdb->pVnode->stopTrim;
+  char          fNameFrom[TSDB_FILENAME_LEN];
+  char          fNameTo[TSDB_FILENAME_LEN];
+
+  // head
+  tsdbHeadFileName(pTsdb, pSetFrom->diskId, pSetFrom->fid, pSetFrom->pHeadF, fNameFrom);
+  tsdbHeadFileName(pTsdb, pSetTo->diskId, pSetTo->fid, pSetTo->pHeadF, fNameTo);
+  code = tsdbCopyFile(fNameFrom, fNameTo, tsdbLogicToFileSize(pSetFrom->pHeadF->size, szPage), speed, stop);
+  if (code) goto _err;
 
   // data
   tsdbDataFileName(pTsdb, pSetFrom->diskId, pSetFrom->fid, pSetFrom->pDataF, fNameFrom);
   tsdbDataFileName(pTsdb, pSetTo->diskId, pSetTo->fid, pSetTo->pDataF, fNameTo);
-  pOutFD = taosOpenFile(fNameTo, TD_FILE_WRITE | TD_FILE_CREATE | TD_FILE_TRUNC);
-  if (pOutFD == NULL) {
-    code = TAOS_SYSTEM_ERROR(errno);
-    goto _err;
-  }
-  PInFD = taosOpenFile(fNameFrom, TD_FILE_READ);
-  if (PInFD == NULL) {
-    code = TAOS_SYSTEM_ERROR(errno);
-    goto _err;
-  }
-  n = taosFSendFile(pOutFD, PInFD, 0, LOGIC_TO_FILE_OFFSET(pSetFrom->pDataF->size, szPage));
-  if (n < 0) {
-    code = TAOS_SYSTEM_ERROR(errno);
-    goto _err;
-  }
-  taosCloseFile(&pOutFD);
-  taosCloseFile(&PInFD);
+  code = tsdbCopyFile(fNameFrom, fNameTo, LOGIC_TO_FILE_OFFSET(pSetFrom->pDataF->size, szPage), speed, stop);
+  if (code) goto _err;
 
   // sma
   tsdbSmaFileName(pTsdb, pSetFrom->diskId, pSetFrom->fid, pSetFrom->pSmaF, fNameFrom);
   tsdbSmaFileName(pTsdb, pSetTo->diskId, pSetTo->fid, pSetTo->pSmaF, fNameTo);
-  pOutFD = taosOpenFile(fNameTo, TD_FILE_WRITE | TD_FILE_CREATE | TD_FILE_TRUNC);
-  if (pOutFD == NULL) {
-    code = TAOS_SYSTEM_ERROR(errno);
-    goto _err;
-  }
-  PInFD = taosOpenFile(fNameFrom, TD_FILE_READ);
-  if (PInFD == NULL) {
-    code = TAOS_SYSTEM_ERROR(errno);
-    goto _err;
-  }
-  n = taosFSendFile(pOutFD, PInFD, 0, tsdbLogicToFileSize(pSetFrom->pSmaF->size, szPage));
-  if (n < 0) {
-    code = TAOS_SYSTEM_ERROR(errno);
-    goto _err;
-  }
-  taosCloseFile(&pOutFD);
-  taosCloseFile(&PInFD);
+  code = tsdbCopyFile(fNameFrom, fNameTo, tsdbLogicToFileSize(pSetFrom->pSmaF->size, szPage), speed, stop);
+  if (code) goto _err;
 
   // stt
   for (int8_t iStt = 0; iStt < pSetFrom->nSttF; iStt++) {
     tsdbSttFileName(pTsdb, pSetFrom->diskId, pSetFrom->fid, pSetFrom->aSttF[iStt], fNameFrom);
     tsdbSttFileName(pTsdb, pSetTo->diskId, pSetTo->fid, pSetTo->aSttF[iStt], fNameTo);
-    pOutFD = taosOpenFile(fNameTo, TD_FILE_WRITE | TD_FILE_CREATE | TD_FILE_TRUNC);
-    if (pOutFD == NULL) {
-      code = TAOS_SYSTEM_ERROR(errno);
-      goto _err;
-    }
-    PInFD = taosOpenFile(fNameFrom, TD_FILE_READ);
-    if (PInFD == NULL) {
-      code = TAOS_SYSTEM_ERROR(errno);
-      goto _err;
-    }
-    n = taosFSendFile(pOutFD, PInFD, 0, tsdbLogicToFileSize(pSetFrom->aSttF[iStt]->size, szPage));
-    if (n < 0) {
-      code = TAOS_SYSTEM_ERROR(errno);
-      goto _err;
-    }
-    taosCloseFile(&pOutFD);
-    taosCloseFile(&PInFD);
+    code = tsdbCopyFile(fNameFrom, fNameTo, tsdbLogicToFileSize(pSetFrom->aSttF[iStt]->size, szPage), speed, stop);
+    if (code) goto _err;
   }
 
   return code;
@@ -928,66 +928,86 @@ _err:
 
 static int32_t tsdbReadBlockDataImpl(SDataFReader *pReader, SBlockInfo *pBlkInfo, SBlockData *pBlockData,
                                      int32_t iStt) {
-  int32_t code = 0;
+  int32_t    code = 0;
+  SLRUCache *pCache = pReader->pTsdb->blkCache;
+  bool       hit = false;
 
   tBlockDataClear(pBlockData);
 
-  STsdbFD *pFD = (iStt < 0) ? pReader->pDataFD : pReader->aSttFD[iStt];
+  STsdbFD       *pFD = (iStt < 0) ? pReader->pDataFD : pReader->aSttFD[iStt];
+  SBlockCacheKey cKey = {.commitID = (iStt < 0) ? pReader->pSet->pDataF->commitID : pReader->pSet->aSttF[iStt]->commitID,
+                         .offset = pBlkInfo->offset,
+                         .fid = pReader->pSet->fid,
+                         .cid = 0,
+                         .ftype = (iStt < 0) ? 0 : 1};
+  SDiskDataHdr   hdr;
 
   // uid + version + tskey
-  code = tRealloc(&pReader->aBuf[0], pBlkInfo->szKey);
-  if (code) goto _err;
+  if (pCache) {
+    code = tsdbBCacheGetBlockKey(pCache, &cKey, &hdr, pBlockData, &pReader->aBuf[0], &hit);
+    if (code) goto _err;
+  }
 
-  code = tsdbReadFile(pFD, pBlkInfo->offset, pReader->aBuf[0], pBlkInfo->szKey);
-  if (code) goto _err;
+  if (!hit) {
+    code = tRealloc(&pReader->aBuf[0], pBlkInfo->szKey);
+    if (code) goto _err;
 
-  SDiskDataHdr hdr;
-  uint8_t     *p = pReader->aBuf[0] + tGetDiskDataHdr(pReader->aBuf[0], &hdr);
+    code = tsdbReadFile(pFD, pBlkInfo->offset, pReader->aBuf[0], pBlkInfo->szKey);
+    if (code) goto _err;
 
-  ASSERT(hdr.delimiter == TSDB_FILE_DLMT);
-  ASSERT(pBlockData->suid == hdr.suid);
-  ASSERT(pBlockData->uid == hdr.uid);
+    uint8_t *p = pReader->aBuf[0] + tGetDiskDataHdr(pReader->aBuf[0], &hdr);
 
-  pBlockData->nRow = hdr.nRow;
+    ASSERT(hdr.delimiter == TSDB_FILE_DLMT);
 
-  // uid
-  if (hdr.uid == 0) {
-    ASSERT(hdr.szUid);
-    code = tsdbDecmprData(p, hdr.szUid, TSDB_DATA_TYPE_BIGINT, hdr.cmprAlg, (uint8_t **)&pBlockData->aUid,
+    // uid
+    if (hdr.uid == 0) {
+      ASSERT(hdr.szUid);
+      code = tsdbDecmprData(p, hdr.szUid, TSDB_DATA_TYPE_BIGINT, hdr.cmprAlg, (uint8_t **)&pBlockData->aUid,
+                            sizeof(int64_t) * hdr.nRow, &pReader->aBuf[1]);
+      if (code) goto _err;
+    } else {
+      ASSERT(!hdr.szUid);
+    }
+    p += hdr.szUid;
+
+    // version
+    code = tsdbDecmprData(p, hdr.szVer, TSDB_DATA_TYPE_BIGINT, hdr.cmprAlg, (uint8_t **)&pBlockData->aVersion,
                           sizeof(int64_t) * hdr.nRow, &pReader->aBuf[1]);
     if (code) goto _err;
-  } else {
-    ASSERT(!hdr.szUid);
-  }
-  p += hdr.szUid;
-
-  // version
-  code = tsdbDecmprData(p, hdr.szVer, TSDB_DATA_TYPE_BIGINT, hdr.cmprAlg, (uint8_t **)&pBlockData->aVersion,
-                        sizeof(int64_t) * hdr.nRow, &pReader->aBuf[1]);
-  if (code) goto _err;
-  p += hdr.szVer;
+    p += hdr.szVer;
 
-  // TSKEY
-  code = tsdbDecmprData(p, hdr.szKey, TSDB_DATA_TYPE_TIMESTAMP, hdr.cmprAlg, (uint8_t **)&pBlockData->aTSKEY,
-                        sizeof(TSKEY) * hdr.nRow, &pReader->aBuf[1]);
-  if (code) goto _err;
-  p += hdr.szKey;
+    // TSKEY
+    code = tsdbDecmprData(p, hdr.szKey, TSDB_DATA_TYPE_TIMESTAMP, hdr.cmprAlg, (uint8_t **)&pBlockData->aTSKEY,
+                          sizeof(TSKEY) * hdr.nRow, &pReader->aBuf[1]);
+    if (code) goto _err;
+    p += hdr.szKey;
 
-  ASSERT(p - pReader->aBuf[0] == pBlkInfo->szKey);
+    ASSERT(p - pReader->aBuf[0] == pBlkInfo->szKey);
 
-  // read and decode columns
-  if (taosArrayGetSize(pBlockData->aIdx) == 0) goto _exit;
+    // SBlockCol list, also kept in the cache entry so a hit needs no file read
+    if (hdr.szBlkCol > 0 && (pCache || taosArrayGetSize(pBlockData->aIdx) > 0)) {
+      int64_t offset = pBlkInfo->offset + pBlkInfo->szKey;
 
-  if (hdr.szBlkCol > 0) {
-    int64_t offset = pBlkInfo->offset + pBlkInfo->szKey;
+      code = tRealloc(&pReader->aBuf[0], hdr.szBlkCol);
+      if (code) goto _err;
 
-    code = tRealloc(&pReader->aBuf[0], hdr.szBlkCol);
-    if (code) goto _err;
+      code = tsdbReadFile(pFD, offset, pReader->aBuf[0], hdr.szBlkCol);
+      if (code) goto _err;
+    }
 
-    code = tsdbReadFile(pFD, offset, pReader->aBuf[0], hdr.szBlkCol);
-    if (code) goto _err;
+    if (pCache) {
+      tsdbBCachePutBlockKey(pCache, &cKey, &hdr, pBlockData, pReader->aBuf[0]);
+    }
   }
 
+  ASSERT(pBlockData->suid == hdr.suid);
+  ASSERT(pBlockData->uid == hdr.uid);
+
+  pBlockData->nRow = hdr.nRow;
+
+  // read and decode columns
+  if (taosArrayGetSize(pBlockData->aIdx) == 0) goto _exit;
+
   SBlockCol  blockCol = {.cid = 0};
   SBlockCol *pBlockCol = &blockCol;
   int32_t    n = 0;
@@ -1021,6 +1041,13 @@ static int32_t tsdbReadBlockDataImpl(SDataFReader *pReader, SBlockInfo *pBlkInfo
           if (code) goto _err;
         }
       } else {
+        if (pCache) {
+          cKey.cid = pBlockCol->cid;
+          code = tsdbBCacheGetColData(pCache, &cKey, pColData, &hit);
+          if (code) goto _err;
+          if (hit) continue;
+        }
+
         // decode from binary
         int64_t offset = pBlkInfo->offset + pBlkInfo->szKey + hdr.szBlkCol + pBlockCol->offset;
         int32_t size = pBlockCol->szBitmap + pBlockCol->szOffset + pBlockCol->szValue;
@@ -1033,6 +1060,10 @@ static int32_t tsdbReadBlockDataImpl(SDataFReader *pReader, SBlockInfo *pBlkInfo
 
         code = tsdbDecmprColData(pReader->aBuf[1], pBlockCol, hdr.cmprAlg, hdr.nRow, pColData, &pReader->aBuf[2]);
         if (code) goto _err;
+
+        if (pCache) {
+          tsdbBCachePutColData(pCache, &cKey, pColData);
+        }
       }
     }
   }
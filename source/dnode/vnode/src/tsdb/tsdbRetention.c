@@ -39,74 +39,207 @@ static bool tsdbShouldDoRetention(STsdb *pTsdb, int64_t now) {
   return false;
 }
 
+static int64_t tsdbDFileSetSize(SDFileSet *pSet) {
+  int64_t size = pSet->pHeadF->size + pSet->pDataF->size + pSet->pSmaF->size;
+  for (int32_t iStt = 0; iStt < pSet->nSttF; iStt++) {
+    size += pSet->aSttF[iStt]->size;
+  }
+  return size;
+}
+
+// whether the file set is not changed by commits since the copy is taken
+static bool tsdbDFileSetSame(SDFileSet *pSet1, SDFileSet *pSet2) {
+  if (pSet1->fid != pSet2->fid || pSet1->nSttF != pSet2->nSttF) return false;
+  if (pSet1->pHeadF->commitID != pSet2->pHeadF->commitID || pSet1->pHeadF->size != pSet2->pHeadF->size) return false;
+  if (pSet1->pDataF->commitID != pSet2->pDataF->commitID || pSet1->pDataF->size != pSet2->pDataF->size) return false;
+  if (pSet1->pSmaF->commitID != pSet2->pSmaF->commitID || pSet1->pSmaF->size != pSet2->pSmaF->size) return false;
+  for (int32_t iStt = 0; iStt < pSet1->nSttF; iStt++) {
+    if (pSet1->aSttF[iStt]->commitID != pSet2->aSttF[iStt]->commitID ||
+        pSet1->aSttF[iStt]->size != pSet2->aSttF[iStt]->size) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static void tsdbRemoveDFileSetFiles(STsdb *pTsdb, SDFileSet *pSet) {
+  char fname[TSDB_FILENAME_LEN];
+
+  tsdbHeadFileName(pTsdb, pSet->diskId, pSet->fid, pSet->pHeadF, fname);
+  taosRemoveFile(fname);
+  tsdbDataFileName(pTsdb, pSet->diskId, pSet->fid, pSet->pDataF, fname);
+  taosRemoveFile(fname);
+  tsdbSmaFileName(pTsdb, pSet->diskId, pSet->fid, pSet->pSmaF, fname);
+  taosRemoveFile(fname);
+  for (int32_t iStt = 0; iStt < pSet->nSttF; iStt++) {
+    tsdbSttFileName(pTsdb, pSet->diskId, pSet->fid, pSet->aSttF[iStt], fname);
+    taosRemoveFile(fname);
+  }
+}
+
+// copy the file sets to lower tiers from a referenced snapshot, neither commits nor queries wait for the copies
+static int32_t tsdbRetentionCopy(STsdb *pTsdb, STsdbFS *pFSRef, int64_t now, SArray *aMoved) {
+  int32_t code = 0;
+  int64_t speed = (int64_t)tsRetentionSpeedLimitMB * 1024 * 1024;
+
+  for (int32_t iSet = 0; iSet < taosArrayGetSize(pFSRef->aDFileSet); iSet++) {
+    SDFileSet *pSet = (SDFileSet *)taosArrayGet(pFSRef->aDFileSet, iSet);
+    int32_t    expLevel = tsdbFidLevel(pSet->fid, &pTsdb->keepCfg, now);
+    int64_t    size = tsdbDFileSetSize(pSet);
+    SDiskID    did;
+
+    if (expLevel <= 0 || expLevel == pSet->diskId.level) continue;
+
+    if (tfsAllocDiskBySize(pTsdb->pVnode->pTfs, expLevel, size, &did) < 0) {
+      tsdbWarn("vgId:%d, no disk to move file set %d to level %d since %s", TD_VID(pTsdb->pVnode), pSet->fid,
+               expLevel, terrstr());
+      continue;
+    }
+
+    if (did.level == pSet->diskId.level) continue;
+
+    // reserve the space only on the disk really written, so concurrent moves spread out
+    tfsReserveDiskSize(pTsdb->pVnode->pTfs, did, size);
+
+    SDFileSet fSet = *pSet;
+    fSet.diskId = did;
+
+    code = tsdbDFileSetCopy(pTsdb, pSet, &fSet, speed);
+    if (code) {
+      tsdbRemoveDFileSetFiles(pTsdb, &fSet);
+      tfsReserveDiskSize(pTsdb->pVnode->pTfs, did, -size);
+      goto _exit;
+    }
+
+    if (taosArrayPush(aMoved, &fSet) == NULL) {
+      tsdbRemoveDFileSetFiles(pTsdb, &fSet);
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      goto _exit;
+    }
+  }
+
+_exit:
+  return code;
+}
+
+static void tsdbRetentionClear(STsdb *pTsdb) {
+  for (int32_t iMoved = 0; iMoved < taosArrayGetSize(pTsdb->aRetention); iMoved++) {
+    tsdbRemoveDFileSetFiles(pTsdb, (SDFileSet *)taosArrayGet(pTsdb->aRetention, iMoved));
+  }
+  taosArrayDestroy(pTsdb->aRetention);
+  pTsdb->aRetention = NULL;
+}
+
+// copy the file sets to move, the copies are kept in pTsdb->aRetention until tsdbCommitRetention()
 int32_t tsdbDoRetention(STsdb *pTsdb, int64_t now) {
   int32_t code = 0;
+  bool    shouldDo;
+  STsdbFS fsRef = {0};
+  int64_t st = taosGetTimestampMs();
+
+  ASSERT(pTsdb->aRetention == NULL);
 
-  if (!tsdbShouldDoRetention(pTsdb, now)) {
-    return code;
+  taosThreadRwlockRdlock(&pTsdb->rwLock);
+  shouldDo = tsdbShouldDoRetention(pTsdb, now);
+  if (shouldDo) {
+    code = tsdbFSRef(pTsdb, &fsRef);
+  }
+  taosThreadRwlockUnlock(&pTsdb->rwLock);
+  if (!shouldDo || code) goto _exit;
+
+  pTsdb->aRetention = taosArrayInit(0, sizeof(SDFileSet));
+  if (pTsdb->aRetention == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _exit;
   }
 
-  // do retention
-  STsdbFS fs;
+  // copy file sets to new disks
+  code = tsdbRetentionCopy(pTsdb, &fsRef, now, pTsdb->aRetention);
+  if (code) goto _exit;
+
+  tsdbInfo("vgId:%d, tsdb do retention, %d file sets copied, cost:%" PRId64 "ms", TD_VID(pTsdb->pVnode),
+           (int32_t)taosArrayGetSize(pTsdb->aRetention), taosGetTimestampMs() - st);
+
+_exit:
+  if (code) {
+    tsdbError("vgId:%d, tsdb do retention failed since %s", TD_VID(pTsdb->pVnode), tstrerror(code));
+    tsdbRetentionClear(pTsdb);
+  }
+  if (fsRef.aDFileSet) {
+    tsdbFSUnref(pTsdb, &fsRef);
+  }
+  return code;
+}
+
+// swap the copied file sets in and drop the expired ones, the caller holds the commit lock (pVnode->canCommit)
+int32_t tsdbCommitRetention(STsdb *pTsdb, int64_t now) {
+  int32_t code = 0;
+  STsdbFS fs = {0};
+  SArray *aMoved = pTsdb->aRetention;
+  int32_t nMoved = 0;
+
+  if (aMoved == NULL) return code;
 
   code = tsdbFSCopy(pTsdb, &fs);
-  if (code) goto _err;
+  if (code) goto _exit;
 
   for (int32_t iSet = 0; iSet < taosArrayGetSize(fs.aDFileSet); iSet++) {
     SDFileSet *pSet = (SDFileSet *)taosArrayGet(fs.aDFileSet, iSet);
     int32_t    expLevel = tsdbFidLevel(pSet->fid, &pTsdb->keepCfg, now);
-    SDiskID    did;
 
     if (expLevel < 0) {
       taosMemoryFree(pSet->pHeadF);
       taosMemoryFree(pSet->pDataF);
-      taosMemoryFree(pSet->aSttF[0]);
+      for (int32_t iStt = 0; iStt < pSet->nSttF; iStt++) {
+        taosMemoryFree(pSet->aSttF[iStt]);
+      }
       taosMemoryFree(pSet->pSmaF);
       taosArrayRemove(fs.aDFileSet, iSet);
       iSet--;
-    } else {
-      if (expLevel == 0) continue;
-      if (tfsAllocDisk(pTsdb->pVnode->pTfs, expLevel, &did) < 0) {
-        code = terrno;
-        goto _exit;
-      }
-
-      if (did.level == pSet->diskId.level) continue;
-
-      // copy file to new disk (todo)
-      SDFileSet fSet = *pSet;
-      fSet.diskId = did;
+    }
+  }
 
-      code = tsdbDFileSetCopy(pTsdb, pSet, &fSet);
-      if (code) goto _err;
+  for (int32_t iMoved = 0; iMoved < taosArrayGetSize(aMoved); iMoved++) {
+    SDFileSet *pMoved = (SDFileSet *)taosArrayGet(aMoved, iMoved);
+    SDFileSet *pSet = (SDFileSet *)taosArraySearch(fs.aDFileSet, pMoved, tDFileSetCmprFn, TD_EQ);
 
-      code = tsdbFSUpsertFSet(&fs, &fSet);
-      if (code) goto _err;
+    if (pSet == NULL || !tsdbDFileSetSame(pSet, pMoved)) {
+      // expired or changed by commits meanwhile, move it in the next retention
+      tsdbRemoveDFileSetFiles(pTsdb, pMoved);
+      taosArrayRemove(aMoved, iMoved);
+      iMoved--;
+      continue;
     }
+
+    code = tsdbFSUpsertFSet(&fs, pMoved);
+    if (code) goto _exit;
+    pSet->diskId = pMoved->diskId;
   }
 
-  // do change fs
   code = tsdbFSCommit1(pTsdb, &fs);
-  if (code) goto _err;
+  if (code) goto _exit;
 
   taosThreadRwlockWrlock(&pTsdb->rwLock);
 
   code = tsdbFSCommit2(pTsdb, &fs);
   if (code) {
     taosThreadRwlockUnlock(&pTsdb->rwLock);
-    goto _err;
+    goto _exit;
   }
 
   taosThreadRwlockUnlock(&pTsdb->rwLock);
-
-  tsdbFSDestroy(&fs);
+  nMoved = taosArrayGetSize(aMoved);
 
 _exit:
+  if (code) {
+    tsdbError("vgId:%d, tsdb commit retention failed since %s", TD_VID(pTsdb->pVnode), tstrerror(code));
+    // the moved files are not in the file system
+    tsdbRetentionClear(pTsdb);
+  } else {
+    tsdbInfo("vgId:%d, tsdb commit retention, %d file sets moved", TD_VID(pTsdb->pVnode), nMoved);
+    taosArrayDestroy(pTsdb->aRetention);
+    pTsdb->aRetention = NULL;
+  }
+  tsdbFSDestroy(&fs);
   return code;
-
-_err:
-  tsdbError("vgId:%d, tsdb do retention failed since %s", TD_VID(pTsdb->pVnode), tstrerror(code));
-  ASSERT(0);
-  // tsdbFSRollback(pTsdb->pFS);
-  return code;
-}
\ No newline at end of file
+}
@@ -1706,7 +1706,7 @@ int32_t tsdbCmprData(uint8_t *pIn, int32_t szIn, int8_t type, int8_t cmprAlg, ui
     code = tRealloc(ppOut, nOut + size);
     if (code) goto _exit;
 
-    if (cmprAlg == TWO_STAGE_COMP) {
+    if (IS_TWO_STAGE_COMP(cmprAlg)) {
       ASSERT(ppBuf);
       code = tRealloc(ppBuf, size);
       if (code) goto _exit;
@@ -1735,7 +1735,7 @@ int32_t tsdbDecmprData(uint8_t *pIn, int32_t szIn, int8_t type, int8_t cmprAlg,
     ASSERT(szIn == szOut);
     memcpy(*ppOut, pIn, szOut);
   } else {
-    if (cmprAlg == TWO_STAGE_COMP) {
+    if (IS_TWO_STAGE_COMP(cmprAlg)) {
       code = tRealloc(ppBuf, szOut + COMP_OVERFLOW_BYTES);
       if (code) goto _exit;
     }
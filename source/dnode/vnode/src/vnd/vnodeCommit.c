@@ -22,7 +22,10 @@ static int  vnodeEncodeInfo(const SVnodeInfo *pInfo, char **ppData);
 static int  vnodeDecodeInfo(uint8_t *pData, SVnodeInfo *pInfo);
 static int  vnodeStartCommit(SVnode *pVnode);
 static int  vnodeEndCommit(SVnode *pVnode);
-static int  vnodeCommitImpl(void *arg);
+static int  vnodePrepareCommit(SVnode *pVnode, SCommitInfo *pInfo);
+static int  vnodeCommitImpl(SCommitInfo *pInfo);
+static int  vnodeCommitTask(void *arg);
+static int  vnodeCompactTask(void *arg);
 static void vnodeWaitCommit(SVnode *pVnode);
 
 int vnodeBegin(SVnode *pVnode) {
@@ -40,7 +43,7 @@ int vnodeBegin(SVnode *pVnode) {
 
   taosThreadMutexUnlock(&pVnode->mutex);
 
-  pVnode->state.commitID++;
+  atomic_add_fetch_64(&pVnode->state.commitID, 1);
   // begin meta
   if (metaBegin(pVnode->pMeta, 0) < 0) {
     vError("vgId:%d, failed to begin meta since %s", TD_VID(pVnode), tstrerror(terrno));
@@ -196,26 +199,45 @@ _err:
 }
 
 int vnodeAsyncCommit(SVnode *pVnode) {
+  SCommitInfo *pInfo = NULL;
+
+  // one commit in flight at a time
   vnodeWaitCommit(pVnode);
 
-  // vnodeBufPoolSwitch(pVnode);
-  // tsdbPrepareCommit(pVnode->pTsdb);
+  pInfo = (SCommitInfo *)taosMemoryCalloc(1, sizeof(*pInfo));
+  if (pInfo == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    tsem_post(&(pVnode->canCommit));
+    vError("vgId:%d, failed to commit since %s", TD_VID(pVnode), tstrerror(terrno));
+    return -1;
+  }
+
+  if (vnodePrepareCommit(pVnode, pInfo) < 0) {
+    taosMemoryFree(pInfo);
+    tsem_post(&(pVnode->canCommit));
+    return -1;
+  }
 
-  vnodeScheduleTask(vnodeCommitImpl, pVnode);
+  // rsma pauses its triggers until the commit ends, so keep it on the write thread
+  if (VND_IS_RSMA(pVnode) || vnodeScheduleTask(vnodeCommitTask, pInfo) < 0) {
+    return vnodeCommitTask(pInfo);
+  }
 
   return 0;
 }
 
 int vnodeSyncCommit(SVnode *pVnode) {
-  vnodeAsyncCommit(pVnode);
+  int32_t code = vnodeAsyncCommit(pVnode);
   vnodeWaitCommit(pVnode);
   tsem_post(&(pVnode->canCommit));
-  return 0;
+  return code;
 }
 
-int vnodeCommit(SVnode *pVnode) {
-  SVnodeInfo info = {0};
+int vnodeCommit(SVnode *pVnode) { return vnodeSyncCommit(pVnode); }
+
+static int vnodePrepareCommit(SVnode *pVnode, SCommitInfo *pInfo) {
   char       dir[TSDB_FILENAME_LEN];
+  SVnodeInfo info;
 
   vInfo("vgId:%d, start to commit, commit ID:%" PRId64 " version:%" PRId64, TD_VID(pVnode), pVnode->state.commitID,
         pVnode->state.applied);
@@ -223,9 +245,20 @@ int vnodeCommit(SVnode *pVnode) {
   pVnode->state.commitTerm = pVnode->state.applyTerm;
 
   // save info
-  info.config = pVnode->config;
-  info.state.committed = pVnode->state.applied;
-  info.state.commitTerm = pVnode->state.applyTerm;
+  pInfo->pVnode = pVnode;
+  pInfo->info.config = pVnode->config;
+  pInfo->info.state.committed = pVnode->state.applied;
+  pInfo->info.state.commitTerm = pVnode->state.applyTerm;
+  pInfo->info.state.commitID = pVnode->state.commitID;
+
+  // the commit ID of compaction is reserved before vnodeBegin() takes the next one, so the files of the next commit
+  // never overwrite the compacted ones
+  if (!VND_IS_RSMA(pVnode) && tsdbShouldCompact(pVnode->pTsdb)) {
+    pInfo->compactID = atomic_add_fetch_64(&pVnode->state.commitID, 1);
+  }
+
+  // the saved commit ID covers the reserved one, so it is not taken again after restart
+  info = pInfo->info;
   info.state.commitID = pVnode->state.commitID;
   snprintf(dir, TSDB_FILENAME_LEN, "%s%s%s", tfsGetPrimaryPath(pVnode->pTfs), TD_DIRSEP, pVnode->path);
   if (vnodeSaveInfo(dir, &info) < 0) {
@@ -236,40 +269,59 @@ int vnodeCommit(SVnode *pVnode) {
 
   // preCommit
   // smaSyncPreCommit(pVnode->pSma);
-  if(smaAsyncPreCommit(pVnode->pSma) < 0){
+  if (smaAsyncPreCommit(pVnode->pSma) < 0) {
     ASSERT(0);
     return -1;
   }
 
-  vnodeBufPoolUnRef(pVnode->inUse);
-  pVnode->inUse = NULL;
-
-  // commit each sub-system
+  // the meta txn is bound to the write thread
   if (metaCommit(pVnode->pMeta) < 0) {
     ASSERT(0);
     return -1;
   }
 
+  // freeze the mem tables, writers move on to a fresh buffer pool in vnodeBegin()
+  if (VND_IS_RSMA(pVnode)) {
+    tsdbPrepareCommit(VND_RSMA0(pVnode));
+    tsdbPrepareCommit(VND_RSMA1(pVnode));
+    tsdbPrepareCommit(VND_RSMA2(pVnode));
+  } else {
+    tsdbPrepareCommit(pVnode->pTsdb);
+  }
+
+  vnodeBufPoolUnRef(pVnode->inUse);
+  pVnode->inUse = NULL;
+
+  return 0;
+}
+
+static int vnodeCommitImpl(SCommitInfo *pInfo) {
+  SVnode *pVnode = pInfo->pVnode;
+  char    dir[TSDB_FILENAME_LEN];
+
+  snprintf(dir, TSDB_FILENAME_LEN, "%s%s%s", tfsGetPrimaryPath(pVnode->pTfs), TD_DIRSEP, pVnode->path);
+
+  // commit each sub-system
   if (VND_IS_RSMA(pVnode)) {
     if (smaAsyncCommit(pVnode->pSma) < 0) {
       ASSERT(0);
       return -1;
     }
 
-    if (tsdbCommit(VND_RSMA0(pVnode)) < 0) {
+    if (tsdbCommit(VND_RSMA0(pVnode), pInfo) < 0) {
       ASSERT(0);
       return -1;
     }
-    if (tsdbCommit(VND_RSMA1(pVnode)) < 0) {
+    if (tsdbCommit(VND_RSMA1(pVnode), pInfo) < 0) {
       ASSERT(0);
       return -1;
     }
-    if (tsdbCommit(VND_RSMA2(pVnode)) < 0) {
+    if (tsdbCommit(VND_RSMA2(pVnode), pInfo) < 0) {
       ASSERT(0);
       return -1;
     }
   } else {
-    if (tsdbCommit(pVnode->pTsdb) < 0) {
+    if (tsdbCommit(pVnode->pTsdb, pInfo) < 0) {
       ASSERT(0);
       return -1;
     }
@@ -282,12 +334,12 @@ int vnodeCommit(SVnode *pVnode) {
   // walCommit (TODO)
 
   // commit info
-  if (vnodeCommitInfo(dir, &info) < 0) {
+  if (vnodeCommitInfo(dir, &pInfo->info) < 0) {
     ASSERT(0);
     return -1;
   }
 
-  pVnode->state.committed = info.state.committed;
+  pVnode->state.committed = pInfo->info.state.committed;
 
   // postCommit
   // smaSyncPostCommit(pVnode->pSma);
@@ -304,16 +356,40 @@ int vnodeCommit(SVnode *pVnode) {
   return 0;
 }
 
-static int vnodeCommitImpl(void *arg) {
-  SVnode *pVnode = (SVnode *)arg;
+static int vnodeCommitTask(void *arg) {
+  SCommitInfo *pInfo = (SCommitInfo *)arg;
+  SVnode      *pVnode = pInfo->pVnode;
 
-  // metaCommit(pVnode->pMeta);
-  tqCommit(pVnode->pTq);
-  // tsdbCommit(pVnode->pTsdb, );
+  int code = vnodeCommitImpl(pInfo);
+  if (code < 0) {
+    vError("vgId:%d, failed to commit since %s", TD_VID(pVnode), tstrerror(terrno));
+  } else if (pInfo->compactID > 0 && vnodeScheduleTask(vnodeCompactTask, pInfo) == 0) {
+    // the compaction task ends this commit round
+    return code;
+  }
 
-  // vnodeBufPoolRecycle(pVnode);
+  taosMemoryFree(pInfo);
   tsem_post(&(pVnode->canCommit));
-  return 0;
+  return code;
+}
+
+// compact the file set with the most .stt files after the commit is done. The next commit waits for it since both
+// swap file sets, and if it fails, the file set in use is kept as it is.
+static int vnodeCompactTask(void *arg) {
+  SCommitInfo *pInfo = (SCommitInfo *)arg;
+  SVnode      *pVnode = pInfo->pVnode;
+
+  int code = tsdbCompact(pVnode->pTsdb, pInfo->compactID);
+  if (code) {
+    vError("vgId:%d, failed to compact, commit ID:%" PRId64 " since %s", TD_VID(pVnode), pInfo->compactID,
+           tstrerror(code));
+  } else {
+    vInfo("vgId:%d, compact end, commit ID:%" PRId64, TD_VID(pVnode), pInfo->compactID);
+  }
+
+  taosMemoryFree(pInfo);
+  tsem_post(&(pVnode->canCommit));
+  return code;
 }
 
 static int vnodeStartCommit(SVnode *pVnode) {
@@ -35,6 +35,11 @@ struct SVnodeGlobal {
 
 struct SVnodeGlobal vnodeGlobal;
 
+// trim copies file sets between tiers under a speed limit for long, so it has a worker of its own and the commits
+// never queue behind it. A vnode queues one trim at most, so the queue holds the max vnodes of a dnode
+#define VNODE_TRIM_QUEUE_SIZE 4096
+static void* vnodeTrimQHandle = NULL;
+
 static void* loop(void* arg);
 
 int vnodeInit(int nthreads) {
@@ -66,12 +71,25 @@ int vnodeInit(int nthreads) {
     taosThreadCreate(&(vnodeGlobal.threads[i]), NULL, loop, NULL);
   }
 
+  vnodeTrimQHandle = taosInitScheduler(VNODE_TRIM_QUEUE_SIZE, 1, "vnode-trim", NULL);
+  if (vnodeTrimQHandle == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    vError("failed to init vnode module since:%s", tstrerror(terrno));
+    return -1;
+  }
+
   if (walInit() < 0) {
     return -1;
   }
   if (tqInit() < 0) {
     return -1;
   }
+  if (tsdbInit() < 0) {
+    return -1;
+  }
+  if (qExecutorInit() < 0) {
+    return -1;
+  }
 
   return 0;
 }
@@ -98,9 +116,16 @@ void vnodeCleanup() {
   taosThreadCondDestroy(&(vnodeGlobal.hasTask));
   taosThreadMutexDestroy(&(vnodeGlobal.mutex));
 
+  if (vnodeTrimQHandle) {
+    taosCleanUpScheduler(vnodeTrimQHandle);
+    taosMemoryFreeClear(vnodeTrimQHandle);
+  }
+
   walCleanUp();
   tqCleanUp();
+  tsdbCleanUp();
   smaCleanUp();
+  qExecutorCleanUp();
 }
 
 int vnodeScheduleTask(int (*execute)(void*), void* arg) {
@@ -128,6 +153,11 @@ int vnodeScheduleTask(int (*execute)(void*), void* arg) {
   return 0;
 }
 
+int32_t vnodeScheduleTrimTask(void (*fp)(SSchedMsg*), void* arg) {
+  SSchedMsg schedMsg = {.fp = fp, .ahandle = arg};
+  return taosScheduleTask(vnodeTrimQHandle, &schedMsg);
+}
+
 /* ------------------------ STATIC METHODS ------------------------ */
 static void* loop(void* arg) {
   SVnodeTask* pTask;
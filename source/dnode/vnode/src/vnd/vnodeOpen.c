@@ -92,6 +92,7 @@ SVnode *vnodeOpen(const char *path, STfs *pTfs, SMsgCb msgCb) {
 
   tsem_init(&pVnode->syncSem, 0, 0);
   tsem_init(&(pVnode->canCommit), 0, 1);
+  tsem_init(&pVnode->canTrim, 0, 1);
   taosThreadMutexInit(&pVnode->mutex, NULL);
   taosThreadCondInit(&pVnode->poolNotEmpty, NULL);
 
@@ -176,6 +177,7 @@ _err:
   if (pVnode->pPool) vnodeCloseBufPool(pVnode);
 
   tsem_destroy(&(pVnode->canCommit));
+  tsem_destroy(&pVnode->canTrim);
   taosMemoryFree(pVnode);
   return NULL;
 }
@@ -188,6 +190,9 @@ void vnodePreClose(SVnode *pVnode) {
 
 void vnodeClose(SVnode *pVnode) {
   if (pVnode) {
+    // stop the trim task in background and wait for it
+    atomic_store_8(&pVnode->stopTrim, 1);
+    tsem_wait(&pVnode->canTrim);
     vnodeCommit(pVnode);
     vnodeSyncClose(pVnode);
     vnodeQueryClose(pVnode);
@@ -199,6 +204,7 @@ void vnodeClose(SVnode *pVnode) {
     vnodeCloseBufPool(pVnode);
     // destroy handle
     tsem_destroy(&(pVnode->canCommit));
+    tsem_destroy(&pVnode->canTrim);
     tsem_destroy(&pVnode->syncSem);
     taosThreadCondDestroy(&pVnode->poolNotEmpty);
     taosThreadMutexDestroy(&pVnode->mutex);
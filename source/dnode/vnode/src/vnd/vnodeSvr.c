@@ -264,11 +264,15 @@ int32_t vnodeProcessWriteMsg(SVnode *pVnode, SRpcMsg *pMsg, int64_t version, SRp
   if (vnodeShouldCommit(pVnode)) {
   _do_commit:
     vInfo("vgId:%d, commit at version %" PRId64, TD_VID(pVnode), version);
-    // commit current change
-    vnodeCommit(pVnode);
+    // freeze current change and flush it in background
+    if (vnodeAsyncCommit(pVnode) < 0) {
+      vError("vgId:%d, failed to commit at version %" PRId64 " since %s", TD_VID(pVnode), version, tstrerror(terrno));
+    }
 
-    // start a new one
-    vnodeBegin(pVnode);
+    // start a new one, unless the commit failed before the current one was frozen
+    if (pVnode->inUse == NULL && vnodeBegin(pVnode) < 0) {
+      goto _err;
+    }
   }
 
   return 0;
@@ -378,26 +382,78 @@ void vnodeUpdateMetaRsp(SVnode *pVnode, STableMetaRsp *pMetaRsp) {
   pMetaRsp->precision = pVnode->config.tsdbCfg.precision;
 }
 
+typedef struct {
+  SVnode *pVnode;
+  int64_t now;
+} STrimInfo;
+
+static void vnodeTrimTask(SSchedMsg *pMsg) {
+  STrimInfo *pInfo = (STrimInfo *)pMsg->ahandle;
+  SVnode    *pVnode = pInfo->pVnode;
+  int32_t    code = 0;
+
+  // copy the file sets, neither writes nor commits wait for it
+  code = tsdbDoRetention(pVnode->pTsdb, pInfo->now);
+  if (code == 0) code = smaDoRetention(pVnode->pSma, pInfo->now);
+  if (code) {
+    vError("vgId:%d, failed to copy file sets of trim since %s", TD_VID(pVnode), tstrerror(code));
+  }
+
+  // swap the copied file sets in under the commit lock, the trim worker is its own so it waits for the in-flight commit
+  tsem_wait(&pVnode->canCommit);
+  int32_t ret = tsdbCommitRetention(pVnode->pTsdb, pInfo->now);
+  if (code == 0) code = ret;
+  ret = smaCommitRetention(pVnode->pSma, pInfo->now);
+  if (code == 0) code = ret;
+  tsem_post(&pVnode->canCommit);
+
+  if (code) {
+    vError("vgId:%d, failed to trim vnode since %s", TD_VID(pVnode), tstrerror(code));
+  } else {
+    vInfo("vgId:%d, trim vnode finished, time:%" PRId64, TD_VID(pVnode), pInfo->now);
+  }
+
+  taosMemoryFree(pInfo);
+  tsem_post(&pVnode->canTrim);
+}
+
 static int32_t vnodeProcessTrimReq(SVnode *pVnode, int64_t version, void *pReq, int32_t len, SRpcMsg *pRsp) {
   int32_t     code = 0;
   SVTrimDbReq trimReq = {0};
+  STrimInfo  *pInfo = NULL;
 
   // decode
   if (tDeserializeSVTrimDbReq(pReq, len, &trimReq) != 0) {
-    code = TSDB_CODE_INVALID_MSG;
-    goto _exit;
+    return TSDB_CODE_INVALID_MSG;
   }
 
   vInfo("vgId:%d, trim vnode request will be processed, time:%d", pVnode->config.vgId, trimReq.timestamp);
 
-  // process
-  code = tsdbDoRetention(pVnode->pTsdb, trimReq.timestamp);
-  if (code) goto _exit;
+  // the retention is idempotent, the next trim request does what the running one misses
+  if (tsem_trywait(&pVnode->canTrim) != 0) {
+    vInfo("vgId:%d, trim vnode request is skipped since the last trim is in progress", pVnode->config.vgId);
+    return code;
+  }
+
+  pInfo = (STrimInfo *)taosMemoryCalloc(1, sizeof(*pInfo));
+  if (pInfo == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _exit;
+  }
+  pInfo->pVnode = pVnode;
+  pInfo->now = trimReq.timestamp;
 
-  code = smaDoRetention(pVnode->pSma, trimReq.timestamp);
-  if (code) goto _exit;
+  // process in background, the data migration must not block the write queue
+  if (vnodeScheduleTrimTask(vnodeTrimTask, pInfo) < 0) {
+    code = TSDB_CODE_VND_IS_CLOSING;
+    goto _exit;
+  }
+
+  return code;
 
 _exit:
+  taosMemoryFree(pInfo);
+  tsem_post(&pVnode->canTrim);
   return code;
 }
 
@@ -746,7 +746,7 @@ int32_t vnodeSyncOpen(SVnode *pVnode, char *path) {
   SSyncInfo syncInfo = {
       .snapshotStrategy = SYNC_STRATEGY_WAL_FIRST,
       //.snapshotStrategy = SYNC_STRATEGY_NO_SNAPSHOT,
-      .batchSize = 1,
+      .batchSize = SYNC_MAX_APPEND_BATCH_SIZE,
       .vgId = pVnode->config.vgId,
       .isStandBy = pVnode->config.standby,
       .syncCfg = pVnode->config.syncCfg,
@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+
+#include "meta.h"
+
+namespace {
+
+STSchema *genTSchema(int32_t sver, int32_t nCols) {
+  STSchema *pTSchema = (STSchema *)taosMemoryCalloc(1, sizeof(STSchema) + sizeof(STColumn) * nCols);
+  pTSchema->numOfCols = nCols;
+  pTSchema->version = sver;
+  for (int32_t iCol = 0; iCol < nCols; iCol++) {
+    pTSchema->columns[iCol].colId = iCol + 1;
+    pTSchema->columns[iCol].type = TSDB_DATA_TYPE_INT;
+    pTSchema->columns[iCol].bytes = sizeof(int32_t);
+  }
+  return pTSchema;
+}
+
+bool cached(SMeta *pMeta, tb_uid_t uid, int32_t sver) {
+  STSchema *pTSchema = NULL;
+  if (metaCacheGetTSchema(pMeta, uid, sver, &pTSchema) != 0) return false;
+
+  bool same = (pTSchema->version == sver);
+  taosMemoryFree(pTSchema);
+  return same;
+}
+
+}  // namespace
+
+class MetaCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    memset(&meta, 0, sizeof(meta));
+    ASSERT_EQ(metaCacheOpen(&meta), 0);
+  }
+  void TearDown() override { metaCacheClose(&meta); }
+
+  SMeta meta;
+};
+
+TEST_F(MetaCacheTest, tschema_hit_and_drop) {
+  STSchema *pTSchema = NULL;
+
+  ASSERT_NE(metaCacheGetTSchema(&meta, 100, 1, &pTSchema), 0);
+
+  for (int32_t sver = 1; sver <= 3; sver++) {
+    STSchema *pNew = genTSchema(sver, 4 + sver);
+    ASSERT_EQ(metaCachePutTSchema(&meta, 100, pNew), 0);
+    taosMemoryFree(pNew);
+  }
+  STSchema *pOther = genTSchema(1, 2);
+  ASSERT_EQ(metaCachePutTSchema(&meta, 200, pOther), 0);
+  taosMemoryFree(pOther);
+
+  // the cache returns a copy
+  ASSERT_EQ(metaCacheGetTSchema(&meta, 100, 2, &pTSchema), 0);
+  ASSERT_EQ(pTSchema->version, 2);
+  ASSERT_EQ(pTSchema->numOfCols, 6);
+  ASSERT_EQ(pTSchema->columns[5].colId, 6);
+  taosMemoryFree(pTSchema);
+  ASSERT_FALSE(cached(&meta, 100, 4));
+
+  // dropping a table drops all its versions only
+  metaCacheDropTSchema(&meta, 100);
+  for (int32_t sver = 1; sver <= 3; sver++) {
+    ASSERT_FALSE(cached(&meta, 100, sver));
+  }
+  ASSERT_TRUE(cached(&meta, 200, 1));
+}
+
+TEST_F(MetaCacheTest, tschema_evict) {
+  const int32_t nCols = 1000;
+  const int32_t size = sizeof(STSchema) + sizeof(STColumn) * nCols;
+  const int32_t nFit = META_SKM_CACHE_SIZE / size;
+  const int32_t nPut = nFit * 3;
+
+  for (int32_t uid = 1; uid <= nPut; uid++) {
+    STSchema *pTSchema = genTSchema(1, nCols);
+    ASSERT_EQ(metaCachePutTSchema(&meta, uid, pTSchema), 0);
+    taosMemoryFree(pTSchema);
+
+    // keep the first one hot
+    ASSERT_TRUE(cached(&meta, 1, 1));
+  }
+
+  // the least recently used ones are evicted, the cache holds no more than its size
+  int32_t nCached = 0;
+  for (int32_t uid = 1; uid <= nPut; uid++) {
+    if (cached(&meta, uid, 1)) nCached++;
+  }
+  ASSERT_LE(nCached, nFit);
+  ASSERT_GE(nCached, nFit - 1);
+  ASSERT_TRUE(cached(&meta, 1, 1));
+  ASSERT_TRUE(cached(&meta, nPut, 1));
+  ASSERT_FALSE(cached(&meta, 2, 1));
+}
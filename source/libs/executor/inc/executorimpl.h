@@ -277,6 +277,12 @@ typedef struct SExchangeInfo {
   SLoadRemoteDataInfo loadInfo;
   uint64_t            self;
   SLimitInfo          limitInfo;
+  TdThreadMutex       lock;           // protect pReadyQueue, which is appended in the fetch rsp callback
+  SArray*             pReadyQueue;    // SArray<int32_t>, sources whose fetch rsp has arrived, in arrival order
+  SArray*             pWaitQueue;     // SArray<int32_t>, sources waiting for a free fetch slot
+  int32_t             maxInflight;    // max number of fetch requests in flight or buffered
+  int32_t             numOfInflight;
+  int32_t             numOfExhausted;
 } SExchangeInfo;
 
 typedef struct SColMatchInfo {
@@ -705,6 +711,13 @@ typedef struct SGroupbyOperatorInfo {
   int32_t       groupKeyLen;  // total group by column width
   SGroupResInfo groupResInfo;
   SExprSupp     scalarSup;
+  // resolve the groups of a whole input block at once, see doHashGroupbyAggBatch
+  SHashObj*     pBatchHash;     // group keys -> index of the group in the current block
+  char*         pBatchKeyBuf;   // two group keys, the current row and the previous one
+  int32_t*      pBatchIndex;    // group of each row, group offsets and the row order
+  int32_t       batchIndexCap;  // in rows
+  char*         pBatchBuf;      // used to reorder the columns of the block
+  int64_t       batchBufLen;
 } SGroupbyOperatorInfo;
 
 typedef struct SDataGroupInfo {
@@ -896,6 +909,43 @@ typedef struct SJoinOperatorInfo {
   SNode*       pCondAfterMerge;
 } SJoinOperatorInfo;
 
+typedef struct SHJoinRowRef {
+  int32_t blockIdx;
+  int32_t rowIdx;
+  int32_t next;  // next row of the same join key, -1 for the end of the list
+} SHJoinRowRef;
+
+typedef struct SHJoinPartition {
+  SArray*      pPageIds[2];  // spilled pages of each downstream
+  SSDataBlock* pBlock[2];    // rows not yet written into the page
+} SHJoinPartition;
+
+typedef struct SHashJoinOperatorInfo {
+  SSDataBlock*     pRes;
+  int32_t          joinType;
+  SArray*          pKeyCols[2];  // SColumnInfo of the join keys of each downstream
+  int32_t          keyBufSize;
+  char*            pKeyBuf;
+  int32_t          buildIdx;  // the smaller downstream, which the hash table is built on
+  SSHashObj*       pHashTable;
+  SArray*          pBuildBlocks;
+  SArray*          pRowRefs;  // SHJoinRowRef, the hash table value is the index of the first row of the key
+  SArray*          pPending[2];  // blocks fetched before the build side is decided
+  bool             downstreamDone[2];
+  int32_t          pendingIdx;
+  SSDataBlock*     pProbe;
+  int32_t          probePos;
+  int32_t          nextRef;
+  SDiskbasedBuf*   pBuf;
+  int32_t          pageSize;
+  int64_t          buildBufSize;  // the memory budget of the build side
+  SHJoinPartition* pParts;  // not NULL once the build side exceeds the memory budget
+  SSDataBlock*     pTemplate[2];
+  int32_t          curPart;
+  int32_t          probePageIdx;
+  SNode*           pCondAfterJoin;
+} SHashJoinOperatorInfo;
+
 #define OPTR_IS_OPENED(_optr)  (((_optr)->status & OP_OPENED) == OP_OPENED)
 #define OPTR_SET_OPENED(_optr) ((_optr)->status |= OP_OPENED)
 
@@ -1014,6 +1064,9 @@ SOperatorInfo* createTimeSliceOperatorInfo(SOperatorInfo* downstream, SPhysiNode
 SOperatorInfo* createMergeJoinOperatorInfo(SOperatorInfo** pDownstream, int32_t numOfDownstream,
                                            SSortMergeJoinPhysiNode* pJoinNode, SExecTaskInfo* pTaskInfo);
 
+SOperatorInfo* createHashJoinOperatorInfo(SOperatorInfo** pDownstream, int32_t numOfDownstream,
+                                          SHashJoinPhysiNode* pJoinNode, SExecTaskInfo* pTaskInfo);
+
 SOperatorInfo* createStreamSessionAggOperatorInfo(SOperatorInfo* downstream, SPhysiNode* pPhyNode,
                                                   SExecTaskInfo* pTaskInfo);
 SOperatorInfo* createStreamFinalSessionAggOperatorInfo(SOperatorInfo* downstream, SPhysiNode* pPhyNode,
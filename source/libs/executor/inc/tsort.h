@@ -56,6 +56,17 @@ typedef struct SMsortComparParam {
 typedef struct SSortHandle SSortHandle;
 typedef struct STupleHandle STupleHandle;
 
+/**
+ * create the sort workers shared by all queries, which generate the external sort runs
+ * @return
+ */
+int32_t tsortInit();
+
+/**
+ * stop the sort workers, the runs are generated on the query thread afterwards
+ */
+void tsortCleanUp();
+
 typedef SSDataBlock* (*_sort_fetch_block_fn_t)(void* param);
 typedef int32_t (*_sort_merge_compar_fn_t)(const void* p1, const void* p2, void* param);
 
@@ -105,6 +116,14 @@ int32_t tsortSetComparFp(SSortHandle* pHandle, _sort_merge_compar_fn_t fp);
  */
 int32_t tsortSetCompareGroupId(SSortHandle* pHandle, bool compareGroupId);
 
+/**
+ * keep only the first maxRows rows of a single source sort, they are found in memory if they fit in the sort buffer
+ * @param pHandle
+ * @param maxRows
+ * @return
+ */
+int32_t tsortSetMaxRows(SSortHandle* pHandle, int64_t maxRows);
+
 /**
  *
  * @param pHandle
@@ -112,7 +112,9 @@ static bool allocBuf(SDataDispatchHandle* pDispatcher, const SInputData* pInput,
   }
 */
 
-  pBuf->allocSize = sizeof(SDataCacheEntry) + blockGetEncodeSize(pInput->pData);
+  // the encoded columns take at most one more byte for the codec of each column
+  pBuf->allocSize = sizeof(SDataCacheEntry) + blockGetEncodeSize(pInput->pData) +
+                    taosArrayGetSize(pInput->pData->pDataBlock) * sizeof(int8_t);
 
   pBuf->pData = taosMemoryMalloc(pBuf->allocSize);
   if (pBuf->pData == NULL) {
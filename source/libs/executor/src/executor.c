@@ -17,6 +17,7 @@
 #include "executorimpl.h"
 #include "planner.h"
 #include "tdatablock.h"
+#include "tglobal.h"
 #include "tref.h"
 #include "tudf.h"
 #include "vnode.h"
@@ -30,6 +31,10 @@ static void cleanupRefPool() {
   taosCloseRef(ref);
 }
 
+int32_t qExecutorInit() { return tsortInit(); }
+
+void qExecutorCleanUp() { tsortCleanUp(); }
+
 static int32_t doSetStreamBlock(SOperatorInfo* pOperator, void* input, size_t numOfBlocks, int32_t type, char* id) {
   ASSERT(pOperator != NULL);
   if (pOperator->operatorType != QUERY_NODE_PHYSICAL_PLAN_STREAM_SCAN) {
@@ -395,6 +400,20 @@ int32_t qCreateExecTask(SReadHandle* readHandle, int32_t vgId, uint64_t taskId,
 
   qDebug("start to create subplan task, TID:0x%" PRIx64 " QID:0x%" PRIx64, taskId, pSubplan->id.queryId);
 
+  // disable query processing if the value of queryBufferSize is zero.
+  if (tsQueryBufferSize == 0) {
+    qError("query processing is disabled since queryBufferSize is 0, TID:0x%" PRIx64 " QID:0x%" PRIx64, taskId,
+           pSubplan->id.queryId);
+    return TSDB_CODE_QRY_NOT_ENOUGH_BUFFER;
+  }
+
+  // the running queries can not spill their pages under the budget any more, reject the new one
+  if (dBufIsMemBudgetExceeded()) {
+    qError("query buffer limit has reached, used:%" PRId64 " bytes, TID:0x%" PRIx64 " QID:0x%" PRIx64,
+           dBufGetMemUsed(), taskId, pSubplan->id.queryId);
+    return TSDB_CODE_QRY_NOT_ENOUGH_BUFFER;
+  }
+
   int32_t code = createExecTaskInfoImpl(pSubplan, pTask, readHandle, taskId, sql, model);
   if (code != TSDB_CODE_SUCCESS) {
     qError("failed to createExecTaskInfoImpl, code: %s", tstrerror(code));
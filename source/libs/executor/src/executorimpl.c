@@ -1747,6 +1747,13 @@ int32_t loadRemoteDataCallback(void* param, SDataBuf* pMsg, int32_t code) {
 
   pSourceDataInfo->status = EX_SOURCE_DATA_READY;
 
+  // the sequential load waits for each source in turn and never pops the queue
+  if (!pExchangeInfo->seqLoadData) {
+    taosThreadMutexLock(&pExchangeInfo->lock);
+    taosArrayPush(pExchangeInfo->pReadyQueue, &index);
+    taosThreadMutexUnlock(&pExchangeInfo->lock);
+  }
+
   tsem_post(&pExchangeInfo->ready);
   taosReleaseRef(exchangeObjRefPool, pWrapper->exchangeId);
 
@@ -1900,102 +1907,127 @@ static void* setAllSourcesCompleted(SOperatorInfo* pOperator, int64_t startTs) {
   return NULL;
 }
 
+// send the fetch requests of the waiting sources until all fetch slots are taken
+static int32_t fillFetchSlots(SExchangeInfo* pExchangeInfo, SExecTaskInfo* pTaskInfo) {
+  while (pExchangeInfo->numOfInflight < pExchangeInfo->maxInflight && taosArrayGetSize(pExchangeInfo->pWaitQueue) > 0) {
+    int32_t index = *(int32_t*)taosArrayGet(pExchangeInfo->pWaitQueue, 0);
+    taosArrayRemove(pExchangeInfo->pWaitQueue, 0);
+
+    SSourceDataInfo* pDataInfo = taosArrayGet(pExchangeInfo->pSourceDataInfo, index);
+    pDataInfo->status = EX_SOURCE_DATA_NOT_READY;
+    pExchangeInfo->numOfInflight += 1;
+
+    int32_t code = doSendFetchDataRequest(pExchangeInfo, pTaskInfo, index);
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
 static void concurrentlyLoadRemoteDataImpl(SOperatorInfo* pOperator, SExchangeInfo* pExchangeInfo,
                                            SExecTaskInfo* pTaskInfo) {
-  int32_t code = 0;
-  int64_t startTs = taosGetTimestampUs();
-  size_t  totalSources = taosArrayGetSize(pExchangeInfo->pSources);
+  int32_t            code = 0;
+  int64_t            startTs = taosGetTimestampUs();
+  size_t             totalSources = taosArrayGetSize(pExchangeInfo->pSources);
+  SRetrieveTableRsp* pRsp = NULL;
 
   while (1) {
-    int32_t completed = 0;
-    for (int32_t i = 0; i < totalSources; ++i) {
-      SSourceDataInfo* pDataInfo = taosArrayGet(pExchangeInfo->pSourceDataInfo, i);
-      if (pDataInfo->status == EX_SOURCE_DATA_EXHAUSTED) {
-        completed += 1;
-        continue;
-      }
+    if (pExchangeInfo->numOfExhausted == totalSources) {
+      setAllSourcesCompleted(pOperator, startTs);
+      return;
+    }
 
-      if (pDataInfo->status != EX_SOURCE_DATA_READY) {
-        continue;
-      }
+    // take whichever source responds first
+    tsem_wait(&pExchangeInfo->ready);
 
-      if (pDataInfo->code != TSDB_CODE_SUCCESS) {
-        code = pDataInfo->code;
-        goto _error;
-      }
+    taosThreadMutexLock(&pExchangeInfo->lock);
+    int32_t i = *(int32_t*)taosArrayGet(pExchangeInfo->pReadyQueue, 0);
+    taosArrayRemove(pExchangeInfo->pReadyQueue, 0);
+    taosThreadMutexUnlock(&pExchangeInfo->lock);
 
-      SRetrieveTableRsp*     pRsp = pDataInfo->pRsp;
-      SDownstreamSourceNode* pSource = taosArrayGet(pExchangeInfo->pSources, i);
-
-      SLoadRemoteDataInfo* pLoadInfo = &pExchangeInfo->loadInfo;
-      if (pRsp->numOfRows == 0) {
-        qDebug("%s vgId:%d, taskId:0x%" PRIx64 " execId:%d index:%d completed, rowsOfSource:%" PRIu64
-               ", totalRows:%" PRIu64 ", completed:%d try next %d/%" PRIzu,
-               GET_TASKID(pTaskInfo), pSource->addr.nodeId, pSource->taskId, pSource->execId, i, pDataInfo->totalRows,
-               pExchangeInfo->loadInfo.totalRows, completed + 1, i + 1, totalSources);
-        pDataInfo->status = EX_SOURCE_DATA_EXHAUSTED;
-        completed += 1;
-        taosMemoryFreeClear(pDataInfo->pRsp);
-        continue;
-      }
+    SSourceDataInfo* pDataInfo = taosArrayGet(pExchangeInfo->pSourceDataInfo, i);
+    pExchangeInfo->numOfInflight -= 1;
 
-      SRetrieveTableRsp* pRetrieveRsp = pDataInfo->pRsp;
-      int32_t            index = 0;
-      char*              pStart = pRetrieveRsp->data;
-      while (index++ < pRetrieveRsp->numOfBlocks) {
-        SSDataBlock* pb = createOneDataBlock(pExchangeInfo->pDummyBlock, false);
-        code = extractDataBlockFromFetchRsp(pb, pStart, NULL, &pStart);
-        if (code != 0) {
-          taosMemoryFreeClear(pDataInfo->pRsp);
-          goto _error;
-        }
+    if (pDataInfo->code != TSDB_CODE_SUCCESS) {
+      code = pDataInfo->code;
+      goto _error;
+    }
 
-        taosArrayPush(pExchangeInfo->pResultBlockList, &pb);
-      }
+    pRsp = pDataInfo->pRsp;
+    pDataInfo->pRsp = NULL;
 
-      updateLoadRemoteInfo(pLoadInfo, pRetrieveRsp->numOfRows, pRetrieveRsp->compLen, startTs, pOperator);
-
-      if (pRsp->completed == 1) {
-        qDebug("%s fetch msg rsp from vgId:%d, taskId:0x%" PRIx64
-               " execId:%d"
-               " index:%d completed, blocks:%d, numOfRows:%d, rowsOfSource:%" PRIu64 ", totalRows:%" PRIu64
-               ", total:%.2f Kb,"
-               " completed:%d try next %d/%" PRIzu,
-               GET_TASKID(pTaskInfo), pSource->addr.nodeId, pSource->taskId, pSource->execId, i, pRsp->numOfBlocks,
-               pRsp->numOfRows, pDataInfo->totalRows, pLoadInfo->totalRows, pLoadInfo->totalSize / 1024.0,
-               completed + 1, i + 1, totalSources);
-        completed += 1;
-        pDataInfo->status = EX_SOURCE_DATA_EXHAUSTED;
-      } else {
-        qDebug("%s fetch msg rsp from vgId:%d, taskId:0x%" PRIx64
-               " execId:%d blocks:%d, numOfRows:%d, totalRows:%" PRIu64 ", total:%.2f Kb",
-               GET_TASKID(pTaskInfo), pSource->addr.nodeId, pSource->taskId, pSource->execId, pRsp->numOfBlocks,
-               pRsp->numOfRows, pLoadInfo->totalRows, pLoadInfo->totalSize / 1024.0);
+    SDownstreamSourceNode* pSource = taosArrayGet(pExchangeInfo->pSources, i);
+    SLoadRemoteDataInfo*   pLoadInfo = &pExchangeInfo->loadInfo;
+
+    if (pRsp->numOfRows == 0) {
+      pDataInfo->status = EX_SOURCE_DATA_EXHAUSTED;
+      pExchangeInfo->numOfExhausted += 1;
+      qDebug("%s vgId:%d, taskId:0x%" PRIx64 " execId:%d index:%d completed, rowsOfSource:%" PRIu64
+             ", totalRows:%" PRIu64 ", completed:%d/%" PRIzu,
+             GET_TASKID(pTaskInfo), pSource->addr.nodeId, pSource->taskId, pSource->execId, i, pDataInfo->totalRows,
+             pExchangeInfo->loadInfo.totalRows, pExchangeInfo->numOfExhausted, totalSources);
+      taosMemoryFreeClear(pRsp);
+
+      code = fillFetchSlots(pExchangeInfo, pTaskInfo);
+      if (code != TSDB_CODE_SUCCESS) {
+        goto _error;
       }
+      continue;
+    }
 
-      taosMemoryFreeClear(pDataInfo->pRsp);
+    if (pRsp->completed == 1) {
+      pDataInfo->status = EX_SOURCE_DATA_EXHAUSTED;
+      pExchangeInfo->numOfExhausted += 1;
+    } else {
+      taosArrayPush(pExchangeInfo->pWaitQueue, &i);
+    }
 
-      if (pDataInfo->status != EX_SOURCE_DATA_EXHAUSTED) {
-        pDataInfo->status = EX_SOURCE_DATA_NOT_READY;
-        code = doSendFetchDataRequest(pExchangeInfo, pTaskInfo, i);
-        if (code != TSDB_CODE_SUCCESS) {
-          taosMemoryFreeClear(pDataInfo->pRsp);
-          goto _error;
-        }
+    // prefetch the next batch before decoding this one, so the network round trip overlaps with the
+    // processing in the upstream operators
+    code = fillFetchSlots(pExchangeInfo, pTaskInfo);
+    if (code != TSDB_CODE_SUCCESS) {
+      goto _error;
+    }
+
+    int32_t index = 0;
+    char*   pStart = pRsp->data;
+    while (index++ < pRsp->numOfBlocks) {
+      SSDataBlock* pb = createOneDataBlock(pExchangeInfo->pDummyBlock, false);
+      code = extractDataBlockFromFetchRsp(pb, pStart, NULL, &pStart);
+      if (code != 0) {
+        blockDataDestroy(pb);
+        goto _error;
       }
 
-      return;
+      taosArrayPush(pExchangeInfo->pResultBlockList, &pb);
     }
 
-    if (completed == totalSources) {
-      setAllSourcesCompleted(pOperator, startTs);
-      return;
+    updateLoadRemoteInfo(pLoadInfo, pRsp->numOfRows, pRsp->compLen, startTs, pOperator);
+    pDataInfo->totalRows += pRsp->numOfRows;
+
+    if (pRsp->completed == 1) {
+      qDebug("%s fetch msg rsp from vgId:%d, taskId:0x%" PRIx64
+             " execId:%d"
+             " index:%d completed, blocks:%d, numOfRows:%d, rowsOfSource:%" PRIu64 ", totalRows:%" PRIu64
+             ", total:%.2f Kb, completed:%d/%" PRIzu,
+             GET_TASKID(pTaskInfo), pSource->addr.nodeId, pSource->taskId, pSource->execId, i, pRsp->numOfBlocks,
+             pRsp->numOfRows, pDataInfo->totalRows, pLoadInfo->totalRows, pLoadInfo->totalSize / 1024.0,
+             pExchangeInfo->numOfExhausted, totalSources);
+    } else {
+      qDebug("%s fetch msg rsp from vgId:%d, taskId:0x%" PRIx64
+             " execId:%d blocks:%d, numOfRows:%d, totalRows:%" PRIu64 ", total:%.2f Kb, inflight:%d",
+             GET_TASKID(pTaskInfo), pSource->addr.nodeId, pSource->taskId, pSource->execId, pRsp->numOfBlocks,
+             pRsp->numOfRows, pLoadInfo->totalRows, pLoadInfo->totalSize / 1024.0, pExchangeInfo->numOfInflight);
     }
 
-    sched_yield();
+    taosMemoryFreeClear(pRsp);
+    return;
   }
 
 _error:
+  taosMemoryFreeClear(pRsp);
   pTaskInfo->code = code;
 }
 
@@ -2006,32 +2038,43 @@ static int32_t prepareConcurrentlyLoad(SOperatorInfo* pOperator) {
   size_t  totalSources = taosArrayGetSize(pExchangeInfo->pSources);
   int64_t startTs = taosGetTimestampUs();
 
-  // Asynchronously send all fetch requests to all sources.
+  // Asynchronously send the fetch requests to as many sources as the fetch slots allow, the rest are sent
+  // once a slot is released.
   for (int32_t i = 0; i < totalSources; ++i) {
-    int32_t code = doSendFetchDataRequest(pExchangeInfo, pTaskInfo, i);
-    if (code != TSDB_CODE_SUCCESS) {
-      pTaskInfo->code = code;
-      return code;
-    }
+    taosArrayPush(pExchangeInfo->pWaitQueue, &i);
+  }
+
+  int32_t code = fillFetchSlots(pExchangeInfo, pTaskInfo);
+  if (code != TSDB_CODE_SUCCESS) {
+    pTaskInfo->code = code;
+    return code;
   }
 
   int64_t endTs = taosGetTimestampUs();
-  qDebug("%s send all fetch requests to %" PRIzu " sources completed, elapsed:%.2fms", GET_TASKID(pTaskInfo),
-         totalSources, (endTs - startTs) / 1000.0);
+  qDebug("%s send fetch requests to %d of %" PRIzu " sources completed, elapsed:%.2fms", GET_TASKID(pTaskInfo),
+         pExchangeInfo->numOfInflight, totalSources, (endTs - startTs) / 1000.0);
 
   pOperator->status = OP_RES_TO_RETURN;
   pOperator->cost.openCost = taosGetTimestampUs() - startTs;
-
-  tsem_wait(&pExchangeInfo->ready);
   return TSDB_CODE_SUCCESS;
 }
 
+// send the fetch request of a source in the sequential load, at most one request is in flight
+static int32_t seqSendFetchDataRequest(SExchangeInfo* pExchangeInfo, SExecTaskInfo* pTaskInfo, int32_t sourceIndex) {
+  SSourceDataInfo* pDataInfo = taosArrayGet(pExchangeInfo->pSourceDataInfo, sourceIndex);
+  pDataInfo->status = EX_SOURCE_DATA_NOT_READY;
+  pExchangeInfo->numOfInflight = 1;
+  return doSendFetchDataRequest(pExchangeInfo, pTaskInfo, sourceIndex);
+}
+
 static int32_t seqLoadRemoteData(SOperatorInfo* pOperator) {
   SExchangeInfo* pExchangeInfo = pOperator->info;
   SExecTaskInfo* pTaskInfo = pOperator->pTaskInfo;
 
-  size_t  totalSources = taosArrayGetSize(pExchangeInfo->pSources);
-  int64_t startTs = taosGetTimestampUs();
+  size_t             totalSources = taosArrayGetSize(pExchangeInfo->pSources);
+  int64_t            startTs = taosGetTimestampUs();
+  SRetrieveTableRsp* pRsp = NULL;
+  int32_t            code = TSDB_CODE_SUCCESS;
 
   while (1) {
     if (pExchangeInfo->current >= totalSources) {
@@ -2039,8 +2082,16 @@ static int32_t seqLoadRemoteData(SOperatorInfo* pOperator) {
       return TSDB_CODE_SUCCESS;
     }
 
-    doSendFetchDataRequest(pExchangeInfo, pTaskInfo, pExchangeInfo->current);
+    // the request may have been sent ahead when the previous response was received
+    if (pExchangeInfo->numOfInflight == 0) {
+      code = seqSendFetchDataRequest(pExchangeInfo, pTaskInfo, pExchangeInfo->current);
+      if (code != TSDB_CODE_SUCCESS) {
+        goto _error;
+      }
+    }
+
     tsem_wait(&pExchangeInfo->ready);
+    pExchangeInfo->numOfInflight = 0;
 
     SSourceDataInfo*       pDataInfo = taosArrayGet(pExchangeInfo->pSourceDataInfo, pExchangeInfo->current);
     SDownstreamSourceNode* pSource = taosArrayGet(pExchangeInfo->pSources, pExchangeInfo->current);
@@ -2048,11 +2099,13 @@ static int32_t seqLoadRemoteData(SOperatorInfo* pOperator) {
     if (pDataInfo->code != TSDB_CODE_SUCCESS) {
       qError("%s vgId:%d, taskID:0x%" PRIx64 " execId:%d error happens, code:%s", GET_TASKID(pTaskInfo),
              pSource->addr.nodeId, pSource->taskId, pSource->execId, tstrerror(pDataInfo->code));
-      pOperator->pTaskInfo->code = pDataInfo->code;
-      return pOperator->pTaskInfo->code;
+      code = pDataInfo->code;
+      goto _error;
     }
 
-    SRetrieveTableRsp*   pRsp = pDataInfo->pRsp;
+    pRsp = pDataInfo->pRsp;
+    pDataInfo->pRsp = NULL;
+
     SLoadRemoteDataInfo* pLoadInfo = &pExchangeInfo->loadInfo;
     if (pRsp->numOfRows == 0) {
       qDebug("%s vgId:%d, taskID:0x%" PRIx64 " execId:%d %d of total completed, rowsOfSource:%" PRIu64
@@ -2062,19 +2115,14 @@ static int32_t seqLoadRemoteData(SOperatorInfo* pOperator) {
 
       pDataInfo->status = EX_SOURCE_DATA_EXHAUSTED;
       pExchangeInfo->current += 1;
-      taosMemoryFreeClear(pDataInfo->pRsp);
+      taosMemoryFreeClear(pRsp);
       continue;
     }
 
-    SRetrieveTableRsp* pRetrieveRsp = pDataInfo->pRsp;
-
-    char*   pStart = pRetrieveRsp->data;
-    int32_t code = extractDataBlockFromFetchRsp(NULL, pStart, NULL, &pStart);
-
     if (pRsp->completed == 1) {
       qDebug("%s fetch msg rsp from vgId:%d, taskId:0x%" PRIx64 " execId:%d numOfRows:%d, rowsOfSource:%" PRIu64
              ", totalRows:%" PRIu64 ", totalBytes:%" PRIu64 " try next %d/%" PRIzu,
-             GET_TASKID(pTaskInfo), pSource->addr.nodeId, pSource->taskId, pSource->execId, pRetrieveRsp->numOfRows,
+             GET_TASKID(pTaskInfo), pSource->addr.nodeId, pSource->taskId, pSource->execId, pRsp->numOfRows,
              pDataInfo->totalRows, pLoadInfo->totalRows, pLoadInfo->totalSize, pExchangeInfo->current + 1,
              totalSources);
 
@@ -2083,16 +2131,42 @@ static int32_t seqLoadRemoteData(SOperatorInfo* pOperator) {
     } else {
       qDebug("%s fetch msg rsp from vgId:%d, taskId:0x%" PRIx64 " execId:%d numOfRows:%d, totalRows:%" PRIu64
              ", totalBytes:%" PRIu64,
-             GET_TASKID(pTaskInfo), pSource->addr.nodeId, pSource->taskId, pSource->execId, pRetrieveRsp->numOfRows,
+             GET_TASKID(pTaskInfo), pSource->addr.nodeId, pSource->taskId, pSource->execId, pRsp->numOfRows,
              pLoadInfo->totalRows, pLoadInfo->totalSize);
     }
 
-    updateLoadRemoteInfo(pLoadInfo, pRetrieveRsp->numOfRows, pRetrieveRsp->compLen, startTs, pOperator);
-    pDataInfo->totalRows += pRetrieveRsp->numOfRows;
+    // prefetch the next batch, of this source or the next one, before decoding this one
+    if (pExchangeInfo->current < totalSources) {
+      code = seqSendFetchDataRequest(pExchangeInfo, pTaskInfo, pExchangeInfo->current);
+      if (code != TSDB_CODE_SUCCESS) {
+        goto _error;
+      }
+    }
 
-    taosMemoryFreeClear(pDataInfo->pRsp);
+    int32_t index = 0;
+    char*   pStart = pRsp->data;
+    while (index++ < pRsp->numOfBlocks) {
+      SSDataBlock* pb = createOneDataBlock(pExchangeInfo->pDummyBlock, false);
+      code = extractDataBlockFromFetchRsp(pb, pStart, NULL, &pStart);
+      if (code != TSDB_CODE_SUCCESS) {
+        blockDataDestroy(pb);
+        goto _error;
+      }
+
+      taosArrayPush(pExchangeInfo->pResultBlockList, &pb);
+    }
+
+    updateLoadRemoteInfo(pLoadInfo, pRsp->numOfRows, pRsp->compLen, startTs, pOperator);
+    pDataInfo->totalRows += pRsp->numOfRows;
+
+    taosMemoryFreeClear(pRsp);
     return TSDB_CODE_SUCCESS;
   }
+
+_error:
+  taosMemoryFreeClear(pRsp);
+  pTaskInfo->code = code;
+  return code;
 }
 
 static int32_t prepareLoadRemoteData(SOperatorInfo* pOperator) {
@@ -2258,6 +2332,15 @@ SOperatorInfo* createExchangeOperatorInfo(void* pTransporter, SExchangePhysiNode
   pInfo->seqLoadData = false;
   pInfo->pTransporter = pTransporter;
 
+  taosThreadMutexInit(&pInfo->lock, NULL);
+  pInfo->pReadyQueue = taosArrayInit(4, sizeof(int32_t));
+  pInfo->pWaitQueue = taosArrayInit(4, sizeof(int32_t));
+  pInfo->maxInflight = tsQueryExchangePrefetch;
+  if (pInfo->pReadyQueue == NULL || pInfo->pWaitQueue == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _error;
+  }
+
   pOperator->name = "ExchangeOperator";
   pOperator->operatorType = QUERY_NODE_PHYSICAL_PLAN_EXCHANGE;
   pOperator->blocking = false;
@@ -3119,7 +3202,10 @@ void doDestroyExchangeOperatorInfo(void* param) {
   }
 
   blockDataDestroy(pExInfo->pDummyBlock);
+  taosArrayDestroy(pExInfo->pReadyQueue);
+  taosArrayDestroy(pExInfo->pWaitQueue);
 
+  taosThreadMutexDestroy(&pExInfo->lock);
   tsem_destroy(&pExInfo->ready);
   taosMemoryFreeClear(param);
 }
@@ -3740,6 +3826,8 @@ SOperatorInfo* createOperatorTree(SPhysiNode* pPhyNode, SExecTaskInfo* pTaskInfo
     pOptr = createStreamStateAggOperatorInfo(ops[0], pPhyNode, pTaskInfo);
   } else if (QUERY_NODE_PHYSICAL_PLAN_MERGE_JOIN == type) {
     pOptr = createMergeJoinOperatorInfo(ops, size, (SSortMergeJoinPhysiNode*)pPhyNode, pTaskInfo);
+  } else if (QUERY_NODE_PHYSICAL_PLAN_HASH_JOIN == type) {
+    pOptr = createHashJoinOperatorInfo(ops, size, (SHashJoinPhysiNode*)pPhyNode, pTaskInfo);
   } else if (QUERY_NODE_PHYSICAL_PLAN_FILL == type) {
     pOptr = createFillOperatorInfo(ops[0], (SFillPhysiNode*)pPhyNode, pTaskInfo);
   } else if (QUERY_NODE_PHYSICAL_PLAN_STREAM_FILL == type) {
@@ -50,6 +50,11 @@ static void destroyGroupOperatorInfo(void* param) {
 
   cleanupGroupResInfo(&pInfo->groupResInfo);
   cleanupAggSup(&pInfo->aggSup);
+
+  taosHashCleanup(pInfo->pBatchHash);
+  taosMemoryFreeClear(pInfo->pBatchKeyBuf);
+  taosMemoryFreeClear(pInfo->pBatchIndex);
+  taosMemoryFreeClear(pInfo->pBatchBuf);
   taosMemoryFreeClear(param);
 }
 
@@ -305,6 +310,228 @@ static void doHashGroupbyAgg(SOperatorInfo* pOperator, SSDataBlock* pBlock) {
   }
 }
 
+static bool canGroupbyInBatch(SGroupbyOperatorInfo* pInfo, SSDataBlock* pBlock) {
+  // the block sma is used instead of the data, or there is nothing to batch
+  if (pBlock->pBlockAgg != NULL || pBlock->info.rows <= 1) {
+    return false;
+  }
+
+  size_t numOfGroupCols = taosArrayGetSize(pInfo->pGroupCols);
+  for (int32_t i = 0; i < numOfGroupCols; ++i) {
+    SColumn* pCol = taosArrayGet(pInfo->pGroupCols, i);
+    if (pCol->type == TSDB_DATA_TYPE_JSON) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// same layout as buildGroupKeys, but reads the key columns of the block directly
+static int32_t buildGroupKeysByRow(char* pKey, SArray* pGroupCols, SSDataBlock* pBlock, int32_t rowIndex) {
+  size_t numOfGroupCols = taosArrayGetSize(pGroupCols);
+
+  char* isNull = pKey;
+  char* pStart = pKey + sizeof(int8_t) * numOfGroupCols;
+  for (int32_t i = 0; i < numOfGroupCols; ++i) {
+    SColumn*         pCol = taosArrayGet(pGroupCols, i);
+    SColumnInfoData* pColInfoData = taosArrayGet(pBlock->pDataBlock, pCol->slotId);
+
+    if (colDataIsNull(pColInfoData, pBlock->info.rows, rowIndex, NULL)) {
+      isNull[i] = 1;
+      continue;
+    }
+
+    isNull[i] = 0;
+    char* val = colDataGetData(pColInfoData, rowIndex);
+    if (IS_VAR_DATA_TYPE(pCol->type)) {
+      varDataCopy(pStart, val);
+      pStart += varDataTLen(val);
+    } else {
+      memcpy(pStart, val, pCol->bytes);
+      pStart += pCol->bytes;
+    }
+  }
+
+  return (int32_t)(pStart - pKey);
+}
+
+// reorder the rows of the block in place, the i-th row of the result is the pOrder[i]-th row of the input
+static int32_t reorderBlockRows(SGroupbyOperatorInfo* pInfo, SSDataBlock* pBlock, const int32_t* pOrder) {
+  int32_t rows = pBlock->info.rows;
+  size_t  numOfCols = taosArrayGetSize(pBlock->pDataBlock);
+
+  int64_t bufLen = rows * sizeof(int32_t);
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    SColumnInfoData* pCol = taosArrayGet(pBlock->pDataBlock, i);
+    if (!IS_VAR_DATA_TYPE(pCol->info.type)) {
+      bufLen = TMAX(bufLen, (int64_t)rows * pCol->info.bytes + BitmapLen(rows));
+    }
+  }
+
+  if (bufLen > pInfo->batchBufLen) {
+    char* p = taosMemoryRealloc(pInfo->pBatchBuf, bufLen);
+    if (p == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+    pInfo->pBatchBuf = p;
+    pInfo->batchBufLen = bufLen;
+  }
+
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    SColumnInfoData* pCol = taosArrayGet(pBlock->pDataBlock, i);
+
+    if (IS_VAR_DATA_TYPE(pCol->info.type)) {
+      // only the offsets move, the var data stays where it is
+      int32_t* pOffset = (int32_t*)pInfo->pBatchBuf;
+      for (int32_t j = 0; j < rows; ++j) {
+        pOffset[j] = pCol->varmeta.offset[pOrder[j]];
+      }
+      memcpy(pCol->varmeta.offset, pOffset, rows * sizeof(int32_t));
+      continue;
+    }
+
+    if (pCol->pData == NULL) {
+      continue;
+    }
+
+    int32_t bytes = pCol->info.bytes;
+    char*   pData = pInfo->pBatchBuf;
+    switch (bytes) {
+      case sizeof(int8_t):
+        for (int32_t j = 0; j < rows; ++j) ((int8_t*)pData)[j] = ((int8_t*)pCol->pData)[pOrder[j]];
+        break;
+      case sizeof(int16_t):
+        for (int32_t j = 0; j < rows; ++j) ((int16_t*)pData)[j] = ((int16_t*)pCol->pData)[pOrder[j]];
+        break;
+      case sizeof(int32_t):
+        for (int32_t j = 0; j < rows; ++j) ((int32_t*)pData)[j] = ((int32_t*)pCol->pData)[pOrder[j]];
+        break;
+      case sizeof(int64_t):
+        for (int32_t j = 0; j < rows; ++j) ((int64_t*)pData)[j] = ((int64_t*)pCol->pData)[pOrder[j]];
+        break;
+      default:
+        for (int32_t j = 0; j < rows; ++j) memcpy(pData + j * bytes, pCol->pData + pOrder[j] * bytes, bytes);
+        break;
+    }
+    memcpy(pCol->pData, pData, rows * bytes);
+
+    if (pCol->nullbitmap != NULL) {
+      char* pBitmap = pInfo->pBatchBuf + rows * bytes;
+      memset(pBitmap, 0, BitmapLen(rows));
+      for (int32_t j = 0; j < rows; ++j) {
+        if (colDataIsNull_f(pCol->nullbitmap, pOrder[j])) {
+          colDataSetNull_f(pBitmap, j);
+        }
+      }
+      memcpy(pCol->nullbitmap, pBitmap, BitmapLen(rows));
+    }
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+// Resolve the group of every row of the block first, then move the rows of each group together, so that each group
+// in the block costs one result row lookup and one call of the aggregate functions, no matter how the rows are ordered.
+// The relative order of the rows inside a group is kept.
+static void doHashGroupbyAggBatch(SOperatorInfo* pOperator, SSDataBlock* pBlock) {
+  SExecTaskInfo*        pTaskInfo = pOperator->pTaskInfo;
+  SGroupbyOperatorInfo* pInfo = pOperator->info;
+  SqlFunctionCtx*       pCtx = pOperator->exprSupp.pCtx;
+  int32_t               rows = pBlock->info.rows;
+
+  if (pInfo->batchIndexCap < rows) {
+    int32_t* p = taosMemoryRealloc(pInfo->pBatchIndex, sizeof(int32_t) * (rows * 3 + 1));
+    if (p == NULL) {
+      T_LONG_JMP(pTaskInfo->env, TSDB_CODE_OUT_OF_MEMORY);
+    }
+    pInfo->pBatchIndex = p;
+    pInfo->batchIndexCap = rows;
+  }
+
+  int32_t* pRowGroup = pInfo->pBatchIndex;  // group of each row
+  int32_t* pOffset = pRowGroup + rows;      // first row of each group, numOfGroups + 1 entries
+  int32_t* pOrder = pOffset + rows + 1;     // rows ordered by group
+
+  // consecutive rows with the same keys skip the hash lookup
+  char*   pCurKey = pInfo->pBatchKeyBuf;
+  char*   pPrevKey = pInfo->pBatchKeyBuf + pInfo->groupKeyLen;
+  int32_t prevLen = -1;
+  int32_t numOfGroups = 0;
+  int32_t numOfRuns = 0;
+
+  taosHashClear(pInfo->pBatchHash);
+  for (int32_t j = 0; j < rows; ++j) {
+    int32_t len = buildGroupKeysByRow(pCurKey, pInfo->pGroupCols, pBlock, j);
+    if (len == prevLen && memcmp(pCurKey, pPrevKey, len) == 0) {
+      pRowGroup[j] = pRowGroup[j - 1];
+      continue;
+    }
+
+    numOfRuns++;
+    int32_t* pGroup = taosHashGet(pInfo->pBatchHash, pCurKey, len);
+    if (pGroup != NULL) {
+      pRowGroup[j] = *pGroup;
+    } else {
+      if (taosHashPut(pInfo->pBatchHash, pCurKey, len, &numOfGroups, sizeof(int32_t)) != 0) {
+        T_LONG_JMP(pTaskInfo->env, TSDB_CODE_OUT_OF_MEMORY);
+      }
+      pRowGroup[j] = numOfGroups++;
+    }
+
+    TSWAP(pCurKey, pPrevKey);
+    prevLen = len;
+  }
+
+  if (numOfRuns == numOfGroups) {
+    // each group is already one run of rows, groups are numbered in the order they appear
+    pOffset[0] = 0;
+    for (int32_t j = 1; j < rows; ++j) {
+      if (pRowGroup[j] != pRowGroup[j - 1]) {
+        pOffset[pRowGroup[j]] = j;
+      }
+    }
+    pOffset[numOfGroups] = rows;
+  } else {
+    // counting sort of the rows by group
+    memset(pOffset, 0, sizeof(int32_t) * (numOfGroups + 1));
+    for (int32_t j = 0; j < rows; ++j) {
+      pOffset[pRowGroup[j] + 1]++;
+    }
+    for (int32_t g = 0; g < numOfGroups; ++g) {
+      pOffset[g + 1] += pOffset[g];
+    }
+    for (int32_t j = 0; j < rows; ++j) {
+      pOrder[pOffset[pRowGroup[j]]++] = j;
+    }
+    // pOffset[g] is the end of group g now, shift it back to the start
+    for (int32_t g = numOfGroups; g > 0; --g) {
+      pOffset[g] = pOffset[g - 1];
+    }
+    pOffset[0] = 0;
+
+    int32_t code = reorderBlockRows(pInfo, pBlock, pOrder);
+    if (code != TSDB_CODE_SUCCESS) {
+      T_LONG_JMP(pTaskInfo->env, code);
+    }
+  }
+
+  for (int32_t g = 0; g < numOfGroups; ++g) {
+    int32_t rowIndex = pOffset[g];
+    int32_t num = pOffset[g + 1] - rowIndex;
+
+    int32_t len = buildGroupKeysByRow(pInfo->keyBuf, pInfo->pGroupCols, pBlock, rowIndex);
+    int32_t ret = setGroupResultOutputBuf(pOperator, &(pInfo->binfo), pOperator->exprSupp.numOfExprs, pInfo->keyBuf,
+                                          len, pBlock->info.groupId, pInfo->aggSup.pResultBuf, &pInfo->aggSup);
+    if (ret != TSDB_CODE_SUCCESS) {
+      T_LONG_JMP(pTaskInfo->env, TSDB_CODE_QRY_APP_ERROR);
+    }
+
+    doApplyFunctions(pTaskInfo, pCtx, NULL, rowIndex, num, rows, pOperator->exprSupp.numOfExprs);
+    doAssignGroupKeys(pCtx, pOperator->exprSupp.numOfExprs, rows, rowIndex);
+  }
+}
+
 static SSDataBlock* buildGroupResultDataBlock(SOperatorInfo* pOperator) {
   SGroupbyOperatorInfo* pInfo = pOperator->info;
 
@@ -370,7 +597,11 @@ static SSDataBlock* hashGroupbyAggregate(SOperatorInfo* pOperator) {
       }
     }
 
-    doHashGroupbyAgg(pOperator, pBlock);
+    if (canGroupbyInBatch(pInfo, pBlock)) {
+      doHashGroupbyAggBatch(pOperator, pBlock);
+    } else {
+      doHashGroupbyAgg(pOperator, pBlock);
+    }
   }
 
   pOperator->status = OP_RES_TO_RETURN;
@@ -418,6 +649,12 @@ SOperatorInfo* createGroupOperatorInfo(SOperatorInfo* downstream, SExprInfo* pEx
     goto _error;
   }
 
+  pInfo->pBatchHash = taosHashInit(1024, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY), false, HASH_NO_LOCK);
+  pInfo->pBatchKeyBuf = taosMemoryCalloc(2, pInfo->groupKeyLen);
+  if (pInfo->pBatchHash == NULL || pInfo->pBatchKeyBuf == NULL) {
+    goto _error;
+  }
+
   initResultSizeInfo(&pOperator->resultInfo, 4096);
   code = initAggInfo(&pOperator->exprSupp, &pInfo->aggSup, pExprInfo, numOfCols, pInfo->groupKeyLen, pTaskInfo->id.str);
   if (code != TSDB_CODE_SUCCESS) {
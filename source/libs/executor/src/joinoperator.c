@@ -28,6 +28,17 @@ static SSDataBlock* doMergeJoin(struct SOperatorInfo* pOperator);
 static void         destroyMergeJoinOperator(void* param);
 static void         extractTimeCondition(SJoinOperatorInfo* pInfo, SOperatorInfo** pDownstream, int32_t numOfDownstream,
                                          SSortMergeJoinPhysiNode* pJoinNode);
+static SSDataBlock* doHashJoin(struct SOperatorInfo* pOperator);
+static int32_t      doOpenHashJoin(SOperatorInfo* pOperator);
+static void         destroyHashJoinOperator(void* param);
+
+// memory budget of the build side, beyond it both sides are partitioned into the disk based buffer
+#define HASH_JOIN_BUILD_BUF_SIZE (64 * 1048576)
+#define HASH_JOIN_PART_BITS      5
+#define HASH_JOIN_PARTITIONS     (1 << HASH_JOIN_PART_BITS)
+#define HASH_JOIN_PART_ROWS      4096
+#define HASH_JOIN_PAGE_SIZE      65536
+#define HASH_JOIN_BUF_PAGES      64
 
 static void extractTimeCondition(SJoinOperatorInfo* pInfo, SOperatorInfo** pDownstream, int32_t numOfDownstream,
                                  SSortMergeJoinPhysiNode* pJoinNode) {
@@ -55,6 +66,22 @@ static void extractTimeCondition(SJoinOperatorInfo* pInfo, SOperatorInfo** pDown
   }
 }
 
+static SNode* createJoinCondAfterMerge(SNode* pOnConditions, SNode* pConditions) {
+  if (pOnConditions != NULL && pConditions != NULL) {
+    SLogicConditionNode* pLogicCond = (SLogicConditionNode*)nodesMakeNode(QUERY_NODE_LOGIC_CONDITION);
+    pLogicCond->pParameterList = nodesMakeList();
+    nodesListMakeAppend(&pLogicCond->pParameterList, nodesCloneNode(pOnConditions));
+    nodesListMakeAppend(&pLogicCond->pParameterList, nodesCloneNode(pConditions));
+    pLogicCond->condType = LOGIC_COND_TYPE_AND;
+    return (SNode*)pLogicCond;
+  } else if (pOnConditions != NULL) {
+    return nodesCloneNode(pOnConditions);
+  } else if (pConditions != NULL) {
+    return nodesCloneNode(pConditions);
+  }
+  return NULL;
+}
+
 SOperatorInfo* createMergeJoinOperatorInfo(SOperatorInfo** pDownstream, int32_t numOfDownstream,
                                            SSortMergeJoinPhysiNode* pJoinNode, SExecTaskInfo* pTaskInfo) {
   SJoinOperatorInfo* pInfo = taosMemoryCalloc(1, sizeof(SJoinOperatorInfo));
@@ -82,20 +109,7 @@ SOperatorInfo* createMergeJoinOperatorInfo(SOperatorInfo** pDownstream, int32_t
 
   extractTimeCondition(pInfo, pDownstream, numOfDownstream, pJoinNode);
 
-  if (pJoinNode->pOnConditions != NULL && pJoinNode->node.pConditions != NULL) {
-    pInfo->pCondAfterMerge = nodesMakeNode(QUERY_NODE_LOGIC_CONDITION);
-    SLogicConditionNode* pLogicCond = (SLogicConditionNode*)(pInfo->pCondAfterMerge);
-    pLogicCond->pParameterList = nodesMakeList();
-    nodesListMakeAppend(&pLogicCond->pParameterList, nodesCloneNode(pJoinNode->pOnConditions));
-    nodesListMakeAppend(&pLogicCond->pParameterList, nodesCloneNode(pJoinNode->node.pConditions));
-    pLogicCond->condType = LOGIC_COND_TYPE_AND;
-  } else if (pJoinNode->pOnConditions != NULL) {
-    pInfo->pCondAfterMerge = nodesCloneNode(pJoinNode->pOnConditions);
-  } else if (pJoinNode->node.pConditions != NULL) {
-    pInfo->pCondAfterMerge = nodesCloneNode(pJoinNode->node.pConditions);
-  } else {
-    pInfo->pCondAfterMerge = NULL;
-  }
+  pInfo->pCondAfterMerge = createJoinCondAfterMerge(pJoinNode->pOnConditions, pJoinNode->node.pConditions);
 
   pInfo->inputOrder = TSDB_ORDER_ASC;
   if (pJoinNode->inputTsOrder == ORDER_ASC) {
@@ -136,11 +150,8 @@ void destroyMergeJoinOperator(void* param) {
   taosMemoryFreeClear(param);
 }
 
-static void mergeJoinJoinLeftRight(struct SOperatorInfo* pOperator, SSDataBlock* pRes, int32_t currRow,
-                                   SSDataBlock* pLeftBlock, int32_t leftPos, SSDataBlock* pRightBlock,
-                                   int32_t rightPos) {
-  SJoinOperatorInfo* pJoinInfo = pOperator->info;
-
+static void joinLeftRightRow(struct SOperatorInfo* pOperator, SSDataBlock* pRes, int32_t currRow,
+                             SSDataBlock* pLeftBlock, int32_t leftPos, SSDataBlock* pRightBlock, int32_t rightPos) {
   for (int32_t i = 0; i < pOperator->exprSupp.numOfExprs; ++i) {
     SColumnInfoData* pDst = taosArrayGet(pRes->pDataBlock, i);
 
@@ -274,8 +285,8 @@ static int32_t mergeJoinJoinDownstreamTsRanges(SOperatorInfo* pOperator, int64_t
           for (int32_t j = 0; j < rightNumJoin; ++j) {
               SRowLocation *leftRow = taosArrayGet(leftRowLocations, i);
               SRowLocation *rightRow = taosArrayGet(rightRowLocations, j);
-              mergeJoinJoinLeftRight(pOperator, pRes, *nRows, leftRow->pDataBlock, leftRow->pos, rightRow->pDataBlock,
-                                     rightRow->pos);
+              joinLeftRightRow(pOperator, pRes, *nRows, leftRow->pDataBlock, leftRow->pos, rightRow->pDataBlock,
+                               rightRow->pos);
               ++*nRows;
           }
       }
@@ -394,3 +405,570 @@ SSDataBlock* doMergeJoin(struct SOperatorInfo* pOperator) {
   }
   return (pRes->info.rows > 0) ? pRes : NULL;
 }
+
+static SArray* extractHashJoinKeys(SNodeList* pKeys, int32_t* pKeyLen) {
+  SArray* pKeyCols = taosArrayInit(LIST_LENGTH(pKeys), sizeof(SColumnInfo));
+  if (pKeyCols == NULL) {
+    return NULL;
+  }
+
+  SNode* pNode = NULL;
+  FOREACH(pNode, pKeys) {
+    SColumnInfo col = {0};
+    setJoinColumnInfo(&col, (SColumnNode*)pNode);
+    taosArrayPush(pKeyCols, &col);
+    (*pKeyLen) += col.bytes;
+  }
+  return pKeyCols;
+}
+
+SOperatorInfo* createHashJoinOperatorInfo(SOperatorInfo** pDownstream, int32_t numOfDownstream,
+                                          SHashJoinPhysiNode* pJoinNode, SExecTaskInfo* pTaskInfo) {
+  SHashJoinOperatorInfo* pInfo = taosMemoryCalloc(1, sizeof(SHashJoinOperatorInfo));
+  SOperatorInfo*         pOperator = taosMemoryCalloc(1, sizeof(SOperatorInfo));
+  if (pOperator == NULL || pInfo == NULL) {
+    goto _error;
+  }
+
+  int32_t leftKeyLen = 0;
+  int32_t rightKeyLen = 0;
+  pInfo->pKeyCols[0] = extractHashJoinKeys(pJoinNode->pLeftKeys, &leftKeyLen);
+  pInfo->pKeyCols[1] = extractHashJoinKeys(pJoinNode->pRightKeys, &rightKeyLen);
+  pInfo->keyBufSize = TMAX(leftKeyLen, rightKeyLen);
+  pInfo->pKeyBuf = taosMemoryMalloc(pInfo->keyBufSize);
+  pInfo->pHashTable = tSimpleHashInit(4096, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY));
+  pInfo->pBuildBlocks = taosArrayInit(8, POINTER_BYTES);
+  pInfo->pRowRefs = taosArrayInit(4096, sizeof(SHJoinRowRef));
+  pInfo->pPending[0] = taosArrayInit(8, POINTER_BYTES);
+  pInfo->pPending[1] = taosArrayInit(8, POINTER_BYTES);
+  if (pInfo->pKeyCols[0] == NULL || pInfo->pKeyCols[1] == NULL || pInfo->pKeyBuf == NULL ||
+      pInfo->pHashTable == NULL || pInfo->pBuildBlocks == NULL || pInfo->pRowRefs == NULL ||
+      pInfo->pPending[0] == NULL || pInfo->pPending[1] == NULL) {
+    goto _error;
+  }
+
+  int32_t rowSize = 0;
+  SNode*  pChild = NULL;
+  FOREACH(pChild, pJoinNode->node.pChildren) {
+    rowSize = TMAX(rowSize, ((SPhysiNode*)pChild)->pOutputDataBlockDesc->totalRowSize);
+  }
+  pInfo->pageSize = TMAX(getProperSortPageSize(rowSize), HASH_JOIN_PAGE_SIZE);
+  pInfo->buildBufSize = HASH_JOIN_BUILD_BUF_SIZE;
+
+  int32_t    numOfCols = 0;
+  SExprInfo* pExprInfo = createExprInfo(pJoinNode->pTargets, NULL, &numOfCols);
+  initResultSizeInfo(&pOperator->resultInfo, 4096);
+
+  pInfo->pRes = createResDataBlock(pJoinNode->node.pOutputDataBlockDesc);
+  pInfo->joinType = pJoinNode->joinType;
+  pInfo->nextRef = -1;
+  pInfo->curPart = -1;
+  pInfo->pCondAfterJoin = createJoinCondAfterMerge(pJoinNode->pOnConditions, pJoinNode->node.pConditions);
+
+  pOperator->name = "HashJoinOperator";
+  pOperator->operatorType = QUERY_NODE_PHYSICAL_PLAN_HASH_JOIN;
+  pOperator->blocking = true;
+  pOperator->status = OP_NOT_OPENED;
+  pOperator->exprSupp.pExprInfo = pExprInfo;
+  pOperator->exprSupp.numOfExprs = numOfCols;
+  pOperator->info = pInfo;
+  pOperator->pTaskInfo = pTaskInfo;
+
+  pOperator->fpSet =
+      createOperatorFpSet(doOpenHashJoin, doHashJoin, NULL, NULL, destroyHashJoinOperator, NULL, NULL, NULL);
+  int32_t code = appendDownstream(pOperator, pDownstream, numOfDownstream);
+  if (code != TSDB_CODE_SUCCESS) {
+    goto _error;
+  }
+
+  return pOperator;
+
+_error:
+  if (pInfo != NULL) {
+    destroyHashJoinOperator(pInfo);
+  }
+  taosMemoryFree(pOperator);
+  pTaskInfo->code = TSDB_CODE_OUT_OF_MEMORY;
+  return NULL;
+}
+
+static void hJoinClearBlocks(SArray* pBlocks) {
+  for (int32_t i = 0; i < taosArrayGetSize(pBlocks); ++i) {
+    blockDataDestroy(taosArrayGetP(pBlocks, i));
+  }
+  taosArrayClear(pBlocks);
+}
+
+void destroyHashJoinOperator(void* param) {
+  SHashJoinOperatorInfo* pInfo = (SHashJoinOperatorInfo*)param;
+
+  for (int32_t i = 0; i < 2; ++i) {
+    taosArrayDestroy(pInfo->pKeyCols[i]);
+    if (pInfo->pPending[i] != NULL) {
+      hJoinClearBlocks(pInfo->pPending[i]);
+      taosArrayDestroy(pInfo->pPending[i]);
+    }
+  }
+  if (pInfo->pBuildBlocks != NULL) {
+    hJoinClearBlocks(pInfo->pBuildBlocks);
+    taosArrayDestroy(pInfo->pBuildBlocks);
+  }
+  if (pInfo->pParts != NULL) {
+    for (int32_t i = 0; i < HASH_JOIN_PARTITIONS; ++i) {
+      for (int32_t j = 0; j < 2; ++j) {
+        taosArrayDestroy(pInfo->pParts[i].pPageIds[j]);
+        blockDataDestroy(pInfo->pParts[i].pBlock[j]);
+      }
+    }
+    taosMemoryFree(pInfo->pParts);
+  }
+  if (pInfo->pBuf != NULL) {
+    destroyDiskbasedBuf(pInfo->pBuf);
+  }
+
+  taosArrayDestroy(pInfo->pRowRefs);
+  tSimpleHashCleanup(pInfo->pHashTable);
+  taosMemoryFree(pInfo->pKeyBuf);
+  nodesDestroyNode(pInfo->pCondAfterJoin);
+  pInfo->pRes = blockDataDestroy(pInfo->pRes);
+  taosMemoryFreeClear(param);
+}
+
+// null never equals to anything, so the rows with any null key are not joined
+static bool hJoinBuildKey(SArray* pKeyCols, SSDataBlock* pBlock, int32_t rowIndex, char* pKeyBuf, int32_t* pKeyLen) {
+  char* p = pKeyBuf;
+  for (int32_t i = 0; i < taosArrayGetSize(pKeyCols); ++i) {
+    SColumnInfo*     pKey = taosArrayGet(pKeyCols, i);
+    SColumnInfoData* pCol = taosArrayGet(pBlock->pDataBlock, pKey->slotId);
+    if (colDataIsNull_s(pCol, rowIndex)) {
+      return false;
+    }
+
+    char* pData = colDataGetData(pCol, rowIndex);
+    if (IS_VAR_DATA_TYPE(pKey->type)) {
+      memcpy(p, pData, varDataTLen(pData));
+      p += varDataTLen(pData);
+    } else if (pKey->type == TSDB_DATA_TYPE_FLOAT) {
+      // float keys are compared by value: nan equals to nothing, and -0.0 equals to 0.0
+      float v = GET_FLOAT_VAL(pData);
+      if (isnan(v)) {
+        return false;
+      }
+      v = (v == 0) ? 0 : v;
+      memcpy(p, &v, sizeof(float));
+      p += sizeof(float);
+    } else if (pKey->type == TSDB_DATA_TYPE_DOUBLE) {
+      double v = GET_DOUBLE_VAL(pData);
+      if (isnan(v)) {
+        return false;
+      }
+      v = (v == 0) ? 0 : v;
+      memcpy(p, &v, sizeof(double));
+      p += sizeof(double);
+    } else {
+      memcpy(p, pData, pKey->bytes);
+      p += pKey->bytes;
+    }
+  }
+
+  *pKeyLen = (int32_t)(p - pKeyBuf);
+  return true;
+}
+
+static SSDataBlock* hJoinFetchBlock(SOperatorInfo* pOperator, int32_t idx) {
+  SHashJoinOperatorInfo* pInfo = pOperator->info;
+  if (pInfo->downstreamDone[idx]) {
+    return NULL;
+  }
+
+  SOperatorInfo* pDownstream = pOperator->pDownstream[idx];
+  SSDataBlock*   pBlock = pDownstream->fpSet.getNextFn(pDownstream);
+  if (pBlock == NULL) {
+    pInfo->downstreamDone[idx] = true;
+  }
+  return pBlock;
+}
+
+static int32_t hJoinBuildHashTable(SHashJoinOperatorInfo* pInfo) {
+  SArray* pKeyCols = pInfo->pKeyCols[pInfo->buildIdx];
+
+  for (int32_t i = 0; i < taosArrayGetSize(pInfo->pBuildBlocks); ++i) {
+    SSDataBlock* pBlock = taosArrayGetP(pInfo->pBuildBlocks, i);
+    for (int32_t j = 0; j < pBlock->info.rows; ++j) {
+      int32_t keyLen = 0;
+      if (!hJoinBuildKey(pKeyCols, pBlock, j, pInfo->pKeyBuf, &keyLen)) {
+        continue;
+      }
+
+      // link the row to the head of the rows with the same key
+      SHJoinRowRef ref = {.blockIdx = i, .rowIdx = j, .next = -1};
+      int32_t      refIdx = taosArrayGetSize(pInfo->pRowRefs);
+      int32_t*     pHead = tSimpleHashGet(pInfo->pHashTable, pInfo->pKeyBuf, keyLen);
+      if (pHead != NULL) {
+        ref.next = *pHead;
+        *pHead = refIdx;
+      } else if (tSimpleHashPut(pInfo->pHashTable, pInfo->pKeyBuf, keyLen, &refIdx, sizeof(int32_t)) != 0) {
+        return TSDB_CODE_OUT_OF_MEMORY;
+      }
+
+      if (taosArrayPush(pInfo->pRowRefs, &ref) == NULL) {
+        return TSDB_CODE_OUT_OF_MEMORY;
+      }
+    }
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t hJoinFlushPartBlock(SHashJoinOperatorInfo* pInfo, SSDataBlock* pBlock, SArray* pPageIds) {
+  int32_t start = 0;
+  while (start < pBlock->info.rows) {
+    int32_t stop = 0;
+    blockDataSplitRows(pBlock, pBlock->info.hasVarCol, start, &stop, pInfo->pageSize);
+    SSDataBlock* p = blockDataExtractBlock(pBlock, start, stop - start + 1);
+    if (p == NULL) {
+      return terrno;
+    }
+
+    int32_t pageId = -1;
+    void*   pPage = getNewBufPage(pInfo->pBuf, &pageId);
+    if (pPage == NULL) {
+      blockDataDestroy(p);
+      return terrno;
+    }
+
+    taosArrayPush(pPageIds, &pageId);
+    blockDataToBuf(pPage, p);
+
+    setBufPageDirty(pPage, true);
+    releaseBufPage(pInfo->pBuf, pPage);
+
+    blockDataDestroy(p);
+    start = stop + 1;
+  }
+
+  blockDataCleanup(pBlock);
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t hJoinSpillBlock(SHashJoinOperatorInfo* pInfo, int32_t idx, SSDataBlock* pBlock) {
+  size_t numOfCols = taosArrayGetSize(pBlock->pDataBlock);
+
+  for (int32_t i = 0; i < pBlock->info.rows; ++i) {
+    int32_t keyLen = 0;
+    if (!hJoinBuildKey(pInfo->pKeyCols[idx], pBlock, i, pInfo->pKeyBuf, &keyLen)) {
+      continue;
+    }
+
+    // the high bits choose the partition, the low bits are left to the hash table of the partition
+    uint32_t         hashVal = MurmurHash3_32(pInfo->pKeyBuf, keyLen);
+    SHJoinPartition* pPart = &pInfo->pParts[hashVal >> (32 - HASH_JOIN_PART_BITS)];
+    if (pPart->pBlock[idx] == NULL) {
+      pPart->pBlock[idx] = createOneDataBlock(pBlock, false);
+      if (pPart->pBlock[idx] == NULL || blockDataEnsureCapacity(pPart->pBlock[idx], HASH_JOIN_PART_ROWS) != 0) {
+        return TSDB_CODE_OUT_OF_MEMORY;
+      }
+    }
+
+    SSDataBlock* pDst = pPart->pBlock[idx];
+    for (int32_t j = 0; j < numOfCols; ++j) {
+      SColumnInfoData* pSrcCol = taosArrayGet(pBlock->pDataBlock, j);
+      SColumnInfoData* pDstCol = taosArrayGet(pDst->pDataBlock, j);
+      if (colDataIsNull_s(pSrcCol, i)) {
+        colDataAppendNULL(pDstCol, pDst->info.rows);
+      } else {
+        int32_t code = colDataAppend(pDstCol, pDst->info.rows, colDataGetData(pSrcCol, i), false);
+        if (code != TSDB_CODE_SUCCESS) {
+          return code;
+        }
+      }
+    }
+
+    pDst->info.rows += 1;
+    if (pDst->info.rows >= HASH_JOIN_PART_ROWS) {
+      int32_t code = hJoinFlushPartBlock(pInfo, pDst, pPart->pPageIds[idx]);
+      if (code != TSDB_CODE_SUCCESS) {
+        return code;
+      }
+    }
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+// grace hash join: both downstreams are partitioned by the join key, and joined partition by partition
+static int32_t hJoinSpillDownstreams(SOperatorInfo* pOperator) {
+  SHashJoinOperatorInfo* pInfo = pOperator->info;
+  SExecTaskInfo*         pTaskInfo = pOperator->pTaskInfo;
+
+  if (!osTempSpaceAvailable()) {
+    terrno = TSDB_CODE_NO_AVAIL_DISK;
+    qError("%s hash join spill failed since %s", GET_TASKID(pTaskInfo), terrstr(terrno));
+    return terrno;
+  }
+
+  int32_t code = createDiskbasedBuf(&pInfo->pBuf, pInfo->pageSize, pInfo->pageSize * HASH_JOIN_BUF_PAGES,
+                                    pTaskInfo->id.str, tsTempDir);
+  if (code != TSDB_CODE_SUCCESS) {
+    return code;
+  }
+
+  pInfo->pParts = taosMemoryCalloc(HASH_JOIN_PARTITIONS, sizeof(SHJoinPartition));
+  if (pInfo->pParts == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+  for (int32_t i = 0; i < HASH_JOIN_PARTITIONS; ++i) {
+    for (int32_t j = 0; j < 2; ++j) {
+      pInfo->pParts[i].pPageIds[j] = taosArrayInit(4, sizeof(int32_t));
+      if (pInfo->pParts[i].pPageIds[j] == NULL) {
+        return TSDB_CODE_OUT_OF_MEMORY;
+      }
+    }
+  }
+
+  qDebug("%s hash join build side exceeds %" PRId64 " bytes, spill into %d partitions", GET_TASKID(pTaskInfo),
+         pInfo->buildBufSize, HASH_JOIN_PARTITIONS);
+
+  for (int32_t i = 0; i < 2; ++i) {
+    for (int32_t j = 0; j < taosArrayGetSize(pInfo->pPending[i]); ++j) {
+      code = hJoinSpillBlock(pInfo, i, taosArrayGetP(pInfo->pPending[i], j));
+      if (code != TSDB_CODE_SUCCESS) {
+        return code;
+      }
+    }
+    hJoinClearBlocks(pInfo->pPending[i]);
+
+    while (1) {
+      SSDataBlock* pBlock = hJoinFetchBlock(pOperator, i);
+      if (pBlock == NULL) {
+        break;
+      }
+      code = hJoinSpillBlock(pInfo, i, pBlock);
+      if (code != TSDB_CODE_SUCCESS) {
+        return code;
+      }
+    }
+
+    for (int32_t j = 0; j < HASH_JOIN_PARTITIONS; ++j) {
+      SHJoinPartition* pPart = &pInfo->pParts[j];
+      if (pPart->pBlock[i] != NULL && pPart->pBlock[i]->info.rows > 0) {
+        code = hJoinFlushPartBlock(pInfo, pPart->pBlock[i], pPart->pPageIds[i]);
+        if (code != TSDB_CODE_SUCCESS) {
+          return code;
+        }
+      }
+    }
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t hJoinLoadPartition(SHashJoinOperatorInfo* pInfo, int32_t partIdx) {
+  SHJoinPartition* pPart = &pInfo->pParts[partIdx];
+  SArray*          pPageIds = pPart->pPageIds[pInfo->buildIdx];
+
+  tSimpleHashClear(pInfo->pHashTable);
+  taosArrayClear(pInfo->pRowRefs);
+  hJoinClearBlocks(pInfo->pBuildBlocks);
+
+  for (int32_t i = 0; i < taosArrayGetSize(pPageIds); ++i) {
+    int32_t* pPageId = taosArrayGet(pPageIds, i);
+    void*    pPage = getBufPage(pInfo->pBuf, *pPageId);
+    if (pPage == NULL) {
+      return terrno;
+    }
+
+    SSDataBlock* pBlock = createOneDataBlock(pPart->pBlock[pInfo->buildIdx], false);
+    if (pBlock == NULL) {
+      releaseBufPage(pInfo->pBuf, pPage);
+      return terrno;
+    }
+
+    taosArrayPush(pInfo->pBuildBlocks, &pBlock);
+    int32_t code = blockDataFromBuf(pBlock, pPage);
+    releaseBufPage(pInfo->pBuf, pPage);
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
+  }
+
+  return hJoinBuildHashTable(pInfo);
+}
+
+int32_t doOpenHashJoin(SOperatorInfo* pOperator) {
+  if (OPTR_IS_OPENED(pOperator)) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  SHashJoinOperatorInfo* pInfo = pOperator->info;
+  SExecTaskInfo*         pTaskInfo = pOperator->pTaskInfo;
+  int64_t                st = taosGetTimestampUs();
+  int64_t                size[2] = {0};
+
+  // fetch the two downstreams by turns, the one exhausted first is the smaller one and becomes the build side
+  while (!pInfo->downstreamDone[0] && !pInfo->downstreamDone[1] && size[0] + size[1] <= pInfo->buildBufSize) {
+    for (int32_t i = 0; i < 2; ++i) {
+      SSDataBlock* pBlock = hJoinFetchBlock(pOperator, i);
+      if (pBlock == NULL) {
+        continue;
+      }
+
+      SSDataBlock* pCopy = createOneDataBlock(pBlock, true);
+      if (pCopy == NULL) {
+        T_LONG_JMP(pTaskInfo->env, terrno);
+      }
+      taosArrayPush(pInfo->pPending[i], &pCopy);
+      size[i] += blockDataGetSize(pCopy);
+    }
+  }
+
+  if (pInfo->downstreamDone[0] != pInfo->downstreamDone[1]) {
+    pInfo->buildIdx = pInfo->downstreamDone[0] ? 0 : 1;
+  } else {
+    pInfo->buildIdx = (size[1] <= size[0]) ? 1 : 0;
+  }
+
+  int32_t code = TSDB_CODE_SUCCESS;
+  if (pInfo->downstreamDone[pInfo->buildIdx] && size[pInfo->buildIdx] <= pInfo->buildBufSize) {
+    TSWAP(pInfo->pBuildBlocks, pInfo->pPending[pInfo->buildIdx]);
+    code = hJoinBuildHashTable(pInfo);
+  } else {
+    code = hJoinSpillDownstreams(pOperator);
+  }
+
+  if (code != TSDB_CODE_SUCCESS) {
+    T_LONG_JMP(pTaskInfo->env, code);
+  }
+
+  pOperator->cost.openCost = (taosGetTimestampUs() - st) / 1000.0;
+  OPTR_SET_OPENED(pOperator);
+  return TSDB_CODE_SUCCESS;
+}
+
+static SSDataBlock* hJoinNextProbeBlock(SOperatorInfo* pOperator) {
+  SHashJoinOperatorInfo* pInfo = pOperator->info;
+  int32_t                probeIdx = 1 - pInfo->buildIdx;
+
+  if (pInfo->pParts == NULL) {
+    if (tSimpleHashGetSize(pInfo->pHashTable) == 0) {
+      return NULL;
+    }
+    if (pInfo->pendingIdx < taosArrayGetSize(pInfo->pPending[probeIdx])) {
+      return taosArrayGetP(pInfo->pPending[probeIdx], pInfo->pendingIdx++);
+    }
+    return hJoinFetchBlock(pOperator, probeIdx);
+  }
+
+  while (1) {
+    if (pInfo->curPart >= 0) {
+      SHJoinPartition* pPart = &pInfo->pParts[pInfo->curPart];
+      if (pInfo->probePageIdx < taosArrayGetSize(pPart->pPageIds[probeIdx]) &&
+          tSimpleHashGetSize(pInfo->pHashTable) > 0) {
+        int32_t* pPageId = taosArrayGet(pPart->pPageIds[probeIdx], pInfo->probePageIdx++);
+        void*    pPage = getBufPage(pInfo->pBuf, *pPageId);
+        if (pPage == NULL) {
+          T_LONG_JMP(pOperator->pTaskInfo->env, terrno);
+        }
+
+        int32_t code = blockDataFromBuf(pPart->pBlock[probeIdx], pPage);
+        releaseBufPage(pInfo->pBuf, pPage);
+        if (code != TSDB_CODE_SUCCESS) {
+          T_LONG_JMP(pOperator->pTaskInfo->env, code);
+        }
+        return pPart->pBlock[probeIdx];
+      }
+    }
+
+    if (++pInfo->curPart >= HASH_JOIN_PARTITIONS) {
+      return NULL;
+    }
+
+    pInfo->probePageIdx = 0;
+    SHJoinPartition* pPart = &pInfo->pParts[pInfo->curPart];
+    if (taosArrayGetSize(pPart->pPageIds[probeIdx]) == 0 || taosArrayGetSize(pPart->pPageIds[pInfo->buildIdx]) == 0) {
+      continue;
+    }
+
+    int32_t code = hJoinLoadPartition(pInfo, pInfo->curPart);
+    if (code != TSDB_CODE_SUCCESS) {
+      T_LONG_JMP(pOperator->pTaskInfo->env, code);
+    }
+  }
+}
+
+static void doHashJoinImpl(SOperatorInfo* pOperator, SSDataBlock* pRes) {
+  SHashJoinOperatorInfo* pInfo = pOperator->info;
+  int32_t                probeIdx = 1 - pInfo->buildIdx;
+  int32_t                capacity = pOperator->resultInfo.capacity;
+
+  while (pRes->info.rows < capacity) {
+    if (pInfo->pProbe == NULL || pInfo->probePos >= pInfo->pProbe->info.rows) {
+      pInfo->pProbe = hJoinNextProbeBlock(pOperator);
+      pInfo->probePos = 0;
+      pInfo->nextRef = -1;
+      if (pInfo->pProbe == NULL) {
+        doSetOperatorCompleted(pOperator);
+        break;
+      }
+      continue;
+    }
+
+    if (pInfo->nextRef == -1) {
+      int32_t  keyLen = 0;
+      int32_t* pHead = NULL;
+      if (hJoinBuildKey(pInfo->pKeyCols[probeIdx], pInfo->pProbe, pInfo->probePos, pInfo->pKeyBuf, &keyLen)) {
+        pHead = tSimpleHashGet(pInfo->pHashTable, pInfo->pKeyBuf, keyLen);
+      }
+      if (pHead == NULL) {
+        pInfo->probePos += 1;
+        continue;
+      }
+      pInfo->nextRef = *pHead;
+    }
+
+    // a probe row may match more rows than the result block can hold, continue from nextRef in the next call
+    while (pInfo->nextRef != -1 && pRes->info.rows < capacity) {
+      SHJoinRowRef* pRef = taosArrayGet(pInfo->pRowRefs, pInfo->nextRef);
+      SSDataBlock*  pBuild = taosArrayGetP(pInfo->pBuildBlocks, pRef->blockIdx);
+      if (probeIdx == 0) {
+        joinLeftRightRow(pOperator, pRes, pRes->info.rows, pInfo->pProbe, pInfo->probePos, pBuild, pRef->rowIdx);
+      } else {
+        joinLeftRightRow(pOperator, pRes, pRes->info.rows, pBuild, pRef->rowIdx, pInfo->pProbe, pInfo->probePos);
+      }
+      pRes->info.rows += 1;
+      pInfo->nextRef = pRef->next;
+    }
+
+    if (pInfo->nextRef == -1) {
+      pInfo->probePos += 1;
+    }
+  }
+}
+
+SSDataBlock* doHashJoin(struct SOperatorInfo* pOperator) {
+  if (pOperator->status == OP_EXEC_DONE) {
+    return NULL;
+  }
+
+  SHashJoinOperatorInfo* pInfo = pOperator->info;
+  SExecTaskInfo*         pTaskInfo = pOperator->pTaskInfo;
+
+  int32_t code = pOperator->fpSet._openFn(pOperator);
+  if (code != TSDB_CODE_SUCCESS) {
+    T_LONG_JMP(pTaskInfo->env, code);
+  }
+
+  SSDataBlock* pRes = pInfo->pRes;
+  blockDataCleanup(pRes);
+  blockDataEnsureCapacity(pRes, pOperator->resultInfo.capacity);
+  while (pOperator->status != OP_EXEC_DONE) {
+    doHashJoinImpl(pOperator, pRes);
+    if (pInfo->pCondAfterJoin != NULL) {
+      doFilter(pInfo->pCondAfterJoin, pRes, NULL);
+    }
+    if (pRes->info.rows > 0) {
+      break;
+    }
+  }
+  return (pRes->info.rows > 0) ? pRes : NULL;
+}
@@ -22,7 +22,6 @@ static int32_t      getExplainExecInfo(SOperatorInfo* pOptr, void** pOptrExplain
 
 static void destroyOrderOperatorInfo(void* param);
 
-// todo add limit/offset impl
 SOperatorInfo* createSortOperatorInfo(SOperatorInfo* downstream, SSortPhysiNode* pSortNode, SExecTaskInfo* pTaskInfo) {
   SSortOperatorInfo* pInfo = taosMemoryCalloc(1, sizeof(SSortOperatorInfo));
   SOperatorInfo*     pOperator = taosMemoryCalloc(1, sizeof(SOperatorInfo));
@@ -176,6 +175,12 @@ int32_t doOpenSortOperator(SOperatorInfo* pOperator) {
 
   tsortSetFetchRawDataFp(pInfo->pSortHandle, loadNextDataBlock, applyScalarFunction, pOperator);
 
+  // the rows are filtered after sort, so only without filter the rows beyond offset + limit can be dropped early
+  SLimit* pLimit = &pInfo->limitInfo.limit;
+  if (pLimit->limit > 0 && pInfo->pCondition == NULL) {
+    tsortSetMaxRows(pInfo->pSortHandle, pLimit->limit + TMAX(pLimit->offset, 0));
+  }
+
   SSortSource* ps = taosMemoryCalloc(1, sizeof(SSortSource));
   ps->param = pOperator->pDownstream[0];
   tsortAddSource(pInfo->pSortHandle, ps);
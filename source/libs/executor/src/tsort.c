@@ -23,6 +23,8 @@
 #include "tsort.h"
 #include "tutil.h"
 #include "tcompare.h"
+#include "tglobal.h"
+#include "tsched.h"
 
 struct STupleHandle {
   SSDataBlock* pBlock;
@@ -58,9 +60,45 @@ struct SSortHandle {
   _sort_fetch_block_fn_t  fetchfp;
   _sort_merge_compar_fn_t comparFn;
   SMultiwayMergeTreeInfo *pMergeTree;
+
+  // runs are sorted and spilled by the sort worker pool while the query thread keeps fetching data
+  int32_t           maxPendingRuns;
+  int32_t           numOfPendingRuns;
+  int32_t           asyncCode;
+  TdThreadMutex     lock;
+  TdThreadCond      cond;
+  // only the first maxRows rows of the single source are kept, 0 means all rows are sorted
+  int64_t           maxRows;
 };
 
+#define SORT_RUN_QUEUE_SIZE 1024
+
+// sort workers shared by all queries, the runs are sorted on the query thread if they are not created
+static void *sortQHandle = NULL;
+
 static int32_t msortComparFn(const void *pLeft, const void *pRight, void *param);
+static int32_t doAddToBuf(SSDataBlock* pDataBlock, SSortHandle* pHandle);
+
+int32_t tsortInit() {
+  if (tsNumOfSortThreads <= 0) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  sortQHandle = taosInitScheduler(SORT_RUN_QUEUE_SIZE, tsNumOfSortThreads, "sort", NULL);
+  if (sortQHandle == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return -1;
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+void tsortCleanUp() {
+  if (sortQHandle) {
+    taosCleanUpScheduler(sortQHandle);
+    taosMemoryFreeClear(sortQHandle);
+  }
+}
 
 SSDataBlock* tsortGetSortedDataBlock(const SSortHandle* pSortHandle) {
   return createOneDataBlock(pSortHandle->pDataBlock, false);
@@ -90,6 +128,12 @@ SSortHandle* tsortCreateSortHandle(SArray* pSortInfo, int32_t type, int32_t page
 
   tsortSetComparFp(pSortHandle, msortComparFn);
 
+  if (type == SORT_SINGLESOURCE_SORT && sortQHandle != NULL) {
+    pSortHandle->maxPendingRuns = tsNumOfSortThreads;
+    taosThreadMutexInit(&pSortHandle->lock, NULL);
+    taosThreadCondInit(&pSortHandle->cond, NULL);
+  }
+
   if (idstr != NULL) {
     pSortHandle->idStr = strdup(idstr);
   }
@@ -97,6 +141,82 @@ SSortHandle* tsortCreateSortHandle(SArray* pSortInfo, int32_t type, int32_t page
   return pSortHandle;
 }
 
+static void waitForSortRuns(SSortHandle* pHandle) {
+  taosThreadMutexLock(&pHandle->lock);
+  while (pHandle->numOfPendingRuns > 0) {
+    taosThreadCondWait(&pHandle->cond, &pHandle->lock);
+  }
+  taosThreadMutexUnlock(&pHandle->lock);
+}
+
+static void doGenerateSortRun(SSchedMsg* pMsg) {
+  SSortHandle* pHandle = pMsg->ahandle;
+  SSDataBlock* pBlock = pMsg->msg;
+
+  // blockDataSort binds the order info to the columns of the block, so each run needs its own copy
+  int32_t code = TSDB_CODE_SUCCESS;
+  int64_t p = taosGetTimestampUs();
+  SArray* pSortInfo = taosArrayDup(pHandle->pSortInfo);
+  if (pSortInfo == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+  } else {
+    code = blockDataSort(pBlock, pSortInfo);
+    taosArrayDestroy(pSortInfo);
+  }
+  int64_t el = taosGetTimestampUs() - p;
+
+  // the disk based buffer is not thread safe, so only the sort itself runs in parallel
+  taosThreadMutexLock(&pHandle->lock);
+  if (code == TSDB_CODE_SUCCESS && pHandle->asyncCode == TSDB_CODE_SUCCESS) {
+    code = doAddToBuf(pBlock, pHandle);
+  }
+
+  if (code != TSDB_CODE_SUCCESS && pHandle->asyncCode == TSDB_CODE_SUCCESS) {
+    pHandle->asyncCode = code;
+  }
+
+  pHandle->sortElapsed += el;
+  pHandle->numOfPendingRuns -= 1;
+  taosThreadCondSignal(&pHandle->cond);
+  taosThreadMutexUnlock(&pHandle->lock);
+
+  blockDataDestroy(pBlock);
+}
+
+// hand the full sort buffer over to the sort worker pool and continue with an empty one
+static int32_t doAddToBufAsync(SSortHandle* pHandle) {
+  SSDataBlock* pEmpty = createOneDataBlock(pHandle->pDataBlock, false);
+  if (pEmpty == NULL) {
+    return terrno;
+  }
+
+  SSchedMsg schedMsg = {.fp = doGenerateSortRun, .ahandle = pHandle, .msg = pHandle->pDataBlock};
+  pHandle->pDataBlock = pEmpty;
+
+  taosThreadMutexLock(&pHandle->lock);
+  while (pHandle->numOfPendingRuns >= pHandle->maxPendingRuns) {
+    taosThreadCondWait(&pHandle->cond, &pHandle->lock);
+  }
+
+  int32_t code = pHandle->asyncCode;
+  if (code == TSDB_CODE_SUCCESS) {
+    pHandle->numOfPendingRuns += 1;
+  }
+  taosThreadMutexUnlock(&pHandle->lock);
+
+  if (code != TSDB_CODE_SUCCESS) {
+    blockDataDestroy(schedMsg.msg);
+    return code;
+  }
+
+  // the sort workers are stopped, so the run is generated on the query thread
+  if (taosScheduleTask(sortQHandle, &schedMsg) != 0) {
+    doGenerateSortRun(&schedMsg);
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
 static int32_t sortComparCleanup(SMsortComparParam* cmpParam) {
   for(int32_t i = 0; i < cmpParam->numOfSources; ++i) {
     SSortSource* pSource = cmpParam->pSources[i];    // NOTICE: pSource may be SGenericSource *, if it is SORT_MULTISOURCE_MERGE
@@ -114,6 +234,13 @@ void tsortDestroySortHandle(SSortHandle* pSortHandle) {
   }
 
   tsortClose(pSortHandle);
+  if (pSortHandle->maxPendingRuns > 0) {
+    // the query may be aborted while runs are still being generated
+    waitForSortRuns(pSortHandle);
+    taosThreadCondDestroy(&pSortHandle->cond);
+    taosThreadMutexDestroy(&pSortHandle->lock);
+  }
+
   if (pSortHandle->pMergeTree != NULL) {
     tMergeTreeDestroy(pSortHandle->pMergeTree);
   }
@@ -206,6 +333,14 @@ static int32_t doAddToBuf(SSDataBlock* pDataBlock, SSortHandle* pHandle) {
   return doAddNewExternalMemSource(pHandle->pBuf, pHandle->pOrderedSource, pBlock, &pHandle->sourceId, pPageIdList);
 }
 
+// the next page of a source is needed as soon as the current one is consumed, start reading it in advance
+static void prefetchNextSourcePage(SSortSource* pSource, SSortHandle* pHandle) {
+  if (pSource->pageIndex + 1 < taosArrayGetSize(pSource->pageIdList)) {
+    int32_t* pPgId = taosArrayGet(pSource->pageIdList, pSource->pageIndex + 1);
+    prefetchBufPage(pHandle->pBuf, *pPgId);
+  }
+}
+
 static void setCurrentSourceIsDone(SSortSource* pSource, SSortHandle* pHandle) {
   pSource->src.rowIndex = -1;
   ++pHandle->numOfCompletedSources;
@@ -236,6 +371,7 @@ static int32_t sortComparInit(SMsortComparParam* cmpParam, SArray* pSources, int
       }
 
       releaseBufPage(pHandle->pBuf, pPage);
+      prefetchNextSourcePage(pSource, pHandle);
     }
   } else {
     // multi-pass internal merge sort is required
@@ -311,6 +447,7 @@ static int32_t adjustMergeTreeForNextTuple(SSortSource *pSource, SMultiwayMergeT
         }
 
         releaseBufPage(pHandle->pBuf, pPage);
+        prefetchNextSourcePage(pSource, pHandle);
       }
     } else {
       pSource->src.pBlock = pHandle->fetchfp(((SSortSource*)pSource)->param);
@@ -578,6 +715,37 @@ int32_t getProperSortPageSize(size_t rowSize) {
   return pgSize;
 }
 
+// Sort the buffered rows and drop all but the first maxRows of them once twice as many rows are buffered, so the
+// top rows are found without spilling to disk. If the kept rows can not fit in the sort buffer, fall back to the
+// external sort, the rows dropped so far are not among the top rows anyway.
+static int32_t doKeepTopRows(SSortHandle* pHandle, size_t sortBufSize) {
+  SSDataBlock* pBlock = pHandle->pDataBlock;
+  int64_t      maxFitRows = sortBufSize / TMAX(blockDataGetRowSize(pBlock), 1);
+
+  // compared by division, since a large limit overflows the products
+  if (pHandle->maxRows > maxFitRows / 2 || 4096 > maxFitRows) {
+    qDebug("%s top %" PRId64 " rows can not fit in sort buffer, sort all rows", pHandle->idStr, pHandle->maxRows);
+    pHandle->maxRows = 0;
+    return TSDB_CODE_SUCCESS;
+  }
+
+  int64_t threshold = TMAX(pHandle->maxRows * 2, 4096);
+
+  if (pBlock->info.rows < threshold) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  int64_t p = taosGetTimestampUs();
+  int32_t code = blockDataSort(pBlock, pHandle->pSortInfo);
+  if (code != 0) {
+    return code;
+  }
+
+  blockDataKeepFirstNRows(pBlock, pHandle->maxRows);
+  pHandle->sortElapsed += (taosGetTimestampUs() - p);
+  return TSDB_CODE_SUCCESS;
+}
+
 static int32_t createInitialSources(SSortHandle* pHandle) {
   size_t sortBufSize = pHandle->numOfPages * pHandle->pageSize;
 
@@ -609,8 +777,24 @@ static int32_t createInitialSources(SSortHandle* pHandle) {
         return code;
       }
 
+      if (pHandle->maxRows > 0) {
+        code = doKeepTopRows(pHandle, sortBufSize);
+        if (code != 0) {
+          return code;
+        }
+
+        if (pHandle->maxRows > 0) {
+          continue;
+        }
+      }
+
       size_t size = blockDataGetSize(pHandle->pDataBlock);
-      if (size > sortBufSize) {
+      if (size > sortBufSize && pHandle->maxPendingRuns > 0) {
+        code = doAddToBufAsync(pHandle);
+        if (code != 0) {
+          return code;
+        }
+      } else if (size > sortBufSize) {
         // Perform the in-memory sort and then flush data in the buffer into disk.
         int64_t p = taosGetTimestampUs();
         code = blockDataSort(pHandle->pDataBlock, pHandle->pSortInfo);
@@ -625,6 +809,13 @@ static int32_t createInitialSources(SSortHandle* pHandle) {
       }
     }
 
+    if (pHandle->maxPendingRuns > 0) {
+      waitForSortRuns(pHandle);
+      if (pHandle->asyncCode != TSDB_CODE_SUCCESS) {
+        return pHandle->asyncCode;
+      }
+    }
+
     if (pHandle->pDataBlock != NULL && pHandle->pDataBlock->info.rows > 0) {
       size_t size = blockDataGetSize(pHandle->pDataBlock);
 
@@ -639,6 +830,11 @@ static int32_t createInitialSources(SSortHandle* pHandle) {
       int64_t el = taosGetTimestampUs() - p;
       pHandle->sortElapsed += el;
 
+      if (pHandle->maxRows > 0 && pHandle->pDataBlock->info.rows > pHandle->maxRows) {
+        blockDataKeepFirstNRows(pHandle->pDataBlock, pHandle->maxRows);
+        size = blockDataGetSize(pHandle->pDataBlock);
+      }
+
       // All sorted data can fit in memory, external memory sort is not needed. Return to directly
       if (size <= sortBufSize && pHandle->pBuf == NULL) {
         pHandle->cmpParam.numOfSources = 1;
@@ -713,6 +909,11 @@ int32_t tsortSetComparFp(SSortHandle* pHandle, _sort_merge_compar_fn_t fp) {
   return TSDB_CODE_SUCCESS;
 }
 
+int32_t tsortSetMaxRows(SSortHandle* pHandle, int64_t maxRows) {
+  pHandle->maxRows = maxRows;
+  return TSDB_CODE_SUCCESS;
+}
+
 int32_t tsortSetCompareGroupId(SSortHandle* pHandle, bool compareGroupId) {
   pHandle->cmpParam.cmpGroupId = compareGroupId;
   return TSDB_CODE_SUCCESS;
@@ -0,0 +1,274 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <vector>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wwrite-strings"
+#pragma GCC diagnostic ignored "-Wunused-function"
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#pragma GCC diagnostic ignored "-Wsign-compare"
+#include "os.h"
+
+#include "executorInt.h"
+#include "executorimpl.h"
+#include "tdatablock.h"
+#include "tref.h"
+
+namespace {
+
+const int32_t ROWS_PER_BATCH = 10;
+
+// the sources are executed locally, so each fetch request is answered synchronously by dummyLocalFetch
+struct SExchangeTestCtx {
+  SExchangeInfo*       pInfo;
+  int32_t              numOfBatches;       // number of batches of each source, the last one is marked completed
+  bool                 emptyLastBatch;     // the source returns an empty batch after its data instead
+  std::vector<int32_t> fetched;            // number of fetch requests of each source
+  std::vector<int32_t> fetchOrder;         // the source of each fetch request
+  std::vector<int32_t> returnedAtFetch;    // number of blocks returned by the operator when each fetch is sent
+  std::vector<int32_t> returnedOrder;      // the source of each block returned by the operator
+  int32_t              returned;
+  int32_t              maxInflight;        // max number of fetch requests in flight or buffered
+  int32_t              maxReady;           // max number of responses waiting in the ready queue
+};
+
+SExchangeTestCtx testCtx;
+
+// value of a row tells the source, the batch and the row in the batch
+int32_t exchangeRowVal(int32_t source, int32_t batch, int32_t row) { return source * 10000 + batch * 100 + row; }
+
+int32_t dummyLocalFetch(void* handle, uint64_t sId, uint64_t queryId, uint64_t taskId, int64_t rId, int32_t execId,
+                        void** pRsp, SArray* explainRes) {
+  int32_t source = (int32_t)taskId;
+  int32_t batch = testCtx.fetched[source]++;
+
+  testCtx.fetchOrder.push_back(source);
+  testCtx.returnedAtFetch.push_back(testCtx.returned);
+  testCtx.maxInflight = std::max(testCtx.maxInflight, testCtx.pInfo->numOfInflight);
+  testCtx.maxReady = std::max(testCtx.maxReady, (int32_t)taosArrayGetSize(testCtx.pInfo->pReadyQueue));
+
+  int32_t numOfRows = (batch < testCtx.numOfBatches) ? ROWS_PER_BATCH : 0;
+  bool    completed = testCtx.emptyLastBatch ? (numOfRows == 0) : (batch == testCtx.numOfBatches - 1);
+
+  SSDataBlock*    pBlock = createDataBlock();
+  SColumnInfoData col = createColumnInfoData(TSDB_DATA_TYPE_INT, sizeof(int32_t), 1);
+  blockDataAppendColInfo(pBlock, &col);
+  blockDataEnsureCapacity(pBlock, ROWS_PER_BATCH);
+  SColumnInfoData* pCol = static_cast<SColumnInfoData*>(taosArrayGet(pBlock->pDataBlock, 0));
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    int32_t v = exchangeRowVal(source, batch, i);
+    colDataAppend(pCol, i, reinterpret_cast<const char*>(&v), false);
+  }
+  pBlock->info.rows = numOfRows;
+
+  int32_t            len = 0;
+  SRetrieveTableRsp* pRetrieveRsp =
+      static_cast<SRetrieveTableRsp*>(taosMemoryCalloc(1, sizeof(SRetrieveTableRsp) + blockGetEncodeSize(pBlock)));
+  if (numOfRows > 0) {
+    blockEncode(pBlock, pRetrieveRsp->data, &len, 1, 0);
+  }
+  pRetrieveRsp->numOfRows = htonl(numOfRows);
+  pRetrieveRsp->numOfBlocks = htonl(numOfRows > 0 ? 1 : 0);
+  pRetrieveRsp->numOfCols = htonl(1);
+  pRetrieveRsp->compLen = htonl(len);
+  pRetrieveRsp->completed = completed ? 1 : 0;
+  blockDataDestroy(pBlock);
+
+  *pRsp = pRetrieveRsp;
+  return TSDB_CODE_SUCCESS;
+}
+
+SExchangePhysiNode* createExchangeNode(int32_t numOfSources) {
+  SExchangePhysiNode* pExchange = (SExchangePhysiNode*)nodesMakeNode(QUERY_NODE_PHYSICAL_PLAN_EXCHANGE);
+  for (int32_t i = 0; i < numOfSources; ++i) {
+    SDownstreamSourceNode* pSource = (SDownstreamSourceNode*)nodesMakeNode(QUERY_NODE_DOWNSTREAM_SOURCE);
+    pSource->addr.nodeId = i;
+    pSource->taskId = i;
+    pSource->localExec = true;
+    nodesListMakeAppend(&pExchange->pSrcEndPoints, (SNode*)pSource);
+  }
+
+  SDataBlockDescNode* pDesc = (SDataBlockDescNode*)nodesMakeNode(QUERY_NODE_DATABLOCK_DESC);
+  pDesc->dataBlockId = 1;
+  pDesc->totalRowSize = sizeof(int32_t);
+
+  SSlotDescNode* pSlot = (SSlotDescNode*)nodesMakeNode(QUERY_NODE_SLOT_DESC);
+  pSlot->slotId = 0;
+  pSlot->dataType.type = TSDB_DATA_TYPE_INT;
+  pSlot->dataType.bytes = sizeof(int32_t);
+  pSlot->output = true;
+  nodesListMakeAppend(&pDesc->pSlots, (SNode*)pSlot);
+
+  pExchange->node.pOutputDataBlockDesc = pDesc;
+  return pExchange;
+}
+
+class ExchangeTest : public ::testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    if (exchangeObjRefPool < 0) {
+      exchangeObjRefPool = taosOpenRef(1024, doDestroyExchangeOperatorInfo);
+    }
+  }
+
+  void SetUp() override {
+    memset(&taskInfo, 0, sizeof(taskInfo));
+    taskInfo.id.str = const_cast<char*>("exchangeTest");
+    taskInfo.localFetch.fp = dummyLocalFetch;
+  }
+
+  void TearDown() override {
+    if (pOperator != NULL) {
+      pOperator->fpSet.closeFn(pOperator->info);
+      taosMemoryFree(pOperator);
+    }
+    nodesDestroyNode((SNode*)pExchangeNode);
+  }
+
+  void createExchange(int32_t numOfSources, int32_t numOfBatches, int32_t maxInflight, bool seqLoad) {
+    testCtx.numOfBatches = numOfBatches;
+    testCtx.emptyLastBatch = false;
+    testCtx.fetched.assign(numOfSources, 0);
+    testCtx.fetchOrder.clear();
+    testCtx.returnedAtFetch.clear();
+    testCtx.returnedOrder.clear();
+    testCtx.returned = 0;
+    testCtx.maxInflight = 0;
+    testCtx.maxReady = 0;
+
+    pExchangeNode = createExchangeNode(numOfSources);
+    pOperator = createExchangeOperatorInfo(NULL, pExchangeNode, &taskInfo);
+    ASSERT_NE(pOperator, nullptr);
+
+    testCtx.pInfo = static_cast<SExchangeInfo*>(pOperator->info);
+    testCtx.pInfo->maxInflight = maxInflight;
+    testCtx.pInfo->seqLoadData = seqLoad;
+  }
+
+  // the rows of each source, in the order they are returned
+  std::vector<std::vector<int32_t>> runExchange(int32_t numOfSources) {
+    std::vector<std::vector<int32_t>> res(numOfSources);
+    while (1) {
+      SSDataBlock* pRes = pOperator->fpSet.getNextFn(pOperator);
+      if (pRes == NULL) {
+        break;
+      }
+
+      testCtx.returned += 1;
+      SColumnInfoData* pCol = static_cast<SColumnInfoData*>(taosArrayGet(pRes->pDataBlock, 0));
+      testCtx.returnedOrder.push_back(*(int32_t*)colDataGetData(pCol, 0) / 10000);
+      for (int32_t i = 0; i < pRes->info.rows; ++i) {
+        int32_t v = *(int32_t*)colDataGetData(pCol, i);
+        res[v / 10000].push_back(v);
+      }
+    }
+    return res;
+  }
+
+  void checkAllRows(const std::vector<std::vector<int32_t>>& res, int32_t numOfBatches) {
+    for (int32_t s = 0; s < res.size(); ++s) {
+      std::vector<int32_t> expect;
+      for (int32_t b = 0; b < numOfBatches; ++b) {
+        for (int32_t i = 0; i < ROWS_PER_BATCH; ++i) {
+          expect.push_back(exchangeRowVal(s, b, i));
+        }
+      }
+      EXPECT_EQ(res[s], expect) << "source " << s;
+    }
+  }
+
+  SExecTaskInfo       taskInfo;
+  SExchangePhysiNode* pExchangeNode = NULL;
+  SOperatorInfo*      pOperator = NULL;
+};
+
+}  // namespace
+
+TEST_F(ExchangeTest, concurrent_load_all_sources) {
+  createExchange(6, 4, 64, false);
+  std::vector<std::vector<int32_t>> res = runExchange(6);
+  ASSERT_EQ(taskInfo.code, TSDB_CODE_SUCCESS);
+
+  checkAllRows(res, 4);
+  EXPECT_EQ(testCtx.fetchOrder.size(), 6 * 4);
+  EXPECT_EQ(taosArrayGetSize(testCtx.pInfo->pReadyQueue), 0);
+  EXPECT_EQ(testCtx.pInfo->numOfInflight, 0);
+}
+
+TEST_F(ExchangeTest, concurrent_load_max_inflight) {
+  createExchange(8, 3, 3, false);
+  std::vector<std::vector<int32_t>> res = runExchange(8);
+  ASSERT_EQ(taskInfo.code, TSDB_CODE_SUCCESS);
+
+  checkAllRows(res, 3);
+  EXPECT_EQ(testCtx.maxInflight, 3);
+  EXPECT_LT(testCtx.maxReady, 3);
+
+  // the sources beyond the limit wait for a free slot in the order of their index
+  std::vector<int32_t> firstFetch;
+  for (int32_t source : testCtx.fetchOrder) {
+    if (std::find(firstFetch.begin(), firstFetch.end(), source) == firstFetch.end()) {
+      firstFetch.push_back(source);
+    }
+  }
+  EXPECT_EQ(firstFetch, std::vector<int32_t>({0, 1, 2, 3, 4, 5, 6, 7}));
+  EXPECT_EQ(testCtx.returnedAtFetch[3], 0);
+  EXPECT_EQ(testCtx.returnedAtFetch[2], 0);
+}
+
+TEST_F(ExchangeTest, concurrent_load_ready_queue_in_arrival_order) {
+  createExchange(4, 2, 4, false);
+  runExchange(4);
+  ASSERT_EQ(taskInfo.code, TSDB_CODE_SUCCESS);
+
+  // every source responds at once, so the responses are consumed in the order the requests are sent
+  EXPECT_EQ(testCtx.fetchOrder, std::vector<int32_t>({0, 1, 2, 3, 0, 1, 2, 3}));
+  EXPECT_EQ(testCtx.returnedOrder, testCtx.fetchOrder);
+  EXPECT_EQ(testCtx.maxReady, 3);
+}
+
+TEST_F(ExchangeTest, seq_load_prefetch) {
+  createExchange(3, 4, 64, true);
+  std::vector<std::vector<int32_t>> res = runExchange(3);
+  ASSERT_EQ(taskInfo.code, TSDB_CODE_SUCCESS);
+
+  checkAllRows(res, 4);
+
+  // the sources are loaded one after another
+  std::vector<int32_t> expectOrder;
+  for (int32_t s = 0; s < 3; ++s) {
+    expectOrder.insert(expectOrder.end(), 4, s);
+  }
+  EXPECT_EQ(testCtx.fetchOrder, expectOrder);
+
+  // the next batch is requested before the current one is returned
+  for (int32_t i = 1; i < testCtx.returnedAtFetch.size(); ++i) {
+    EXPECT_EQ(testCtx.returnedAtFetch[i], i - 1) << "fetch " << i;
+  }
+  EXPECT_EQ(taosArrayGetSize(testCtx.pInfo->pReadyQueue), 0);
+}
+
+TEST_F(ExchangeTest, seq_load_empty_last_batch) {
+  createExchange(3, 2, 64, true);
+  testCtx.emptyLastBatch = true;
+  std::vector<std::vector<int32_t>> res = runExchange(3);
+  ASSERT_EQ(taskInfo.code, TSDB_CODE_SUCCESS);
+
+  checkAllRows(res, 2);
+  EXPECT_EQ(testCtx.fetchOrder.size(), 3 * 3);
+}
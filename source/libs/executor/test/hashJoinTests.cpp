@@ -0,0 +1,330 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <tuple>
+#include <vector>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wwrite-strings"
+#pragma GCC diagnostic ignored "-Wunused-function"
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#pragma GCC diagnostic ignored "-Wsign-compare"
+#include "os.h"
+
+#include "executorimpl.h"
+#include "tdatablock.h"
+
+namespace {
+
+enum { LEFT_BLOCK_ID = 1, RIGHT_BLOCK_ID = 2, RES_BLOCK_ID = 3 };
+
+// one input row: the join key and a value to tell the rows apart, a null key is marked by keyNull
+struct SJoinRow {
+  double  key;
+  int32_t val;
+  bool    keyNull;
+};
+
+typedef std::tuple<double, int32_t, int32_t> SJoinResRow;  // the key, the left value and the right value
+
+struct SDummyJoinInput {
+  std::vector<SSDataBlock*> blocks;
+  int32_t                   current;
+};
+
+SSDataBlock* getDummyJoinBlock(SOperatorInfo* pOperator) {
+  SDummyJoinInput* pInput = static_cast<SDummyJoinInput*>(pOperator->info);
+  if (pInput->current >= pInput->blocks.size()) {
+    return NULL;
+  }
+  return pInput->blocks[pInput->current++];
+}
+
+void destroyDummyJoinInput(void* param) {
+  SDummyJoinInput* pInput = static_cast<SDummyJoinInput*>(param);
+  for (SSDataBlock* pBlock : pInput->blocks) {
+    blockDataDestroy(pBlock);
+  }
+  delete pInput;
+}
+
+SOperatorInfo* createDummyJoinInput(int32_t blockId, int16_t keyType, const std::vector<SJoinRow>& rows,
+                                    int32_t rowsPerBlock) {
+  SDummyJoinInput* pInput = new SDummyJoinInput();
+  pInput->current = 0;
+
+  for (int32_t start = 0; start < rows.size(); start += rowsPerBlock) {
+    SSDataBlock* pBlock = createDataBlock();
+    pBlock->info.blockId = blockId;
+
+    SColumnInfoData keyCol = createColumnInfoData(keyType, tDataTypes[keyType].bytes, 1);
+    SColumnInfoData valCol = createColumnInfoData(TSDB_DATA_TYPE_INT, sizeof(int32_t), 2);
+    blockDataAppendColInfo(pBlock, &keyCol);
+    blockDataAppendColInfo(pBlock, &valCol);
+
+    int32_t numOfRows = std::min<int32_t>(rowsPerBlock, rows.size() - start);
+    blockDataEnsureCapacity(pBlock, numOfRows);
+    SColumnInfoData* pKeyCol = static_cast<SColumnInfoData*>(taosArrayGet(pBlock->pDataBlock, 0));
+    SColumnInfoData* pValCol = static_cast<SColumnInfoData*>(taosArrayGet(pBlock->pDataBlock, 1));
+    for (int32_t i = 0; i < numOfRows; ++i) {
+      const SJoinRow& row = rows[start + i];
+      if (row.keyNull) {
+        colDataAppendNULL(pKeyCol, i);
+      } else if (keyType == TSDB_DATA_TYPE_DOUBLE) {
+        colDataAppend(pKeyCol, i, reinterpret_cast<const char*>(&row.key), false);
+      } else {
+        int32_t k = (int32_t)row.key;
+        colDataAppend(pKeyCol, i, reinterpret_cast<const char*>(&k), false);
+      }
+      colDataAppend(pValCol, i, reinterpret_cast<const char*>(&row.val), false);
+    }
+    pBlock->info.rows = numOfRows;
+    pInput->blocks.push_back(pBlock);
+  }
+
+  SOperatorInfo* pOperator = static_cast<SOperatorInfo*>(taosMemoryCalloc(1, sizeof(SOperatorInfo)));
+  pOperator->name = "dummyJoinInput4Test";
+  pOperator->info = pInput;
+  pOperator->fpSet.getNextFn = getDummyJoinBlock;
+  pOperator->fpSet.closeFn = destroyDummyJoinInput;
+  return pOperator;
+}
+
+SNode* createJoinColumn(int32_t blockId, int16_t slotId, int16_t type) {
+  SColumnNode* pCol = (SColumnNode*)nodesMakeNode(QUERY_NODE_COLUMN);
+  pCol->node.resType.type = type;
+  pCol->node.resType.bytes = tDataTypes[type].bytes;
+  pCol->dataBlockId = blockId;
+  pCol->slotId = slotId;
+  return (SNode*)pCol;
+}
+
+SNode* createJoinChild(int32_t blockId, int16_t keyType) {
+  SPhysiNode*         pChild = (SPhysiNode*)nodesMakeNode(QUERY_NODE_PHYSICAL_PLAN_PROJECT);
+  SDataBlockDescNode* pDesc = (SDataBlockDescNode*)nodesMakeNode(QUERY_NODE_DATABLOCK_DESC);
+  pDesc->dataBlockId = blockId;
+  pDesc->totalRowSize = tDataTypes[keyType].bytes + sizeof(int32_t);
+  pChild->pOutputDataBlockDesc = pDesc;
+  return (SNode*)pChild;
+}
+
+void appendJoinTarget(SHashJoinPhysiNode* pJoin, int32_t blockId, int16_t slotId, int16_t type) {
+  int16_t      resSlotId = LIST_LENGTH(pJoin->pTargets);
+  STargetNode* pTarget = (STargetNode*)nodesMakeNode(QUERY_NODE_TARGET);
+  pTarget->dataBlockId = RES_BLOCK_ID;
+  pTarget->slotId = resSlotId;
+  pTarget->pExpr = createJoinColumn(blockId, slotId, type);
+  nodesListMakeAppend(&pJoin->pTargets, (SNode*)pTarget);
+
+  SSlotDescNode* pSlot = (SSlotDescNode*)nodesMakeNode(QUERY_NODE_SLOT_DESC);
+  pSlot->slotId = resSlotId;
+  pSlot->dataType.type = type;
+  pSlot->dataType.bytes = tDataTypes[type].bytes;
+  pSlot->output = true;
+  nodesListMakeAppend(&pJoin->node.pOutputDataBlockDesc->pSlots, (SNode*)pSlot);
+}
+
+// the result columns are the left key, the left value and the right value
+SHashJoinPhysiNode* createHashJoinNode(int16_t keyType) {
+  SHashJoinPhysiNode* pJoin = (SHashJoinPhysiNode*)nodesMakeNode(QUERY_NODE_PHYSICAL_PLAN_HASH_JOIN);
+  pJoin->joinType = JOIN_TYPE_INNER;
+  nodesListMakeAppend(&pJoin->node.pChildren, createJoinChild(LEFT_BLOCK_ID, keyType));
+  nodesListMakeAppend(&pJoin->node.pChildren, createJoinChild(RIGHT_BLOCK_ID, keyType));
+  nodesListMakeAppend(&pJoin->pLeftKeys, createJoinColumn(LEFT_BLOCK_ID, 0, keyType));
+  nodesListMakeAppend(&pJoin->pRightKeys, createJoinColumn(RIGHT_BLOCK_ID, 0, keyType));
+
+  pJoin->node.pOutputDataBlockDesc = (SDataBlockDescNode*)nodesMakeNode(QUERY_NODE_DATABLOCK_DESC);
+  pJoin->node.pOutputDataBlockDesc->dataBlockId = RES_BLOCK_ID;
+  appendJoinTarget(pJoin, LEFT_BLOCK_ID, 0, keyType);
+  appendJoinTarget(pJoin, LEFT_BLOCK_ID, 1, TSDB_DATA_TYPE_INT);
+  appendJoinTarget(pJoin, RIGHT_BLOCK_ID, 1, TSDB_DATA_TYPE_INT);
+  return pJoin;
+}
+
+// the same join done by a nested loop, a null or nan key matches nothing and -0.0 matches 0.0
+std::vector<SJoinResRow> nestedLoopJoin(const std::vector<SJoinRow>& left, const std::vector<SJoinRow>& right) {
+  std::vector<SJoinResRow> res;
+  for (const SJoinRow& l : left) {
+    for (const SJoinRow& r : right) {
+      if (!l.keyNull && !r.keyNull && l.key == r.key) {
+        res.push_back(std::make_tuple(l.key == 0 ? 0 : l.key, l.val, r.val));
+      }
+    }
+  }
+  std::sort(res.begin(), res.end());
+  return res;
+}
+
+class HashJoinTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    memset(&taskInfo, 0, sizeof(taskInfo));
+    taskInfo.id.str = const_cast<char*>("hashJoinTest");
+    pOperator = NULL;
+  }
+
+  void TearDown() override {
+    if (pOperator != NULL) {
+      pOperator->fpSet.closeFn(pOperator->info);
+      for (int32_t i = 0; i < pOperator->numOfDownstream; ++i) {
+        pOperator->pDownstream[i]->fpSet.closeFn(pOperator->pDownstream[i]->info);
+        taosMemoryFree(pOperator->pDownstream[i]);
+      }
+      taosMemoryFree(pOperator->pDownstream);
+      cleanupExprSupp(&pOperator->exprSupp);
+      taosMemoryFree(pOperator);
+    }
+    nodesDestroyNode((SNode*)pJoinNode);
+  }
+
+  void createJoin(int16_t keyType, const std::vector<SJoinRow>& left, const std::vector<SJoinRow>& right,
+                  int32_t rowsPerBlock) {
+    keyType_ = keyType;
+    pJoinNode = createHashJoinNode(keyType);
+
+    SOperatorInfo* pDownstream[2] = {createDummyJoinInput(LEFT_BLOCK_ID, keyType, left, rowsPerBlock),
+                                     createDummyJoinInput(RIGHT_BLOCK_ID, keyType, right, rowsPerBlock)};
+    pOperator = createHashJoinOperatorInfo(pDownstream, 2, pJoinNode, &taskInfo);
+    ASSERT_NE(pOperator, nullptr);
+  }
+
+  std::vector<SJoinResRow> runJoin() {
+    std::vector<SJoinResRow> res;
+    while (1) {
+      SSDataBlock* pRes = pOperator->fpSet.getNextFn(pOperator);
+      if (pRes == NULL) {
+        break;
+      }
+
+      SColumnInfoData* pKeyCol = static_cast<SColumnInfoData*>(taosArrayGet(pRes->pDataBlock, 0));
+      SColumnInfoData* pLeftCol = static_cast<SColumnInfoData*>(taosArrayGet(pRes->pDataBlock, 1));
+      SColumnInfoData* pRightCol = static_cast<SColumnInfoData*>(taosArrayGet(pRes->pDataBlock, 2));
+      for (int32_t i = 0; i < pRes->info.rows; ++i) {
+        double key = (keyType_ == TSDB_DATA_TYPE_DOUBLE) ? *(double*)colDataGetData(pKeyCol, i)
+                                                         : *(int32_t*)colDataGetData(pKeyCol, i);
+        res.push_back(std::make_tuple(key == 0 ? 0 : key, *(int32_t*)colDataGetData(pLeftCol, i),
+                                      *(int32_t*)colDataGetData(pRightCol, i)));
+      }
+    }
+    std::sort(res.begin(), res.end());
+    return res;
+  }
+
+  SHashJoinOperatorInfo* joinInfo() { return static_cast<SHashJoinOperatorInfo*>(pOperator->info); }
+
+  SExecTaskInfo       taskInfo;
+  SHashJoinPhysiNode* pJoinNode = NULL;
+  SOperatorInfo*      pOperator = NULL;
+  int16_t             keyType_ = TSDB_DATA_TYPE_INT;
+};
+
+}  // namespace
+
+TEST_F(HashJoinTest, inner_join) {
+  std::vector<SJoinRow> left, right;
+  for (int32_t i = 0; i < 3000; ++i) {
+    left.push_back({(double)i, i, false});
+  }
+  for (int32_t i = 0; i < 1000; ++i) {
+    right.push_back({(double)(i * 5), 100000 + i, false});
+  }
+
+  createJoin(TSDB_DATA_TYPE_INT, left, right, 512);
+  std::vector<SJoinResRow> res = runJoin();
+  EXPECT_EQ(res.size(), 600);
+  EXPECT_EQ(res, nestedLoopJoin(left, right));
+  EXPECT_EQ(joinInfo()->pParts, nullptr);
+}
+
+TEST_F(HashJoinTest, duplicate_keys) {
+  std::vector<SJoinRow> left, right;
+  for (int32_t i = 0; i < 1500; ++i) {
+    left.push_back({(double)(i % 100), i, false});
+  }
+  for (int32_t i = 0; i < 300; ++i) {
+    right.push_back({(double)(i % 50), 100000 + i, false});
+  }
+
+  // 50 keys on both sides, each key has 15 rows on the left and 6 rows on the right, more than one result block
+  createJoin(TSDB_DATA_TYPE_INT, left, right, 256);
+  std::vector<SJoinResRow> res = runJoin();
+  EXPECT_EQ(res.size(), 50 * 15 * 6);
+  EXPECT_EQ(res, nestedLoopJoin(left, right));
+}
+
+TEST_F(HashJoinTest, null_keys) {
+  std::vector<SJoinRow> left, right;
+  for (int32_t i = 0; i < 1000; ++i) {
+    left.push_back({(double)(i % 10), i, i % 3 == 0});
+    right.push_back({(double)(i % 10), 100000 + i, i % 4 == 0});
+  }
+
+  createJoin(TSDB_DATA_TYPE_INT, left, right, 128);
+  std::vector<SJoinResRow> res = runJoin();
+  EXPECT_FALSE(res.empty());
+  EXPECT_EQ(res, nestedLoopJoin(left, right));
+}
+
+TEST_F(HashJoinTest, null_keys_only) {
+  std::vector<SJoinRow> left, right;
+  for (int32_t i = 0; i < 100; ++i) {
+    left.push_back({0, i, true});
+    right.push_back({0, 100000 + i, true});
+  }
+
+  createJoin(TSDB_DATA_TYPE_INT, left, right, 64);
+  EXPECT_TRUE(runJoin().empty());
+}
+
+TEST_F(HashJoinTest, float_keys_by_value) {
+  std::vector<SJoinRow> left, right;
+  left.push_back({-0.0, 1, false});
+  left.push_back({0.0, 2, false});
+  left.push_back({NAN, 3, false});
+  left.push_back({1.5, 4, false});
+  right.push_back({0.0, 11, false});
+  right.push_back({-0.0, 12, false});
+  right.push_back({NAN, 13, false});
+  right.push_back({1.5, 14, false});
+
+  createJoin(TSDB_DATA_TYPE_DOUBLE, left, right, 4);
+  std::vector<SJoinResRow> res = runJoin();
+  EXPECT_EQ(res.size(), 5);
+  EXPECT_EQ(res, nestedLoopJoin(left, right));
+}
+
+TEST_F(HashJoinTest, build_side_over_budget) {
+  std::vector<SJoinRow> left, right;
+  for (int32_t i = 0; i < 20000; ++i) {
+    left.push_back({(double)(i % 5000), i, i % 97 == 0});
+  }
+  for (int32_t i = 0; i < 10000; ++i) {
+    right.push_back({(double)(i % 7000), 100000 + i, i % 89 == 0});
+  }
+
+  // both sides are larger than the budget, so they are spilled and joined partition by partition
+  createJoin(TSDB_DATA_TYPE_INT, left, right, 1024);
+  joinInfo()->buildBufSize = 4096;
+
+  std::vector<SJoinResRow> res = runJoin();
+  EXPECT_NE(joinInfo()->pParts, nullptr);
+  EXPECT_FALSE(res.empty());
+  EXPECT_EQ(res, nestedLoopJoin(left, right));
+}
+
+#pragma GCC diagnostic pop
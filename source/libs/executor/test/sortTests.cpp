@@ -16,7 +16,10 @@
 #include <gtest/gtest.h>
 #include <tglobal.h>
 #include <tsort.h>
+#include <algorithm>
 #include <iostream>
+#include <thread>
+#include <vector>
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wwrite-strings"
@@ -193,8 +196,159 @@ int32_t docomp(const void* p1, const void* p2, void* param) {
 
   return 0;
 }
+
+typedef struct {
+  const std::vector<int64_t>* values;
+  int32_t                     pageRows;
+  int32_t                     offset;
+  SSDataBlock*                pBlock;
+} _vals_info;
+
+// the blocks of a bigint column taken from the values in order, the last block is freed by the next call
+SSDataBlock* getValuesBlock(void* param) {
+  _vals_info* pInfo = (_vals_info*)param;
+  blockDataDestroy(pInfo->pBlock);
+  pInfo->pBlock = NULL;
+
+  int32_t rows = TMIN(pInfo->pageRows, (int32_t)pInfo->values->size() - pInfo->offset);
+  if (rows <= 0) {
+    return NULL;
+  }
+
+  pInfo->pBlock = createDataBlock();
+  SColumnInfoData colInfo = createColumnInfoData(TSDB_DATA_TYPE_BIGINT, sizeof(int64_t), 1);
+  blockDataAppendColInfo(pInfo->pBlock, &colInfo);
+  blockDataEnsureCapacity(pInfo->pBlock, rows);
+
+  SColumnInfoData* pColInfo = (SColumnInfoData*)taosArrayGet(pInfo->pBlock->pDataBlock, 0);
+  for (int32_t i = 0; i < rows; ++i) {
+    colDataAppend(pColInfo, i, (const char*)&(*pInfo->values)[pInfo->offset + i], false);
+  }
+
+  pInfo->offset += rows;
+  pInfo->pBlock->info.rows = rows;
+  return pInfo->pBlock;
+}
+
+// sort the values descending the way the sort operator does, keeping only maxRows rows if it is not 0
+std::vector<int64_t> sortValues(const std::vector<int64_t>& values, int64_t maxRows, int32_t pageSize, int32_t numOfPages) {
+  SBlockOrderInfo oi = {0};
+  oi.order = TSDB_ORDER_DESC;
+  oi.slotId = 0;
+  SArray* orderInfo = taosArrayInit(1, sizeof(SBlockOrderInfo));
+  taosArrayPush(orderInfo, &oi);
+
+  // without a block the sort handle picks the page size and the number of pages of its own
+  SSDataBlock* pBlock = NULL;
+  if (pageSize > 0) {
+    pBlock = createDataBlock();
+    SColumnInfoData colInfo = createColumnInfoData(TSDB_DATA_TYPE_BIGINT, sizeof(int64_t), 1);
+    blockDataAppendColInfo(pBlock, &colInfo);
+  }
+
+  _vals_info info = {&values, 1000, 0, NULL};
+
+  SSortHandle* phandle = tsortCreateSortHandle(orderInfo, SORT_SINGLESOURCE_SORT, pageSize, numOfPages, pBlock, "test_top");
+  tsortSetFetchRawDataFp(phandle, getValuesBlock, NULL, NULL);
+  tsortSetMaxRows(phandle, maxRows);
+
+  SSortSource* ps = static_cast<SSortSource*>(taosMemoryCalloc(1, sizeof(SSortSource)));
+  ps->param = &info;
+  tsortAddSource(phandle, ps);
+
+  std::vector<int64_t> res;
+  int32_t              code = tsortOpen(phandle);
+  taosMemoryFreeClear(ps);
+  EXPECT_EQ(code, TSDB_CODE_SUCCESS);
+
+  while (code == TSDB_CODE_SUCCESS) {
+    STupleHandle* pTupleHandle = tsortNextTuple(phandle);
+    if (pTupleHandle == NULL) {
+      break;
+    }
+
+    res.push_back(*(int64_t*)tsortGetValue(pTupleHandle, 0));
+  }
+
+  tsortDestroySortHandle(phandle);
+  blockDataDestroy(info.pBlock);
+  blockDataDestroy(pBlock);
+  taosArrayDestroy(orderInfo);
+  return res;
+}
+
+std::vector<int64_t> randValues(int32_t num) {
+  std::vector<int64_t> values;
+  for (int32_t i = 0; i < num; ++i) {
+    values.push_back(taosRand() % 1000000 - 500000);
+  }
+
+  return values;
+}
 }  // namespace
 
+TEST(testCase, top_rows_sort_Test) {
+  std::vector<int64_t> values = randValues(20000);
+  std::vector<int64_t> all = sortValues(values, 0, 0, 0);
+  ASSERT_EQ(all.size(), values.size());
+
+  // offset + limit of ORDER BY ... LIMIT, the rows of the pushed down limit are the head of the full sort
+  for (int64_t maxRows : {1, 150, 2047, 3000, 19999}) {
+    std::vector<int64_t> top = sortValues(values, maxRows, 0, 0);
+    ASSERT_EQ(top.size(), maxRows);
+    EXPECT_TRUE(std::equal(top.begin(), top.end(), all.begin())) << "maxRows " << maxRows;
+  }
+
+  // more than the total rows keeps all of them
+  EXPECT_EQ(sortValues(values, 50000, 0, 0), all);
+}
+
+TEST(testCase, top_rows_external_sort_Test) {
+  std::vector<int64_t> values = randValues(20000);
+  std::vector<int64_t> all = sortValues(values, 0, 1024, 16);
+  ASSERT_EQ(all.size(), values.size());
+
+  // the kept rows do not fit in the sort buffer, so all rows are sorted by the external sort, a huge limit must not
+  // overflow the buffer check
+  for (int64_t maxRows : {(int64_t)1, (int64_t)5000, INT64_MAX / 2, INT64_MAX}) {
+    std::vector<int64_t> top = sortValues(values, maxRows, 1024, 16);
+    ASSERT_GE(top.size(), TMIN(maxRows, (int64_t)values.size()));
+    EXPECT_TRUE(std::equal(top.begin(), top.begin() + TMIN(maxRows, (int64_t)top.size()), all.begin()))
+        << "maxRows " << maxRows;
+  }
+}
+
+TEST(testCase, parallel_sort_runs_Test) {
+  std::vector<int64_t> values = randValues(50000);
+  std::vector<int64_t> expect = values;
+  std::sort(expect.begin(), expect.end(), std::greater<int64_t>());
+
+  // without the sort workers the runs are generated on the query thread
+  EXPECT_EQ(sortValues(values, 0, 1024, 16), expect);
+
+  tsNumOfSortThreads = 4;
+  ASSERT_EQ(tsortInit(), 0);
+  EXPECT_EQ(sortValues(values, 0, 1024, 16), expect);
+
+  // the sort workers are shared by the queries running at the same time
+  std::vector<std::vector<int64_t>> res(4);
+  std::vector<std::thread>          threads;
+  for (int32_t i = 0; i < res.size(); ++i) {
+    threads.emplace_back([&values, &res, i]() { res[i] = sortValues(values, 0, 1024, 16); });
+  }
+
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  for (auto& r : res) {
+    EXPECT_EQ(r, expect);
+  }
+
+  tsortCleanUp();
+  EXPECT_EQ(sortValues(values, 0, 1024, 16), expect);
+}
+
 #if 0
 TEST(testCase, inMem_sort_Test) {
   SBlockOrderInfo oi = {0};
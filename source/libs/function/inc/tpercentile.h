@@ -62,6 +62,7 @@ typedef struct tMemBucket {
   int32_t            times;        // count that has been checked for deciding the correct data value buckets.
   __compar_fn_t      comparFn;
   tMemBucketSlot*    pSlots;
+  tMemBucketSlot     overflow;     // values beyond the range of slots, bucketed again before searching the percentile
   SDiskbasedBuf*     pBuffer;
   __perc_hash_func_t hashFunc;
   SHashObj*          groupPagesMap; // disk page map for different groups;
@@ -73,7 +74,7 @@ void tMemBucketDestroy(tMemBucket *pBucket);
 
 int32_t tMemBucketPut(tMemBucket *pBucket, const void *data, size_t size);
 
-double getPercentile(tMemBucket *pMemBucket, double percent);
+int32_t getPercentile(tMemBucket *pMemBucket, double percent, double *result);
 
 #endif  // TDENGINE_TPERCENTILE_H
 
@@ -130,9 +130,6 @@ typedef struct SLeastSQRInfo {
 typedef struct SPercentileInfo {
   double      result;
   tMemBucket* pMemBucket;
-  int32_t     stage;
-  double      minval;
-  double      maxval;
   int64_t     numOfElems;
 } SPercentileInfo;
 
@@ -2330,10 +2327,8 @@ bool percentileFunctionSetup(SqlFunctionCtx* pCtx, SResultRowEntryInfo* pResultI
     return false;
   }
 
-  // in the first round, get the min-max value of all involved data
   SPercentileInfo* pInfo = GET_ROWCELL_INTERBUF(pResultInfo);
-  SET_DOUBLE_VAL(&pInfo->minval, DBL_MAX);
-  SET_DOUBLE_VAL(&pInfo->maxval, -DBL_MAX);
+  pInfo->pMemBucket = NULL;
   pInfo->numOfElems = 0;
 
   return true;
@@ -2348,24 +2343,19 @@ int32_t percentileFunction(SqlFunctionCtx* pCtx) {
 
   SColumnInfoData* pCol = pInput->pData[0];
   int32_t          type = pCol->info.type;
+  int32_t          start = pInput->startRowIndex;
 
   SPercentileInfo* pInfo = GET_ROWCELL_INTERBUF(pResInfo);
-  if (pCtx->scanFlag == REPEAT_SCAN && pInfo->stage == 0) {
-    pInfo->stage += 1;
 
-    // all data are null, set it completed
-    if (pInfo->numOfElems == 0) {
-      pResInfo->complete = true;
-      return 0;
-    } else {
-      pInfo->pMemBucket = tMemBucketCreate(pCol->info.bytes, type, pInfo->minval, pInfo->maxval);
-    }
-  }
-
-  // the first stage, only acquire the min/max value
-  if (pInfo->stage == 0) {
+  // the value range of buckets is seeded by the first block with data, the data beyond it are bucketed again
+  // when the result is calculated, so the input is scanned only once
+  if (pInfo->pMemBucket == NULL) {
+    double tmin = DBL_MAX, tmax = -DBL_MAX;
     if (pCtx->input.colDataAggIsSet) {
-      double tmin = 0.0, tmax = 0.0;
+      if (pAgg->numOfNull == pInput->numOfRows) {
+        return TSDB_CODE_SUCCESS;
+      }
+
       if (IS_SIGNED_NUMERIC_TYPE(type)) {
         tmin = (double)GET_INT64_VAL(&pAgg->min);
         tmax = (double)GET_INT64_VAL(&pAgg->max);
@@ -2376,55 +2366,45 @@ int32_t percentileFunction(SqlFunctionCtx* pCtx) {
         tmin = (double)GET_UINT64_VAL(&pAgg->min);
         tmax = (double)GET_UINT64_VAL(&pAgg->max);
       }
-
-      if (GET_DOUBLE_VAL(&pInfo->minval) > tmin) {
-        SET_DOUBLE_VAL(&pInfo->minval, tmin);
-      }
-
-      if (GET_DOUBLE_VAL(&pInfo->maxval) < tmax) {
-        SET_DOUBLE_VAL(&pInfo->maxval, tmax);
-      }
-
-      pInfo->numOfElems += (pInput->numOfRows - pAgg->numOfNull);
     } else {
-      // check the valid data one by one
-      int32_t start = pInput->startRowIndex;
       for (int32_t i = start; i < pInput->numOfRows + start; ++i) {
         if (colDataIsNull_f(pCol->nullbitmap, i)) {
           continue;
         }
 
-        char* data = colDataGetData(pCol, i);
-
         double v = 0;
-        GET_TYPED_DATA(v, double, type, data);
-        if (v < GET_DOUBLE_VAL(&pInfo->minval)) {
-          SET_DOUBLE_VAL(&pInfo->minval, v);
-        }
-
-        if (v > GET_DOUBLE_VAL(&pInfo->maxval)) {
-          SET_DOUBLE_VAL(&pInfo->maxval, v);
-        }
+        GET_TYPED_DATA(v, double, type, colDataGetData(pCol, i));
+        tmin = TMIN(tmin, v);
+        tmax = TMAX(tmax, v);
+      }
 
-        pInfo->numOfElems += 1;
+      // all data are null
+      if (tmin > tmax) {
+        return TSDB_CODE_SUCCESS;
       }
     }
-  } else {
-    // the second stage, calculate the true percentile value
-    int32_t start = pInput->startRowIndex;
-    for (int32_t i = start; i < pInput->numOfRows + start; ++i) {
-      if (colDataIsNull_f(pCol->nullbitmap, i)) {
-        continue;
-      }
 
-      char* data = colDataGetData(pCol, i);
-      numOfElems += 1;
-      tMemBucketPut(pInfo->pMemBucket, data, 1);
+    pInfo->pMemBucket = tMemBucketCreate(pCol->info.bytes, type, tmin, tmax);
+    if (pInfo->pMemBucket == NULL) {
+      return (terrno != 0) ? terrno : TSDB_CODE_OUT_OF_MEMORY;
+    }
+  }
+
+  for (int32_t i = start; i < pInput->numOfRows + start; ++i) {
+    if (colDataIsNull_f(pCol->nullbitmap, i)) {
+      continue;
     }
 
-    SET_VAL(pResInfo, numOfElems, 1);
+    char* data = colDataGetData(pCol, i);
+    numOfElems += 1;
+    int32_t code = tMemBucketPut(pInfo->pMemBucket, data, 1);
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
   }
 
+  pInfo->numOfElems += numOfElems;
+  SET_VAL(pResInfo, numOfElems, 1);
   return TSDB_CODE_SUCCESS;
 }
 
@@ -2438,7 +2418,14 @@ int32_t percentileFinalize(SqlFunctionCtx* pCtx, SSDataBlock* pBlock) {
 
   tMemBucket* pMemBucket = ppInfo->pMemBucket;
   if (pMemBucket != NULL && pMemBucket->total > 0) {  // check for null
-    SET_DOUBLE_VAL(&ppInfo->result, getPercentile(pMemBucket, v));
+    double  result = 0;
+    int32_t code = getPercentile(pMemBucket, v, &result);
+    if (code != TSDB_CODE_SUCCESS) {
+      tMemBucketDestroy(pMemBucket);
+      ppInfo->pMemBucket = NULL;
+      return code;
+    }
+    SET_DOUBLE_VAL(&ppInfo->result, result);
   }
 
   tMemBucketDestroy(pMemBucket);
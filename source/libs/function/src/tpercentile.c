@@ -24,6 +24,7 @@
 #include "ttypes.h"
 
 #define DEFAULT_NUM_OF_SLOT 1024
+#define OVERFLOW_GROUP_ID   (-1)
 
 int32_t getGroupId(int32_t numOfSlots, int32_t slotIndex, int32_t times) {
   return (times * numOfSlots) + slotIndex;
@@ -31,6 +32,10 @@ int32_t getGroupId(int32_t numOfSlots, int32_t slotIndex, int32_t times) {
 
 static SFilePage *loadDataFromFilePage(tMemBucket *pMemBucket, int32_t slotIdx) {
   SFilePage *buffer = (SFilePage *)taosMemoryCalloc(1, pMemBucket->bytes * pMemBucket->pSlots[slotIdx].info.size + sizeof(SFilePage));
+  if (buffer == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return NULL;
+  }
 
   int32_t groupId = getGroupId(pMemBucket->numOfSlots, slotIdx, pMemBucket->times);
   SArray* pIdList = *(SArray**)taosHashGet(pMemBucket->groupPagesMap, &groupId, sizeof(groupId));
@@ -40,6 +45,11 @@ static SFilePage *loadDataFromFilePage(tMemBucket *pMemBucket, int32_t slotIdx)
     int32_t* pageId = taosArrayGet(pIdList, i);
 
     SFilePage* pg = getBufPage(pMemBucket->pBuffer, *pageId);
+    if (pg == NULL) {
+      taosMemoryFree(buffer);
+      return NULL;
+    }
+
     memcpy(buffer->data + offset, pg->data, (size_t)(pg->num * pMemBucket->bytes));
 
     offset += (int32_t)(pg->num * pMemBucket->bytes);
@@ -81,6 +91,19 @@ static int32_t setBoundingBox(MinMaxEntry* range, int16_t type, double minval, d
   return 0;
 }
 
+static void mergeBoundingBox(MinMaxEntry* range, const MinMaxEntry* other, int32_t type) {
+  if (IS_SIGNED_NUMERIC_TYPE(type)) {
+    range->i64MinVal = TMIN(range->i64MinVal, other->i64MinVal);
+    range->i64MaxVal = TMAX(range->i64MaxVal, other->i64MaxVal);
+  } else if (IS_UNSIGNED_NUMERIC_TYPE(type)) {
+    range->u64MinVal = TMIN(range->u64MinVal, other->u64MinVal);
+    range->u64MaxVal = TMAX(range->u64MaxVal, other->u64MaxVal);
+  } else {
+    range->dMinVal = TMIN(range->dMinVal, other->dMinVal);
+    range->dMaxVal = TMAX(range->dMaxVal, other->dMaxVal);
+  }
+}
+
 static void resetPosInfo(SSlotInfo* pInfo) {
   pInfo->size   = 0;
   pInfo->pageId = -1;
@@ -213,9 +236,21 @@ static void resetSlotInfo(tMemBucket* pBucket) {
   for (int32_t i = 0; i < pBucket->numOfSlots; ++i) {
     tMemBucketSlot* pSlot = &pBucket->pSlots[i];
 
+    // the page being written is not needed in memory any more
+    if (pSlot->info.data != NULL) {
+      releaseBufPage(pBucket->pBuffer, pSlot->info.data);
+    }
+
     resetBoundingBox(&pSlot->range, pBucket->type);
     resetPosInfo(&pSlot->info);
   }
+
+  if (pBucket->overflow.info.data != NULL) {
+    releaseBufPage(pBucket->pBuffer, pBucket->overflow.info.data);
+  }
+
+  resetBoundingBox(&pBucket->overflow.range, pBucket->type);
+  resetPosInfo(&pBucket->overflow.info);
 }
 
 tMemBucket *tMemBucketCreate(int16_t nElemSize, int16_t dataType, double minval, double maxval) {
@@ -332,59 +367,136 @@ void tMemBucketUpdateBoundingBox(MinMaxEntry *r, const char *data, int32_t dataT
   }
 }
 
+static int32_t tMemBucketAppend(tMemBucket *pBucket, tMemBucketSlot *pSlot, int32_t groupId, const char *d) {
+  tMemBucketUpdateBoundingBox(&pSlot->range, d, pBucket->type);
+
+  // ensure available memory pages to allocate
+  if (pSlot->info.data == NULL || pSlot->info.data->num >= pBucket->elemPerPage) {
+    if (pSlot->info.data != NULL) {
+      assert(pSlot->info.data->num >= pBucket->elemPerPage && pSlot->info.size > 0);
+
+      // keep the pointer in memory
+      releaseBufPage(pBucket->pBuffer, pSlot->info.data);
+      pSlot->info.data = NULL;
+    }
+
+    SArray** p = (SArray**)taosHashGet(pBucket->groupPagesMap, &groupId, sizeof(groupId));
+    SArray*  pPageIdList = (p != NULL) ? *p : NULL;
+    if (pPageIdList == NULL) {
+      pPageIdList = taosArrayInit(4, sizeof(int32_t));
+      if (pPageIdList == NULL) {
+        return TSDB_CODE_OUT_OF_MEMORY;
+      }
+      taosHashPut(pBucket->groupPagesMap, &groupId, sizeof(groupId), &pPageIdList, POINTER_BYTES);
+    }
+
+    int32_t pageId = -1;
+    pSlot->info.data = getNewBufPage(pBucket->pBuffer, &pageId);
+    if (pSlot->info.data == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+    pSlot->info.pageId = pageId;
+    taosArrayPush(pPageIdList, &pageId);
+  }
+
+  memcpy(pSlot->info.data->data + pSlot->info.data->num * pBucket->bytes, d, pBucket->bytes);
+  setBufPageDirty(pSlot->info.data, true);
+
+  pSlot->info.data->num += 1;
+  pSlot->info.size += 1;
+  return TSDB_CODE_SUCCESS;
+}
+
 /*
  * in memory bucket, we only accept data array list
  */
 int32_t tMemBucketPut(tMemBucket *pBucket, const void *data, size_t size) {
   assert(pBucket != NULL && data != NULL && size > 0);
 
+  int32_t code = TSDB_CODE_SUCCESS;
   int32_t count = 0;
   int32_t bytes = pBucket->bytes;
   for (int32_t i = 0; i < size; ++i) {
     char *d = (char *) data + i * bytes;
     int32_t index = (pBucket->hashFunc)(pBucket, d);
     if (index < 0) {
-      continue;
+      // out of the range of slots, kept aside until all data are put
+      code = tMemBucketAppend(pBucket, &pBucket->overflow, OVERFLOW_GROUP_ID, d);
+    } else {
+      int32_t groupId = getGroupId(pBucket->numOfSlots, index, pBucket->times);
+      code = tMemBucketAppend(pBucket, &pBucket->pSlots[index], groupId, d);
+    }
+
+    if (code != TSDB_CODE_SUCCESS) {
+      break;
     }
 
     count += 1;
+  }
 
-    tMemBucketSlot *pSlot = &pBucket->pSlots[index];
-    tMemBucketUpdateBoundingBox(&pSlot->range, d, pBucket->type);
+  pBucket->total += count;
+  return code;
+}
 
-    // ensure available memory pages to allocate
-    int32_t groupId = getGroupId(pBucket->numOfSlots, index, pBucket->times);
-    int32_t pageId = -1;
+// put the data in all pages of a group into the slots again
+static int32_t tMemBucketPutGroup(tMemBucket *pBucket, int32_t groupId) {
+  SArray** p = (SArray**)taosHashGet(pBucket->groupPagesMap, &groupId, sizeof(groupId));
+  if (p == NULL) {
+    return TSDB_CODE_SUCCESS;
+  }
 
-    if (pSlot->info.data == NULL || pSlot->info.data->num >= pBucket->elemPerPage) {
-      if (pSlot->info.data != NULL) {
-        assert(pSlot->info.data->num >= pBucket->elemPerPage && pSlot->info.size > 0);
+  SArray* pIdList = *p;
+  for (int32_t i = 0; i < taosArrayGetSize(pIdList); ++i) {
+    int32_t*   pageId = taosArrayGet(pIdList, i);
+    SFilePage* pg = getBufPage(pBucket->pBuffer, *pageId);
+    if (pg == NULL) {
+      return terrno;
+    }
 
-        // keep the pointer in memory
-        releaseBufPage(pBucket->pBuffer, pSlot->info.data);
-        pSlot->info.data = NULL;
-      }
+    int32_t code = (pg->num > 0) ? tMemBucketPut(pBucket, pg->data, (int32_t)pg->num) : TSDB_CODE_SUCCESS;
+    releaseBufPage(pBucket->pBuffer, pg);
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
+  }
 
-      SArray* pPageIdList = (SArray*)taosHashGet(pBucket->groupPagesMap, &groupId, sizeof(groupId));
-      if (pPageIdList == NULL) {
-        SArray* pList = taosArrayInit(4, sizeof(int32_t));
-        taosHashPut(pBucket->groupPagesMap, &groupId, sizeof(groupId), &pList, POINTER_BYTES);
-        pPageIdList =  pList;
-      }
+  return TSDB_CODE_SUCCESS;
+}
 
-      pSlot->info.data = getNewBufPage(pBucket->pBuffer, &pageId);
-      pSlot->info.pageId = pageId;
-      taosArrayPush(pPageIdList, &pageId);
-    }
+/*
+ * The value range of slots is decided by the data seen first, the data out of it are bucketed again
+ * together with the others by the full value range, so no second scan of the input data is required.
+ */
+static int32_t tMemBucketRebuild(tMemBucket *pBucket) {
+  if (pBucket->overflow.info.size == 0) {
+    return TSDB_CODE_SUCCESS;
+  }
 
-    memcpy(pSlot->info.data->data + pSlot->info.data->num * pBucket->bytes, d, pBucket->bytes);
+  int32_t times = pBucket->times;
+  mergeBoundingBox(&pBucket->range, &pBucket->overflow.range, pBucket->type);
 
-    pSlot->info.data->num += 1;
-    pSlot->info.size += 1;
+  pBucket->times += 1;
+  pBucket->total = 0;
+  resetSlotInfo(pBucket);
+
+  for (int32_t i = 0; i < pBucket->numOfSlots; ++i) {
+    int32_t code = tMemBucketPutGroup(pBucket, getGroupId(pBucket->numOfSlots, i, times));
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
   }
 
-  pBucket->total += count;
-  return 0;
+  int32_t code = tMemBucketPutGroup(pBucket, OVERFLOW_GROUP_ID);
+  if (code != TSDB_CODE_SUCCESS) {
+    return code;
+  }
+
+  assert(pBucket->overflow.info.size == 0);
+
+  int32_t  groupId = OVERFLOW_GROUP_ID;
+  SArray** p = (SArray**)taosHashGet(pBucket->groupPagesMap, &groupId, sizeof(groupId));
+  taosArrayClear(*p);
+  return TSDB_CODE_SUCCESS;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////
@@ -424,7 +536,7 @@ static double getIdenticalDataVal(tMemBucket* pMemBucket, int32_t slotIndex) {
   return finalResult;
 }
 
-double getPercentileImpl(tMemBucket *pMemBucket, int32_t count, double fraction) {
+int32_t getPercentileImpl(tMemBucket *pMemBucket, int32_t count, double fraction, double *result) {
   int32_t num = 0;
 
   for (int32_t i = 0; i < pMemBucket->numOfSlots; ++i) {
@@ -457,13 +569,17 @@ double getPercentileImpl(tMemBucket *pMemBucket, int32_t count, double fraction)
 
         assert(minOfNextSlot > maxOfThisSlot);
 
-        double val = (1 - fraction) * maxOfThisSlot + fraction * minOfNextSlot;
-        return val;
+        *result = (1 - fraction) * maxOfThisSlot + fraction * minOfNextSlot;
+        return TSDB_CODE_SUCCESS;
       }
 
       if (pSlot->info.size <= pMemBucket->maxCapacity) {
         // data in buffer and file are merged together to be processed.
         SFilePage *buffer = loadDataFromFilePage(pMemBucket, i);
+        if (buffer == NULL) {
+          return terrno;
+        }
+
         int32_t    currentIdx = count - num;
 
         char *thisVal = buffer->data + pMemBucket->bytes * currentIdx;
@@ -473,13 +589,14 @@ double getPercentileImpl(tMemBucket *pMemBucket, int32_t count, double fraction)
         GET_TYPED_DATA(td, double, pMemBucket->type, thisVal);
         GET_TYPED_DATA(nd, double, pMemBucket->type, nextVal);
 
-        double val = (1 - fraction) * td + fraction * nd;
+        *result = (1 - fraction) * td + fraction * nd;
         taosMemoryFreeClear(buffer);
 
-        return val;
+        return TSDB_CODE_SUCCESS;
       } else {  // incur a second round bucket split
        if (isIdenticalData(pMemBucket, i)) {
-         return getIdenticalDataVal(pMemBucket, i);
+         *result = getIdenticalDataVal(pMemBucket, i);
+         return TSDB_CODE_SUCCESS;
        }
 
        // try next round
@@ -492,35 +609,39 @@ double getPercentileImpl(tMemBucket *pMemBucket, int32_t count, double fraction)
        resetSlotInfo(pMemBucket);
 
        int32_t groupId = getGroupId(pMemBucket->numOfSlots, i, pMemBucket->times - 1);
-        SIDList list = taosHashGet(pMemBucket->groupPagesMap, &groupId, sizeof(groupId));
-       assert(list->size > 0);
-
-       for (int32_t f = 0; f < list->size; ++f) {
-         SPageInfo *pgInfo = *(SPageInfo **)taosArrayGet(list, f);
-         SFilePage *pg = getBufPage(pMemBucket->pBuffer, getPageId(pgInfo));
-
-         tMemBucketPut(pMemBucket, pg->data, (int32_t)pg->num);
-         releaseBufPageInfo(pMemBucket->pBuffer, pgInfo);
+       int32_t code = tMemBucketPutGroup(pMemBucket, groupId);
+       if (code != TSDB_CODE_SUCCESS) {
+         terrno = code;
+         return code;
        }
 
-       return getPercentileImpl(pMemBucket, count - num, fraction);
+       return getPercentileImpl(pMemBucket, count - num, fraction, result);
       }
     } else {
       num += pSlot->info.size;
     }
   }
 
-  return 0;
+  *result = 0;
+  return TSDB_CODE_SUCCESS;
 }
 
-double getPercentile(tMemBucket *pMemBucket, double percent) {
+int32_t getPercentile(tMemBucket *pMemBucket, double percent, double *result) {
   if (pMemBucket->total == 0) {
-    return 0.0;
+    *result = 0.0;
+    return TSDB_CODE_SUCCESS;
+  }
+
+  int32_t code = tMemBucketRebuild(pMemBucket);
+  if (code != TSDB_CODE_SUCCESS) {
+    terrno = code;
+    return code;
   }
 
   // if only one elements exists, return it
   if (pMemBucket->total == 1) {
-    return findOnlyResult(pMemBucket);
+    *result = findOnlyResult(pMemBucket);
+    return TSDB_CODE_SUCCESS;
   }
 
   percent = fabs(percent);
@@ -530,21 +651,20 @@ double getPercentile(tMemBucket *pMemBucket, double percent) {
     MinMaxEntry* pRange = &pMemBucket->range;
 
     if (IS_SIGNED_NUMERIC_TYPE(pMemBucket->type)) {
-      double v = (double)(fabs(percent - 100) < DBL_EPSILON ? pRange->i64MaxVal : pRange->i64MinVal);
-      return v;
+      *result = (double)(fabs(percent - 100) < DBL_EPSILON ? pRange->i64MaxVal : pRange->i64MinVal);
     } else if (IS_UNSIGNED_NUMERIC_TYPE(pMemBucket->type)) {
-      double v = (double)(fabs(percent - 100) < DBL_EPSILON ? pRange->u64MaxVal : pRange->u64MinVal);
-      return v;
+      *result = (double)(fabs(percent - 100) < DBL_EPSILON ? pRange->u64MaxVal : pRange->u64MinVal);
     } else {
-      return fabs(percent - 100) < DBL_EPSILON? pRange->dMaxVal:pRange->dMinVal;
+      *result = fabs(percent - 100) < DBL_EPSILON ? pRange->dMaxVal : pRange->dMinVal;
     }
+    return TSDB_CODE_SUCCESS;
   }
 
   double  percentVal = (percent * (pMemBucket->total - 1)) / ((double)100.0);
 
   // do put data by using buckets
   int32_t orderIdx = (int32_t)percentVal;
-  return getPercentileImpl(pMemBucket, orderIdx, percentVal - orderIdx);
+  return getPercentileImpl(pMemBucket, orderIdx, percentVal - orderIdx, result);
 }
 
 /*
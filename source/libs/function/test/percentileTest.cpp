@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <vector>
+
+#include "builtinsimpl.h"
+#include "tdatablock.h"
+#include "tpercentile.h"
+
+namespace {
+
+const double percents[] = {0, 0.5, 1, 10, 25, 33.3, 50, 66.6, 75, 90, 99, 99.5, 100};
+
+// the percentile by sorting all values, interpolated the same way as the memory bucket
+double sortPercentile(std::vector<double> values, double percent) {
+  std::sort(values.begin(), values.end());
+
+  double  pos = percent * (values.size() - 1) / 100.0;
+  int32_t idx = (int32_t)pos;
+  if (idx + 1 >= (int32_t)values.size()) {
+    return values[idx];
+  }
+
+  double fraction = pos - idx;
+  return (1 - fraction) * values[idx] + fraction * values[idx + 1];
+}
+
+class PercentileTest : public ::testing::Test {
+ protected:
+  static void SetUpTestSuite() { osDefaultInit(); }
+
+  void SetUp() override { reset(); }
+
+  void TearDown() override { taosMemoryFreeClear(pResInfo); }
+
+  void reset() {
+    taosMemoryFreeClear(pResInfo);
+    values.clear();
+
+    memset(&ctx, 0, sizeof(ctx));
+    memset(&expr, 0, sizeof(expr));
+    memset(param, 0, sizeof(param));
+
+    pResInfo = (SResultRowEntryInfo *)taosMemoryCalloc(1, sizeof(SResultRowEntryInfo) + 64);
+    ctx.resultInfo = pResInfo;
+    ctx.resDataInfo.interBufSize = 64;
+    ctx.pExpr = &expr;
+    ctx.param = param;
+    ctx.numOfParams = 2;
+    ctx.input.pData = &pInputCol;
+    ctx.input.pColumnDataAgg = &pInputAgg;
+    ctx.input.numOfInputCols = 1;
+    pInputAgg = NULL;
+
+    ASSERT_TRUE(percentileFunctionSetup(&ctx, pResInfo));
+  }
+
+  // feed one block to the function, the values are in the column type
+  template <typename T>
+  void putBlock(int16_t type, const std::vector<T> &block) {
+    SColumnInfoData col = createColumnInfoData(type, sizeof(T), 1);
+    ASSERT_EQ(colInfoDataEnsureCapacity(&col, block.size()), 0);
+    for (int32_t i = 0; i < block.size(); ++i) {
+      colDataAppend(&col, i, (const char *)&block[i], false);
+      values.push_back((double)block[i]);
+    }
+
+    pInputCol = &col;
+    ctx.input.startRowIndex = 0;
+    ctx.input.numOfRows = block.size();
+    ctx.input.totalRows = block.size();
+    ASSERT_EQ(percentileFunction(&ctx), TSDB_CODE_SUCCESS);
+    colDataDestroy(&col);
+  }
+
+  double finalize(double percent) {
+    param[1].param.nType = TSDB_DATA_TYPE_DOUBLE;
+    param[1].param.d = percent;
+
+    SSDataBlock    *pBlock = createDataBlock();
+    SColumnInfoData col = createColumnInfoData(TSDB_DATA_TYPE_DOUBLE, sizeof(double), 1);
+    blockDataAppendColInfo(pBlock, &col);
+    blockDataEnsureCapacity(pBlock, 1);
+
+    EXPECT_EQ(percentileFinalize(&ctx, pBlock), 1);
+    double v = *(double *)colDataGetData((SColumnInfoData *)taosArrayGet(pBlock->pDataBlock, 0), 0);
+    blockDataDestroy(pBlock);
+    return v;
+  }
+
+  // the first block seeds the bucket range, the later ones fall below and above it
+  template <typename T>
+  void checkRebucket(int16_t type, T base, T below, T above) {
+    std::vector<T> blocks[4];
+    for (int32_t i = 0; i < 3000; ++i) {
+      blocks[0].push_back(base + (T)(taosRand() % 1000));
+      blocks[1].push_back(below + (T)(taosRand() % 100000));
+      blocks[2].push_back(above + (T)(taosRand() % 100000));
+      blocks[3].push_back((i % 2 == 0) ? below + (T)(taosRand() % 10) : above + (T)(taosRand() % 10));
+    }
+
+    // the result is finalized once per run, so each percent takes a run of its own
+    for (double percent : percents) {
+      reset();
+      for (int32_t i = 0; i < 4; ++i) {
+        putBlock(type, blocks[i]);
+      }
+
+      EXPECT_DOUBLE_EQ(finalize(percent), sortPercentile(values, percent)) << "percent " << percent;
+    }
+  }
+
+  SqlFunctionCtx       ctx;
+  SExprInfo            expr;
+  SFunctParam          param[2];
+  SResultRowEntryInfo *pResInfo = NULL;
+  SColumnInfoData     *pInputCol;
+  SColumnDataAgg      *pInputAgg;
+  std::vector<double>  values;
+};
+
+}  // namespace
+
+TEST_F(PercentileTest, rebucket_int) { checkRebucket<int32_t>(TSDB_DATA_TYPE_INT, 0, -200000, 1000); }
+
+TEST_F(PercentileTest, rebucket_unsigned) {
+  checkRebucket<uint32_t>(TSDB_DATA_TYPE_UINT, 200000, 0, 300000);
+}
+
+TEST_F(PercentileTest, rebucket_double) {
+  checkRebucket<double>(TSDB_DATA_TYPE_DOUBLE, 0.25, -100000.5, 1000.75);
+}
+
+TEST_F(PercentileTest, first_block_only) {
+  std::vector<int64_t> block;
+  for (int32_t i = 0; i < 5000; ++i) {
+    block.push_back(taosRand() % 100000 - 50000);
+  }
+
+  putBlock(TSDB_DATA_TYPE_BIGINT, block);
+  EXPECT_DOUBLE_EQ(finalize(50), sortPercentile(values, 50));
+}
@@ -16,6 +16,7 @@
 #define __INDEX_UTIL_H__
 
 #include "indexInt.h"
+#include "troaring.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -94,12 +95,13 @@ typedef struct {
 
 /*
  * index temp result
- *
+ * total: uids loaded from tfile posting lists
+ * add/del: uids changed in cache
  */
 typedef struct {
-  SArray *total;
-  SArray *add;
-  SArray *del;
+  SRoaring *total;
+  SArray   *add;
+  SArray   *del;
 } SIdxTRslt;
 
 SIdxTRslt *idxTRsltCreate();
@@ -108,6 +110,11 @@ void idxTRsltClear(SIdxTRslt *tr);
 
 void idxTRsltDestroy(SIdxTRslt *tr);
 
+/*
+ * (total + add - del) saved in out
+ */
+int32_t idxTRsltMergeToBitmap(SIdxTRslt *tr, SRoaring *out);
+
 void idxTRsltMergeTo(SIdxTRslt *tr, SArray *out);
 
 #ifdef __cplusplus
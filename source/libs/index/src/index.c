@@ -75,10 +75,10 @@ typedef struct SIdxColInfo {
 
 static TdThreadOnce isInit = PTHREAD_ONCE_INIT;
 // static void           indexInit();
-static int idxTermSearch(SIndex* sIdx, SIndexTermQuery* term, SArray** result);
+static int idxTermSearch(SIndex* sIdx, SIndexTermQuery* term, SRoaring** result);
 
 static void idxInterRsltDestroy(SArray* results);
-static int  idxMergeFinalResults(SArray* in, EIndexOperatorType oType, SArray* out);
+static int  idxMergeFinalResults(SArray* in, EIndexOperatorType oType, SRoaring* out);
 
 static int idxGenTFile(SIndex* index, IndexCache* cache, SArray* batch);
 
@@ -235,11 +235,16 @@ int indexSearch(SIndex* index, SIndexMultiTermQuery* multiQuerys, SArray* result
   int     nQuery = taosArrayGetSize(multiQuerys->query);
   for (size_t i = 0; i < nQuery; i++) {
     SIndexTermQuery* qterm = taosArrayGet(multiQuerys->query, i);
-    SArray*          trslt = NULL;
+    SRoaring*        trslt = NULL;
     idxTermSearch(index, qterm, &trslt);
     taosArrayPush(iRslts, (void*)&trslt);
   }
-  idxMergeFinalResults(iRslts, opera, result);
+
+  SRoaring* fRslt = tRoaringCreate();
+  if (fRslt != NULL && idxMergeFinalResults(iRslts, opera, fRslt) == 0) {
+    tRoaringToArray(fRslt, result);
+  }
+  tRoaringDestroy(fRslt);
   idxInterRsltDestroy(iRslts);
   return 0;
 }
@@ -381,7 +386,7 @@ bool indexJsonIsRebuild(SIndexJson* idx) {
   return ((SIdxStatus)atomic_load_8(&idx->status)) == kRebuild ? true : false;
 }
 
-static int idxTermSearch(SIndex* sIdx, SIndexTermQuery* query, SArray** result) {
+static int idxTermSearch(SIndex* sIdx, SIndexTermQuery* query, SRoaring** result) {
   SIndexTerm* term = query->term;
   const char* colName = term->colName;
   int32_t     nColName = term->nColName;
@@ -400,7 +405,7 @@ static int idxTermSearch(SIndex* sIdx, SIndexTermQuery* query, SArray** result)
   cache = (pCache == NULL) ? NULL : *pCache;
   taosThreadMutexUnlock(&sIdx->mtx);
 
-  *result = taosArrayInit(4, sizeof(uint64_t));
+  *result = tRoaringCreate();
   // TODO: iterator mem and tidex
   STermValueType s = kTypeValue;
 
@@ -411,6 +416,7 @@ static int idxTermSearch(SIndex* sIdx, SIndexTermQuery* query, SArray** result)
     if (s == kTypeDeletion) {
       indexInfo("col: %s already drop by", term->colName);
       // coloum already drop by other oper, no need to query tindex
+      idxTRsltDestroy(tr);
       return 0;
     } else {
       st = taosGetTimestampUs();
@@ -428,7 +434,9 @@ static int idxTermSearch(SIndex* sIdx, SIndexTermQuery* query, SArray** result)
   int64_t cost = taosGetTimestampUs() - st;
   indexInfo("search cost: %" PRIu64 "us", cost);
 
-  idxTRsltMergeTo(tr, *result);
+  if (*result == NULL || idxTRsltMergeToBitmap(tr, *result) != 0) {
+    goto END;
+  }
 
   idxTRsltDestroy(tr);
   return 0;
@@ -443,30 +451,40 @@ static void idxInterRsltDestroy(SArray* results) {
 
   size_t sz = taosArrayGetSize(results);
   for (size_t i = 0; i < sz; i++) {
-    SArray* p = taosArrayGetP(results, i);
-    taosArrayDestroy(p);
+    SRoaring* p = taosArrayGetP(results, i);
+    tRoaringDestroy(p);
   }
   taosArrayDestroy(results);
 }
 
-static int idxMergeFinalResults(SArray* in, EIndexOperatorType oType, SArray* out) {
-  // refactor, merge interResults into fResults by oType
-  for (int i = 0; i < taosArrayGetSize(in); i--) {
-    SArray* t = taosArrayGetP(in, i);
-    taosArraySort(t, uidCompare);
-    taosArrayRemoveDuplicate(t, uidCompare, NULL);
+static int idxMergeFinalResults(SArray* in, EIndexOperatorType oType, SRoaring* out) {
+  // merge interResults into fResults by oType
+  int32_t sz = taosArrayGetSize(in);
+  if (sz <= 0) {
+    return 0;
+  }
+  for (int i = 0; i < sz; i++) {
+    if (taosArrayGetP(in, i) == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
   }
 
+  int32_t code = 0;
   if (oType == MUST) {
-    iIntersection(in, out);
+    code = tRoaringOr(out, taosArrayGetP(in, 0));
+    for (int i = 1; i < sz && code == 0; i++) {
+      code = tRoaringAnd(out, taosArrayGetP(in, i));
+    }
   } else if (oType == SHOULD) {
-    iUnion(in, out);
+    for (int i = 0; i < sz && code == 0; i++) {
+      code = tRoaringOr(out, taosArrayGetP(in, i));
+    }
   } else if (oType == NOT) {
     // just one column index, enhance later
     // taosArrayAddAll(fResults, interResults);
     // not use currently
   }
-  return 0;
+  return code;
 }
 
 static void idxMayMergeTempToFinalRslt(SArray* result, TFileValue* tfv, SIdxTRslt* tr) {
@@ -504,7 +522,7 @@ static void idxMergeCacheAndTFile(SArray* result, IterateValue* cv, IterateValue
     }
   }
   if (tv != NULL) {
-    taosArrayAddAll(tr->total, tv->val);
+    tRoaringAddArray(tr->total, tv->val);
   }
 }
 static void idxDestroyFinalRslt(SArray* result) {
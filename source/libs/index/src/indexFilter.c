@@ -68,7 +68,7 @@ typedef union {
 typedef struct SIFParam {
   SHashObj *pFilter;
 
-  SArray *result;
+  SRoaring *result;
   char   *condValue;
 
   SIdxFltStatus status;
@@ -115,7 +115,8 @@ static sif_func_t sifNullFunc = NULL;
 static FORCE_INLINE void sifFreeParam(SIFParam *param) {
   if (param == NULL) return;
 
-  taosArrayDestroy(param->result);
+  tRoaringDestroy(param->result);
+  param->result = NULL;
   taosMemoryFree(param->condValue);
   param->condValue = NULL;
   taosHashCleanup(param->pFilter);
@@ -467,7 +468,17 @@ static int32_t sifDoIndex(SIFParam *left, SIFParam *right, int8_t operType, SIFP
 
     SIndexMultiTermQuery *mtm = indexMultiTermQueryCreate(MUST);
     indexMultiTermQueryAdd(mtm, tm, qtype);
-    ret = indexJsonSearch(arg->ivtIdx, mtm, output->result);
+
+    SArray *uids = taosArrayInit(8, sizeof(uint64_t));
+    if (uids == NULL) {
+      indexMultiTermQueryDestroy(mtm);
+      return TSDB_CODE_QRY_OUT_OF_MEMORY;
+    }
+    ret = indexJsonSearch(arg->ivtIdx, mtm, uids);
+    if (ret == 0) {
+      ret = tRoaringAddArray(output->result, uids);
+    }
+    taosArrayDestroy(uids);
   } else {
     bool       reverse;
     FilterFunc filterFunc = sifGetFilterFunc(qtype, &reverse);
@@ -492,7 +503,7 @@ static int32_t sifDoIndex(SIFParam *left, SIFParam *right, int8_t operType, SIFP
     } else {
       sifSetFltParam(left, right, &typedata, &param);
     }
-    ret = metaFilterTableIds(arg->metaEx, &param, output->result);
+    ret = metaFilterTableBitmap(arg->metaEx, &param, output->result);
   }
   return ret;
 }
@@ -687,19 +698,17 @@ static int32_t sifExecLogic(SLogicConditionNode *node, SIFCtx *ctx, SIFParam *ou
   if (ctx->noExec == false) {
     for (int32_t m = 0; m < node->pParameterList->length; m++) {
       if (node->condType == LOGIC_COND_TYPE_AND) {
-        taosArrayAddAll(output->result, params[m].result);
+        SIF_ERR_JRET(tRoaringOr(output->result, params[m].result));
       } else if (node->condType == LOGIC_COND_TYPE_OR) {
-        taosArrayAddAll(output->result, params[m].result);
+        SIF_ERR_JRET(tRoaringOr(output->result, params[m].result));
       } else if (node->condType == LOGIC_COND_TYPE_NOT) {
-        // taosArrayAddAll(output->result, params[m].result);
+        // tRoaringOr(output->result, params[m].result);
       }
-      taosArraySort(output->result, idxUidCompare);
-      taosArrayRemoveDuplicate(output->result, idxUidCompare, NULL);
     }
   } else {
     for (int32_t m = 0; m < node->pParameterList->length; m++) {
       output->status = sifMergeCond(node->condType, output->status, params[m].status);
-      taosArrayDestroy(params[m].result);
+      tRoaringDestroy(params[m].result);
       params[m].result = NULL;
     }
   }
@@ -710,9 +719,13 @@ _return:
 
 static EDealRes sifWalkFunction(SNode *pNode, void *context) {
   SFunctionNode *node = (SFunctionNode *)pNode;
-  SIFParam       output = {.result = taosArrayInit(8, sizeof(uint64_t))};
+  SIFParam       output = {.result = tRoaringCreate()};
 
   SIFCtx *ctx = context;
+  if (output.result == NULL) {
+    ctx->code = TSDB_CODE_QRY_OUT_OF_MEMORY;
+    return DEAL_RES_ERROR;
+  }
   ctx->code = sifExecFunction(node, ctx, &output);
   if (ctx->code != TSDB_CODE_SUCCESS) {
     sifFreeParam(&output);
@@ -728,9 +741,13 @@ static EDealRes sifWalkFunction(SNode *pNode, void *context) {
 static EDealRes sifWalkLogic(SNode *pNode, void *context) {
   SLogicConditionNode *node = (SLogicConditionNode *)pNode;
 
-  SIFParam output = {.result = taosArrayInit(8, sizeof(uint64_t))};
+  SIFParam output = {.result = tRoaringCreate()};
 
   SIFCtx *ctx = context;
+  if (output.result == NULL) {
+    ctx->code = TSDB_CODE_QRY_OUT_OF_MEMORY;
+    return DEAL_RES_ERROR;
+  }
   ctx->code = sifExecLogic(node, ctx, &output);
   if (ctx->code) {
     sifFreeParam(&output);
@@ -745,9 +762,13 @@ static EDealRes sifWalkLogic(SNode *pNode, void *context) {
 }
 static EDealRes sifWalkOper(SNode *pNode, void *context) {
   SOperatorNode *node = (SOperatorNode *)pNode;
-  SIFParam       output = {.result = taosArrayInit(8, sizeof(uint64_t)), .status = SFLT_COARSE_INDEX};
+  SIFParam       output = {.result = tRoaringCreate(), .status = SFLT_COARSE_INDEX};
 
   SIFCtx *ctx = context;
+  if (output.result == NULL) {
+    ctx->code = TSDB_CODE_QRY_OUT_OF_MEMORY;
+    return DEAL_RES_ERROR;
+  }
   ctx->code = sifExecOper(node, ctx, &output);
   if (ctx->code) {
     sifFreeParam(&output);
@@ -822,7 +843,7 @@ static int32_t sifCalculate(SNode *pNode, SIFParam *pDst) {
       SIF_ERR_RET(TSDB_CODE_QRY_APP_ERROR);
     }
     if (res->result != NULL) {
-      taosArrayAddAll(pDst->result, res->result);
+      code = tRoaringOr(pDst->result, res->result);
     }
 
     sifFreeParam(res);
@@ -873,16 +894,20 @@ int32_t doFilterTag(SNode *pFilterNode, SIndexMetaArg *metaArg, SArray *result,
 
   SFilterInfo *filter = NULL;
 
-  SArray  *output = taosArrayInit(8, sizeof(uint64_t));
+  SRoaring *output = tRoaringCreate();
+  if (output == NULL) {
+    return TSDB_CODE_QRY_OUT_OF_MEMORY;
+  }
   SIFParam param = {.arg = *metaArg, .result = output};
   int32_t  code = sifCalculate((SNode *)pFilterNode, &param);
+  if (code == 0) {
+    code = tRoaringToArray(param.result, result);
+  }
+  sifFreeParam(&param);
   if (code != 0) {
-    sifFreeParam(&param);
     return code;
   }
 
-  taosArrayAddAll(result, param.result);
-  sifFreeParam(&param);
   *status = st;
   return TSDB_CODE_SUCCESS;
 }
@@ -32,11 +32,12 @@ typedef struct TFileFstIter {
   TFileReader* rdr;
 } TFileFstIter;
 
-#define TF_TABLE_TATOAL_SIZE(sz) (sizeof(sz) + sz * sizeof(uint64_t))
+// posting list is [int32_t -len][roaring(len)], a positive head means the legacy [int32_t n][uint64_t * n]
+#define TF_TABLE_TATOAL_SIZE(sz) (sizeof(int32_t) + (sz))
 
 static int  tfileStrCompare(const void* a, const void* b);
 static int  tfileValueCompare(const void* a, const void* b, const void* param);
-static void tfileSerialTableIdsToBuf(char* buf, SArray* tableIds);
+static void tfileSerialTableIdsToBuf(char* buf, SRoaring* tableIds, int32_t len);
 
 static int tfileWriteHeader(TFileWriter* writer);
 static int tfileWriteFstOffset(TFileWriter* tw, int32_t offset);
@@ -47,7 +48,7 @@ static int tfileWriteFooter(TFileWriter* write);
 static int tfileReaderLoadHeader(TFileReader* reader);
 static int tfileReaderLoadFst(TFileReader* reader);
 static int tfileReaderVerify(TFileReader* reader);
-static int tfileReaderLoadTableIds(TFileReader* reader, int32_t offset, SArray* result);
+static int tfileReaderLoadTableIds(TFileReader* reader, int32_t offset, SRoaring* result);
 
 static SArray* tfileGetFileList(const char* path);
 static int     tfileRmExpireFile(SArray* result);
@@ -377,7 +378,7 @@ static int32_t tfSearchTerm_JSON(void* reader, SIndexTerm* tem, SIdxTRslt* tr) {
     cost = taosGetTimestampUs() - et;
     indexInfo("index: %" PRIu64 ", col: %s, colVal: %s, load all table info, offset: %" PRIu64
               ", size: %d, time cost: %" PRIu64 "us",
-              tem->suid, tem->colName, tem->colVal, offset, (int)taosArrayGetSize(tr->total), cost);
+              tem->suid, tem->colName, tem->colVal, offset, (int)tRoaringCardinality(tr->total), cost);
   }
   fstSliceDestroy(&key);
   return 0;
@@ -549,38 +550,53 @@ int tfileWriterPut(TFileWriter* tw, void* data, bool order) {
   int32_t sz = taosArrayGetSize((SArray*)data);
   int32_t fstOffset = tw->offset;
 
+  SArray* bms = taosArrayInit(sz, POINTER_BYTES);
+  if (bms == NULL) {
+    return -1;
+  }
   // ugly code, refactor later
   for (size_t i = 0; i < sz; i++) {
     TFileValue* v = taosArrayGetP((SArray*)data, i);
-    taosArraySort(v->tableId, idxUidCompare);
-    taosArrayRemoveDuplicate(v->tableId, idxUidCompare, NULL);
-    int32_t tbsz = taosArrayGetSize(v->tableId);
-    fstOffset += TF_TABLE_TATOAL_SIZE(tbsz);
+    SRoaring*   bm = tRoaringCreate();
+    if (bm == NULL || tRoaringAddArray(bm, v->tableId) != 0) {
+      tRoaringDestroy(bm);
+      goto _err;
+    }
+    taosArrayPush(bms, &bm);
+    fstOffset += TF_TABLE_TATOAL_SIZE(tRoaringSerialSize(bm));
   }
   tfileWriteFstOffset(tw, fstOffset);
 
   int32_t cap = 4 * 1024;
   char*   buf = taosMemoryCalloc(1, cap);
+  if (buf == NULL) {
+    goto _err;
+  }
 
   for (size_t i = 0; i < sz; i++) {
     TFileValue* v = taosArrayGetP((SArray*)data, i);
+    SRoaring*   bm = taosArrayGetP(bms, i);
 
-    int32_t tbsz = taosArrayGetSize(v->tableId);
+    int32_t len = tRoaringSerialSize(bm);
     // check buf has enough space or not
-    int32_t ttsz = TF_TABLE_TATOAL_SIZE(tbsz);
+    int32_t ttsz = TF_TABLE_TATOAL_SIZE(len);
 
     if (cap < ttsz) {
+      char* tbuf = (char*)taosMemoryRealloc(buf, ttsz);
+      if (tbuf == NULL) {
+        taosMemoryFree(buf);
+        goto _err;
+      }
       cap = ttsz;
-      buf = (char*)taosMemoryRealloc(buf, cap);
+      buf = tbuf;
     }
-    char* p = buf;
-    tfileSerialTableIdsToBuf(p, v->tableId);
+    tfileSerialTableIdsToBuf(buf, bm, len);
     tw->ctx->write(tw->ctx, buf, ttsz);
     v->offset = tw->offset;
     tw->offset += ttsz;
-    memset(buf, 0, cap);
   }
   taosMemoryFree(buf);
+  taosArrayDestroyP(bms, (FDelete)tRoaringDestroy);
 
   tw->fb = fstBuilderCreate(tw->ctx, 0);
   if (tw->fb == NULL) {
@@ -603,6 +619,9 @@ int tfileWriterPut(TFileWriter* tw, void* data, bool order) {
   fstBuilderDestroy(tw->fb);
   tfileWriteFooter(tw);
   return 0;
+_err:
+  taosArrayDestroyP(bms, (FDelete)tRoaringDestroy);
+  return -1;
 }
 void tfileWriterClose(TFileWriter* tw) {
   if (tw == NULL) {
@@ -693,9 +712,13 @@ static bool tfileIteratorNext(Iterate* iiter) {
   offset = (uint64_t)(rt->out.out);
   swsResultDestroy(rt);
   // set up iterate value
-  if (tfileReaderLoadTableIds(tIter->rdr, offset, iv->val) != 0) {
+  SRoaring* bm = tRoaringCreate();
+  if (bm == NULL || tfileReaderLoadTableIds(tIter->rdr, offset, bm) != 0 || tRoaringToArray(bm, iv->val) != 0) {
+    tRoaringDestroy(bm);
+    taosMemoryFree(colVal);
     return false;
   }
+  tRoaringDestroy(bm);
 
   iv->ver = 0;
   iv->type = ADD_VALUE;  // value in tfile always ADD_VALUE
@@ -803,13 +826,10 @@ void tfileValueDestroy(TFileValue* tf) {
   taosMemoryFree(tf->colVal);
   taosMemoryFree(tf);
 }
-static void tfileSerialTableIdsToBuf(char* buf, SArray* ids) {
-  int sz = taosArrayGetSize(ids);
-  SERIALIZE_VAR_TO_BUF(buf, sz, int32_t);
-  for (size_t i = 0; i < sz; i++) {
-    uint64_t* v = taosArrayGet(ids, i);
-    SERIALIZE_VAR_TO_BUF(buf, *v, uint64_t);
-  }
+static void tfileSerialTableIdsToBuf(char* buf, SRoaring* ids, int32_t len) {
+  int32_t head = -len;
+  SERIALIZE_VAR_TO_BUF(buf, head, int32_t);
+  tRoaringSerialize(ids, buf);
 }
 
 static int tfileWriteFstOffset(TFileWriter* tw, int32_t offset) {
@@ -905,8 +925,7 @@ static int tfileReaderLoadFst(TFileReader* reader) {
 
   return reader->fst != NULL ? 0 : -1;
 }
-static int tfileReaderLoadTableIds(TFileReader* reader, int32_t offset, SArray* result) {
-  // TODO(yihao): opt later
+static int tfileReaderLoadTableIds(TFileReader* reader, int32_t offset, SRoaring* result) {
   IFileCtx* ctx = reader->ctx;
   // add block cache
   char    block[4096] = {0};
@@ -917,10 +936,29 @@ static int tfileReaderLoadTableIds(TFileReader* reader, int32_t offset, SArray*
   int32_t nid = *(int32_t*)p;
   p += sizeof(nid);
 
+  if (nid < 0) {
+    // roaring posting list
+    int32_t len = -nid;
+    if (len <= nread - (int32_t)sizeof(nid)) {
+      return tRoaringDeserializeOr(result, p, len);
+    }
+    char* buf = taosMemoryMalloc(len);
+    if (buf == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+    int32_t code = TSDB_CODE_FILE_CORRUPTED;
+    if (ctx->readFrom(ctx, buf, len, offset + sizeof(nid)) == len) {
+      code = tRoaringDeserializeOr(result, buf, len);
+    }
+    taosMemoryFree(buf);
+    return code;
+  }
+
+  // legacy posting list
   while (nid > 0) {
     int32_t left = block + sizeof(block) - p;
     if (left >= sizeof(uint64_t)) {
-      taosArrayPush(result, (uint64_t*)p);
+      tRoaringAdd(result, *(uint64_t*)p);
       p += sizeof(uint64_t);
     } else {
       char buf[sizeof(uint64_t)] = {0};
@@ -931,7 +969,7 @@ static int tfileReaderLoadTableIds(TFileReader* reader, int32_t offset, SArray*
       nread = ctx->readFrom(ctx, block, sizeof(block), offset);
       memcpy(buf + left, block, sizeof(uint64_t) - left);
 
-      taosArrayPush(result, (uint64_t*)buf);
+      tRoaringAdd(result, *(uint64_t*)buf);
       p = block + sizeof(uint64_t) - left;
     }
     nid -= 1;
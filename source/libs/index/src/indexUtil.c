@@ -161,7 +161,7 @@ int verdataCompare(const void *a, const void *b) {
 SIdxTRslt *idxTRsltCreate() {
   SIdxTRslt *tr = taosMemoryCalloc(1, sizeof(SIdxTRslt));
 
-  tr->total = taosArrayInit(4, sizeof(uint64_t));
+  tr->total = tRoaringCreate();
   tr->add = taosArrayInit(4, sizeof(uint64_t));
   tr->del = taosArrayInit(4, sizeof(uint64_t));
   return tr;
@@ -170,7 +170,7 @@ void idxTRsltClear(SIdxTRslt *tr) {
   if (tr == NULL) {
     return;
   }
-  taosArrayClear(tr->total);
+  tRoaringClear(tr->total);
   taosArrayClear(tr->add);
   taosArrayClear(tr->del);
 }
@@ -178,25 +178,36 @@ void idxTRsltDestroy(SIdxTRslt *tr) {
   if (tr == NULL) {
     return;
   }
-  taosArrayDestroy(tr->total);
+  tRoaringDestroy(tr->total);
   taosArrayDestroy(tr->add);
   taosArrayDestroy(tr->del);
   taosMemoryFree(tr);
 }
+int32_t idxTRsltMergeToBitmap(SIdxTRslt *tr, SRoaring *out) {
+  int32_t code = tRoaringOr(out, tr->total);
+  if (code == 0) {
+    code = tRoaringAddArray(out, tr->add);
+  }
+  if (code == 0 && taosArrayGetSize(tr->del) > 0) {
+    SRoaring *del = tRoaringCreate();
+    if (del == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+    code = tRoaringAddArray(del, tr->del);
+    if (code == 0) {
+      code = tRoaringAndNot(out, del);
+    }
+    tRoaringDestroy(del);
+  }
+  return code;
+}
 void idxTRsltMergeTo(SIdxTRslt *tr, SArray *result) {
-  taosArraySort(tr->total, uidCompare);
-  taosArraySort(tr->add, uidCompare);
-  taosArraySort(tr->del, uidCompare);
-
-  if (taosArrayGetSize(tr->total) == 0 || taosArrayGetSize(tr->add) == 0) {
-    SArray *t = taosArrayGetSize(tr->total) == 0 ? tr->add : tr->total;
-    taosArrayAddAll(result, t);
-  } else {
-    SArray *arrs = taosArrayInit(2, sizeof(void *));
-    taosArrayPush(arrs, &tr->total);
-    taosArrayPush(arrs, &tr->add);
-    iUnion(arrs, result);
-    taosArrayDestroy(arrs);
-  }
-  iExcept(result, tr->del);
+  SRoaring *out = tRoaringCreate();
+  if (out == NULL) {
+    return;
+  }
+  if (idxTRsltMergeToBitmap(tr, out) == 0) {
+    tRoaringToArray(out, result);
+  }
+  tRoaringDestroy(out);
 }
@@ -20,6 +20,7 @@
 #include "parUtil.h"
 #include "query.h"
 #include "tglobal.h"
+#include "tsched.h"
 #include "ttime.h"
 #include "ttypes.h"
 
@@ -1349,44 +1350,270 @@ static int32_t parseValuesClause(SInsertParseContext* pCxt, STableDataBlocks* da
   return TSDB_CODE_SUCCESS;
 }
 
-static int32_t parseCsvFile(SInsertParseContext* pCxt, TdFilePtr fp, STableDataBlocks* pDataBlock, int maxRows,
-                            int32_t* numOfRows) {
-  STableComInfo tinfo = getTableInfo(pDataBlock->pTableMeta);
-  int32_t       extendedRowSize = getExtendedRowSize(pDataBlock);
+// csv files are read by segments, each segment is split on line boundaries into chunks parsed by several threads
+#define CSV_SEGMENT_SIZE      (16 * 1024 * 1024)
+#define CSV_MIN_CHUNK_SIZE    (256 * 1024)
+#define CSV_MAX_PARSE_THREADS 8
+#define CSV_PARSE_QUEUE_SIZE  1024
+
+// the workers are shared by all the csv files parsed in the process, the caller parses one chunk of each segment
+static TdThreadOnce csvParsePoolInit = PTHREAD_ONCE_INIT;
+static void*        csvParseQHandle = NULL;
+
+static void doInitCsvParsePool() {
+  int32_t numOfThreads = TMAX(TMIN(CSV_MAX_PARSE_THREADS, (int32_t)tsNumOfCores) - 1, 1);
+  csvParseQHandle = taosInitScheduler(CSV_PARSE_QUEUE_SIZE, numOfThreads, "csv-parse", NULL);
+  if (NULL == csvParseQHandle) {
+    parserWarn("failed to init csv parse pool, csv files are parsed by the caller thread");
+  }
+}
+
+void parCleanupCsvParsePool() {
+  void* p = csvParseQHandle;
+  if (p != NULL && atomic_val_compare_exchange_ptr(&csvParseQHandle, p, NULL) == p) {
+    taosCleanUpScheduler(p);
+    taosMemoryFree(p);
+  }
+}
+
+typedef struct SCsvChunk {
+  SInsertParseContext* pCxt;   // private copy of the parse context
+  STableDataBlocks     block;  // private row buffer, shares table meta and bound columns with the target block
+  char*                pStart;
+  char*                pEnd;
+  int32_t              numOfRows;
+  TSKEY                firstTs;
+  int32_t              code;
+  tsem_t*              pDone;  // posted when a chunk parsed by the pool is done
+} SCsvChunk;
+
+static int32_t parseCsvLines(SCsvChunk* pChunk) {
+  SInsertParseContext* pCxt = pChunk->pCxt;
+  STableDataBlocks*    pDataBlock = &pChunk->block;
+  STableComInfo        tinfo = getTableInfo(pDataBlock->pTableMeta);
+  int32_t              extendedRowSize = getExtendedRowSize(pDataBlock);
+  int32_t              maxRows = 0;
   CHECK_CODE(initRowBuilder(&pDataBlock->rowBuilder, pDataBlock->pTableMeta->sversion, &pDataBlock->boundColumnInfo));
 
-  (*numOfRows) = 0;
-  char    tmpTokenBuf[TSDB_MAX_BYTES_PER_ROW] = {0};  // used for deleting Escape character: \\, \', \"
-  char*   pLine = NULL;
-  int64_t readLen = 0;
-  while ((readLen = taosGetLineFile(fp, &pLine)) != -1) {
-    if (('\r' == pLine[readLen - 1]) || ('\n' == pLine[readLen - 1])) {
-      pLine[--readLen] = '\0';
-    }
+  char* pLine = pChunk->pStart;
+  while (pLine < pChunk->pEnd) {
+    char* pNext = memchr(pLine, '\n', pChunk->pEnd - pLine);
+    char* pLineEnd = (NULL == pNext) ? pChunk->pEnd : pNext;
+    pNext = (NULL == pNext) ? pChunk->pEnd : pNext + 1;
 
-    if (readLen == 0) {
+    if (pLineEnd > pLine && '\r' == *(pLineEnd - 1)) {
+      --pLineEnd;
+    }
+    *pLineEnd = '\0';
+    if (pLineEnd == pLine) {
+      pLine = pNext;
       continue;
     }
 
-    if ((*numOfRows) >= maxRows || pDataBlock->size + extendedRowSize >= pDataBlock->nAllocSize) {
-      int32_t tSize;
-      CHECK_CODE(allocateMemIfNeed(pDataBlock, extendedRowSize, &tSize));
-      ASSERT(tSize >= maxRows);
-      maxRows = tSize;
+    if (pChunk->numOfRows >= maxRows || pDataBlock->size + extendedRowSize >= pDataBlock->nAllocSize) {
+      CHECK_CODE(allocateMemIfNeed(pDataBlock, extendedRowSize, &maxRows));
     }
 
     strtolower(pLine, pLine);
-    char* pRawSql = pCxt->pSql;
     pCxt->pSql = pLine;
     bool gotRow = false;
-    CHECK_CODE(parseOneRow(pCxt, pDataBlock, tinfo.precision, &gotRow, tmpTokenBuf));
+    CHECK_CODE(parseOneRow(pCxt, pDataBlock, tinfo.precision, &gotRow, pCxt->tmpTokenBuf));
     if (gotRow) {
+      if (0 == pChunk->numOfRows) {
+        pChunk->firstTs = TD_ROW_KEY((STSRow*)(pDataBlock->pData + pDataBlock->size));
+      }
       pDataBlock->size += extendedRowSize;  // len;
-      (*numOfRows)++;
+      pChunk->numOfRows++;
     }
-    pCxt->pSql = pRawSql;
+    pLine = pNext;
+  }
+  return TSDB_CODE_SUCCESS;
+}
+
+static void parseCsvLinesTask(SSchedMsg* pSchedMsg) {
+  SCsvChunk* pChunk = pSchedMsg->ahandle;
+  pChunk->code = parseCsvLines(pChunk);
+  tsem_post(pChunk->pDone);
+}
+
+static int32_t initCsvChunk(SInsertParseContext* pCxt, STableDataBlocks* pDataBlock, SCsvChunk* pChunk) {
+  pChunk->pCxt = taosMemoryMalloc(sizeof(SInsertParseContext));
+  char* pMsg = taosMemoryCalloc(1, pCxt->msg.len + 1);
+  char* pData = taosMemoryCalloc(1, TSDB_PAYLOAD_SIZE);
+  if (NULL == pChunk->pCxt || NULL == pMsg || NULL == pData) {
+    taosMemoryFreeClear(pChunk->pCxt);
+    taosMemoryFree(pMsg);
+    taosMemoryFree(pData);
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+  memcpy(pChunk->pCxt, pCxt, sizeof(SInsertParseContext));
+  pChunk->pCxt->msg.buf = pMsg;
+
+  pChunk->block = *pDataBlock;
+  pChunk->block.pData = pData;
+  pChunk->block.nAllocSize = TSDB_PAYLOAD_SIZE;
+  pChunk->block.headerSize = 0;
+  pChunk->block.size = 0;
+  pChunk->block.ordered = true;
+  pChunk->block.prevTS = INT64_MIN;
+  return TSDB_CODE_SUCCESS;
+}
+
+static void destroyCsvChunk(SCsvChunk* pChunk) {
+  if (NULL != pChunk->pCxt) {
+    taosMemoryFree(pChunk->pCxt->msg.buf);
+    taosMemoryFreeClear(pChunk->pCxt);
+  }
+  taosMemoryFreeClear(pChunk->block.pData);
+}
+
+// append the rows of chunk to the target block, the chunks must be merged in file order
+static int32_t mergeCsvChunk(STableDataBlocks* pDataBlock, SCsvChunk* pChunk, int32_t* numOfRows) {
+  if (0 == pChunk->numOfRows) {
+    return TSDB_CODE_SUCCESS;
   }
 
+  uint32_t len = pChunk->block.size;
+  if (pDataBlock->nAllocSize - pDataBlock->size < len) {
+    uint32_t nAllocSize = TMAX(pDataBlock->nAllocSize * 1.5, pDataBlock->size + len);
+    char*    tmp = taosMemoryRealloc(pDataBlock->pData, nAllocSize);
+    if (NULL == tmp) {
+      return TSDB_CODE_TSC_OUT_OF_MEMORY;
+    }
+    pDataBlock->pData = tmp;
+    pDataBlock->nAllocSize = nAllocSize;
+  }
+  memcpy(pDataBlock->pData + pDataBlock->size, pChunk->block.pData, len);
+  pDataBlock->size += len;
+
+  if (pDataBlock->ordered) {
+    if (!pChunk->block.ordered || pChunk->firstTs <= pDataBlock->prevTS) {
+      pDataBlock->ordered = false;
+    } else {
+      pDataBlock->prevTS = pChunk->block.prevTS;
+    }
+  }
+  (*numOfRows) += pChunk->numOfRows;
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t parseCsvSegment(SInsertParseContext* pCxt, STableDataBlocks* pDataBlock, char* pStart, char* pEnd,
+                               int32_t* numOfRows) {
+  int32_t maxThreads = TMIN(CSV_MAX_PARSE_THREADS, TMAX((int32_t)tsNumOfCores, 1));
+  int32_t numOfChunks = TMIN(maxThreads, TMAX((pEnd - pStart) / CSV_MIN_CHUNK_SIZE, 1));
+
+  SCsvChunk chunks[CSV_MAX_PARSE_THREADS] = {0};
+  int32_t   code = TSDB_CODE_SUCCESS;
+  char*     p = pStart;
+  int32_t   n = 0;
+  for (; n < numOfChunks && p < pEnd; ++n) {
+    char* pChunkEnd = pEnd;
+    if (n < numOfChunks - 1) {
+      pChunkEnd = p + (pEnd - p) / (numOfChunks - n);
+      char* pNewLine = memchr(pChunkEnd, '\n', pEnd - pChunkEnd);
+      pChunkEnd = (NULL == pNewLine) ? pEnd : pNewLine + 1;
+    }
+    chunks[n].pStart = p;
+    chunks[n].pEnd = pChunkEnd;
+    p = pChunkEnd;
+
+    code = initCsvChunk(pCxt, pDataBlock, &chunks[n]);
+    if (TSDB_CODE_SUCCESS != code) {
+      break;
+    }
+  }
+
+  if (TSDB_CODE_SUCCESS == code && n > 1) {
+    taosThreadOnce(&csvParsePoolInit, doInitCsvParsePool);
+  }
+
+  if (TSDB_CODE_SUCCESS == code) {
+    tsem_t  done;
+    int32_t numOfScheduled = 0;
+    tsem_init(&done, 0, 0);
+    for (int32_t i = 1; i < n; ++i) {
+      chunks[i].pDone = &done;
+      SSchedMsg schedMsg = {.fp = parseCsvLinesTask, .ahandle = &chunks[i]};
+      if (NULL != csvParseQHandle && 0 == taosScheduleTask(csvParseQHandle, &schedMsg)) {
+        ++numOfScheduled;
+      } else {
+        chunks[i].code = parseCsvLines(&chunks[i]);
+      }
+    }
+    chunks[0].code = parseCsvLines(&chunks[0]);
+    for (int32_t i = 0; i < numOfScheduled; ++i) {
+      tsem_wait(&done);
+    }
+    tsem_destroy(&done);
+  }
+
+  for (int32_t i = 0; i < n; ++i) {
+    if (TSDB_CODE_SUCCESS == code) {
+      code = chunks[i].code;
+      if (TSDB_CODE_SUCCESS != code) {
+        tstrncpy(pCxt->msg.buf, chunks[i].pCxt->msg.buf, pCxt->msg.len);
+      } else {
+        code = mergeCsvChunk(pDataBlock, &chunks[i], numOfRows);
+      }
+    }
+    destroyCsvChunk(&chunks[i]);
+  }
+  return code;
+}
+
+static int32_t parseCsvFile(SInsertParseContext* pCxt, TdFilePtr fp, STableDataBlocks* pDataBlock,
+                            int32_t* numOfRows) {
+  (*numOfRows) = 0;
+  int64_t cap = CSV_SEGMENT_SIZE;
+  char*   pBuf = taosMemoryMalloc(cap + 1);
+  if (NULL == pBuf) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  int32_t code = TSDB_CODE_SUCCESS;
+  int64_t len = 0;
+  while (TSDB_CODE_SUCCESS == code) {
+    if (len == cap) {
+      // a single line is longer than the buffer
+      char* tmp = taosMemoryRealloc(pBuf, cap * 2 + 1);
+      if (NULL == tmp) {
+        code = TSDB_CODE_OUT_OF_MEMORY;
+        break;
+      }
+      pBuf = tmp;
+      cap *= 2;
+    }
+
+    int64_t readLen = taosReadFile(fp, pBuf + len, cap - len);
+    if (readLen < 0) {
+      code = TAOS_SYSTEM_ERROR(errno);
+      break;
+    }
+    len += readLen;
+    bool eof = (0 == readLen);
+
+    // only the complete lines are parsed, the tail is kept for the next round
+    char* pEnd = pBuf + len;
+    if (!eof) {
+      while (pEnd > pBuf && '\n' != *(pEnd - 1)) {
+        --pEnd;
+      }
+      if (pEnd == pBuf) {
+        continue;
+      }
+    }
+    if (pEnd > pBuf) {
+      code = parseCsvSegment(pCxt, pDataBlock, pBuf, pEnd, numOfRows);
+    }
+    if (eof) {
+      break;
+    }
+    len = pBuf + len - pEnd;
+    memmove(pBuf, pEnd, len);
+  }
+  taosMemoryFree(pBuf);
+  CHECK_CODE(code);
+
   if (0 == (*numOfRows) && (!TSDB_QUERY_HAS_TYPE(pCxt->pOutput->insertType, TSDB_QUERY_TYPE_STMT_INSERT))) {
     return buildSyntaxErrMsg(&pCxt->msg, "no any data points", NULL);
   }
@@ -1400,16 +1627,15 @@ static int32_t parseDataFromFile(SInsertParseContext* pCxt, SToken filePath, STa
   } else {
     strncpy(filePathStr, filePath.z, filePath.n);
   }
-  TdFilePtr fp = taosOpenFile(filePathStr, TD_FILE_READ | TD_FILE_STREAM);
+  TdFilePtr fp = taosOpenFile(filePathStr, TD_FILE_READ);
   if (NULL == fp) {
     return TAOS_SYSTEM_ERROR(errno);
   }
 
-  int32_t maxNumOfRows;
-  CHECK_CODE(allocateMemIfNeed(dataBuf, getExtendedRowSize(dataBuf), &maxNumOfRows));
-
   int32_t numOfRows = 0;
-  CHECK_CODE(parseCsvFile(pCxt, fp, dataBuf, maxNumOfRows, &numOfRows));
+  int32_t code = parseCsvFile(pCxt, fp, dataBuf, &numOfRows);
+  taosCloseFile(&fp);
+  CHECK_CODE(code);
 
   SSubmitBlk* pBlocks = (SSubmitBlk*)(dataBuf->pData);
   if (TSDB_CODE_SUCCESS != setBlockInfo(pBlocks, dataBuf, numOfRows)) {
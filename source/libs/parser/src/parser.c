@@ -234,6 +234,8 @@ int32_t qSetSTableIdForRsma(SNode* pStmt, int64_t uid) {
 
 void qCleanupKeywordsTable() { taosCleanupKeywordsTable(); }
 
+void qCleanupCsvParsePool() { parCleanupCsvParsePool(); }
+
 int32_t qStmtBindParams(SQuery* pQuery, TAOS_MULTI_BIND* pParams, int32_t colIdx) {
   int32_t code = TSDB_CODE_SUCCESS;
 
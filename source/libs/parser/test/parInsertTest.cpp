@@ -14,8 +14,10 @@
  */
 
 #include <gtest/gtest.h>
+#include <fstream>
 
 #include "parTestUtil.h"
+#include "parser.h"
 
 using namespace std;
 
@@ -84,4 +86,95 @@ TEST_F(ParserInsertTest, autoCreateTableTest) {
       "st1s2 (ts, c1, c2) USING st1 TAGS(2, 'abc', now) VALUES (now+1s, 2, 'shanghai')");
 }
 
+// INSERT INTO tb_name FILE csv_file_path, the large files are parsed by several threads
+class ParserInsertCsvTest : public ParserInsertTest {
+ protected:
+  struct SCsvParseRes {
+    int32_t code;
+    string  msg;
+    string  data;
+  };
+
+  void SetUp() override {
+    csvPath_ = string(tsTempDir) + "/par_insert_csv_test.csv";
+    numOfCores_ = tsNumOfCores;
+  }
+
+  void TearDown() override {
+    tsNumOfCores = numOfCores_;
+    taosRemoveFile(csvPath_.c_str());
+  }
+
+  // about 40 bytes each row, so that the file is split into several chunks
+  void writeCsv(int32_t numOfRows, int32_t badRow) {
+    ofstream os(csvPath_, ios::trunc);
+    for (int32_t i = 0; i < numOfRows; ++i) {
+      if (i == badRow) {
+        os << 1659000000000 + i << ",abc,'bad row'," << i << ",1.5,2.5\n";
+      } else {
+        os << 1659000000000 + i << "," << i << ",'row_" << i << "'," << i * 10 << ",1.5,2.5\n";
+      }
+    }
+  }
+
+  // the submit data of all vgroups, to compare the results of different number of threads
+  SCsvParseRes parseCsv(int32_t numOfCores) {
+    tsNumOfCores = numOfCores;
+
+    string        sql = "insert into test.t1 file '" + csvPath_ + "'";
+    char          msgBuf[1024] = {0};
+    SParseContext cxt = {0};
+    cxt.acctId = 0;
+    cxt.db = "test";
+    cxt.pUser = "root";
+    cxt.isSuperUser = true;
+    cxt.enableSysInfo = true;
+    cxt.pSql = sql.c_str();
+    cxt.sqlLen = sql.length();
+    cxt.pMsg = msgBuf;
+    cxt.msgLen = sizeof(msgBuf);
+    cxt.svrVer = "3.0.0.0";
+
+    SQuery*      pQuery = nullptr;
+    SCsvParseRes res;
+    res.code = qParseSql(&cxt, &pQuery);
+    res.msg = msgBuf;
+    if (TSDB_CODE_SUCCESS == res.code) {
+      SArray* pDataBlocks = ((SVnodeModifOpStmt*)pQuery->pRoot)->pDataBlocks;
+      for (int32_t i = 0; i < taosArrayGetSize(pDataBlocks); ++i) {
+        SVgDataBlocks* pVg = (SVgDataBlocks*)taosArrayGetP(pDataBlocks, i);
+        res.data.append(pVg->pData, pVg->size);
+      }
+    }
+    qDestroyQuery(pQuery);
+    taosArrayDestroy(cxt.pTableMetaPos);
+    taosArrayDestroy(cxt.pTableVgroupPos);
+    return res;
+  }
+
+  string  csvPath_;
+  float   numOfCores_;
+};
+
+TEST_F(ParserInsertCsvTest, parallelSameAsSerial) {
+  writeCsv(100000, -1);
+
+  SCsvParseRes serial = parseCsv(1);
+  SCsvParseRes parallel = parseCsv(8);
+  ASSERT_EQ(serial.code, TSDB_CODE_SUCCESS);
+  ASSERT_EQ(parallel.code, TSDB_CODE_SUCCESS);
+  ASSERT_FALSE(serial.data.empty());
+  EXPECT_TRUE(serial.data == parallel.data);
+}
+
+TEST_F(ParserInsertCsvTest, badRowInMiddleChunk) {
+  writeCsv(100000, 50000);
+
+  SCsvParseRes serial = parseCsv(1);
+  SCsvParseRes parallel = parseCsv(8);
+  ASSERT_NE(serial.code, TSDB_CODE_SUCCESS);
+  EXPECT_EQ(parallel.code, serial.code);
+  EXPECT_EQ(parallel.msg, serial.msg);
+}
+
 }  // namespace ParserTest
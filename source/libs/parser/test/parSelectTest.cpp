@@ -210,12 +210,16 @@ TEST_F(ParserSelectTest, partitionBy) {
   run("SELECT c1, c2 FROM t1 PARTITION BY c2");
 
   run("SELECT SUM(c1), c2 FROM t1 PARTITION BY c2");
+
+  run("SELECT PERCENTILE(c1, 50), c2 FROM t1 PARTITION BY c2");
 }
 
 TEST_F(ParserSelectTest, partitionBySemanticCheck) {
   useDb("root", "test");
 
   run("SELECT SUM(c1), c2, c3 FROM t1 PARTITION BY c2", TSDB_CODE_PAR_NOT_SINGLE_GROUP);
+
+  run("SELECT PERCENTILE(c1, 50) FROM st1 PARTITION BY TBNAME", TSDB_CODE_PAR_ONLY_SUPPORT_SINGLE_TABLE);
 }
 
 TEST_F(ParserSelectTest, groupBy) {
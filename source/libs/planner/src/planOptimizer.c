@@ -663,28 +663,97 @@ static bool pushDownCondOptContainPriKeyEqualCond(SJoinLogicNode* pJoin, SNode*
   }
 }
 
+static bool pushDownCondOptIsHashKey(SNode* pNode, SNodeList* pTableCols) {
+  if (QUERY_NODE_COLUMN != nodeType(pNode)) {
+    return false;
+  }
+  SColumnNode* pCol = (SColumnNode*)pNode;
+  if (TSDB_DATA_TYPE_JSON == pCol->node.resType.type || TSDB_SYSTEM_TABLE == pCol->tableType) {
+    return false;
+  }
+  return pushDownCondOptBelongThisTable(pNode, pTableCols);
+}
+
+// column equal condition between the two children, the two columns must have the same type to be hashed
+static bool pushDownCondOptIsColEqualCond(SJoinLogicNode* pJoin, SNode* pCond) {
+  if (QUERY_NODE_OPERATOR != nodeType(pCond)) {
+    return false;
+  }
+
+  SOperatorNode* pOper = (SOperatorNode*)pCond;
+  if (OP_TYPE_EQUAL != pOper->opType || NULL == pOper->pLeft || NULL == pOper->pRight ||
+      ((SExprNode*)pOper->pLeft)->resType.type != ((SExprNode*)pOper->pRight)->resType.type) {
+    return false;
+  }
+
+  SNodeList* pLeftCols = ((SLogicNode*)nodesListGetNode(pJoin->node.pChildren, 0))->pTargets;
+  SNodeList* pRightCols = ((SLogicNode*)nodesListGetNode(pJoin->node.pChildren, 1))->pTargets;
+  if (pushDownCondOptIsHashKey(pOper->pLeft, pLeftCols)) {
+    return pushDownCondOptIsHashKey(pOper->pRight, pRightCols);
+  } else if (pushDownCondOptIsHashKey(pOper->pLeft, pRightCols)) {
+    return pushDownCondOptIsHashKey(pOper->pRight, pLeftCols);
+  }
+  return false;
+}
+
+static bool pushDownCondOptContainColEqualCond(SJoinLogicNode* pJoin, SNode* pCond) {
+  if (QUERY_NODE_LOGIC_CONDITION == nodeType(pCond)) {
+    SLogicConditionNode* pLogicCond = (SLogicConditionNode*)pCond;
+    if (LOGIC_COND_TYPE_AND != pLogicCond->condType) {
+      return false;
+    }
+    SNode* pCond = NULL;
+    FOREACH(pCond, pLogicCond->pParameterList) {
+      if (pushDownCondOptIsColEqualCond(pJoin, pCond)) {
+        return true;
+      }
+    }
+    return false;
+  }
+  return pushDownCondOptIsColEqualCond(pJoin, pCond);
+}
+
 static int32_t pushDownCondOptCheckJoinOnCond(SOptimizeContext* pCxt, SJoinLogicNode* pJoin) {
   if (NULL == pJoin->pOnConditions) {
     return generateUsageErrMsg(pCxt->pPlanCxt->pMsg, pCxt->pPlanCxt->msgLen, TSDB_CODE_PLAN_NOT_SUPPORT_CROSS_JOIN);
   }
+  pJoin->isHashJoin = false;
   if (!pushDownCondOptContainPriKeyEqualCond(pJoin, pJoin->pOnConditions)) {
-    return generateUsageErrMsg(pCxt->pPlanCxt->pMsg, pCxt->pPlanCxt->msgLen, TSDB_CODE_PLAN_EXPECTED_TS_EQUAL);
+    // without the primary key equal condition, fall back to the hash join on the column equal conditions
+    if (JOIN_TYPE_INNER != pJoin->joinType || !pushDownCondOptContainColEqualCond(pJoin, pJoin->pOnConditions)) {
+      return generateUsageErrMsg(pCxt->pPlanCxt->pMsg, pCxt->pPlanCxt->msgLen, TSDB_CODE_PLAN_EXPECTED_TS_EQUAL);
+    }
+    pJoin->isHashJoin = true;
   }
   return TSDB_CODE_SUCCESS;
 }
 
+static bool pushDownCondOptIsJoinKeyCond(SJoinLogicNode* pJoin, SNode* pCond) {
+  return pJoin->isHashJoin ? pushDownCondOptIsColEqualCond(pJoin, pCond) : pushDownCondOptIsPriKeyEqualCond(pJoin, pCond);
+}
+
 static int32_t pushDownCondOptPartJoinOnCondLogicCond(SJoinLogicNode* pJoin, SNode** ppMergeCond, SNode** ppOnCond) {
   SLogicConditionNode* pLogicCond = (SLogicConditionNode*)(pJoin->pOnConditions);
 
   int32_t    code = TSDB_CODE_SUCCESS;
   SNodeList* pOnConds = NULL;
+  SNodeList* pKeyConds = NULL;
   SNode*     pCond = NULL;
   FOREACH(pCond, pLogicCond->pParameterList) {
-    if (pushDownCondOptIsPriKeyEqualCond(pJoin, pCond)) {
+    if (pJoin->isHashJoin && pushDownCondOptIsColEqualCond(pJoin, pCond)) {
+      code = nodesListMakeAppend(&pKeyConds, nodesCloneNode(pCond));
+    } else if (!pJoin->isHashJoin && pushDownCondOptIsPriKeyEqualCond(pJoin, pCond)) {
       *ppMergeCond = nodesCloneNode(pCond);
     } else {
       code = nodesListMakeAppend(&pOnConds, nodesCloneNode(pCond));
     }
+    if (TSDB_CODE_SUCCESS != code) {
+      break;
+    }
+  }
+
+  if (TSDB_CODE_SUCCESS == code && NULL != pKeyConds) {
+    code = nodesMergeConds(ppMergeCond, &pKeyConds);
   }
 
   SNode* pTempOnCond = NULL;
@@ -699,6 +768,7 @@ static int32_t pushDownCondOptPartJoinOnCondLogicCond(SJoinLogicNode* pJoin, SNo
     return TSDB_CODE_SUCCESS;
   } else {
     nodesDestroyList(pOnConds);
+    nodesDestroyList(pKeyConds);
     nodesDestroyNode(pTempOnCond);
     return TSDB_CODE_PLAN_INTERNAL_ERROR;
   }
@@ -710,7 +780,7 @@ static int32_t pushDownCondOptPartJoinOnCond(SJoinLogicNode* pJoin, SNode** ppMe
     return pushDownCondOptPartJoinOnCondLogicCond(pJoin, ppMergeCond, ppOnCond);
   }
 
-  if (pushDownCondOptIsPriKeyEqualCond(pJoin, pJoin->pOnConditions)) {
+  if (pushDownCondOptIsJoinKeyCond(pJoin, pJoin->pOnConditions)) {
     *ppMergeCond = nodesCloneNode(pJoin->pOnConditions);
     *ppOnCond = NULL;
     nodesDestroyNode(pJoin->pOnConditions);
@@ -1092,6 +1162,11 @@ static int32_t sortPriKeyOptGetSequencingNodesImpl(SLogicNode* pNode, bool* pNot
       return nodesListMakeAppend(pSequencingNodes, (SNode*)pNode);
     }
     case QUERY_NODE_LOGIC_PLAN_JOIN: {
+      // the output of hash join is not ordered by the primary key
+      if (((SJoinLogicNode*)pNode)->isHashJoin) {
+        *pNotOptimize = true;
+        return TSDB_CODE_SUCCESS;
+      }
       int32_t code = sortPriKeyOptGetSequencingNodesImpl((SLogicNode*)nodesListGetNode(pNode->pChildren, 0),
                                                          pNotOptimize, pSequencingNodes);
       if (TSDB_CODE_SUCCESS == code) {
@@ -2393,6 +2468,44 @@ static int32_t tagScanOptimize(SOptimizeContext* pCxt, SLogicSubplan* pLogicSubp
   return TSDB_CODE_SUCCESS;
 }
 
+static bool pushDownLimitOptMayBeOptimized(SLogicNode* pNode) {
+  if (QUERY_NODE_LOGIC_PLAN_SORT != nodeType(pNode) || ((SSortLogicNode*)pNode)->groupSort ||
+      NULL != pNode->pLimit || NULL != pNode->pSlimit || NULL != pNode->pConditions) {
+    return false;
+  }
+
+  // the project keeps one output row per input row, so only its first offset + limit input rows are needed
+  SLogicNode* pParent = pNode->pParent;
+  if (NULL == pParent || QUERY_NODE_LOGIC_PLAN_PROJECT != nodeType(pParent) || NULL == pParent->pLimit ||
+      NULL != pParent->pSlimit || NULL != pParent->pConditions) {
+    return false;
+  }
+
+  SLimitNode* pLimit = (SLimitNode*)pParent->pLimit;
+  return pLimit->limit > 0 && (pLimit->offset <= 0 || pLimit->limit <= INT64_MAX - pLimit->offset);
+}
+
+static int32_t pushDownLimitOptimize(SOptimizeContext* pCxt, SLogicSubplan* pLogicSubplan) {
+  SLogicNode* pSort = optFindPossibleNode(pLogicSubplan->pNode, pushDownLimitOptMayBeOptimized);
+  if (NULL == pSort) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  SLimitNode* pParentLimit = (SLimitNode*)pSort->pParent->pLimit;
+  SLimitNode* pLimit = (SLimitNode*)nodesMakeNode(QUERY_NODE_LIMIT);
+  if (NULL == pLimit) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  // the offset is still applied by the project
+  pLimit->limit = pParentLimit->limit + TMAX(pParentLimit->offset, 0);
+  pLimit->offset = 0;
+  pSort->pLimit = (SNode*)pLimit;
+
+  pCxt->optimized = true;
+  return TSDB_CODE_SUCCESS;
+}
+
 // clang-format off
 static const SOptimizeRule optimizeRuleSet[] = {
   {.pName = "ScanPath",                   .optimizeFunc = scanPathOptimize},
@@ -2406,7 +2519,8 @@ static const SOptimizeRule optimizeRuleSet[] = {
   {.pName = "RewriteTail",                .optimizeFunc = rewriteTailOptimize},
   {.pName = "RewriteUnique",              .optimizeFunc = rewriteUniqueOptimize},
   {.pName = "LastRowScan",               .optimizeFunc = lastRowScanOptimize},
-  {.pName = "TagScan",                   .optimizeFunc = tagScanOptimize}
+  {.pName = "TagScan",                   .optimizeFunc = tagScanOptimize},
+  {.pName = "PushDownLimit",             .optimizeFunc = pushDownLimitOptimize}
 };
 // clang-format on
 
@@ -638,8 +638,95 @@ static int32_t createScanPhysiNode(SPhysiPlanContext* pCxt, SSubplan* pSubplan,
   return TSDB_CODE_FAILED;
 }
 
+static int32_t appendHashJoinKeys(SNode* pKeyCond, int16_t leftBlockId, SHashJoinPhysiNode* pJoin) {
+  SOperatorNode* pOper = (SOperatorNode*)pKeyCond;
+  SNode*         pLeft = pOper->pLeft;
+  SNode*         pRight = pOper->pRight;
+  if (leftBlockId != ((SColumnNode*)pLeft)->dataBlockId) {
+    TSWAP(pLeft, pRight);
+  }
+  int32_t code = nodesListMakeStrictAppend(&pJoin->pLeftKeys, nodesCloneNode(pLeft));
+  if (TSDB_CODE_SUCCESS == code) {
+    code = nodesListMakeStrictAppend(&pJoin->pRightKeys, nodesCloneNode(pRight));
+  }
+  return code;
+}
+
+static int32_t setHashJoinKeys(SPhysiPlanContext* pCxt, int16_t leftBlockId, int16_t rightBlockId,
+                               SJoinLogicNode* pJoinLogicNode, SHashJoinPhysiNode* pJoin) {
+  SNode*  pKeyCond = NULL;
+  int32_t code = setNodeSlotId(pCxt, leftBlockId, rightBlockId, pJoinLogicNode->pMergeCondition, &pKeyCond);
+  if (TSDB_CODE_SUCCESS == code) {
+    if (QUERY_NODE_LOGIC_CONDITION == nodeType(pKeyCond)) {
+      SNode* pCond = NULL;
+      FOREACH(pCond, ((SLogicConditionNode*)pKeyCond)->pParameterList) {
+        code = appendHashJoinKeys(pCond, leftBlockId, pJoin);
+        if (TSDB_CODE_SUCCESS != code) {
+          break;
+        }
+      }
+    } else {
+      code = appendHashJoinKeys(pKeyCond, leftBlockId, pJoin);
+    }
+  }
+  nodesDestroyNode(pKeyCond);
+  return code;
+}
+
+static int32_t createHashJoinPhysiNode(SPhysiPlanContext* pCxt, SNodeList* pChildren, SJoinLogicNode* pJoinLogicNode,
+                                       SPhysiNode** pPhyNode) {
+  SHashJoinPhysiNode* pJoin =
+      (SHashJoinPhysiNode*)makePhysiNode(pCxt, (SLogicNode*)pJoinLogicNode, QUERY_NODE_PHYSICAL_PLAN_HASH_JOIN);
+  if (NULL == pJoin) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  SDataBlockDescNode* pLeftDesc = ((SPhysiNode*)nodesListGetNode(pChildren, 0))->pOutputDataBlockDesc;
+  SDataBlockDescNode* pRightDesc = ((SPhysiNode*)nodesListGetNode(pChildren, 1))->pOutputDataBlockDesc;
+
+  pJoin->joinType = pJoinLogicNode->joinType;
+  int32_t code = setHashJoinKeys(pCxt, pLeftDesc->dataBlockId, pRightDesc->dataBlockId, pJoinLogicNode, pJoin);
+  if (TSDB_CODE_SUCCESS == code) {
+    code = setListSlotId(pCxt, pLeftDesc->dataBlockId, pRightDesc->dataBlockId, pJoinLogicNode->node.pTargets,
+                         &pJoin->pTargets);
+  }
+  if (TSDB_CODE_SUCCESS == code) {
+    code = addDataBlockSlots(pCxt, pJoin->pTargets, pJoin->node.pOutputDataBlockDesc);
+  }
+
+  SNodeList* condCols = nodesMakeList();
+  if (TSDB_CODE_SUCCESS == code && NULL != pJoinLogicNode->pOnConditions) {
+    code = nodesCollectColumnsFromNode(pJoinLogicNode->pOnConditions, NULL, COLLECT_COL_TYPE_ALL, &condCols);
+  }
+  if (TSDB_CODE_SUCCESS == code) {
+    code = addDataBlockSlots(pCxt, condCols, pJoin->node.pOutputDataBlockDesc);
+  }
+  nodesDestroyList(condCols);
+
+  if (TSDB_CODE_SUCCESS == code && NULL != pJoinLogicNode->pOnConditions) {
+    code = setNodeSlotId(pCxt, ((SPhysiNode*)pJoin)->pOutputDataBlockDesc->dataBlockId, -1,
+                         pJoinLogicNode->pOnConditions, &pJoin->pOnConditions);
+  }
+
+  if (TSDB_CODE_SUCCESS == code) {
+    code = setConditionsSlotId(pCxt, (const SLogicNode*)pJoinLogicNode, (SPhysiNode*)pJoin);
+  }
+
+  if (TSDB_CODE_SUCCESS == code) {
+    *pPhyNode = (SPhysiNode*)pJoin;
+  } else {
+    nodesDestroyNode((SNode*)pJoin);
+  }
+
+  return code;
+}
+
 static int32_t createJoinPhysiNode(SPhysiPlanContext* pCxt, SNodeList* pChildren, SJoinLogicNode* pJoinLogicNode,
                                    SPhysiNode** pPhyNode) {
+  if (pJoinLogicNode->isHashJoin) {
+    return createHashJoinPhysiNode(pCxt, pChildren, pJoinLogicNode, pPhyNode);
+  }
+
   SSortMergeJoinPhysiNode* pJoin =
       (SSortMergeJoinPhysiNode*)makePhysiNode(pCxt, (SLogicNode*)pJoinLogicNode, QUERY_NODE_PHYSICAL_PLAN_MERGE_JOIN);
   if (NULL == pJoin) {
@@ -53,6 +53,18 @@ TEST_F(PlanJoinTest, withAggAndOrderBy) {
   run("SELECT t1.ts, TOP(t2.c1, 10) FROM st1s1 t1 JOIN st1s2 t2 ON t1.ts = t2.ts ORDER BY t2.ts");
 }
 
+TEST_F(PlanJoinTest, hashJoin) {
+  useDb("root", "test");
+
+  run("SELECT t1.c1, t2.c2 FROM st1s1 t1 JOIN st1s2 t2 ON t1.c1 = t2.c1");
+
+  run("SELECT t1.c1, t2.c2 FROM st1s1 t1 JOIN st1s2 t2 ON t1.c1 = t2.c1 AND t1.c2 = t2.c2 WHERE t1.c1 > 10");
+
+  run("SELECT t1.c1, t2.tag2 FROM st1 t1 JOIN st1 t2 ON t1.tag1 = t2.tag1 AND t1.c1 > t2.c1");
+
+  run("SELECT t1.ts, t2.c2 FROM st1s1 t1 JOIN st1s2 t2 ON t1.c1 = t2.c1 ORDER BY t1.ts");
+}
+
 TEST_F(PlanJoinTest, multiJoin) {
   useDb("root", "test");
 
@@ -117,4 +117,14 @@ TEST_F(PlanOptimizeTest, tagScan) {
   run("select tag1 from st1 group by tag1");
   run("select distinct tag1 from st1");
   run("select tag1*tag1 from st1 group by tag1*tag1");
-}
\ No newline at end of file
+}
+
+TEST_F(PlanOptimizeTest, pushDownLimit) {
+  useDb("root", "test");
+
+  run("SELECT c1 FROM t1 ORDER BY c1 LIMIT 10");
+
+  run("SELECT c1 FROM t1 ORDER BY c2 DESC LIMIT 5 OFFSET 10");
+
+  run("SELECT c1 FROM st1 ORDER BY c1 LIMIT 100");
+}
@@ -3283,6 +3283,234 @@ bool filterExecuteImpl(void *pinfo, int32_t numOfRows, SColumnInfoData *pRes, SC
   return all;
 }
 
+// column-at-a-time kernels: each unit is evaluated over the whole block into a row result array, then the
+// units are combined by AND inside a group and by OR across groups. Only fixed-width columns compared with
+// the plain comparison operators are supported, the others fall back to filterExecuteImpl.
+typedef void (*fltVecUnitFunc)(const void *data, int32_t numOfRows, const void *val, const void *val2, uint8_t optr,
+                               uint8_t optr2, int8_t *res);
+
+// same result as compareFloatVal/compareDoubleVal
+static FORCE_INLINE int32_t fltVecCompareFloat(float p1, float p2) {
+  if (isnan(p1) || isnan(p2)) {
+    return isnan(p1) ? (isnan(p2) ? 0 : -1) : 1;
+  }
+
+  return FLT_EQUAL(p1, p2) ? 0 : (p1 > p2 ? 1 : -1);
+}
+
+static FORCE_INLINE int32_t fltVecCompareDouble(double p1, double p2) {
+  if (isnan(p1) || isnan(p2)) {
+    return isnan(p1) ? (isnan(p2) ? 0 : -1) : 1;
+  }
+
+  return FLT_EQUAL(p1, p2) ? 0 : (p1 > p2 ? 1 : -1);
+}
+
+#define FLT_VEC_NUM_COMPARE(_a, _b) (((_a) > (_b)) - ((_a) < (_b)))
+
+#define FLT_VEC_LOOP(_res, _n, _expr)    \
+  do {                                   \
+    for (int32_t i = 0; i < (_n); ++i) { \
+      (_res)[i] = (_expr);               \
+    }                                    \
+  } while (0)
+
+#define FLT_VEC_LOOP_AND(_res, _n, _expr) \
+  do {                                    \
+    for (int32_t i = 0; i < (_n); ++i) {  \
+      (_res)[i] &= (_expr);               \
+    }                                     \
+  } while (0)
+
+#define FLT_VEC_UNIT_FUNC(_name, _type, _cmp)                                                                      \
+  static void _name(const void *data, int32_t numOfRows, const void *val, const void *val2, uint8_t optr,          \
+                    uint8_t optr2, int8_t *res) {                                                                  \
+    const _type *p = (const _type *)data;                                                                          \
+    _type        v = *(const _type *)val;                                                                          \
+    switch (optr) {                                                                                                \
+      case OP_TYPE_GREATER_THAN:                                                                                   \
+        FLT_VEC_LOOP(res, numOfRows, _cmp(p[i], v) > 0);                                                           \
+        break;                                                                                                     \
+      case OP_TYPE_GREATER_EQUAL:                                                                                  \
+        FLT_VEC_LOOP(res, numOfRows, _cmp(p[i], v) >= 0);                                                          \
+        break;                                                                                                     \
+      case OP_TYPE_LOWER_THAN:                                                                                     \
+        FLT_VEC_LOOP(res, numOfRows, _cmp(p[i], v) < 0);                                                           \
+        break;                                                                                                     \
+      case OP_TYPE_LOWER_EQUAL:                                                                                    \
+        FLT_VEC_LOOP(res, numOfRows, _cmp(p[i], v) <= 0);                                                          \
+        break;                                                                                                     \
+      case OP_TYPE_EQUAL:                                                                                          \
+        FLT_VEC_LOOP(res, numOfRows, _cmp(p[i], v) == 0);                                                          \
+        break;                                                                                                     \
+      case OP_TYPE_NOT_EQUAL:                                                                                      \
+        FLT_VEC_LOOP(res, numOfRows, _cmp(p[i], v) != 0);                                                          \
+        break;                                                                                                     \
+      default:                                                                                                     \
+        ASSERT(0);                                                                                                 \
+    }                                                                                                              \
+                                                                                                                   \
+    if (optr2 == OP_TYPE_LOWER_THAN) {                                                                             \
+      _type v2 = *(const _type *)val2;                                                                             \
+      FLT_VEC_LOOP_AND(res, numOfRows, _cmp(p[i], v2) < 0);                                                        \
+    } else if (optr2 == OP_TYPE_LOWER_EQUAL) {                                                                     \
+      _type v2 = *(const _type *)val2;                                                                             \
+      FLT_VEC_LOOP_AND(res, numOfRows, _cmp(p[i], v2) <= 0);                                                       \
+    }                                                                                                              \
+  }
+
+FLT_VEC_UNIT_FUNC(fltVecUnitInt8, int8_t, FLT_VEC_NUM_COMPARE)
+FLT_VEC_UNIT_FUNC(fltVecUnitInt16, int16_t, FLT_VEC_NUM_COMPARE)
+FLT_VEC_UNIT_FUNC(fltVecUnitInt32, int32_t, FLT_VEC_NUM_COMPARE)
+FLT_VEC_UNIT_FUNC(fltVecUnitInt64, int64_t, FLT_VEC_NUM_COMPARE)
+FLT_VEC_UNIT_FUNC(fltVecUnitUint8, uint8_t, FLT_VEC_NUM_COMPARE)
+FLT_VEC_UNIT_FUNC(fltVecUnitUint16, uint16_t, FLT_VEC_NUM_COMPARE)
+FLT_VEC_UNIT_FUNC(fltVecUnitUint32, uint32_t, FLT_VEC_NUM_COMPARE)
+FLT_VEC_UNIT_FUNC(fltVecUnitUint64, uint64_t, FLT_VEC_NUM_COMPARE)
+FLT_VEC_UNIT_FUNC(fltVecUnitFloat, float, fltVecCompareFloat)
+FLT_VEC_UNIT_FUNC(fltVecUnitDouble, double, fltVecCompareDouble)
+
+static fltVecUnitFunc fltVecGetUnitFunc(int32_t type) {
+  switch (type) {
+    case TSDB_DATA_TYPE_BOOL:
+    case TSDB_DATA_TYPE_TINYINT:
+      return fltVecUnitInt8;
+    case TSDB_DATA_TYPE_SMALLINT:
+      return fltVecUnitInt16;
+    case TSDB_DATA_TYPE_INT:
+      return fltVecUnitInt32;
+    case TSDB_DATA_TYPE_BIGINT:
+    case TSDB_DATA_TYPE_TIMESTAMP:
+      return fltVecUnitInt64;
+    case TSDB_DATA_TYPE_UTINYINT:
+      return fltVecUnitUint8;
+    case TSDB_DATA_TYPE_USMALLINT:
+      return fltVecUnitUint16;
+    case TSDB_DATA_TYPE_UINT:
+      return fltVecUnitUint32;
+    case TSDB_DATA_TYPE_UBIGINT:
+      return fltVecUnitUint64;
+    case TSDB_DATA_TYPE_FLOAT:
+      return fltVecUnitFloat;
+    case TSDB_DATA_TYPE_DOUBLE:
+      return fltVecUnitDouble;
+    default:
+      return NULL;
+  }
+}
+
+static bool fltVecUnitSupported(SFilterInfo *info, uint32_t uidx) {
+  SFilterComUnit *cunit = &info->cunits[uidx];
+  if (fltVecGetUnitFunc(cunit->dataType) == NULL) {
+    return false;
+  }
+
+  switch (cunit->optr) {
+    case OP_TYPE_IS_NULL:
+    case OP_TYPE_IS_NOT_NULL:
+      return true;
+    case OP_TYPE_GREATER_THAN:
+    case OP_TYPE_GREATER_EQUAL:
+    case OP_TYPE_LOWER_THAN:
+    case OP_TYPE_LOWER_EQUAL:
+    case OP_TYPE_EQUAL:
+    case OP_TYPE_NOT_EQUAL:
+      return cunit->valData != NULL;
+    default:
+      return false;
+  }
+}
+
+// evaluate one unit over all rows, the null rows only satisfy IS NULL
+static void fltVecExecUnit(SFilterInfo *info, uint32_t uidx, int32_t numOfRows, int8_t *res) {
+  SFilterComUnit  *cunit = &info->cunits[uidx];
+  SColumnInfoData *pCol = (SColumnInfoData *)cunit->colData;
+  uint8_t          optr = cunit->optr;
+  int8_t           nullRes = (optr == OP_TYPE_IS_NULL);
+
+  if (pCol->pData == NULL) {
+    memset(res, nullRes, numOfRows);
+    return;
+  }
+
+  if (optr == OP_TYPE_IS_NULL || optr == OP_TYPE_IS_NOT_NULL) {
+    memset(res, !nullRes, numOfRows);
+  } else {
+    fltVecUnitFunc fp = fltVecGetUnitFunc(cunit->dataType);
+    (*fp)(pCol->pData, numOfRows, cunit->valData, cunit->valData2, optr, info->units[uidx].compare.optr2, res);
+  }
+
+  if (!pCol->hasNull) {
+    return;
+  }
+
+  int32_t len = BitmapLen(numOfRows);
+  for (int32_t b = 0; b < len; ++b) {
+    if (pCol->nullbitmap[b] == 0) {
+      continue;
+    }
+
+    int32_t end = TMIN((b + 1) * 8, numOfRows);
+    for (int32_t i = b * 8; i < end; ++i) {
+      if (colDataIsNull_f(pCol->nullbitmap, i)) {
+        res[i] = nullRes;
+      }
+    }
+  }
+}
+
+bool filterExecuteImplVector(void *pinfo, int32_t numOfRows, SColumnInfoData *pRes, SColumnDataAgg *statis,
+                             int16_t numOfCols, int32_t *numOfQualified) {
+  SFilterInfo *info = (SFilterInfo *)pinfo;
+  bool         all = true;
+
+  if (filterExecuteBasedOnStatis(info, numOfRows, pRes, statis, numOfCols, &all) == 0) {
+    return all;
+  }
+
+  // the column type of the data block may differ from the one the filter is built with
+  for (uint32_t i = 0; i < info->unitNum; ++i) {
+    if (((SColumnInfoData *)info->cunits[i].colData)->info.type != info->cunits[i].dataType) {
+      return filterExecuteImpl(pinfo, numOfRows, pRes, statis, numOfCols, numOfQualified);
+    }
+  }
+
+  int8_t *unitRes = taosMemoryMalloc(numOfRows * 2);
+  if (unitRes == NULL) {
+    return filterExecuteImpl(pinfo, numOfRows, pRes, statis, numOfCols, numOfQualified);
+  }
+
+  int8_t *groupRes = unitRes + numOfRows;
+  int8_t *p = (int8_t *)pRes->pData;
+  memset(p, 0, numOfRows);
+
+  for (uint32_t g = 0; g < info->groupNum; ++g) {
+    SFilterGroup *group = &info->groups[g];
+
+    fltVecExecUnit(info, group->unitIdxs[0], numOfRows, groupRes);
+    for (uint32_t u = 1; u < group->unitNum; ++u) {
+      fltVecExecUnit(info, group->unitIdxs[u], numOfRows, unitRes);
+      for (int32_t i = 0; i < numOfRows; ++i) {
+        groupRes[i] &= unitRes[i];
+      }
+    }
+
+    for (int32_t i = 0; i < numOfRows; ++i) {
+      p[i] |= groupRes[i];
+    }
+  }
+
+  int32_t num = 0;
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    num += p[i];
+  }
+
+  taosMemoryFree(unitRes);
+
+  *numOfQualified += num;
+  return num == numOfRows;
+}
+
 int32_t filterSetExecFunc(SFilterInfo *info) {
   if (FILTER_ALL_RES(info)) {
     info->func = filterExecuteImplAll;
@@ -3294,6 +3522,16 @@ int32_t filterSetExecFunc(SFilterInfo *info) {
     return TSDB_CODE_SUCCESS;
   }
 
+  bool vectorized = true;
+  for (uint32_t i = 0; i < info->unitNum && vectorized; ++i) {
+    vectorized = fltVecUnitSupported(info, i);
+  }
+
+  if (vectorized) {
+    info->func = filterExecuteImplVector;
+    return TSDB_CODE_SUCCESS;
+  }
+
   if (info->unitNum > 1) {
     info->func = filterExecuteImpl;
     return TSDB_CODE_SUCCESS;
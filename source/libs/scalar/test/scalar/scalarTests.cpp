@@ -38,6 +38,7 @@
 #include "tvariant.h"
 #include "tdatablock.h"
 #include "stub.h"
+#include "filter.h"
 #include "scalar.h"
 #include "nodes.h"
 #include "tlog.h"
@@ -3639,6 +3640,177 @@ TEST(ScalarFunctionTest, powFunction_column) {
  taosMemoryFree(pInput);
 }
 
+// run the filter by the chosen path first, then by the row at a time path, both must give eRes
+void scltCheckVectorFilter(SNode *pCond, SSDataBlock *src, bool vectorized, const int8_t *eRes) {
+ SFilterInfo *filter = NULL;
+ int32_t code = filterInitFromNode(pCond, &filter, 0);
+ ASSERT_EQ(code, 0);
+
+ SFilterColumnParam param = {(int32_t)taosArrayGetSize(src->pDataBlock), src->pDataBlock};
+ code = filterSetDataFromSlotId(filter, &param);
+ ASSERT_EQ(code, 0);
+ ASSERT_EQ(filter->func == filterExecuteImplVector, vectorized);
+
+ // the scalar mode filter has no row at a time path to compare with
+ int32_t rounds = filter->scalarMode ? 1 : 2;
+ for (int32_t round = 0; round < rounds; ++round) {
+   if (round == 1) {
+     filter->func = filterExecuteImpl;
+   }
+
+   SColumnInfoData *pRes = NULL;
+   int32_t status = 0;
+   filterExecute(filter, src, &pRes, NULL, (int16_t)taosArrayGetSize(src->pDataBlock), &status);
+   for (int32_t i = 0; i < src->info.rows; ++i) {
+     ASSERT_EQ(((int8_t *)pRes->pData)[i], eRes[i]) << "round " << round << " row " << i;
+   }
+   colDataDestroy(pRes);
+   taosMemoryFree(pRes);
+ }
+
+ filterFreeInfo(filter);
+}
+
+TEST(filterVectorTest, double_column_with_nan) {
+ SNode *pLeft = NULL, *pRight = NULL, *opNode = NULL;
+ double leftv[6] = {NAN, 1.0, 2.0, NAN, -1.0, 0.5};
+ double rightv = 0.5;
+ SSDataBlock *src = NULL;
+ int32_t rowNum = sizeof(leftv) / sizeof(leftv[0]);
+
+ // nan is less than any other value, the same as compareDoubleVal
+ int8_t eGreater[6] = {0, 1, 1, 0, 0, 0};
+ int8_t eLower[6] = {1, 0, 0, 1, 1, 0};
+ int8_t eNotEqual[6] = {1, 1, 1, 1, 1, 0};
+
+ scltMakeColumnNode(&pLeft, &src, TSDB_DATA_TYPE_DOUBLE, sizeof(double), rowNum, leftv);
+ scltMakeValueNode(&pRight, TSDB_DATA_TYPE_DOUBLE, &rightv);
+ scltMakeOpNode(&opNode, OP_TYPE_GREATER_THAN, TSDB_DATA_TYPE_BOOL, pLeft, pRight);
+ scltCheckVectorFilter(opNode, src, true, eGreater);
+
+ ((SOperatorNode *)opNode)->opType = OP_TYPE_LOWER_THAN;
+ scltCheckVectorFilter(opNode, src, true, eLower);
+
+ // not equal is calculated in the scalar mode
+ ((SOperatorNode *)opNode)->opType = OP_TYPE_NOT_EQUAL;
+ scltCheckVectorFilter(opNode, src, false, eNotEqual);
+
+ nodesDestroyNode(opNode);
+ blockDataDestroy(src);
+}
+
+TEST(filterVectorTest, float_column_equal_with_tolerance) {
+ SNode *pLeft = NULL, *pRight = NULL, *opNode = NULL;
+ volatile float a = 0.3f, b = 0.2f;
+ float leftv[5] = {0.1f, a - b, 0.2f, 0.1f + 2e-7f, 0.1f - 1e-6f};
+ float rightv = 0.1f;
+ SSDataBlock *src = NULL;
+ int32_t rowNum = sizeof(leftv) / sizeof(leftv[0]);
+
+ // values within FLT_EQUAL tolerance of 0.1 are equal to it
+ int8_t eEqual[5] = {1, 1, 0, 1, 0};
+ int8_t eGreaterEqual[5] = {1, 1, 1, 1, 0};
+ int8_t eLowerThan[5] = {0, 0, 0, 0, 1};
+
+ scltMakeColumnNode(&pLeft, &src, TSDB_DATA_TYPE_FLOAT, sizeof(float), rowNum, leftv);
+ scltMakeValueNode(&pRight, TSDB_DATA_TYPE_FLOAT, &rightv);
+ scltMakeOpNode(&opNode, OP_TYPE_EQUAL, TSDB_DATA_TYPE_BOOL, pLeft, pRight);
+ scltCheckVectorFilter(opNode, src, true, eEqual);
+
+ ((SOperatorNode *)opNode)->opType = OP_TYPE_GREATER_EQUAL;
+ scltCheckVectorFilter(opNode, src, true, eGreaterEqual);
+
+ ((SOperatorNode *)opNode)->opType = OP_TYPE_LOWER_THAN;
+ scltCheckVectorFilter(opNode, src, true, eLowerThan);
+
+ nodesDestroyNode(opNode);
+ blockDataDestroy(src);
+}
+
+TEST(filterVectorTest, int_column_with_null_rows) {
+ SNode *pLeft = NULL, *pRight = NULL, *opNode1 = NULL, *opNode2 = NULL, *logicNode = NULL;
+ const int32_t rowNum = 20;
+ int32_t leftv[rowNum] = {0};
+ int32_t rightv = 5;
+ int8_t eGreaterOrNull[rowNum] = {0};
+ int8_t eNotEqual[rowNum] = {0};
+ SSDataBlock *src = NULL;
+
+ // the null rows span several bytes of the null bitmap
+ for (int32_t i = 0; i < rowNum; ++i) {
+   leftv[i] = i;
+   bool isNull = (i % 3 == 1);
+   eGreaterOrNull[i] = isNull || i > rightv;
+   eNotEqual[i] = !isNull && i != rightv;
+ }
+
+ scltMakeColumnNode(&pLeft, &src, TSDB_DATA_TYPE_INT, sizeof(int32_t), rowNum, leftv);
+ SColumnInfoData *pCol = (SColumnInfoData *)taosArrayGetLast(src->pDataBlock);
+ for (int32_t i = 1; i < rowNum; i += 3) {
+   colDataAppendNULL(pCol, i);
+ }
+
+ scltMakeValueNode(&pRight, TSDB_DATA_TYPE_INT, &rightv);
+ scltMakeOpNode(&opNode1, OP_TYPE_GREATER_THAN, TSDB_DATA_TYPE_BOOL, pLeft, pRight);
+ scltMakeColumnNode(&pLeft, NULL, TSDB_DATA_TYPE_INT, sizeof(int32_t), 0, NULL);
+ ((SColumnNode *)pLeft)->slotId = 2;
+ ((SColumnNode *)pLeft)->colId = 3;
+ scltMakeOpNode(&opNode2, OP_TYPE_IS_NULL, TSDB_DATA_TYPE_BOOL, pLeft, NULL);
+ SNode *list[2] = {opNode1, opNode2};
+ scltMakeLogicNode(&logicNode, LOGIC_COND_TYPE_OR, list, 2);
+ scltCheckVectorFilter(logicNode, src, true, eGreaterOrNull);
+ nodesDestroyNode(logicNode);
+
+ scltMakeColumnNode(&pLeft, NULL, TSDB_DATA_TYPE_INT, sizeof(int32_t), 0, NULL);
+ ((SColumnNode *)pLeft)->slotId = 2;
+ ((SColumnNode *)pLeft)->colId = 3;
+ scltMakeValueNode(&pRight, TSDB_DATA_TYPE_INT, &rightv);
+ scltMakeOpNode(&opNode1, OP_TYPE_NOT_EQUAL, TSDB_DATA_TYPE_BOOL, pLeft, pRight);
+ scltCheckVectorFilter(opNode1, src, false, eNotEqual);
+ nodesDestroyNode(opNode1);
+
+ blockDataDestroy(src);
+}
+
+TEST(filterVectorTest, binary_column_falls_back_to_row_filter) {
+ SNode *pLeft1 = NULL, *pRight1 = NULL, *pLeft2 = NULL, *pRight2 = NULL, *opNode1 = NULL, *opNode2 = NULL,
+       *logicNode = NULL;
+ int32_t leftv1[4] = {1, 2, 3, 4};
+ int32_t rightv1 = 1;
+ char rightv2[8] = {0};
+ const char *strs[4] = {"ab", "cd", "ab", "ef"};
+ int8_t eRes[4] = {0, 0, 1, 0};
+ SSDataBlock *src = NULL;
+ int32_t rowNum = 4;
+
+ char buf[4 * 8] = {0};
+ char *p = buf;
+ for (int32_t i = 0; i < rowNum; ++i) {
+   varDataSetLen(p, strlen(strs[i]));
+   memcpy(varDataVal(p), strs[i], strlen(strs[i]));
+   p += varDataTLen(p);
+ }
+ varDataSetLen(rightv2, 2);
+ memcpy(varDataVal(rightv2), "ab", 2);
+
+ scltMakeColumnNode(&pLeft1, &src, TSDB_DATA_TYPE_INT, sizeof(int32_t), rowNum, leftv1);
+ scltMakeValueNode(&pRight1, TSDB_DATA_TYPE_INT, &rightv1);
+ scltMakeOpNode(&opNode1, OP_TYPE_GREATER_THAN, TSDB_DATA_TYPE_BOOL, pLeft1, pRight1);
+ strcpy(((SColumnNode *)pLeft1)->colName, "c1");
+ scltMakeColumnNode(&pLeft2, &src, TSDB_DATA_TYPE_BINARY, 8, rowNum, buf);
+ strcpy(((SColumnNode *)pLeft2)->colName, "c_bin");
+ scltMakeValueNode(&pRight2, TSDB_DATA_TYPE_BINARY, rightv2);
+ scltMakeOpNode(&opNode2, OP_TYPE_EQUAL, TSDB_DATA_TYPE_BOOL, pLeft2, pRight2);
+ SNode *list[2] = {opNode1, opNode2};
+ scltMakeLogicNode(&logicNode, LOGIC_COND_TYPE_AND, list, 2);
+
+ // a unit the vectorized path can not evaluate makes the whole filter run row at a time
+ scltCheckVectorFilter(logicNode, src, false, eRes);
+
+ nodesDestroyNode(logicNode);
+ blockDataDestroy(src);
+}
+
 int main(int argc, char** argv) {
  taosSeedRand(taosGetTimestampSec());
  testing::InitGoogleTest(&argc, argv);
@@ -104,6 +104,8 @@ typedef struct SSyncNode {
   // tla+ leader vars
   SSyncIndexMgr* pNextIndex;
   SSyncIndexMgr* pMatchIndex;
+  SSyncIndexMgr* pSentIndex;  // last index sent to each peer, ahead of next index while batches are in flight
+  SSyncIndexMgr* pPeerBatchSize;  // max entries in one append entries each peer accepts, learned from its replies
 
   // tla+ log vars
   SSyncLogStore* pLogStore;
@@ -166,6 +168,9 @@ typedef struct SSyncNode {
   int64_t leaderTime;
   int64_t lastReplicateTime;
 
+  // the last successful reply to the leader, held until the wal group commit has written out its entries
+  SyncAppendEntriesReply* pPendingReply;
+
 } SSyncNode;
 
 // open/close --------------
@@ -252,6 +257,11 @@ int32_t syncNodeCommit(SSyncNode* ths, SyncIndex beginIndex, SyncIndex endIndex,
 int32_t syncNodePreCommit(SSyncNode* ths, SSyncRaftEntry* pEntry, int32_t code);
 
 int32_t syncNodeUpdateNewConfigIndex(SSyncNode* ths, SSyncCfg* pNewCfg);
+int32_t syncCacheEntry(SSyncLogStore* pLogStore, SSyncRaftEntry* pEntry, LRUHandle** h);
+
+int32_t syncNodeSendAppendEntriesReply(SSyncNode* ths, SyncAppendEntriesReply* pReply);
+void    syncNodeEqWalFlush(SSyncNode* pSyncNode);
+int32_t syncNodeOnWalFlushed(SSyncNode* ths);
 
 bool                 syncNodeInRaftGroup(SSyncNode* ths, SRaftId* pRaftId);
 SSyncSnapshotSender* syncNodeGetSnapshotSender(SSyncNode* ths, SRaftId* pDestId);
@@ -48,6 +48,7 @@ char*          logStoreSimple2Str(SSyncLogStore* pLogStore);
 SyncIndex logStoreFirstIndex(SSyncLogStore* pLogStore);
 
 SyncIndex logStoreWalCommitVer(SSyncLogStore* pLogStore);
+SyncIndex logStoreWalFlushIndex(SSyncLogStore* pLogStore);
 
 // for debug
 void logStorePrint(SSyncLogStore* pLogStore);
@@ -56,6 +56,9 @@ int32_t syncNodeAppendEntriesPeersSnapshot(SSyncNode* pSyncNode);
 int32_t syncNodeAppendEntriesPeersSnapshot2(SSyncNode* pSyncNode);
 
 int32_t syncNodeAppendEntriesOnePeer(SSyncNode* pSyncNode, SRaftId* pDestId, SyncIndex nextIndex);
+int32_t syncNodeAppendEntriesPipeline(SSyncNode* pSyncNode, SRaftId* pDestId, bool force);
+void    syncNodeResetSentIndex(SSyncNode* pSyncNode);
+int32_t syncNodePeerBatchSize(SSyncNode* pSyncNode, const SRaftId* pDestId);
 
 int32_t syncNodeReplicate(SSyncNode* pSyncNode, bool isTimer);
 int32_t syncNodeAppendEntries(SSyncNode* pSyncNode, const SRaftId* destRaftId, const SyncAppendEntries* pMsg);
@@ -150,13 +150,8 @@ int32_t syncNodeOnAppendEntriesCb(SSyncNode* ths, SyncAppendEntries* pMsg) {
     pReply->matchIndex = SYNC_INDEX_INVALID;
     pReply->startTime = ths->startTime;
 
-    // msg event log
-    syncLogSendAppendEntriesReply(ths, pReply, "");
-
-    SRpcMsg rpcMsg;
-    syncAppendEntriesReply2RpcMsg(pReply, &rpcMsg);
-    syncNodeSendMsgById(&pReply->destId, ths, &rpcMsg);
-    syncAppendEntriesReplyDestroy(pReply);
+    // send response
+    syncNodeSendAppendEntriesReply(ths, pReply);
 
     return ret;
   }
@@ -293,18 +288,14 @@ int32_t syncNodeOnAppendEntriesCb(SSyncNode* ths, SyncAppendEntries* pMsg) {
 
     pReply->startTime = ths->startTime;
 
-    // msg event log
-    syncLogSendAppendEntriesReply(ths, pReply, "");
-
-    SRpcMsg rpcMsg;
-    syncAppendEntriesReply2RpcMsg(pReply, &rpcMsg);
-    syncNodeSendMsgById(&pReply->destId, ths, &rpcMsg);
-    syncAppendEntriesReplyDestroy(pReply);
+    // send response
+    syncNodeSendAppendEntriesReply(ths, pReply);
 
     // maybe update commit index from leader
     if (pMsg->commitIndex > ths->commitIndex) {
-      // has commit entry in local
-      if (pMsg->commitIndex <= ths->pLogStore->getLastIndex(ths->pLogStore)) {
+      // has commit entry in local, and written out by the wal group commit
+      if (pMsg->commitIndex <= ths->pLogStore->getLastIndex(ths->pLogStore) &&
+          pMsg->commitIndex <= logStoreWalFlushIndex(ths->pLogStore)) {
         SyncIndex beginIndex = ths->commitIndex + 1;
         SyncIndex endIndex = pMsg->commitIndex;
 
@@ -504,6 +495,62 @@ static bool syncNodeOnAppendEntriesLogOK(SSyncNode* pSyncNode, SyncAppendEntries
   return false;
 }
 
+// append the entries of a batch behind its pre index. entries already in the local log with the same term are kept,
+// so a batch sent again while later batches are in flight does not roll back what they have appended
+static int32_t syncNodeAppendBatchEntries(SSyncNode* ths, SyncAppendEntriesBatch* pMsg) {
+  SOffsetAndContLen* metaTableArr = syncAppendEntriesBatchMetaTableArray(pMsg);
+  SyncIndex          myLastIndex = syncNodeGetLastIndex(ths);
+  int32_t            code = 0;
+
+  for (int32_t i = 0; i < pMsg->dataCount; ++i) {
+    SSyncRaftEntry* pAppendEntry = (SSyncRaftEntry*)(pMsg->data + metaTableArr[i].offset);
+
+    if (pAppendEntry->index <= ths->commitIndex) {
+      continue;
+    }
+
+    if (pAppendEntry->index <= myLastIndex) {
+      SyncTerm myTerm = syncNodeGetPreTerm(ths, pAppendEntry->index + 1);
+      if (myTerm == pAppendEntry->term) {
+        continue;
+      }
+
+      // make log same, rollback conflict entries
+      int32_t pass = syncNodeDoMakeLogSame(ths, pAppendEntry->index);
+      ASSERT(pass >= 0);
+
+      myLastIndex = syncNodeGetLastIndex(ths);
+      if (pAppendEntry->index <= myLastIndex) {
+        continue;
+      }
+    }
+
+    code = ths->pLogStore->syncLogAppendEntry(ths->pLogStore, pAppendEntry);
+    if (code != 0) {
+      return -1;
+    }
+    myLastIndex = pAppendEntry->index;
+
+    code = syncNodePreCommit(ths, pAppendEntry, 0);
+    ASSERT(code == 0);
+
+    // cache it for commit
+    SSyncRaftEntry* pCacheEntry = syncEntryBuild(pAppendEntry->dataLen);
+    ASSERT(pCacheEntry != NULL);
+    memcpy(pCacheEntry, pAppendEntry, pAppendEntry->bytes);
+
+    LRUHandle* h = NULL;
+    syncCacheEntry(ths->pLogStore, pCacheEntry, &h);
+    if (h) {
+      taosLRUCacheRelease(ths->pLogStore->pCache, h, false);
+    } else {
+      syncEntryDestory(pCacheEntry);
+    }
+  }
+
+  return 0;
+}
+
 int32_t syncNodeOnAppendEntriesSnapshot2Cb(SSyncNode* ths, SyncAppendEntriesBatch* pMsg) {
   int32_t ret = 0;
   int32_t code = 0;
@@ -554,39 +601,14 @@ int32_t syncNodeOnAppendEntriesSnapshot2Cb(SSyncNode* ths, SyncAppendEntriesBatc
     if (condition) {
       syncLogRecvAppendEntriesBatch(ths, pMsg, "fake match");
 
-      SyncIndex          matchIndex = ths->commitIndex;
-      bool               hasAppendEntries = pMsg->dataLen > 0;
-      SOffsetAndContLen* metaTableArr = syncAppendEntriesBatchMetaTableArray(pMsg);
+      SyncIndex matchIndex = ths->commitIndex;
+      bool      hasAppendEntries = pMsg->dataLen > 0;
 
       if (hasAppendEntries && pMsg->prevLogIndex == ths->commitIndex) {
-        int32_t   pass = 0;
-        SyncIndex logLastIndex = ths->pLogStore->syncLogLastIndex(ths->pLogStore);
-        bool      hasExtraEntries = logLastIndex > pMsg->prevLogIndex;
-
-        // make log same
-        if (hasExtraEntries) {
-          // make log same, rollback deleted entries
-          pass = syncNodeDoMakeLogSame(ths, pMsg->prevLogIndex + 1);
-          ASSERT(pass >= 0);
-        }
-
         // append entry batch
-        if (pass == 0) {
-          // assert! no batch
-          ASSERT(pMsg->dataCount <= 1);
-
-          for (int32_t i = 0; i < pMsg->dataCount; ++i) {
-            SSyncRaftEntry* pAppendEntry = (SSyncRaftEntry*)(pMsg->data + metaTableArr[i].offset);
-            code = ths->pLogStore->syncLogAppendEntry(ths->pLogStore, pAppendEntry);
-            if (code != 0) {
-              return -1;
-            }
-
-            code = syncNodePreCommit(ths, pAppendEntry, 0);
-            ASSERT(code == 0);
-
-            // syncEntryDestory(pAppendEntry);
-          }
+        code = syncNodeAppendBatchEntries(ths, pMsg);
+        if (code != 0) {
+          return -1;
         }
 
         // fsync once
@@ -608,14 +630,8 @@ int32_t syncNodeOnAppendEntriesSnapshot2Cb(SSyncNode* ths, SyncAppendEntriesBatc
       pReply->matchIndex = matchIndex;
       pReply->startTime = ths->startTime;
 
-      // msg event log
-      syncLogSendAppendEntriesReply(ths, pReply, "");
-
       // send response
-      SRpcMsg rpcMsg;
-      syncAppendEntriesReply2RpcMsg(pReply, &rpcMsg);
-      syncNodeSendMsgById(&pReply->destId, ths, &rpcMsg);
-      syncAppendEntriesReplyDestroy(pReply);
+      syncNodeSendAppendEntriesReply(ths, pReply);
 
       return 0;
     }
@@ -657,14 +673,8 @@ int32_t syncNodeOnAppendEntriesSnapshot2Cb(SSyncNode* ths, SyncAppendEntriesBatc
       pReply->matchIndex = ths->commitIndex;
       pReply->startTime = ths->startTime;
 
-      // msg event log
-      syncLogSendAppendEntriesReply(ths, pReply, "");
-
       // send response
-      SRpcMsg rpcMsg;
-      syncAppendEntriesReply2RpcMsg(pReply, &rpcMsg);
-      syncNodeSendMsgById(&pReply->destId, ths, &rpcMsg);
-      syncAppendEntriesReplyDestroy(pReply);
+      syncNodeSendAppendEntriesReply(ths, pReply);
 
       return 0;
     }
@@ -681,43 +691,19 @@ int32_t syncNodeOnAppendEntriesSnapshot2Cb(SSyncNode* ths, SyncAppendEntriesBatc
   do {
     bool condition = (pMsg->term == ths->pRaftStore->currentTerm) && (ths->state == TAOS_SYNC_STATE_FOLLOWER) && logOK;
     if (condition) {
-      // has extra entries (> preIndex) in local log
-      SyncIndex myLastIndex = syncNodeGetLastIndex(ths);
-      bool      hasExtraEntries = myLastIndex > pMsg->prevLogIndex;
-
       // has entries in SyncAppendEntries msg
-      bool               hasAppendEntries = pMsg->dataLen > 0;
-      SOffsetAndContLen* metaTableArr = syncAppendEntriesBatchMetaTableArray(pMsg);
+      bool      hasAppendEntries = pMsg->dataLen > 0;
+      SyncIndex matchIndex = hasAppendEntries ? pMsg->prevLogIndex + pMsg->dataCount : pMsg->prevLogIndex;
 
       syncLogRecvAppendEntriesBatch(ths, pMsg, "really match");
 
-      int32_t pass = 0;
-
-      if (hasExtraEntries) {
-        // make log same, rollback deleted entries
-        pass = syncNodeDoMakeLogSame(ths, pMsg->prevLogIndex + 1);
-        ASSERT(pass >= 0);
-      }
-
+      // extra entries are rolled back only if they conflict with the entries in msg, an empty msg may arrive after
+      // the batches sent behind it
       if (hasAppendEntries) {
         // append entry batch
-        if (pass == 0) {
-          // assert! no batch
-          ASSERT(pMsg->dataCount <= 1);
-
-          // append entry batch
-          for (int32_t i = 0; i < pMsg->dataCount; ++i) {
-            SSyncRaftEntry* pAppendEntry = (SSyncRaftEntry*)(pMsg->data + metaTableArr[i].offset);
-            code = ths->pLogStore->syncLogAppendEntry(ths->pLogStore, pAppendEntry);
-            if (code != 0) {
-              return -1;
-            }
-
-            code = syncNodePreCommit(ths, pAppendEntry, 0);
-            ASSERT(code == 0);
-
-            // syncEntryDestory(pAppendEntry);
-          }
+        code = syncNodeAppendBatchEntries(ths, pMsg);
+        if (code != 0) {
+          return -1;
         }
 
         // fsync once
@@ -733,21 +719,17 @@ int32_t syncNodeOnAppendEntriesSnapshot2Cb(SSyncNode* ths, SyncAppendEntriesBatc
       pReply->term = ths->pRaftStore->currentTerm;
       pReply->privateTerm = ths->pNewNodeReceiver->privateTerm;
       pReply->success = true;
-      pReply->matchIndex = hasAppendEntries ? pMsg->prevLogIndex + pMsg->dataCount : pMsg->prevLogIndex;
+      pReply->matchIndex = matchIndex;
       pReply->startTime = ths->startTime;
 
-      // msg event log
-      syncLogSendAppendEntriesReply(ths, pReply, "");
-
       // send response
-      SRpcMsg rpcMsg;
-      syncAppendEntriesReply2RpcMsg(pReply, &rpcMsg);
-      syncNodeSendMsgById(&pReply->destId, ths, &rpcMsg);
-      syncAppendEntriesReplyDestroy(pReply);
+      syncNodeSendAppendEntriesReply(ths, pReply);
 
       // maybe update commit index, leader notice me
       if (pMsg->commitIndex > ths->commitIndex) {
-        SyncIndex lastIndex = ths->pLogStore->syncLogLastIndex(ths->pLogStore);
+        // local entries after match index are not confirmed by this msg, nor committed before their wal group is
+        // written out
+        SyncIndex lastIndex = TMIN(matchIndex, logStoreWalFlushIndex(ths->pLogStore));
 
         SyncIndex beginIndex = 0;
         SyncIndex endIndex = -1;
@@ -882,14 +864,8 @@ int32_t syncNodeOnAppendEntriesSnapshotCb(SSyncNode* ths, SyncAppendEntries* pMs
       pReply->matchIndex = matchIndex;
       pReply->startTime = ths->startTime;
 
-      // msg event log
-      syncLogSendAppendEntriesReply(ths, pReply, "");
-
       // send response
-      SRpcMsg rpcMsg;
-      syncAppendEntriesReply2RpcMsg(pReply, &rpcMsg);
-      syncNodeSendMsgById(&pReply->destId, ths, &rpcMsg);
-      syncAppendEntriesReplyDestroy(pReply);
+      syncNodeSendAppendEntriesReply(ths, pReply);
 
       return ret;
     }
@@ -928,14 +904,8 @@ int32_t syncNodeOnAppendEntriesSnapshotCb(SSyncNode* ths, SyncAppendEntries* pMs
       pReply->matchIndex = SYNC_INDEX_INVALID;
       pReply->startTime = ths->startTime;
 
-      // msg event log
-      syncLogSendAppendEntriesReply(ths, pReply, "");
-
       // send response
-      SRpcMsg rpcMsg;
-      syncAppendEntriesReply2RpcMsg(pReply, &rpcMsg);
-      syncNodeSendMsgById(&pReply->destId, ths, &rpcMsg);
-      syncAppendEntriesReplyDestroy(pReply);
+      syncNodeSendAppendEntriesReply(ths, pReply);
 
       return ret;
     }
@@ -994,19 +964,14 @@ int32_t syncNodeOnAppendEntriesSnapshotCb(SSyncNode* ths, SyncAppendEntries* pMs
       pReply->matchIndex = hasAppendEntries ? pMsg->prevLogIndex + 1 : pMsg->prevLogIndex;
       pReply->startTime = ths->startTime;
 
-      // msg event log
-      syncLogSendAppendEntriesReply(ths, pReply, "");
-
       // send response
-      SRpcMsg rpcMsg;
-      syncAppendEntriesReply2RpcMsg(pReply, &rpcMsg);
-      syncNodeSendMsgById(&pReply->destId, ths, &rpcMsg);
-      syncAppendEntriesReplyDestroy(pReply);
+      syncNodeSendAppendEntriesReply(ths, pReply);
 
       // maybe update commit index, leader notice me
       if (pMsg->commitIndex > ths->commitIndex) {
-        // has commit entry in local
-        if (pMsg->commitIndex <= ths->pLogStore->syncLogLastIndex(ths->pLogStore)) {
+        // has commit entry in local, and written out by the wal group commit
+        if (pMsg->commitIndex <= ths->pLogStore->syncLogLastIndex(ths->pLogStore) &&
+            pMsg->commitIndex <= logStoreWalFlushIndex(ths->pLogStore)) {
           // advance commit index to sanpshot first
           SSnapshot snapshot;
           ths->pFsm->FpGetSnapshotInfo(ths->pFsm, &snapshot);
@@ -133,9 +133,9 @@ void syncMaybeAdvanceCommitIndex(SSyncNode* pSyncNode) {
 }
 
 bool syncAgreeIndex(SSyncNode* pSyncNode, SRaftId* pRaftId, SyncIndex index) {
-  // I am leader, I agree
+  // I am leader, I agree once the entry is written out by the wal group commit
   if (syncUtilSameId(pRaftId, &(pSyncNode->myRaftId)) && pSyncNode->state == TAOS_SYNC_STATE_LEADER) {
-    return true;
+    return index <= logStoreWalFlushIndex(pSyncNode->pLogStore);
   }
 
   // follower agree
@@ -33,6 +33,7 @@
 #include "syncTimeout.h"
 #include "syncUtil.h"
 #include "syncVoteMgr.h"
+#include "tglobal.h"
 #include "tref.h"
 
 bool gRaftDetailLog = false;
@@ -814,7 +815,7 @@ int32_t syncNodeProposeBatch(SSyncNode* pSyncNode, SRpcMsg** pMsgPArr, bool* pIs
   syncClientRequestBatch2RpcMsg(pSyncMsg, &rpcMsg);
   taosMemoryFree(pSyncMsg);  // only free msg body, do not free rpc msg content
 
-  if (pSyncNode->replicaNum == 1 && pSyncNode->vgId != 1) {
+  if (pSyncNode->replicaNum == 1 && pSyncNode->vgId != 1 && tsWalGroupCommitMs <= 0) {
     int32_t code = syncNodeOnClientRequestBatchCb(pSyncNode, pSyncMsg);
     if (code == 0) {
       // update rpc msg applyIndex
@@ -1005,6 +1006,17 @@ SSyncNode* syncNodeOpen(const SSyncInfo* pOldSyncInfo) {
     goto _error;
   }
 
+  // the batch size is persisted when the raft cfg is created, upgrade the one saved by an older version
+  if (pSyncInfo->batchSize > 0 && pSyncNode->pRaftCfg->batchSize != pSyncInfo->batchSize) {
+    sInfo("vgId:%d, update raft cfg batch size from %d to %d", pSyncInfo->vgId, pSyncNode->pRaftCfg->batchSize,
+          pSyncInfo->batchSize);
+    pSyncNode->pRaftCfg->batchSize = pSyncInfo->batchSize;
+    if (raftCfgPersist(pSyncNode->pRaftCfg) != 0) {
+      sError("failed to persist raft cfg file. path:%s", pSyncNode->configPath);
+      goto _error;
+    }
+  }
+
   // init internal
   pSyncNode->myNodeInfo = pSyncNode->pRaftCfg->cfg.nodeInfo[pSyncNode->pRaftCfg->cfg.myIndex];
   if (!syncUtilnodeInfo2raftId(&pSyncNode->myNodeInfo, pSyncNode->vgId, &pSyncNode->myRaftId)) {
@@ -1100,6 +1112,17 @@ SSyncNode* syncNodeOpen(const SSyncInfo* pOldSyncInfo) {
     sError("failed to create SyncIndexMgr. vgId:%d", pSyncNode->vgId);
     goto _error;
   }
+  pSyncNode->pSentIndex = syncIndexMgrCreate(pSyncNode);
+  if (pSyncNode->pSentIndex == NULL) {
+    sError("failed to create SyncIndexMgr. vgId:%d", pSyncNode->vgId);
+    goto _error;
+  }
+  syncNodeResetSentIndex(pSyncNode);
+  pSyncNode->pPeerBatchSize = syncIndexMgrCreate(pSyncNode);
+  if (pSyncNode->pPeerBatchSize == NULL) {
+    sError("failed to create SyncIndexMgr. vgId:%d", pSyncNode->vgId);
+    goto _error;
+  }
 
   // init TLA+ log vars
   pSyncNode->pLogStore = logStoreCreate(pSyncNode);
@@ -1290,6 +1313,10 @@ void syncNodeClose(SSyncNode* pSyncNode) {
   pSyncNode->pNextIndex = NULL;
   syncIndexMgrDestroy(pSyncNode->pMatchIndex);
   pSyncNode->pMatchIndex = NULL;
+  syncIndexMgrDestroy(pSyncNode->pSentIndex);
+  pSyncNode->pSentIndex = NULL;
+  syncIndexMgrDestroy(pSyncNode->pPeerBatchSize);
+  pSyncNode->pPeerBatchSize = NULL;
   logStoreDestory(pSyncNode->pLogStore);
   pSyncNode->pLogStore = NULL;
   raftCfgClose(pSyncNode->pRaftCfg);
@@ -1315,6 +1342,9 @@ void syncNodeClose(SSyncNode* pSyncNode) {
     pSyncNode->pNewNodeReceiver = NULL;
   }
 
+  syncAppendEntriesReplyDestroy(pSyncNode->pPendingReply);
+  pSyncNode->pPendingReply = NULL;
+
   taosMemoryFree(pSyncNode);
 }
 
@@ -1621,6 +1651,7 @@ cJSON* syncNode2Json(const SSyncNode* pSyncNode) {
     // tla+ leader vars
     cJSON_AddItemToObject(pRoot, "pNextIndex", syncIndexMgr2Json(pSyncNode->pNextIndex));
     cJSON_AddItemToObject(pRoot, "pMatchIndex", syncIndexMgr2Json(pSyncNode->pMatchIndex));
+    cJSON_AddItemToObject(pRoot, "pSentIndex", syncIndexMgr2Json(pSyncNode->pSentIndex));
 
     // tla+ log vars
     cJSON_AddItemToObject(pRoot, "pLogStore", logStore2Json(pSyncNode->pLogStore));
@@ -1993,6 +2024,9 @@ void syncNodeDoConfigChange(SSyncNode* pSyncNode, SSyncCfg* pNewConfig, SyncInde
 
     syncIndexMgrUpdate(pSyncNode->pNextIndex, pSyncNode);
     syncIndexMgrUpdate(pSyncNode->pMatchIndex, pSyncNode);
+    syncIndexMgrUpdate(pSyncNode->pSentIndex, pSyncNode);
+    syncNodeResetSentIndex(pSyncNode);
+    syncIndexMgrUpdate(pSyncNode->pPeerBatchSize, pSyncNode);
     voteGrantedUpdate(pSyncNode->pVotesGranted, pSyncNode);
     votesRespondUpdate(pSyncNode->pVotesRespond, pSyncNode);
 
@@ -2235,6 +2269,8 @@ void syncNodeBecomeLeader(SSyncNode* pSyncNode, const char* debugStr) {
     pSyncNode->pMatchIndex->index[i] = SYNC_INDEX_INVALID;
   }
 
+  syncNodeResetSentIndex(pSyncNode);
+
   // update sender private term
   SSyncSnapshotSender* pMySender = syncNodeGetSnapshotSender(pSyncNode, &(pSyncNode->myRaftId));
   if (pMySender != NULL) {
@@ -2648,7 +2684,7 @@ static int32_t syncNodeEqNoop(SSyncNode* ths) {
 
 static void deleteCacheEntry(const void* key, size_t keyLen, void* value) { taosMemoryFree(value); }
 
-static int32_t syncCacheEntry(SSyncLogStore* pLogStore, SSyncRaftEntry* pEntry, LRUHandle** h) {
+int32_t syncCacheEntry(SSyncLogStore* pLogStore, SSyncRaftEntry* pEntry, LRUHandle** h) {
   int       code = 0;
   int       entryLen = sizeof(*pEntry) + pEntry->dataLen;
   LRUStatus status = taosLRUCacheInsert(pLogStore->pCache, &pEntry->index, sizeof(pEntry->index), pEntry, entryLen,
@@ -2660,6 +2696,72 @@ static int32_t syncCacheEntry(SSyncLogStore* pLogStore, SSyncRaftEntry* pEntry,
   return code;
 }
 
+// a successful reply acks the entries as persisted, so it is held while they wait for the wal group commit, a later
+// reply replaces the held one. Takes the ownership of pReply.
+int32_t syncNodeSendAppendEntriesReply(SSyncNode* ths, SyncAppendEntriesReply* pReply) {
+  if (pReply->success && pReply->matchIndex > logStoreWalFlushIndex(ths->pLogStore)) {
+    syncAppendEntriesReplyDestroy(ths->pPendingReply);
+    ths->pPendingReply = pReply;
+    return 0;
+  }
+
+  // msg event log
+  syncLogSendAppendEntriesReply(ths, pReply, "");
+
+  // send response
+  SRpcMsg rpcMsg;
+  syncAppendEntriesReply2RpcMsg(pReply, &rpcMsg);
+  int32_t code = syncNodeSendMsgById(&pReply->destId, ths, &rpcMsg);
+  syncAppendEntriesReplyDestroy(pReply);
+  return code;
+}
+
+void syncNodeEqWalFlush(SSyncNode* pSyncNode) {
+  SyncTimeout* pSyncMsg = syncTimeoutBuild2(SYNC_TIMEOUT_WAL_FLUSH, 0, 0, pSyncNode->vgId, pSyncNode);
+  SRpcMsg      rpcMsg;
+  syncTimeout2RpcMsg(pSyncMsg, &rpcMsg);
+  if (pSyncNode->FpEqMsg != NULL) {
+    int32_t code = pSyncNode->FpEqMsg(pSyncNode->msgcb, &rpcMsg);
+    if (code != 0) {
+      sError("vgId:%d, sync enqueue wal flush msg error, code:%d", pSyncNode->vgId, code);
+      rpcFreeCont(rpcMsg.pCont);
+    }
+  } else {
+    rpcFreeCont(rpcMsg.pCont);
+  }
+  syncTimeoutDestroy(pSyncMsg);
+}
+
+// a wal group is written out, the entries in it can be committed and acked now
+int32_t syncNodeOnWalFlushed(SSyncNode* ths) {
+  SyncIndex flushIndex = logStoreWalFlushIndex(ths->pLogStore);
+  SyncIndex lastIndex = ths->pLogStore->syncLogLastIndex(ths->pLogStore);
+
+  // the entries of a failed group are dropped from the wal, drop them from the cache too
+  for (SyncIndex index = lastIndex + 1;; ++index) {
+    LRUHandle* h = taosLRUCacheLookup(ths->pLogStore->pCache, &index, sizeof(index));
+    if (h == NULL) break;
+    taosLRUCacheRelease(ths->pLogStore->pCache, h, false);
+    taosLRUCacheErase(ths->pLogStore->pCache, &index, sizeof(index));
+  }
+
+  if (ths->state == TAOS_SYNC_STATE_LEADER) {
+    syncMaybeAdvanceCommitIndex(ths);
+  }
+
+  SyncAppendEntriesReply* pReply = ths->pPendingReply;
+  if (pReply != NULL && pReply->matchIndex <= flushIndex) {
+    ths->pPendingReply = NULL;
+    syncNodeSendAppendEntriesReply(ths, pReply);
+  } else if (pReply != NULL && pReply->matchIndex > lastIndex) {
+    // its entries are lost, the leader sends them again
+    ths->pPendingReply = NULL;
+    syncAppendEntriesReplyDestroy(pReply);
+  }
+
+  return 0;
+}
+
 static int32_t syncNodeAppendNoop(SSyncNode* ths) {
   int32_t ret = 0;
 
@@ -3026,8 +3128,9 @@ static int32_t syncNodeProposeConfigChangeFinish(SSyncNode* ths, SyncReconfigFin
   return 0;
 }
 
+// with wal group commit, a write is applied and acked by the commit of its entry, after its group is written out
 bool syncNodeIsOptimizedOneReplica(SSyncNode* ths, SRpcMsg* pMsg) {
-  return (ths->replicaNum == 1 && syncUtilUserCommit(pMsg->msgType) && ths->vgId != 1);
+  return (ths->replicaNum == 1 && syncUtilUserCommit(pMsg->msgType) && ths->vgId != 1 && tsWalGroupCommitMs <= 0);
 }
 
 int32_t syncNodeCommit(SSyncNode* ths, SyncIndex beginIndex, SyncIndex endIndex, uint64_t flag) {
@@ -3076,7 +3179,7 @@ int32_t syncNodeCommit(SSyncNode* ths, SyncIndex beginIndex, SyncIndex endIndex,
         // user commit
         if ((ths->pFsm->FpCommitCb != NULL) && syncUtilUserCommit(pEntry->originalRpcType)) {
           bool internalExecute = true;
-          if ((ths->replicaNum == 1) && ths->restoreFinish && ths->vgId != 1) {
+          if ((ths->replicaNum == 1) && ths->restoreFinish && ths->vgId != 1 && tsWalGroupCommitMs <= 0) {
             internalExecute = false;
           }
 
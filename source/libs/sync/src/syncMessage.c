@@ -1844,6 +1844,7 @@ SyncAppendEntriesReply* syncAppendEntriesReplyBuild(int32_t vgId) {
   pMsg->bytes = bytes;
   pMsg->vgId = vgId;
   pMsg->msgType = TDMT_SYNC_APPEND_ENTRIES_REPLY;
+  pMsg->batchSize = SYNC_MAX_APPEND_BATCH_SIZE;
   return pMsg;
 }
 
@@ -1861,6 +1862,11 @@ void syncAppendEntriesReplySerialize(const SyncAppendEntriesReply* pMsg, char* b
 void syncAppendEntriesReplyDeserialize(const char* buf, uint32_t len, SyncAppendEntriesReply* pMsg) {
   memcpy(pMsg, buf, len);
   ASSERT(len == pMsg->bytes);
+
+  // the reply of an older version is shorter, the fields it does not have are zero
+  if (len < sizeof(SyncAppendEntriesReply)) {
+    memset((char*)pMsg + len, 0, sizeof(SyncAppendEntriesReply) - len);
+  }
 }
 
 char* syncAppendEntriesReplySerialize2(const SyncAppendEntriesReply* pMsg, uint32_t* len) {
@@ -1875,7 +1881,7 @@ char* syncAppendEntriesReplySerialize2(const SyncAppendEntriesReply* pMsg, uint3
 
 SyncAppendEntriesReply* syncAppendEntriesReplyDeserialize2(const char* buf, uint32_t len) {
   uint32_t                bytes = *((uint32_t*)buf);
-  SyncAppendEntriesReply* pMsg = taosMemoryMalloc(bytes);
+  SyncAppendEntriesReply* pMsg = taosMemoryMalloc(TMAX(bytes, sizeof(SyncAppendEntriesReply)));
   ASSERT(pMsg != NULL);
   syncAppendEntriesReplyDeserialize(buf, len, pMsg);
   ASSERT(len == pMsg->bytes);
@@ -1949,6 +1955,7 @@ cJSON* syncAppendEntriesReply2Json(const SyncAppendEntriesReply* pMsg) {
     cJSON_AddStringToObject(pRoot, "matchIndex", u64buf);
     snprintf(u64buf, sizeof(u64buf), "%" PRId64, pMsg->startTime);
     cJSON_AddStringToObject(pRoot, "startTime", u64buf);
+    cJSON_AddNumberToObject(pRoot, "batchSize", pMsg->batchSize);
   }
 
   cJSON* pJson = cJSON_CreateObject();
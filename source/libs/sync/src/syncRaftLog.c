@@ -47,6 +47,7 @@ static int32_t         logStoreAppendEntry(SSyncLogStore* pLogStore, SSyncRaftEn
 static int32_t         logStoreTruncate(SSyncLogStore* pLogStore, SyncIndex fromIndex);
 static int32_t         logStoreUpdateCommitIndex(SSyncLogStore* pLogStore, SyncIndex index);
 static SyncIndex       logStoreGetCommitIndex(SSyncLogStore* pLogStore);
+static void            logStoreWalFlushed(void* param, int64_t ver);
 
 //-------------------------------
 SSyncLogStore* logStoreCreate(SSyncNode* pSyncNode) {
@@ -73,6 +74,7 @@ SSyncLogStore* logStoreCreate(SSyncNode* pSyncNode) {
   taosThreadMutexInit(&(pData->mutex), NULL);
   pData->pWalHandle = walOpenReader(pData->pWal, NULL);
   ASSERT(pData->pWalHandle != NULL);
+  walSetFlushCb(pData->pWal, logStoreWalFlushed, pSyncNode);
 
   pLogStore->appendEntry = logStoreAppendEntry;
   pLogStore->getEntry = logStoreGetEntry;
@@ -101,6 +103,7 @@ SSyncLogStore* logStoreCreate(SSyncNode* pSyncNode) {
 void logStoreDestory(SSyncLogStore* pLogStore) {
   if (pLogStore != NULL) {
     SSyncLogStoreData* pData = pLogStore->data;
+    walSetFlushCb(pData->pWal, NULL, NULL);
 
     taosThreadMutexLock(&(pData->mutex));
     if (pData->pWalHandle != NULL) {
@@ -142,6 +145,7 @@ static int32_t raftLogRestoreFromSnapshot(struct SSyncLogStore* pLogStore, SyncI
     return -1;
   }
 
+  taosLRUCacheEraseUnrefEntries(pLogStore->pCache);
   return 0;
 }
 
@@ -260,6 +264,19 @@ static int32_t raftLogGetEntry(struct SSyncLogStore* pLogStore, SyncIndex index,
 
   *ppEntry = NULL;
 
+  // recently written entries are still in the cache, no need to read them back from wal
+  LRUHandle* h = taosLRUCacheLookup(pLogStore->pCache, &index, sizeof(index));
+  if (h) {
+    SSyncRaftEntry* pCacheEntry = (SSyncRaftEntry*)taosLRUCacheValue(pLogStore->pCache, h);
+    *ppEntry = syncEntryBuild(pCacheEntry->dataLen);
+    ASSERT(*ppEntry != NULL);
+    memcpy(*ppEntry, pCacheEntry, pCacheEntry->bytes);
+    (*ppEntry)->msgType = TDMT_SYNC_CLIENT_REQUEST;
+    (*ppEntry)->rid = -1;
+    taosLRUCacheRelease(pLogStore->pCache, h, false);
+    return 0;
+  }
+
   // SWalReadHandle* pWalHandle = walOpenReadHandle(pWal);
   SWalReader* pWalHandle = pData->pWalHandle;
   if (pWalHandle == NULL) {
@@ -330,6 +347,11 @@ static int32_t raftLogTruncate(struct SSyncLogStore* pLogStore, SyncIndex fromIn
     return 0;
   }
 
+  // entries with the same index will be written again, maybe with another term
+  for (SyncIndex index = fromIndex; index <= wallastVer; ++index) {
+    taosLRUCacheErase(pLogStore->pCache, &index, sizeof(index));
+  }
+
   int32_t code = walRollback(pWal, fromIndex);
   if (code != 0) {
     int32_t     err = terrno;
@@ -476,6 +498,12 @@ SSyncRaftEntry* logStoreGetEntry(SSyncLogStore* pLogStore, SyncIndex index) {
 int32_t logStoreTruncate(SSyncLogStore* pLogStore, SyncIndex fromIndex) {
   SSyncLogStoreData* pData = pLogStore->data;
   SWal*              pWal = pData->pWal;
+
+  SyncIndex wallastVer = walGetLastVer(pWal);
+  for (SyncIndex index = fromIndex; index <= wallastVer; ++index) {
+    taosLRUCacheErase(pLogStore->pCache, &index, sizeof(index));
+  }
+
   // ASSERT(walRollback(pWal, fromIndex) == 0);
   int32_t code = walRollback(pWal, fromIndex);
   if (code != 0) {
@@ -666,6 +694,16 @@ SyncIndex logStoreWalCommitVer(SSyncLogStore* pLogStore) {
   return walGetCommittedVer(pWal);
 }
 
+// the last index written out by the wal group commit, the entries after it may still be lost
+SyncIndex logStoreWalFlushIndex(SSyncLogStore* pLogStore) {
+  SSyncLogStoreData* pData = pLogStore->data;
+  SWal*              pWal = pData->pWal;
+  return walGetFlushedVer(pWal);
+}
+
+// called by the wal, maybe in its own thread, so the sync node is notified through its queue
+static void logStoreWalFlushed(void* param, int64_t ver) { syncNodeEqWalFlush((SSyncNode*)param); }
+
 // for debug -----------------
 void logStorePrint(SSyncLogStore* pLogStore) {
   char* serialized = logStore2Str(pLogStore);
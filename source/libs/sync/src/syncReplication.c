@@ -116,8 +116,10 @@ int32_t syncNodeAppendEntriesPeers(SSyncNode* pSyncNode) {
   return ret;
 }
 
-int32_t syncNodeAppendEntriesOnePeer(SSyncNode* pSyncNode, SRaftId* pDestId, SyncIndex nextIndex) {
+static int32_t syncNodeDoAppendEntriesOnePeer(SSyncNode* pSyncNode, SRaftId* pDestId, SyncIndex nextIndex,
+                                              int32_t* pCount) {
   int32_t ret = 0;
+  *pCount = 0;
 
   // pre index, pre term
   SyncIndex preLogIndex = syncNodeGetPreIndex(pSyncNode, nextIndex);
@@ -128,6 +130,7 @@ int32_t syncNodeAppendEntriesOnePeer(SSyncNode* pSyncNode, SRaftId* pDestId, Syn
 
     syncIndexMgrSetIndex(pSyncNode->pNextIndex, pDestId, newNextIndex);
     syncIndexMgrSetIndex(pSyncNode->pMatchIndex, pDestId, SYNC_INDEX_INVALID);
+    syncIndexMgrSetIndex(pSyncNode->pSentIndex, pDestId, SYNC_INDEX_INVALID);
     sError("vgId:%d, sync get pre term error, nextIndex:%" PRId64 ", update next-index:%" PRId64
            ", match-index:%d, raftid:%" PRId64,
            pSyncNode->vgId, nextIndex, newNextIndex, SYNC_INDEX_INVALID, pDestId->addr);
@@ -135,19 +138,22 @@ int32_t syncNodeAppendEntriesOnePeer(SSyncNode* pSyncNode, SRaftId* pDestId, Syn
   }
 
   // entry pointer array
-  SSyncRaftEntry* entryPArr[SYNC_MAX_BATCH_SIZE];
+  SSyncRaftEntry* entryPArr[SYNC_MAX_APPEND_BATCH_SIZE];
   memset(entryPArr, 0, sizeof(entryPArr));
 
-  // get entry batch
+  // get entry batch, entries are read from the log cache if they are recently written
   int32_t   getCount = 0;
+  int64_t   getBytes = 0;
+  int32_t   batchSize = syncNodePeerBatchSize(pSyncNode, pDestId);
   SyncIndex getEntryIndex = nextIndex;
-  for (int32_t i = 0; i < pSyncNode->pRaftCfg->batchSize; ++i) {
+  for (int32_t i = 0; i < batchSize && getBytes < SYNC_MAX_APPEND_BATCH_BYTES; ++i) {
     SSyncRaftEntry* pEntry = NULL;
     int32_t         code = pSyncNode->pLogStore->syncLogGetEntry(pSyncNode->pLogStore, getEntryIndex, &pEntry);
     if (code == 0) {
       ASSERT(pEntry != NULL);
       entryPArr[i] = pEntry;
       getCount++;
+      getBytes += pEntry->bytes;
       getEntryIndex++;
 
     } else {
@@ -170,7 +176,7 @@ int32_t syncNodeAppendEntriesOnePeer(SSyncNode* pSyncNode, SRaftId* pDestId, Syn
   ASSERT(pMsg != NULL);
 
   // free entries
-  for (int32_t i = 0; i < pSyncNode->pRaftCfg->batchSize; ++i) {
+  for (int32_t i = 0; i < getCount; ++i) {
     SSyncRaftEntry* pEntry = entryPArr[i];
     if (pEntry != NULL) {
       syncEntryDestory(pEntry);
@@ -190,6 +196,7 @@ int32_t syncNodeAppendEntriesOnePeer(SSyncNode* pSyncNode, SRaftId* pDestId, Syn
 
   // send msg
   syncNodeAppendEntriesBatch(pSyncNode, pDestId, pMsg);
+  *pCount = getCount;
 
   // speed up
   if (pMsg->dataCount > 0 && pSyncNode->commitIndex - pMsg->prevLogIndex > SYNC_SLOW_DOWN_RANGE) {
@@ -212,6 +219,61 @@ int32_t syncNodeAppendEntriesOnePeer(SSyncNode* pSyncNode, SRaftId* pDestId, Syn
   return ret;
 }
 
+int32_t syncNodeAppendEntriesOnePeer(SSyncNode* pSyncNode, SRaftId* pDestId, SyncIndex nextIndex) {
+  int32_t count = 0;
+  return syncNodeDoAppendEntriesOnePeer(pSyncNode, pDestId, nextIndex, &count);
+}
+
+// one entry each time until the peer replies with the batch size it accepts, a follower of an older version
+// asserts on a batch of more entries
+int32_t syncNodePeerBatchSize(SSyncNode* pSyncNode, const SRaftId* pDestId) {
+  int64_t peerBatchSize = syncIndexMgrGetIndex(pSyncNode->pPeerBatchSize, pDestId);
+  int32_t batchSize = TMIN(pSyncNode->pRaftCfg->batchSize, SYNC_MAX_APPEND_BATCH_SIZE);
+  return TMAX(TMIN(batchSize, peerBatchSize), 1);
+}
+
+void syncNodeResetSentIndex(SSyncNode* pSyncNode) {
+  for (int i = 0; i < pSyncNode->pSentIndex->replicaNum; ++i) {
+    pSyncNode->pSentIndex->index[i] = SYNC_INDEX_INVALID;
+  }
+}
+
+// send batches following the ones still in flight, up to SYNC_MAX_INFLIGHT_BATCHES batches are not replied.
+// if force and nothing is in flight, send one message at least, even if it is empty
+int32_t syncNodeAppendEntriesPipeline(SSyncNode* pSyncNode, SRaftId* pDestId, bool force) {
+  int32_t   ret = 0;
+  SyncIndex nextIndex = syncIndexMgrGetIndex(pSyncNode->pNextIndex, pDestId);
+  SyncIndex sentIndex = syncIndexMgrGetIndex(pSyncNode->pSentIndex, pDestId);
+  SyncIndex lastIndex = syncNodeGetLastIndex(pSyncNode);
+  int64_t   window = (int64_t)syncNodePeerBatchSize(pSyncNode, pDestId) * SYNC_MAX_INFLIGHT_BATCHES;
+
+  if (sentIndex >= nextIndex) {
+    // the replies of batches in flight will bring new ones
+    force = false;
+  } else {
+    sentIndex = nextIndex - 1;
+  }
+
+  while (force || (sentIndex < lastIndex && sentIndex - nextIndex + 1 < window)) {
+    int32_t count = 0;
+    int32_t code = syncNodeDoAppendEntriesOnePeer(pSyncNode, pDestId, sentIndex + 1, &count);
+    if (code < 0) {
+      return code;
+    }
+
+    ret = TMAX(ret, code);
+    sentIndex += count;
+    syncIndexMgrSetIndex(pSyncNode->pSentIndex, pDestId, sentIndex);
+
+    force = false;
+    if (count == 0) {
+      break;
+    }
+  }
+
+  return ret;
+}
+
 int32_t syncNodeAppendEntriesPeersSnapshot2(SSyncNode* pSyncNode) {
   if (pSyncNode->state != TAOS_SYNC_STATE_LEADER) {
     return -1;
@@ -220,10 +282,7 @@ int32_t syncNodeAppendEntriesPeersSnapshot2(SSyncNode* pSyncNode) {
   int32_t ret = 0;
   for (int i = 0; i < pSyncNode->peersNum; ++i) {
     SRaftId* pDestId = &(pSyncNode->peersId[i]);
-
-    // next index
-    SyncIndex nextIndex = syncIndexMgrGetIndex(pSyncNode->pNextIndex, pDestId);
-    ret = syncNodeAppendEntriesOnePeer(pSyncNode, pDestId, nextIndex);
+    ret = syncNodeAppendEntriesPipeline(pSyncNode, pDestId, true);
   }
 
   return ret;
@@ -433,6 +492,10 @@ int32_t syncNodeReplicate(SSyncNode* pSyncNode, bool isTimer) {
       break;
 
     case SYNC_STRATEGY_WAL_FIRST:
+      // batches in flight may be lost, send from next index again on timer
+      if (isTimer) {
+        syncNodeResetSentIndex(pSyncNode);
+      }
       ret = syncNodeAppendEntriesPeersSnapshot2(pSyncNode);
       break;
 
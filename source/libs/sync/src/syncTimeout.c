@@ -103,6 +103,8 @@ int32_t syncNodeOnTimeoutCb(SSyncNode* ths, SyncTimeout* pMsg) {
              ths->heartbeatTimerCounter, ths->heartbeatTimerLogicClockUser);
       syncNodeReplicate(ths, true);
     }
+  } else if (pMsg->timeoutType == SYNC_TIMEOUT_WAL_FLUSH) {
+    syncNodeOnWalFlushed(ths);
   } else {
     sError("vgId:%d, unknown timeout-type:%d", ths->vgId, pMsg->timeoutType);
   }
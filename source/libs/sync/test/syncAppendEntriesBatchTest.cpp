@@ -1,9 +1,14 @@
 //#include <gtest/gtest.h>
 #include <stdio.h>
+#include <vector>
 #include "syncIO.h"
 #include "syncInt.h"
+#include "syncIndexMgr.h"
 #include "syncMessage.h"
+#include "syncRaftCfg.h"
 #include "syncRaftEntry.h"
+#include "syncRaftStore.h"
+#include "syncReplication.h"
 #include "syncUtil.h"
 #include "trpc.h"
 
@@ -120,6 +125,149 @@ void test5() {
 }
 */
 
+// a leader with one peer, the log holds entries [0, LOG_ENTRY_NUM), the sent messages are captured
+#define LOG_ENTRY_NUM 1000
+
+SSyncNode              *pLeader;
+SRaftId                 peerId;
+std::vector<SyncAppendEntriesBatch *> sentMsgs;
+
+int32_t testLogGetEntry(SSyncLogStore *pLogStore, SyncIndex index, SSyncRaftEntry **ppEntry) {
+  if (index < SYNC_INDEX_BEGIN || index >= LOG_ENTRY_NUM) {
+    return -1;
+  }
+  *ppEntry = createEntry(index);
+  (*ppEntry)->index = index;
+  (*ppEntry)->term = 1;
+  return 0;
+}
+
+SyncIndex testLogLastIndex(SSyncLogStore *pLogStore) { return LOG_ENTRY_NUM - 1; }
+SyncIndex testLogBeginIndex(SSyncLogStore *pLogStore) { return SYNC_INDEX_BEGIN; }
+
+int32_t testSendMsg(const SEpSet *pEpSet, SRpcMsg *pMsg) {
+  syncUtilMsgNtoH(pMsg->pCont);
+  sentMsgs.push_back(syncAppendEntriesBatchFromRpcMsg2(pMsg));
+  rpcFreeCont(pMsg->pCont);
+  return 0;
+}
+
+void clearSentMsgs() {
+  for (SyncAppendEntriesBatch *pMsg : sentMsgs) {
+    syncAppendEntriesBatchDestroy(pMsg);
+  }
+  sentMsgs.clear();
+}
+
+void createLeader() {
+  pLeader = (SSyncNode *)taosMemoryCalloc(1, sizeof(SSyncNode));
+  pLeader->vgId = 1234;
+  pLeader->state = TAOS_SYNC_STATE_LEADER;
+  pLeader->replicaNum = 2;
+  pLeader->replicasId[0].addr = syncUtilAddr2U64("127.0.0.1", 7010);
+  pLeader->replicasId[0].vgId = 1234;
+  pLeader->replicasId[1].addr = syncUtilAddr2U64("127.0.0.1", 7110);
+  pLeader->replicasId[1].vgId = 1234;
+  pLeader->myRaftId = pLeader->replicasId[0];
+  pLeader->peersNum = 1;
+  pLeader->peersId[0] = pLeader->replicasId[1];
+  peerId = pLeader->replicasId[1];
+
+  pLeader->pRaftCfg = (SRaftCfg *)taosMemoryCalloc(1, sizeof(SRaftCfg));
+  pLeader->pRaftCfg->batchSize = SYNC_MAX_APPEND_BATCH_SIZE;
+  pLeader->pRaftCfg->snapshotStrategy = SYNC_STRATEGY_WAL_FIRST;
+  pLeader->pRaftStore = (SRaftStore *)taosMemoryCalloc(1, sizeof(SRaftStore));
+  pLeader->pRaftStore->currentTerm = 1;
+  pLeader->pFsm = (SSyncFSM *)taosMemoryCalloc(1, sizeof(SSyncFSM));
+  pLeader->pLogStore = (SSyncLogStore *)taosMemoryCalloc(1, sizeof(SSyncLogStore));
+  pLeader->pLogStore->syncLogGetEntry = testLogGetEntry;
+  pLeader->pLogStore->syncLogLastIndex = testLogLastIndex;
+  pLeader->pLogStore->syncLogBeginIndex = testLogBeginIndex;
+  pLeader->FpSendMsg = testSendMsg;
+
+  pLeader->pNextIndex = syncIndexMgrCreate(pLeader);
+  pLeader->pMatchIndex = syncIndexMgrCreate(pLeader);
+  pLeader->pSentIndex = syncIndexMgrCreate(pLeader);
+  pLeader->pPeerBatchSize = syncIndexMgrCreate(pLeader);
+}
+
+void destroyLeader() {
+  clearSentMsgs();
+  syncIndexMgrDestroy(pLeader->pNextIndex);
+  syncIndexMgrDestroy(pLeader->pMatchIndex);
+  syncIndexMgrDestroy(pLeader->pSentIndex);
+  syncIndexMgrDestroy(pLeader->pPeerBatchSize);
+  taosMemoryFree(pLeader->pLogStore);
+  taosMemoryFree(pLeader->pFsm);
+  taosMemoryFree(pLeader->pRaftStore);
+  taosMemoryFree(pLeader->pRaftCfg);
+  taosMemoryFree(pLeader);
+}
+
+// send from the first index with nothing in flight, check each message carries consecutive entries of the batch size
+void checkPipeline(int32_t batchSize) {
+  clearSentMsgs();
+  syncIndexMgrSetIndex(pLeader->pNextIndex, &peerId, SYNC_INDEX_BEGIN);
+  syncNodeResetSentIndex(pLeader);
+  assert(syncNodePeerBatchSize(pLeader, &peerId) == batchSize);
+
+  syncNodeAppendEntriesPipeline(pLeader, &peerId, true);
+  assert(sentMsgs.size() == SYNC_MAX_INFLIGHT_BATCHES);
+
+  SyncIndex index = SYNC_INDEX_BEGIN;
+  for (SyncAppendEntriesBatch *pMsg : sentMsgs) {
+    assert(pMsg->dataCount == batchSize);
+    assert(pMsg->prevLogIndex == index - 1);
+
+    SOffsetAndContLen *metaArr = syncAppendEntriesBatchMetaTableArray(pMsg);
+    for (int32_t i = 0; i < pMsg->dataCount; ++i) {
+      SSyncRaftEntry *pEntry = (SSyncRaftEntry *)(pMsg->data + metaArr[i].offset);
+      assert(pEntry->bytes == metaArr[i].contLen);
+      assert(pEntry->index == index);
+      index++;
+    }
+  }
+  assert(syncIndexMgrGetIndex(pLeader->pSentIndex, &peerId) == index - 1);
+}
+
+// the reply goes through the rpc message as a follower sends it, a shorter one is from a version before batching
+void recvReply(uint32_t replyBytes) {
+  SyncAppendEntriesReply *pReply = syncAppendEntriesReplyBuild(1234);
+  pReply->srcId = peerId;
+  pReply->bytes = replyBytes;
+
+  SRpcMsg rpcMsg;
+  syncAppendEntriesReply2RpcMsg(pReply, &rpcMsg);
+  SyncAppendEntriesReply *pReply2 = syncAppendEntriesReplyFromRpcMsg2(&rpcMsg);
+  syncIndexMgrSetIndex(pLeader->pPeerBatchSize, &peerId, pReply2->batchSize);
+
+  rpcFreeCont(rpcMsg.pCont);
+  syncAppendEntriesReplyDestroy(pReply);
+  syncAppendEntriesReplyDestroy(pReply2);
+}
+
+void test2() {
+  createLeader();
+
+  // the peer has not replied, it may be a version which accepts one entry only
+  checkPipeline(1);
+
+  // a reply tells the batch size accepted by the peer
+  recvReply(sizeof(SyncAppendEntriesReply));
+  checkPipeline(SYNC_MAX_APPEND_BATCH_SIZE);
+
+  // the peer is replaced by an older version
+  recvReply(offsetof(SyncAppendEntriesReply, batchSize));
+  checkPipeline(1);
+
+  // the raft cfg saved by an older version
+  recvReply(sizeof(SyncAppendEntriesReply));
+  pLeader->pRaftCfg->batchSize = 1;
+  checkPipeline(1);
+
+  destroyLeader();
+}
+
 int main() {
   gRaftDetailLog = true;
   tsAsyncLog = 0;
@@ -127,6 +275,7 @@ int main() {
   logTest();
 
   test1();
+  test2();
 
   /*
    test2();
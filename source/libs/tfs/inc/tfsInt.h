@@ -80,6 +80,7 @@ void      tfsDestroyTier(STfsTier *pTier);
 STfsDisk *tfsMountDiskToTier(STfsTier *pTier, SDiskCfg *pCfg);
 void      tfsUpdateTierSize(STfsTier *pTier);
 int32_t   tfsAllocDiskOnTier(STfsTier *pTier);
+int32_t   tfsAllocDiskOnTierBySize(STfsTier *pTier, int64_t size);
 void      tfsPosNextId(STfsTier *pTier);
 
 #define tfsLockTier(pTier) taosThreadSpinLock(&(pTier)->lock)
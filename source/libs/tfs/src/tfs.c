@@ -141,6 +141,32 @@ int32_t tfsAllocDisk(STfs *pTfs, int32_t expLevel, SDiskID *pDiskId) {
   return -1;
 }
 
+int32_t tfsAllocDiskBySize(STfs *pTfs, int32_t expLevel, int64_t size, SDiskID *pDiskId) {
+  pDiskId->level = TMAX(TMIN(expLevel, pTfs->nlevel - 1), 0);
+  pDiskId->id = -1;
+
+  while (pDiskId->level >= 0) {
+    pDiskId->id = tfsAllocDiskOnTierBySize(&pTfs->tiers[pDiskId->level], size);
+    if (pDiskId->id < 0) {
+      pDiskId->level--;
+      continue;
+    }
+
+    return 0;
+  }
+
+  terrno = TSDB_CODE_FS_NO_VALID_DISK;
+  return -1;
+}
+
+void tfsReserveDiskSize(STfs *pTfs, SDiskID diskId, int64_t size) {
+  STfsTier *pTier = TFS_TIER_AT(pTfs, diskId.level);
+
+  tfsLockTier(pTier);
+  TFS_DISK_AT(pTfs, diskId)->size.avail -= size;
+  tfsUnLockTier(pTier);
+}
+
 const char *tfsGetPrimaryPath(STfs *pTfs) { return TFS_PRIMARY_DISK(pTfs)->path; }
 
 const char *tfsGetDiskPath(STfs *pTfs, SDiskID diskId) { return TFS_DISK_AT(pTfs, diskId)->path; }
@@ -126,6 +126,38 @@ int32_t tfsAllocDiskOnTier(STfsTier *pTier) {
   return retId;
 }
 
+// Allocate the disk with the most free space
+int32_t tfsAllocDiskOnTierBySize(STfsTier *pTier, int64_t size) {
+  terrno = TSDB_CODE_FS_NO_VALID_DISK;
+
+  tfsLockTier(pTier);
+
+  if (pTier->ndisk <= 0 || pTier->nAvailDisks <= 0) {
+    tfsUnLockTier(pTier);
+    return -1;
+  }
+
+  int32_t retId = -1;
+  for (int32_t id = 0; id < pTier->ndisk; ++id) {
+    STfsDisk *pDisk = pTier->disks[id];
+
+    if (pDisk == NULL) continue;
+
+    if (pDisk->size.avail - size < TFS_MIN_DISK_FREE_SIZE) continue;
+
+    if (retId < 0 || pDisk->size.avail > pTier->disks[retId]->size.avail) {
+      retId = id;
+    }
+  }
+
+  if (retId >= 0) {
+    terrno = 0;
+  }
+
+  tfsUnLockTier(pTier);
+  return retId;
+}
+
 void tfsPosNextId(STfsTier *pTier) {
   int32_t nextid = 0;
 
@@ -159,6 +159,10 @@ int64_t walGetSeq();
 int     walSeekWriteVer(SWal* pWal, int64_t ver);
 int32_t walRollImpl(SWal* pWal);
 
+// group commit
+int32_t walFlushWriteBuf(SWal* pWal);
+void    walFlushBeforeRead(SWal* pWal, int64_t ver);
+
 #ifdef __cplusplus
 }
 #endif
@@ -35,6 +35,14 @@ int64_t FORCE_INLINE walGetCommittedVer(SWal* pWal) { return pWal->vers.commitVe
 
 int64_t FORCE_INLINE walGetAppliedVer(SWal* pWal) { return pWal->vers.appliedVer; }
 
+// entries after the flushed version are still buffered by group commit
+int64_t walGetFlushedVer(SWal* pWal) {
+  taosThreadMutexLock(&pWal->mutex);
+  int64_t ver = (pWal->bufFirstVer == -1) ? pWal->vers.lastVer : pWal->bufFirstVer - 1;
+  taosThreadMutexUnlock(&pWal->mutex);
+  return ver;
+}
+
 static FORCE_INLINE int walBuildMetaName(SWal* pWal, int metaVer, char* buf) {
   return sprintf(buf, "%s/meta-ver%d", pWal->path, metaVer);
 }
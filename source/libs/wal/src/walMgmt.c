@@ -15,8 +15,10 @@
 
 #define _DEFAULT_SOURCE
 #include "os.h"
+#include "tRealloc.h"
 #include "taoserror.h"
 #include "tcompare.h"
+#include "tglobal.h"
 #include "tref.h"
 #include "walInt.h"
 
@@ -129,6 +131,7 @@ SWal *walOpen(const char *path, SWalCfg *pCfg) {
   memset(&pWal->writeHead, 0, sizeof(SWalCkHead));
   pWal->writeHead.head.protoVer = WAL_PROTO_VER;
   pWal->writeHead.magic = WAL_MAGIC;
+  pWal->bufFirstVer = -1;
 
   if (taosThreadMutexInit(&pWal->mutex, NULL) < 0) {
     taosArrayDestroy(pWal->fileInfoSet);
@@ -194,6 +197,11 @@ int32_t walAlter(SWal *pWal, SWalCfg *pCfg) {
 
 void walClose(SWal *pWal) {
   taosThreadMutexLock(&pWal->mutex);
+  walFlushWriteBuf(pWal);
+  tFree(pWal->pLogBuf);
+  pWal->pLogBuf = NULL;
+  tFree(pWal->pIdxBuf);
+  pWal->pIdxBuf = NULL;
   taosCloseFile(&pWal->pLogFile);
   pWal->pLogFile = NULL;
   taosCloseFile(&pWal->pIdxFile);
@@ -227,8 +235,32 @@ static bool walNeedFsync(SWal *pWal) {
   return false;
 }
 
+// write out the groups whose first entry has waited for the whole group commit window
+static void walFlushExpiredAll() {
+  SWal *pWal = taosIterateRef(tsWal.refSetId, 0);
+  while (pWal) {
+    if (atomic_load_64(&pWal->bufFirstVer) != -1) {
+      taosThreadMutexLock(&pWal->mutex);
+      if (pWal->bufFirstVer != -1 && taosGetTimestampMs() - pWal->bufFirstTs >= tsWalGroupCommitMs) {
+        walFlushWriteBuf(pWal);
+      }
+      taosThreadMutexUnlock(&pWal->mutex);
+    }
+    pWal = taosIterateRef(tsWal.refSetId, pWal->refId);
+  }
+}
+
 static void walUpdateSeq() {
-  taosMsleep(WAL_REFRESH_MS);
+  // read once, the window may be changed to 0 while sleeping
+  int32_t groupCommitMs = tsWalGroupCommitMs;
+  if (groupCommitMs <= 0) {
+    taosMsleep(WAL_REFRESH_MS);
+  } else {
+    for (int32_t elapsed = 0; elapsed < WAL_REFRESH_MS; elapsed += groupCommitMs) {
+      taosMsleep(TMIN(groupCommitMs, WAL_REFRESH_MS - elapsed));
+      walFlushExpiredAll();
+    }
+  }
   atomic_add_fetch_32(&tsWal.seq, 1);
 }
 
@@ -238,10 +270,15 @@ static void walFsyncAll() {
     if (walNeedFsync(pWal)) {
       wTrace("vgId:%d, do fsync, level:%d seq:%d rseq:%d", pWal->cfg.vgId, pWal->cfg.level, pWal->fsyncSeq,
              atomic_load_32(&tsWal.seq));
+      taosThreadMutexLock(&pWal->mutex);
+      walFlushWriteBuf(pWal);
+      taosThreadMutexUnlock(&pWal->mutex);
       int32_t code = taosFsyncFile(pWal->pLogFile);
       if (code != 0) {
         wError("vgId:%d, file:%" PRId64 ".log, failed to fsync since %s", pWal->cfg.vgId, walGetLastFileFirstVer(pWal),
                strerror(code));
+      } else {
+        atomic_add_fetch_64(&pWal->fsyncCnt, 1);
       }
     }
     pWal = taosIterateRef(tsWal.refSetId, pWal->refId);
@@ -265,6 +302,8 @@ static int32_t walCreateThread() {
   taosThreadAttrInit(&thAttr);
   taosThreadAttrSetDetachState(&thAttr, PTHREAD_CREATE_JOINABLE);
 
+  // the module may be initialized again after a clean up
+  atomic_store_8(&tsWal.stop, 0);
   if (taosThreadCreate(&tsWal.thread, &thAttr, walThreadFunc, NULL) != 0) {
     wError("failed to create wal thread since %s", strerror(errno));
     terrno = TAOS_SYSTEM_ERROR(errno);
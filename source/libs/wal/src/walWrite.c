@@ -14,8 +14,10 @@
  */
 
 #include "os.h"
+#include "tRealloc.h"
 #include "taoserror.h"
 #include "tchecksum.h"
+#include "tglobal.h"
 #include "walInt.h"
 
 int32_t walRestoreFromSnapshot(SWal *pWal, int64_t ver) {
@@ -32,6 +34,11 @@ int32_t walRestoreFromSnapshot(SWal *pWal, int64_t ver) {
     }
   }
 
+  // drop the buffered group, the files are removed anyway
+  pWal->nLogBuf = 0;
+  pWal->nIdxBuf = 0;
+  atomic_store_64(&pWal->bufFirstVer, -1);
+
   taosCloseFile(&pWal->pLogFile);
   taosCloseFile(&pWal->pIdxFile);
 
@@ -94,6 +101,11 @@ int32_t walRollback(SWal *pWal, int64_t ver) {
     return -1;
   }
 
+  if (walFlushWriteBuf(pWal) < 0) {
+    taosThreadMutexUnlock(&pWal->mutex);
+    return -1;
+  }
+
   // find correct file
   if (ver < walGetLastFileFirstVer(pWal)) {
     // change current files
@@ -263,6 +275,12 @@ int32_t walEndSnapshot(SWal *pWal) {
     goto END;
   };
 
+  // the meta saved below must not refer to buffered entries
+  code = walFlushWriteBuf(pWal);
+  if (code < 0) {
+    goto END;
+  }
+
   pWal->vers.snapshotVer = ver;
   int ts = taosGetTimestampSec();
 
@@ -337,6 +355,13 @@ END:
 
 int32_t walRollImpl(SWal *pWal) {
   int32_t code = 0;
+
+  // a group never spans two files
+  code = walFlushWriteBuf(pWal);
+  if (code != 0) {
+    goto END;
+  }
+
   if (pWal->pIdxFile != NULL) {
     code = taosCloseFile(&pWal->pIdxFile);
     if (code != 0) {
@@ -403,6 +428,84 @@ static int32_t walWriteIndex(SWal *pWal, int64_t ver, int64_t offset) {
   return 0;
 }
 
+int32_t walFlushWriteBuf(SWal *pWal) {
+  int32_t code = 0;
+
+  if (pWal->bufFirstVer == -1) return 0;
+
+  int64_t offset = walGetCurFileOffset(pWal) - pWal->nLogBuf;
+  int64_t idxOffset = walGetVerIdxOffset(pWal, pWal->bufFirstVer);
+
+  wDebug("vgId:%d, wal flush group, index:%" PRId64 "-%" PRId64 ", size:%" PRId64, pWal->cfg.vgId,
+         pWal->bufFirstVer, pWal->vers.lastVer, pWal->nLogBuf);
+
+  // log before idx, so an idx entry never points beyond the end of the log file. The group is fsynced as a whole,
+  // so the entries appended within one window share a single fsync
+  bool fsync = pWal->cfg.level == TAOS_WAL_FSYNC && pWal->cfg.fsyncPeriod == 0;
+  if (taosWriteFile(pWal->pLogFile, pWal->pLogBuf, pWal->nLogBuf) != pWal->nLogBuf ||
+      taosWriteFile(pWal->pIdxFile, pWal->pIdxBuf, pWal->nIdxBuf) != pWal->nIdxBuf ||
+      (fsync && taosFsyncFile(pWal->pLogFile) < 0)) {
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    wError("vgId:%d, file:%" PRId64 ".log, failed to write group since %s", pWal->cfg.vgId,
+           walGetLastFileFirstVer(pWal), strerror(errno));
+
+    // drop the whole group
+    taosFtruncateFile(pWal->pLogFile, offset);
+    taosFtruncateFile(pWal->pIdxFile, idxOffset);
+
+    SWalFileInfo *pInfo = walGetCurFileInfo(pWal);
+    pInfo->fileSize = offset;
+    pInfo->lastVer = pWal->bufFirstVer - 1;
+    if (pInfo->lastVer < pInfo->firstVer) pInfo->firstVer = -1;
+    pWal->totSize -= pWal->nLogBuf;
+    pWal->vers.lastVer = pWal->bufFirstVer - 1;
+    if (pWal->vers.lastVer < pWal->vers.firstVer) pWal->vers.firstVer = -1;
+    code = -1;
+  } else if (fsync) {
+    atomic_add_fetch_64(&pWal->fsyncCnt, 1);
+  }
+
+  pWal->nLogBuf = 0;
+  pWal->nIdxBuf = 0;
+  atomic_store_64(&pWal->bufFirstVer, -1);
+
+  // also called for a failed group, the owner learns from ver that its entries are dropped
+  if (pWal->fpFlushCb != NULL) {
+    pWal->fpFlushCb(pWal->flushParam, pWal->vers.lastVer);
+  }
+  return code;
+}
+
+void walFlushBeforeRead(SWal *pWal, int64_t ver) {
+  int64_t bufFirstVer = atomic_load_64(&pWal->bufFirstVer);
+  if (bufFirstVer == -1 || ver < bufFirstVer) return;
+
+  taosThreadMutexLock(&pWal->mutex);
+  walFlushWriteBuf(pWal);
+  taosThreadMutexUnlock(&pWal->mutex);
+}
+
+static int32_t walBufferEntry(SWal *pWal, int64_t ver, int64_t offset, const void *body, int32_t bodyLen) {
+  if (tRealloc(&pWal->pLogBuf, pWal->nLogBuf + sizeof(SWalCkHead) + bodyLen) != 0 ||
+      tRealloc(&pWal->pIdxBuf, pWal->nIdxBuf + sizeof(SWalIdxEntry)) != 0) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return -1;
+  }
+
+  SWalIdxEntry entry = {.ver = ver, .offset = offset};
+  memcpy(pWal->pLogBuf + pWal->nLogBuf, &pWal->writeHead, sizeof(SWalCkHead));
+  memcpy(pWal->pLogBuf + pWal->nLogBuf + sizeof(SWalCkHead), body, bodyLen);
+  memcpy(pWal->pIdxBuf + pWal->nIdxBuf, &entry, sizeof(SWalIdxEntry));
+  pWal->nLogBuf += sizeof(SWalCkHead) + bodyLen;
+  pWal->nIdxBuf += sizeof(SWalIdxEntry);
+
+  if (pWal->bufFirstVer == -1) {
+    pWal->bufFirstTs = taosGetTimestampMs();
+    atomic_store_64(&pWal->bufFirstVer, ver);
+  }
+  return 0;
+}
+
 // TODO  gurantee atomicity by truncate failed writing
 static FORCE_INLINE int32_t walWriteImpl(SWal *pWal, int64_t index, tmsg_t msgType, SWalSyncInfo syncMeta,
                                          const void *body, int32_t bodyLen) {
@@ -423,28 +526,27 @@ static FORCE_INLINE int32_t walWriteImpl(SWal *pWal, int64_t index, tmsg_t msgTy
 
   wDebug("vgId:%d, wal write log %ld, msgType: %s", pWal->cfg.vgId, index, TMSG_INFO(msgType));
 
-  if (taosWriteFile(pWal->pLogFile, &pWal->writeHead, sizeof(SWalCkHead)) != sizeof(SWalCkHead)) {
-    // TODO ftruncate
-    terrno = TAOS_SYSTEM_ERROR(errno);
-    wError("vgId:%d, file:%" PRId64 ".log, failed to write since %s", pWal->cfg.vgId, walGetLastFileFirstVer(pWal),
-           strerror(errno));
-    code = -1;
-    goto END;
-  }
-
-  if (taosWriteFile(pWal->pLogFile, (char *)body, bodyLen) != bodyLen) {
-    // TODO ftruncate
-    terrno = TAOS_SYSTEM_ERROR(errno);
-    wError("vgId:%d, file:%" PRId64 ".log, failed to write since %s", pWal->cfg.vgId, walGetLastFileFirstVer(pWal),
-           strerror(errno));
-    code = -1;
-    goto END;
-  }
+  if (tsWalGroupCommitMs > 0) {
+    // appended to the files by walFlushWriteBuf together with the rest of the group
+    if (walBufferEntry(pWal, index, offset, body, bodyLen) < 0) {
+      goto END;
+    }
+  } else {
+    TdIoVec iov[2] = {{.base = &pWal->writeHead, .len = sizeof(SWalCkHead)}, {.base = body, .len = bodyLen}};
+    if (taosWritevFile(pWal->pLogFile, iov, 2) != sizeof(SWalCkHead) + bodyLen) {
+      // TODO ftruncate
+      terrno = TAOS_SYSTEM_ERROR(errno);
+      wError("vgId:%d, file:%" PRId64 ".log, failed to write since %s", pWal->cfg.vgId, walGetLastFileFirstVer(pWal),
+             strerror(errno));
+      code = -1;
+      goto END;
+    }
 
-  code = walWriteIndex(pWal, index, offset);
-  if (code < 0) {
-    // TODO ftruncate
-    goto END;
+    code = walWriteIndex(pWal, index, offset);
+    if (code < 0) {
+      // TODO ftruncate
+      goto END;
+    }
   }
 
   // set status
@@ -457,6 +559,14 @@ static FORCE_INLINE int32_t walWriteImpl(SWal *pWal, int64_t index, tmsg_t msgTy
   walGetCurFileInfo(pWal)->lastVer = index;
   walGetCurFileInfo(pWal)->fileSize += sizeof(SWalCkHead) + bodyLen;
 
+  // close the group once it is large enough or its first entry has waited long enough
+  if (pWal->bufFirstVer != -1 &&
+      (pWal->nLogBuf >= WAL_GROUP_BUF_SIZE || taosGetTimestampMs() - pWal->bufFirstTs >= tsWalGroupCommitMs)) {
+    if (walFlushWriteBuf(pWal) < 0) {
+      goto END;
+    }
+  }
+
   return 0;
 END:
   return -1;
@@ -537,12 +647,37 @@ int32_t walWrite(SWal *pWal, int64_t index, tmsg_t msgType, const void *body, in
   return walWriteWithSyncInfo(pWal, index, msgType, syncMeta, body, bodyLen);
 }
 
-void walFsync(SWal *pWal, bool forceFsync) {
+int32_t walFsync(SWal *pWal, bool forceFsync) {
+  // with group commit, a group is written and fsynced by itself once it is closed by size or time, so the end of a
+  // batch does not close it unless forced
+  if (!forceFsync && tsWalGroupCommitMs > 0) {
+    return 0;
+  }
+
+  taosThreadMutexLock(&pWal->mutex);
+  int32_t code = walFlushWriteBuf(pWal);
+  taosThreadMutexUnlock(&pWal->mutex);
+  if (code < 0) {
+    return -1;
+  }
+
   if (forceFsync || (pWal->cfg.level == TAOS_WAL_FSYNC && pWal->cfg.fsyncPeriod == 0)) {
     wTrace("vgId:%d, fileId:%" PRId64 ".log, do fsync", pWal->cfg.vgId, walGetCurFileFirstVer(pWal));
     if (taosFsyncFile(pWal->pLogFile) < 0) {
+      terrno = TAOS_SYSTEM_ERROR(errno);
       wError("vgId:%d, file:%" PRId64 ".log, fsync failed since %s", pWal->cfg.vgId, walGetCurFileFirstVer(pWal),
              strerror(errno));
+      return -1;
     }
+    atomic_add_fetch_64(&pWal->fsyncCnt, 1);
   }
+
+  return 0;
+}
+
+void walSetFlushCb(SWal *pWal, FWalFlushCb fp, void *param) {
+  taosThreadMutexLock(&pWal->mutex);
+  pWal->fpFlushCb = fp;
+  pWal->flushParam = param;
+  taosThreadMutexUnlock(&pWal->mutex);
 }
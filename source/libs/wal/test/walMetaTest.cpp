@@ -3,6 +3,7 @@
 #include <iostream>
 #include <queue>
 
+#include "tglobal.h"
 #include "walInt.h"
 
 const char* ranStr = "tvapq02tcp";
@@ -40,6 +41,22 @@ class WalCleanEnv : public ::testing::Test {
   const char* pathName = TD_TMP_DIR_PATH "wal_test";
 };
 
+class WalGroupCommitEnv : public WalCleanEnv {
+ protected:
+  void SetUp() override {
+    groupCommitMs = tsWalGroupCommitMs;
+    tsWalGroupCommitMs = 1000;
+    WalCleanEnv::SetUp();
+  }
+
+  void TearDown() override {
+    WalCleanEnv::TearDown();
+    tsWalGroupCommitMs = groupCommitMs;
+  }
+
+  int32_t groupCommitMs = 0;
+};
+
 class WalCleanDeleteEnv : public ::testing::Test {
  protected:
   static void SetUpTestCase() {
@@ -257,6 +274,85 @@ TEST_F(WalCleanEnv, rollback) {
   ASSERT_EQ(code, 0);
 }
 
+TEST_F(WalGroupCommitEnv, groupCommit) {
+  int code;
+  for (int i = 0; i < 10; i++) {
+    code = walWrite(pWal, i, i + 1, (void*)ranStr, ranStrLen);
+    ASSERT_EQ(code, 0);
+    ASSERT_EQ(pWal->vers.lastVer, i);
+  }
+  // still buffered
+  ASSERT_EQ(pWal->bufFirstVer, 0);
+  ASSERT_EQ(walGetLastFileSize(pWal), 10 * (sizeof(SWalCkHead) + ranStrLen));
+
+  // readers see buffered entries
+  SWalReader* pRead = walOpenReader(pWal, NULL);
+  ASSERT(pRead != NULL);
+  code = walReadVer(pRead, 9);
+  ASSERT_EQ(code, 0);
+  ASSERT_EQ(pRead->pHead->head.version, 9);
+  ASSERT_EQ(pWal->bufFirstVer, -1);
+  walCloseReader(pRead);
+
+  for (int i = 10; i < 20; i++) {
+    code = walWrite(pWal, i, i + 1, (void*)ranStr, ranStrLen);
+    ASSERT_EQ(code, 0);
+  }
+  code = walRollback(pWal, 15);
+  ASSERT_EQ(code, 0);
+  ASSERT_EQ(pWal->vers.lastVer, 14);
+
+  code = walWrite(pWal, 15, 0, (void*)ranStr, ranStrLen);
+  ASSERT_EQ(code, 0);
+  code = walFsync(pWal, true);
+  ASSERT_EQ(code, 0);
+  ASSERT_EQ(pWal->bufFirstVer, -1);
+
+  int64_t size = 0;
+  char    fnameStr[WAL_FILE_LEN];
+  walBuildLogName(pWal, 0, fnameStr);
+  taosStatFile(fnameStr, &size, NULL);
+  ASSERT_EQ(size, 16 * (sizeof(SWalCkHead) + ranStrLen));
+}
+
+static void walTestFlushCb(void* param, int64_t ver) { atomic_store_64((int64_t*)param, ver); }
+
+TEST_F(WalGroupCommitEnv, groupFsync) {
+  int64_t flushedVer = -1;
+  int64_t fsyncCnt = pWal->fsyncCnt;
+  walSetFlushCb(pWal, walTestFlushCb, &flushedVer);
+
+  // the end of a batch does not close the group
+  for (int i = 0; i < 10; i++) {
+    ASSERT_EQ(walWrite(pWal, i, 0, (void*)ranStr, ranStrLen), 0);
+    ASSERT_EQ(walFsync(pWal, false), 0);
+  }
+  ASSERT_EQ(walGetFlushedVer(pWal), -1);
+  ASSERT_EQ(atomic_load_64(&flushedVer), -1);
+  ASSERT_EQ(pWal->fsyncCnt, fsyncCnt);
+
+  // closed by the wal thread once the window expires, all entries share one fsync
+  for (int i = 0; i < 500 && atomic_load_64(&flushedVer) != 9; i++) {
+    taosMsleep(10);
+  }
+  ASSERT_EQ(atomic_load_64(&flushedVer), 9);
+  ASSERT_EQ(walGetFlushedVer(pWal), 9);
+  ASSERT_EQ(pWal->fsyncCnt, fsyncCnt + 1);
+
+  // closed by size on the writing thread
+  int32_t bodyLen = 64 * 1024;
+  char*   body = (char*)taosMemoryCalloc(1, bodyLen);
+  int32_t num = WAL_GROUP_BUF_SIZE / (sizeof(SWalCkHead) + bodyLen) + 1;
+  for (int i = 10; i < 10 + num; i++) {
+    ASSERT_EQ(walWrite(pWal, i, 0, body, bodyLen), 0);
+  }
+  taosMemoryFree(body);
+  ASSERT_EQ(atomic_load_64(&flushedVer), 9 + num);
+  ASSERT_EQ(pWal->fsyncCnt, fsyncCnt + 2);
+
+  walSetFlushCb(pWal, NULL, NULL);
+}
+
 TEST_F(WalCleanDeleteEnv, roll) {
   int code;
   int i;
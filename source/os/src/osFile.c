@@ -32,6 +32,7 @@
 #include <sys/sendfile.h>
 #endif
 #include <sys/stat.h>
+#include <sys/uio.h>
 #include <unistd.h>
 #define LINUX_FILE_NO_TEXT_OPTION 0
 #define O_TEXT                    LINUX_FILE_NO_TEXT_OPTION
@@ -490,6 +491,63 @@ int64_t taosWriteFile(TdFilePtr pFile, const void *buf, int64_t count) {
   return count;
 }
 
+int64_t taosWritevFile(TdFilePtr pFile, const TdIoVec *iov, int32_t iovcnt) {
+  if (pFile == NULL) {
+    return 0;
+  }
+#ifdef WINDOWS
+  int64_t count = 0;
+  for (int32_t i = 0; i < iovcnt; i++) {
+    if (taosWriteFile(pFile, iov[i].base, iov[i].len) != iov[i].len) return -1;
+    count += iov[i].len;
+  }
+  return count;
+#else
+#if FILE_WITH_LOCK
+  taosThreadRwlockWrlock(&(pFile->rwlock));
+#endif
+  assert(pFile->fd >= 0);  // Please check if you have closed the file.
+
+  struct iovec vec[TD_IOVEC_MAX];
+  int64_t      count = 0;
+  int32_t      i = 0;
+  int64_t      skip = 0;  // bytes of iov[i] already written
+
+  while (i < iovcnt) {
+    int32_t n = 0;
+    for (int32_t j = i; j < iovcnt && n < TD_IOVEC_MAX; j++, n++) {
+      vec[n].iov_base = (char *)iov[j].base + (j == i ? skip : 0);
+      vec[n].iov_len = iov[j].len - (j == i ? skip : 0);
+    }
+
+    int64_t nwritten = writev(pFile->fd, vec, n);
+    if (nwritten < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+#if FILE_WITH_LOCK
+      taosThreadRwlockUnlock(&(pFile->rwlock));
+#endif
+      return -1;
+    }
+    count += nwritten;
+
+    // advance over the written bytes, a short write may stop in the middle of a vector
+    nwritten += skip;
+    while (i < iovcnt && nwritten >= iov[i].len) {
+      nwritten -= iov[i].len;
+      i++;
+    }
+    skip = nwritten;
+  }
+
+#if FILE_WITH_LOCK
+  taosThreadRwlockUnlock(&(pFile->rwlock));
+#endif
+  return count;
+#endif
+}
+
 int64_t taosLSeekFile(TdFilePtr pFile, int64_t offset, int32_t whence) {
 #if FILE_WITH_LOCK
   taosThreadRwlockRdlock(&(pFile->rwlock));
@@ -632,6 +690,18 @@ int32_t taosFsyncFile(TdFilePtr pFile) {
   return 0;
 }
 
+int32_t taosPrefetchFile(TdFilePtr pFile, int64_t offset, int64_t len) {
+  if (pFile == NULL || pFile->fd < 0) {
+    return 0;
+  }
+
+#if defined(WINDOWS) || defined(_TD_DARWIN_64)
+  return 0;
+#else
+  return posix_fadvise(pFile->fd, offset, len, POSIX_FADV_WILLNEED);
+#endif
+}
+
 int64_t taosFSendFile(TdFilePtr pFileOut, TdFilePtr pFileIn, int64_t *offset, int64_t size) {
   if (pFileOut == NULL || pFileIn == NULL) {
     return 0;
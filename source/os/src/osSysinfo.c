@@ -444,6 +444,22 @@ int32_t taosGetCpuCores(float *numOfCores) {
 #endif
 }
 
+int32_t taosGetCpuInstructions(char *sse42, char *avx, char *avx2, char *fma) {
+  *sse42 = 0;
+  *avx = 0;
+  *avx2 = 0;
+  *fma = 0;
+#if !defined(WINDOWS) && (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+  // __builtin_cpu_supports also checks that the OS saves the AVX registers
+  __builtin_cpu_init();
+  *sse42 = __builtin_cpu_supports("sse4.2") ? 1 : 0;
+  *avx = __builtin_cpu_supports("avx") ? 1 : 0;
+  *avx2 = __builtin_cpu_supports("avx2") ? 1 : 0;
+  *fma = __builtin_cpu_supports("fma") ? 1 : 0;
+#endif
+  return 0;
+}
+
 void taosGetCpuUsage(double *cpu_system, double *cpu_engine) {
   static int64_t lastSysUsed = 0;
   static int64_t lastSysTotal = 0;
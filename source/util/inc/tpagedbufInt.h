@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _TD_UTIL_PAGEDBUF_INT_H_
+#define _TD_UTIL_PAGEDBUF_INT_H_
+
+#include "tarray.h"
+#include "tpagedbuf.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct SPageDiskInfo {
+  int64_t offset;
+  int32_t length;
+} SPageDiskInfo, SFreeListItem;
+
+struct SPageInfo {
+  SListNode* pn;  // point to list node struct
+  void*      pData;
+  int64_t    offset;
+  int32_t    pageId;
+  int32_t    length : 29;
+  bool       used : 1;   // set current page is in used
+  bool       dirty : 1;  // set current buffer page is dirty or not
+};
+
+struct SDiskbasedBuf {
+  int32_t   numOfPages;
+  int64_t   totalBufSize;
+  uint64_t  fileSize;  // disk file size
+  TdFilePtr pFile;
+  int32_t   allocateId;  // allocated page id
+  char*     path;        // file path
+  int32_t   pageSize;    // current used page size
+  int32_t   inMemPages;  // numOfPages that are allocated in memory
+  int64_t   memSize;     // size of pages that are allocated in memory, accounted in dBufMemUsed
+  SList*    freePgList;  // free page list
+  SArray*   pIdList;     // page id list
+  SHashObj* all;
+  SList*    lruList;
+  void*     emptyDummyIdList;  // dummy id list
+  void*     assistBuf;         // assistant buffer for compress/decompress data
+  SArray*   pFree;             // free area in file
+  bool      comp;              // compressed before flushed to disk
+  uint64_t  nextPos;           // next page flush position
+
+  char*     id;          // for debug purpose
+  bool      printStatis;  // Print statistics info when closing this buffer.
+  SDiskbasedBufStatis statis;
+};
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // _TD_UTIL_PAGEDBUF_INT_H_
@@ -21,6 +21,7 @@
 #include "tdef.h"
 #include "thash.h"
 #include "tlog.h"
+#include "tutil.h"
 #include "types.h"
 
 int32_t setChkInBytes1(const void *pLeft, const void *pRight) {
@@ -1133,40 +1134,186 @@ int32_t compareStrRegexCompNMatch(const void *pLeft, const void *pRight) {
   return compareStrRegexComp(pLeft, pRight) ? 0 : 1;
 }
 
-int32_t compareStrRegexComp(const void *pLeft, const void *pRight) {
-  size_t sz = varDataLen(pRight);
-  char  *pattern = taosMemoryMalloc(sz + 1);
-  memcpy(pattern, varDataVal(pRight), varDataLen(pRight));
-  pattern[sz] = 0;
+// compiled patterns are cached per thread, since regexec serializes the threads sharing one regex_t
+#define REGEX_CACHE_SIZE    16
+#define REGEX_STACK_BUF_LEN 256
 
-  sz = varDataLen(pLeft);
-  char *str = taosMemoryMalloc(sz + 1);
-  memcpy(str, varDataVal(pLeft), sz);
-  str[sz] = 0;
+typedef enum {
+  REGEX_PATTERN_INVALID = 0,  // failed to compile, never matches
+  REGEX_PATTERN_REGEX,
+  REGEX_PATTERN_LITERAL,  // no meta character, matched by memory search
+} ERegexPatternType;
 
-  int32_t errCode = 0;
+typedef struct SRegexCacheEntry {
+  char   *pattern;  // NULL if the slot is empty
+  int32_t len;
+  int8_t  type;
+  bool    headAnchor;  // literal pattern starts with '^'
+  bool    tailAnchor;  // literal pattern ends with '$'
+  int64_t lastUsed;
   regex_t regex;
-  char    msgbuf[256] = {0};
+} SRegexCacheEntry;
+
+typedef struct SRegexCache {
+  int64_t          clock;
+  SRegexCacheEntry entries[REGEX_CACHE_SIZE];
+} SRegexCache;
+
+static TdThreadOnce regexCacheOnce = PTHREAD_ONCE_INIT;
+static TdThreadKey  regexCacheKey;
+
+static void regexCacheEntryClear(SRegexCacheEntry *pEntry) {
+  if (pEntry->type == REGEX_PATTERN_REGEX) {
+    regfree(&pEntry->regex);
+  }
+
+  taosMemoryFreeClear(pEntry->pattern);
+  pEntry->type = REGEX_PATTERN_INVALID;
+}
+
+static void regexCacheDestroy(void *param) {
+  SRegexCache *pCache = param;
+  for (int32_t i = 0; i < REGEX_CACHE_SIZE; ++i) {
+    regexCacheEntryClear(&pCache->entries[i]);
+  }
+
+  taosMemoryFree(pCache);
+}
+
+static void regexCacheInit() { taosThreadKeyCreate(&regexCacheKey, regexCacheDestroy); }
+
+static bool isRegexMetaChar(char c) { return strchr(".[]()*+?{}|\\^$", c) != NULL; }
+
+static void regexCacheEntryInit(SRegexCacheEntry *pEntry, const char *pattern, int32_t len) {
+  int32_t start = (len > 0 && pattern[0] == '^') ? 1 : 0;
+  int32_t end = (len > start && pattern[len - 1] == '$') ? len - 1 : len;
 
-  int32_t cflags = REG_EXTENDED;
-  if ((errCode = regcomp(&regex, pattern, cflags)) != 0) {
-    regerror(errCode, &regex, msgbuf, sizeof(msgbuf));
+  // a pattern with '\0' inside is truncated by regcomp
+  bool literal = (strlen(pattern) == len);
+  for (int32_t i = start; i < end && literal; ++i) {
+    if (isRegexMetaChar(pattern[i])) {
+      literal = false;
+      break;
+    }
+  }
+
+  if (literal) {
+    pEntry->type = REGEX_PATTERN_LITERAL;
+    pEntry->headAnchor = (start == 1);
+    pEntry->tailAnchor = (end < len);
+    return;
+  }
+
+  int32_t code = regcomp(&pEntry->regex, pattern, REG_EXTENDED);
+  if (code != 0) {
+    char msgbuf[256] = {0};
+    regerror(code, &pEntry->regex, msgbuf, sizeof(msgbuf));
     uError("Failed to compile regex pattern %s. reason %s", pattern, msgbuf);
-    regfree(&regex);
-    taosMemoryFree(str);
-    taosMemoryFree(pattern);
+    regfree(&pEntry->regex);
+    pEntry->type = REGEX_PATTERN_INVALID;
+    return;
+  }
+
+  pEntry->type = REGEX_PATTERN_REGEX;
+}
+
+// return the cached entry of the pattern, or compile it in place of the least recently used one
+static SRegexCacheEntry *regexCacheGet(const char *pattern, int32_t len) {
+  taosThreadOnce(&regexCacheOnce, regexCacheInit);
+
+  SRegexCache *pCache = taosThreadGetSpecific(regexCacheKey);
+  if (pCache == NULL) {
+    pCache = taosMemoryCalloc(1, sizeof(SRegexCache));
+    if (pCache == NULL) {
+      return NULL;
+    }
+
+    taosThreadSetSpecific(regexCacheKey, pCache);
+  }
+
+  SRegexCacheEntry *pVictim = &pCache->entries[0];
+  for (int32_t i = 0; i < REGEX_CACHE_SIZE; ++i) {
+    SRegexCacheEntry *pEntry = &pCache->entries[i];
+    if (pEntry->pattern != NULL && pEntry->len == len && memcmp(pEntry->pattern, pattern, len) == 0) {
+      pEntry->lastUsed = ++pCache->clock;
+      return pEntry;
+    }
+
+    if (pVictim->pattern != NULL && (pEntry->pattern == NULL || pEntry->lastUsed < pVictim->lastUsed)) {
+      pVictim = pEntry;
+    }
+  }
+
+  char *p = taosMemoryMalloc(len + 1);
+  if (p == NULL) {
+    return NULL;
+  }
+
+  memcpy(p, pattern, len);
+  p[len] = 0;
+
+  regexCacheEntryClear(pVictim);
+  pVictim->pattern = p;
+  pVictim->len = len;
+  pVictim->lastUsed = ++pCache->clock;
+  regexCacheEntryInit(pVictim, p, len);
+  return pVictim;
+}
+
+static int32_t regexLiteralMatch(SRegexCacheEntry *pEntry, const char *str, int32_t len) {
+  const char *lit = pEntry->pattern + (pEntry->headAnchor ? 1 : 0);
+  int32_t     litLen = pEntry->len - (pEntry->headAnchor ? 1 : 0) - (pEntry->tailAnchor ? 1 : 0);
+
+  // the string is compared as a c string by regexec
+  len = strnlen(str, len);
+  if (litLen > len) {
     return 1;
   }
 
-  errCode = regexec(&regex, str, 0, NULL, 0);
+  if (pEntry->headAnchor && pEntry->tailAnchor) {
+    return (litLen == len && memcmp(str, lit, litLen) == 0) ? 0 : 1;
+  } else if (pEntry->headAnchor) {
+    return memcmp(str, lit, litLen) == 0 ? 0 : 1;
+  } else if (pEntry->tailAnchor) {
+    return memcmp(str + len - litLen, lit, litLen) == 0 ? 0 : 1;
+  } else {
+    // an empty pattern matches any string, as regexec does
+    return (litLen == 0 || tmemmem(str, len, lit, litLen) != NULL) ? 0 : 1;
+  }
+}
+
+int32_t compareStrRegexComp(const void *pLeft, const void *pRight) {
+  SRegexCacheEntry *pEntry = regexCacheGet(varDataVal(pRight), varDataLen(pRight));
+  if (pEntry == NULL || pEntry->type == REGEX_PATTERN_INVALID) {
+    return 1;
+  }
+
+  if (pEntry->type == REGEX_PATTERN_LITERAL) {
+    return regexLiteralMatch(pEntry, varDataVal(pLeft), varDataLen(pLeft));
+  }
+
+  size_t sz = varDataLen(pLeft);
+  char   buf[REGEX_STACK_BUF_LEN];
+  char  *str = (sz < REGEX_STACK_BUF_LEN) ? buf : taosMemoryMalloc(sz + 1);
+  if (str == NULL) {
+    return 1;
+  }
+
+  memcpy(str, varDataVal(pLeft), sz);
+  str[sz] = 0;
+
+  int32_t errCode = regexec(&pEntry->regex, str, 0, NULL, 0);
   if (errCode != 0 && errCode != REG_NOMATCH) {
-    regerror(errCode, &regex, msgbuf, sizeof(msgbuf));
-    uDebug("Failed to match %s with pattern %s, reason %s", str, pattern, msgbuf)
+    char msgbuf[256] = {0};
+    regerror(errCode, &pEntry->regex, msgbuf, sizeof(msgbuf));
+    uDebug("Failed to match %s with pattern %s, reason %s", str, pEntry->pattern, msgbuf)
   }
+
   int32_t result = (errCode == 0) ? 0 : 1;
-  regfree(&regex);
-  taosMemoryFree(str);
-  taosMemoryFree(pattern);
+  if (str != buf) {
+    taosMemoryFree(str);
+  }
+
   return result;
 }
 
@@ -36,7 +36,8 @@
  *   better when there are a lot of consecutive true values or false values.
  *
  * STRING Compression Algorithm:
- *   We us LZ4 method to compress the string type.
+ *   We us LZ4 method to compress the string type. With TWO_STAGE_COMP_ZSTD, zstd is used instead,
+ *   which trades some speed for a better compression ratio.
  *
  * FLOAT Compression Algorithm:
  *   We use the same method with Akumuli to compress float and double types. The compression
@@ -48,6 +49,12 @@
  */
 
 #define _DEFAULT_SOURCE
+// AVX2 decoders are compiled with function level target attributes and only run when the CPU supports AVX2
+#if !defined(WINDOWS) && defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define TD_DECOMPRESS_AVX2
+#include <immintrin.h>
+#endif
+#include "zstd.h"
 #include "tcompression.h"
 #include "lz4.h"
 #include "tRealloc.h"
@@ -65,6 +72,22 @@ static const int32_t TEST_NUMBER = 1;
 #define ZIGZAG_ENCODE(T, v) ((u##T)((v) >> (sizeof(T) * 8 - 1))) ^ (((u##T)(v)) << 1)  // zigzag encode
 #define ZIGZAG_DECODE(T, v) ((v) >> 1) ^ -((T)((v)&1))                                 // zigzag decode
 
+static TdThreadOnce tsDecompressInitOnce = PTHREAD_ONCE_INIT;
+static bool         tsDecompressAVX2 = false;
+
+static void tsDecompressInit() {
+  char sse42, avx, avx2, fma;
+  taosGetCpuInstructions(&sse42, &avx, &avx2, &fma);
+#ifdef TD_DECOMPRESS_AVX2
+  tsDecompressAVX2 = (avx2 != 0);
+#endif
+}
+
+bool tsDecompressAVX2Supported(void) {
+  taosThreadOnce(&tsDecompressInitOnce, tsDecompressInit);
+  return tsDecompressAVX2;
+}
+
 #ifdef TD_TSZ
 bool lossyFloat = false;
 bool lossyDouble = false;
@@ -227,25 +250,61 @@ int32_t tsCompressINTImp(const char *const input, const int32_t nelements, char
   return opos;
 }
 
-int32_t tsDecompressINTImp(const char *const input, const int32_t nelements, char *const output, const char type) {
-  int32_t word_length = 0;
+static const uint8_t SIMPLE8B_BIT_PER_INTEGER[] = {0, 0, 1, 2, 3, 4, 5, 6, 7, 8, 10, 12, 15, 20, 30, 60};
+static const int32_t SIMPLE8B_SELECTOR_TO_ELEMS[] = {240, 120, 60, 30, 20, 15, 12, 10, 8, 7, 6, 5, 4, 3, 2, 1};
+
+static int32_t tsGetIntWordLength(const char type) {
   switch (type) {
     case TSDB_DATA_TYPE_BIGINT:
-      word_length = LONG_BYTES;
-      break;
+      return LONG_BYTES;
     case TSDB_DATA_TYPE_INT:
-      word_length = INT_BYTES;
-      break;
+      return INT_BYTES;
     case TSDB_DATA_TYPE_SMALLINT:
-      word_length = SHORT_BYTES;
-      break;
+      return SHORT_BYTES;
     case TSDB_DATA_TYPE_TINYINT:
-      word_length = CHAR_BYTES;
-      break;
+      return CHAR_BYTES;
     default:
-      uError("Invalid decompress integer type:%d", type);
       return -1;
   }
+}
+
+// Decode simple8b words into an array of type T, the type dispatch is done once outside of the loop.
+#define SIMPLE8B_DECODE_SCALAR(T, ip, output, nelements)                                      \
+  do {                                                                                        \
+    T      *op = (T *)(output);                                                               \
+    int32_t count = 0;                                                                        \
+    int64_t prev_value = 0;                                                                   \
+    while (count < (nelements)) {                                                             \
+      uint64_t w;                                                                             \
+      memcpy(&w, (ip), LONG_BYTES);                                                           \
+      (ip) += LONG_BYTES;                                                                     \
+                                                                                              \
+      int32_t selector = (int32_t)(w & INT64MASK(4));                                         \
+      int32_t bit = SIMPLE8B_BIT_PER_INTEGER[selector];                                       \
+      int32_t elems = TMIN(SIMPLE8B_SELECTOR_TO_ELEMS[selector], (nelements)-count);          \
+                                                                                              \
+      if (selector == 0 || selector == 1) {                                                   \
+        for (int32_t i = 0; i < elems; i++) op[count++] = (T)prev_value;                      \
+      } else {                                                                                \
+        uint64_t mask = INT64MASK(bit);                                                       \
+        w >>= 4;                                                                              \
+        for (int32_t i = 0; i < elems; i++) {                                                 \
+          uint64_t zigzag_value = w & mask;                                                   \
+          w >>= bit;                                                                          \
+          prev_value = (int64_t)((uint64_t)prev_value + (uint64_t)(ZIGZAG_DECODE(int64_t, zigzag_value))); \
+          op[count++] = (T)prev_value;                                                        \
+        }                                                                                     \
+      }                                                                                       \
+    }                                                                                         \
+  } while (0)
+
+int32_t tsDecompressINTImpScalar(const char *const input, const int32_t nelements, char *const output,
+                                 const char type) {
+  int32_t word_length = tsGetIntWordLength(type);
+  if (word_length < 0) {
+    uError("Invalid decompress integer type:%d", type);
+    return -1;
+  }
 
   // If not compressed.
   if (input[0] == 1) {
@@ -253,67 +312,150 @@ int32_t tsDecompressINTImp(const char *const input, const int32_t nelements, cha
     return nelements * word_length;
   }
 
-  // Selector value:              0    1   2   3   4   5   6   7   8  9  10  11
-  // 12  13  14  15
-  char    bit_per_integer[] = {0, 0, 1, 2, 3, 4, 5, 6, 7, 8, 10, 12, 15, 20, 30, 60};
-  int32_t selector_to_elems[] = {240, 120, 60, 30, 20, 15, 12, 10, 8, 7, 6, 5, 4, 3, 2, 1};
+  const char *ip = input + 1;
+  switch (type) {
+    case TSDB_DATA_TYPE_BIGINT:
+      SIMPLE8B_DECODE_SCALAR(int64_t, ip, output, nelements);
+      break;
+    case TSDB_DATA_TYPE_INT:
+      SIMPLE8B_DECODE_SCALAR(int32_t, ip, output, nelements);
+      break;
+    case TSDB_DATA_TYPE_SMALLINT:
+      SIMPLE8B_DECODE_SCALAR(int16_t, ip, output, nelements);
+      break;
+    case TSDB_DATA_TYPE_TINYINT:
+      SIMPLE8B_DECODE_SCALAR(int8_t, ip, output, nelements);
+      break;
+  }
+
+  return nelements * word_length;
+}
+
+#ifdef TD_DECOMPRESS_AVX2
+// inclusive prefix sum of the four int64 lanes
+__attribute__((target("avx2"))) static FORCE_INLINE __m256i tsPrefixSumEpi64(__m256i x) {
+  __m256i zero = _mm256_setzero_si256();
+  x = _mm256_add_epi64(x, _mm256_blend_epi32(_mm256_permute4x64_epi64(x, _MM_SHUFFLE(2, 1, 0, 0)), zero, 0x03));
+  x = _mm256_add_epi64(x, _mm256_blend_epi32(_mm256_permute4x64_epi64(x, _MM_SHUFFLE(1, 0, 0, 0)), zero, 0x0F));
+  return x;
+}
+
+__attribute__((target("avx2"))) static FORCE_INLINE void tsStoreEpi64(__m256i x, char *output, int32_t pos,
+                                                                       const char type) {
+  int64_t v[4];
+  switch (type) {
+    case TSDB_DATA_TYPE_BIGINT:
+      _mm256_storeu_si256((__m256i *)((int64_t *)output + pos), x);
+      break;
+    case TSDB_DATA_TYPE_INT:
+      x = _mm256_permutevar8x32_epi32(x, _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6));
+      _mm_storeu_si128((__m128i *)((int32_t *)output + pos), _mm256_castsi256_si128(x));
+      break;
+    case TSDB_DATA_TYPE_SMALLINT:
+      _mm256_storeu_si256((__m256i *)v, x);
+      for (int32_t i = 0; i < 4; i++) *((int16_t *)output + pos + i) = (int16_t)v[i];
+      break;
+    case TSDB_DATA_TYPE_TINYINT:
+      _mm256_storeu_si256((__m256i *)v, x);
+      for (int32_t i = 0; i < 4; i++) *((int8_t *)output + pos + i) = (int8_t)v[i];
+      break;
+  }
+}
+
+static FORCE_INLINE void tsStoreInt64(int64_t value, char *output, int32_t pos, const char type) {
+  switch (type) {
+    case TSDB_DATA_TYPE_BIGINT:
+      *((int64_t *)output + pos) = value;
+      break;
+    case TSDB_DATA_TYPE_INT:
+      *((int32_t *)output + pos) = (int32_t)value;
+      break;
+    case TSDB_DATA_TYPE_SMALLINT:
+      *((int16_t *)output + pos) = (int16_t)value;
+      break;
+    case TSDB_DATA_TYPE_TINYINT:
+      *((int8_t *)output + pos) = (int8_t)value;
+      break;
+  }
+}
+
+// Four values of a simple8b word are unpacked per step: variable shifts extract the lanes, zigzag decoding and the
+// delta prefix sum are done in registers.
+__attribute__((target("avx2"))) int32_t tsDecompressINTImpAVX2(const char *const input, const int32_t nelements,
+                                                                char *const output, const char type) {
+  int32_t word_length = tsGetIntWordLength(type);
+  if (word_length < 0) {
+    uError("Invalid decompress integer type:%d", type);
+    return -1;
+  }
+
+  if (input[0] == 1) {
+    memcpy(output, input + 1, nelements * word_length);
+    return nelements * word_length;
+  }
 
   const char *ip = input + 1;
   int32_t     count = 0;
-  int32_t     _pos = 0;
   int64_t     prev_value = 0;
+  __m256i     one = _mm256_set1_epi64x(1);
+  __m256i     zero = _mm256_setzero_si256();
 
-  while (1) {
-    if (count == nelements) break;
-
-    uint64_t w = 0;
+  while (count < nelements) {
+    uint64_t w;
     memcpy(&w, ip, LONG_BYTES);
+    ip += LONG_BYTES;
 
-    char    selector = (char)(w & INT64MASK(4));       // selector = 4
-    char    bit = bit_per_integer[(int32_t)selector];  // bit = 3
-    int32_t elems = selector_to_elems[(int32_t)selector];
+    int32_t selector = (int32_t)(w & INT64MASK(4));
+    int32_t bit = SIMPLE8B_BIT_PER_INTEGER[selector];
+    int32_t elems = TMIN(SIMPLE8B_SELECTOR_TO_ELEMS[selector], nelements - count);
+    int32_t i = 0;
 
-    for (int32_t i = 0; i < elems; i++) {
-      uint64_t zigzag_value;
+    if (selector == 0 || selector == 1) {
+      __m256i vPrev = _mm256_set1_epi64x(prev_value);
+      for (; i + 4 <= elems; i += 4, count += 4) tsStoreEpi64(vPrev, output, count, type);
+      for (; i < elems; i++) tsStoreInt64(prev_value, output, count++, type);
+      continue;
+    }
 
-      if (selector == 0 || selector == 1) {
-        zigzag_value = 0;
-      } else {
-        zigzag_value = ((w >> (4 + bit * i)) & INT64MASK(bit));
-      }
-      int64_t diff = ZIGZAG_DECODE(int64_t, zigzag_value);
-      int64_t curr_value = diff + prev_value;
-      prev_value = curr_value;
+    __m256i vWord = _mm256_set1_epi64x((int64_t)w);
+    __m256i vMask = _mm256_set1_epi64x((int64_t)INT64MASK(bit));
+    __m256i vShift = _mm256_setr_epi64x(4, 4 + bit, 4 + 2 * bit, 4 + 3 * bit);
+    __m256i vStep = _mm256_set1_epi64x(4 * bit);
+    __m256i vPrev = _mm256_set1_epi64x(prev_value);
+    for (; i + 4 <= elems; i += 4, count += 4) {
+      __m256i vZigzag = _mm256_and_si256(_mm256_srlv_epi64(vWord, vShift), vMask);
+      __m256i vDiff = _mm256_xor_si256(_mm256_srli_epi64(vZigzag, 1),
+                                       _mm256_sub_epi64(zero, _mm256_and_si256(vZigzag, one)));
+      __m256i vValue = _mm256_add_epi64(tsPrefixSumEpi64(vDiff), vPrev);
+
+      tsStoreEpi64(vValue, output, count, type);
+      vPrev = _mm256_permute4x64_epi64(vValue, _MM_SHUFFLE(3, 3, 3, 3));
+      vShift = _mm256_add_epi64(vShift, vStep);
+    }
+    prev_value = _mm256_extract_epi64(vPrev, 0);
 
-      switch (type) {
-        case TSDB_DATA_TYPE_BIGINT:
-          *((int64_t *)output + _pos) = (int64_t)curr_value;
-          _pos++;
-          break;
-        case TSDB_DATA_TYPE_INT:
-          *((int32_t *)output + _pos) = (int32_t)curr_value;
-          _pos++;
-          break;
-        case TSDB_DATA_TYPE_SMALLINT:
-          *((int16_t *)output + _pos) = (int16_t)curr_value;
-          _pos++;
-          break;
-        case TSDB_DATA_TYPE_TINYINT:
-          *((int8_t *)output + _pos) = (int8_t)curr_value;
-          _pos++;
-          break;
-        default:
-          perror("Wrong integer types.\n");
-          return -1;
-      }
-      count++;
-      if (count == nelements) break;
+    for (; i < elems; i++) {
+      uint64_t zigzag_value = (w >> (4 + bit * i)) & INT64MASK(bit);
+      prev_value = (int64_t)((uint64_t)prev_value + (uint64_t)(ZIGZAG_DECODE(int64_t, zigzag_value)));
+      tsStoreInt64(prev_value, output, count++, type);
     }
-    ip += LONG_BYTES;
   }
 
   return nelements * word_length;
 }
+#else
+int32_t tsDecompressINTImpAVX2(const char *const input, const int32_t nelements, char *const output,
+                               const char type) {
+  return tsDecompressINTImpScalar(input, nelements, output, type);
+}
+#endif
+
+int32_t tsDecompressINTImp(const char *const input, const int32_t nelements, char *const output, const char type) {
+  if (tsDecompressAVX2Supported()) {
+    return tsDecompressINTImpAVX2(input, nelements, output, type);
+  }
+  return tsDecompressINTImpScalar(input, nelements, output, type);
+}
 
 /* ----------------------------------------------Bool Compression
  * ---------------------------------------------- */
@@ -463,6 +605,89 @@ int32_t tsDecompressStringImp(const char *const input, int32_t compressedSize, c
   }
 }
 
+/* ----------------------------------------------String Compression (zstd)
+ * ---------------------------------------------- */
+int32_t tsZstdCompressLevel = 3;
+
+static TdThreadOnce tsZstdInitOnce = PTHREAD_ONCE_INIT;
+static TdThreadKey  tsZstdCCtxKey;
+static TdThreadKey  tsZstdDCtxKey;
+
+static void tsZstdFreeCCtx(void *ctx) { ZSTD_freeCCtx((ZSTD_CCtx *)ctx); }
+static void tsZstdFreeDCtx(void *ctx) { ZSTD_freeDCtx((ZSTD_DCtx *)ctx); }
+
+static void tsZstdInit() {
+  taosThreadKeyCreate(&tsZstdCCtxKey, tsZstdFreeCCtx);
+  taosThreadKeyCreate(&tsZstdDCtxKey, tsZstdFreeDCtx);
+}
+
+// zstd contexts are expensive to create, so each thread keeps its own and reuses it
+static ZSTD_CCtx *tsZstdGetCCtx() {
+  taosThreadOnce(&tsZstdInitOnce, tsZstdInit);
+  ZSTD_CCtx *ctx = taosThreadGetSpecific(tsZstdCCtxKey);
+  if (ctx == NULL) {
+    ctx = ZSTD_createCCtx();
+    if (ctx != NULL) taosThreadSetSpecific(tsZstdCCtxKey, ctx);
+  }
+  return ctx;
+}
+
+static ZSTD_DCtx *tsZstdGetDCtx() {
+  taosThreadOnce(&tsZstdInitOnce, tsZstdInit);
+  ZSTD_DCtx *ctx = taosThreadGetSpecific(tsZstdDCtxKey);
+  if (ctx == NULL) {
+    ctx = ZSTD_createDCtx();
+    if (ctx != NULL) taosThreadSetSpecific(tsZstdDCtxKey, ctx);
+  }
+  return ctx;
+}
+
+// Same layout as tsCompressStringImp: the first byte is 1 if the data is compressed and 0 if it is stored as is.
+int32_t tsCompressStringZstdImp(const char *const input, int32_t inputSize, char *const output, int32_t outputSize) {
+  ZSTD_CCtx *ctx = tsZstdGetCCtx();
+  size_t     compressed_data_size = 0;
+
+  if (ctx != NULL) {
+    compressed_data_size = ZSTD_compressCCtx(ctx, output + 1, outputSize - 1, input, inputSize, tsZstdCompressLevel);
+  }
+
+  // If cannot compress or after compression, data becomes larger.
+  if (ctx == NULL || ZSTD_isError(compressed_data_size) || compressed_data_size == 0 ||
+      (int32_t)compressed_data_size > inputSize) {
+    output[0] = 0;
+    memcpy(output + 1, input, inputSize);
+    return inputSize + 1;
+  }
+
+  output[0] = 1;
+  return (int32_t)compressed_data_size + 1;
+}
+
+int32_t tsDecompressStringZstdImp(const char *const input, int32_t compressedSize, char *const output,
+                                  int32_t outputSize) {
+  if (input[0] == 1) {
+    ZSTD_DCtx *ctx = tsZstdGetDCtx();
+    if (ctx == NULL) {
+      uError("Failed to create zstd decompression context");
+      return -1;
+    }
+
+    size_t decompressed_size = ZSTD_decompressDCtx(ctx, output, outputSize, input + 1, compressedSize - 1);
+    if (ZSTD_isError(decompressed_size)) {
+      uError("Failed to decompress string with zstd algorithm since %s", ZSTD_getErrorName(decompressed_size));
+      return -1;
+    }
+
+    return (int32_t)decompressed_size;
+  } else if (input[0] == 0) {
+    memcpy(output, input + 1, compressedSize - 1);
+    return compressedSize - 1;
+  } else {
+    uError("Invalid decompress string indicator:%d", input[0]);
+    return -1;
+  }
+}
+
 /* --------------------------------------------Timestamp Compression
  * ---------------------------------------------- */
 // TODO: Take care here, we assumes little endian encoding.
@@ -562,7 +787,7 @@ _exit_over:
   return nelements * LONG_BYTES + 1;
 }
 
-int32_t tsDecompressTimestampImp(const char *const input, const int32_t nelements, char *const output) {
+int32_t tsDecompressTimestampImpScalar(const char *const input, const int32_t nelements, char *const output) {
   assert(nelements >= 0);
   if (nelements == 0) return 0;
 
@@ -631,6 +856,77 @@ int32_t tsDecompressTimestampImp(const char *const input, const int32_t nelement
     return -1;
   }
 }
+
+#ifdef TD_DECOMPRESS_AVX2
+// The variable length delta-of-delta values are unpacked in a first pass, then both levels of prefix sums are done
+// four lanes at a time.
+__attribute__((target("avx2"))) int32_t tsDecompressTimestampImpAVX2(const char *const input,
+                                                                      const int32_t nelements, char *const output) {
+  assert(nelements >= 0);
+  if (nelements == 0) return 0;
+
+  if (input[0] == 0) {
+    memcpy(output, input + 1, nelements * LONG_BYTES);
+    return nelements * LONG_BYTES;
+  } else if (input[0] != 1) {
+    assert(0);
+    return -1;
+  }
+
+  int64_t *ostream = (int64_t *)output;
+  int32_t  ipos = 1;
+
+  // unpack delta-of-delta values
+  for (int32_t opos = 0; opos < nelements;) {
+    uint8_t flags = input[ipos++];
+    for (int32_t k = 0; k < 2 && opos < nelements; k++) {
+      uint64_t dd = 0;
+      int8_t   nbytes = (flags >> (4 * k)) & INT8MASK(4);
+      for (int8_t j = 0; j < nbytes; j++) {
+        dd |= ((uint64_t)(uint8_t)input[ipos++]) << (BITS_PER_BYTE * j);
+      }
+      ostream[opos++] = ZIGZAG_DECODE(int64_t, dd);
+    }
+  }
+
+  // delta = prefix_sum(delta_of_delta), value = prefix_sum(delta), the first value is stored as it is
+  __m256i vDelta = _mm256_setzero_si256();
+  __m256i vValue = _mm256_set1_epi64x(ostream[0]);
+  int32_t i = 1;
+  for (; i + 4 <= nelements; i += 4) {
+    __m256i x = _mm256_loadu_si256((__m256i *)(ostream + i));
+
+    x = _mm256_add_epi64(tsPrefixSumEpi64(x), vDelta);
+    vDelta = _mm256_permute4x64_epi64(x, _MM_SHUFFLE(3, 3, 3, 3));
+    x = _mm256_add_epi64(tsPrefixSumEpi64(x), vValue);
+    vValue = _mm256_permute4x64_epi64(x, _MM_SHUFFLE(3, 3, 3, 3));
+
+    _mm256_storeu_si256((__m256i *)(ostream + i), x);
+  }
+
+  int64_t prev_delta = _mm256_extract_epi64(vDelta, 0);
+  int64_t prev_value = _mm256_extract_epi64(vValue, 0);
+  for (; i < nelements; i++) {
+    prev_delta = (int64_t)((uint64_t)prev_delta + (uint64_t)ostream[i]);
+    prev_value = (int64_t)((uint64_t)prev_value + (uint64_t)prev_delta);
+    ostream[i] = prev_value;
+  }
+
+  return nelements * LONG_BYTES;
+}
+#else
+int32_t tsDecompressTimestampImpAVX2(const char *const input, const int32_t nelements, char *const output) {
+  return tsDecompressTimestampImpScalar(input, nelements, output);
+}
+#endif
+
+int32_t tsDecompressTimestampImp(const char *const input, const int32_t nelements, char *const output) {
+  if (tsDecompressAVX2Supported()) {
+    return tsDecompressTimestampImpAVX2(input, nelements, output);
+  }
+  return tsDecompressTimestampImpScalar(input, nelements, output);
+}
+
 /* --------------------------------------------Double Compression
  * ---------------------------------------------- */
 void encodeDoubleValue(uint64_t diff, uint8_t flag, char *const output, int32_t *const pos) {
@@ -1586,11 +1882,21 @@ int32_t tCompGen(SCompressor *pCmprsor, const uint8_t **ppData, int64_t *nData)
     return code;
   }
 
-  if (pCmprsor->cmprAlg == TWO_STAGE_COMP /*|| IS_VAR_DATA_TYPE(pCmprsor->type)*/) {
+  if (IS_TWO_STAGE_COMP(pCmprsor->cmprAlg) /*|| IS_VAR_DATA_TYPE(pCmprsor->type)*/) {
     code = tRealloc(&pCmprsor->aBuf[1], pCmprsor->nBuf[0] + 1);
     if (code) return code;
 
-    int64_t ret = LZ4_compress_default(pCmprsor->aBuf[0], pCmprsor->aBuf[1] + 1, pCmprsor->nBuf[0], pCmprsor->nBuf[0]);
+    int64_t ret = 0;
+    if (pCmprsor->cmprAlg == TWO_STAGE_COMP_ZSTD) {
+      ZSTD_CCtx *ctx = tsZstdGetCCtx();
+      if (ctx) {
+        size_t n = ZSTD_compressCCtx(ctx, pCmprsor->aBuf[1] + 1, pCmprsor->nBuf[0], pCmprsor->aBuf[0],
+                                     pCmprsor->nBuf[0], tsZstdCompressLevel);
+        if (!ZSTD_isError(n)) ret = n;
+      }
+    } else {
+      ret = LZ4_compress_default(pCmprsor->aBuf[0], pCmprsor->aBuf[1] + 1, pCmprsor->nBuf[0], pCmprsor->nBuf[0]);
+    }
     if (ret) {
       pCmprsor->aBuf[1][0] = 0;
       pCmprsor->nBuf[1] = ret + 1;
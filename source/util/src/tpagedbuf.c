@@ -1,51 +1,18 @@
 #define _DEFAULT_SOURCE
-#include "tpagedbuf.h"
+#include "tpagedbufInt.h"
 #include "taoserror.h"
 #include "tcompression.h"
 #include "thash.h"
 #include "tlog.h"
 
 #define GET_DATA_PAYLOAD(_p)          ((char*)(_p)->pData + POINTER_BYTES)
-#define NO_IN_MEM_AVAILABLE_PAGES(_b) (listNEles((_b)->lruList) >= (_b)->inMemPages)
-
-typedef struct SPageDiskInfo {
-  int64_t offset;
-  int32_t length;
-} SPageDiskInfo, SFreeListItem;
-
-struct SPageInfo {
-  SListNode* pn;  // point to list node struct
-  void*      pData;
-  int64_t    offset;
-  int32_t    pageId;
-  int32_t    length : 29;
-  bool       used : 1;   // set current page is in used
-  bool       dirty : 1;  // set current buffer page is dirty or not
-};
-
-struct SDiskbasedBuf {
-  int32_t   numOfPages;
-  int64_t   totalBufSize;
-  uint64_t  fileSize;  // disk file size
-  TdFilePtr pFile;
-  int32_t   allocateId;  // allocated page id
-  char*     path;        // file path
-  int32_t   pageSize;    // current used page size
-  int32_t   inMemPages;  // numOfPages that are allocated in memory
-  SList*    freePgList;  // free page list
-  SArray*   pIdList;     // page id list
-  SHashObj* all;
-  SList*    lruList;
-  void*     emptyDummyIdList;  // dummy id list
-  void*     assistBuf;         // assistant buffer for compress/decompress data
-  SArray*   pFree;             // free area in file
-  bool      comp;              // compressed before flushed to disk
-  uint64_t  nextPos;           // next page flush position
-
-  char*     id;          // for debug purpose
-  bool      printStatis;  // Print statistics info when closing this buffer.
-  SDiskbasedBufStatis statis;
-};
+#define NO_IN_MEM_AVAILABLE_PAGES(_b) (listNEles((_b)->lruList) >= (_b)->inMemPages || isMemBudgetExhausted(_b))
+
+// minimum number of in-memory pages that each buffer keeps when the node level budget is used up
+#define DBUF_MIN_IN_MEM_PAGES 2
+
+static int64_t dBufMemBudget = -1;  // node level budget for in-memory pages of all buffers, -1 means no limit
+static int64_t dBufMemUsed = 0;     // in-memory pages size of all buffers in bytes
 
 static int32_t createDiskFile(SDiskbasedBuf* pBuf) {
   pBuf->pFile = taosOpenFile(pBuf->path, TD_FILE_CREATE | TD_FILE_WRITE | TD_FILE_READ | TD_FILE_TRUNC | TD_FILE_AUTO_DEL);
@@ -56,7 +23,8 @@ static int32_t createDiskFile(SDiskbasedBuf* pBuf) {
   return TSDB_CODE_SUCCESS;
 }
 
-static char* doCompressData(void* data, int32_t srcSize, int32_t* dst, SDiskbasedBuf* pBuf) {  // do nothing
+// the page is compressed by LZ4 in place, the first byte indicates if it is stored as is when it is not compressible.
+static char* doCompressData(void* data, int32_t srcSize, int32_t* dst, SDiskbasedBuf* pBuf) {
   if (!pBuf->comp) {
     *dst = srcSize;
     return data;
@@ -68,46 +36,117 @@ static char* doCompressData(void* data, int32_t srcSize, int32_t* dst, SDiskbase
   return data;
 }
 
-static char* doDecompressData(void* data, int32_t srcSize, int32_t* dst, SDiskbasedBuf* pBuf) {  // do nothing
+static int32_t doDecompressData(void* data, int32_t srcSize, int32_t* dst, SDiskbasedBuf* pBuf) {
   if (!pBuf->comp) {
     *dst = srcSize;
-    return data;
+    return TSDB_CODE_SUCCESS;
   }
 
   *dst = tsDecompressString(data, srcSize, 1, pBuf->assistBuf, pBuf->pageSize, ONE_STAGE_COMP, NULL, 0);
-  if (*dst > 0) {
-    memcpy(data, pBuf->assistBuf, *dst);
+  if (*dst != pBuf->pageSize) {
+    uError("failed to decompress page, size:%d, decompressed size:%d, %s", srcSize, *dst, pBuf->id);
+    return TSDB_CODE_COMPRESS_ERROR;
   }
-  return data;
+
+  memcpy(data, pBuf->assistBuf, *dst);
+  return TSDB_CODE_SUCCESS;
 }
 
-static uint64_t allocatePositionInFile(SDiskbasedBuf* pBuf, size_t size) {
-  if (pBuf->pFree == NULL) {
-    return pBuf->nextPos;
-  } else {
-    int32_t offset = -1;
+// compressed pages have different sizes, so the first free area that is large enough is used, and the rest of the
+// area is kept in the free list.
+static int64_t allocatePositionInFile(SDiskbasedBuf* pBuf, int32_t size) {
+  size_t num = taosArrayGetSize(pBuf->pFree);
+  for (int32_t i = 0; i < num; ++i) {
+    SFreeListItem* pi = taosArrayGet(pBuf->pFree, i);
+    if (pi->length >= size) {
+      int64_t offset = pi->offset;
+      pi->offset += size;
+      pi->length -= size;
+      if (pi->length == 0) {
+        taosArrayRemove(pBuf->pFree, i);
+      }
 
-    size_t num = taosArrayGetSize(pBuf->pFree);
-    for (int32_t i = 0; i < num; ++i) {
-      SFreeListItem* pi = taosArrayGet(pBuf->pFree, i);
-      if (pi->length >= size) {
-        offset = pi->offset;
-        pi->offset += (int32_t)size;
-        pi->length -= (int32_t)size;
+      return offset;
+    }
+  }
 
-        return offset;
-      }
+  // no available recycle space, allocate new area in file
+  int64_t offset = pBuf->nextPos;
+  pBuf->nextPos += size;
+  return offset;
+}
+
+// return the area in file to the free list, and merge it with the adjacent free areas.
+static void addFreeAreaInFile(SDiskbasedBuf* pBuf, int64_t offset, int32_t length) {
+  if (length <= 0) {
+    return;
+  }
+
+  size_t num = taosArrayGetSize(pBuf->pFree);
+  for (int32_t i = 0; i < num; ++i) {
+    SFreeListItem* pi = taosArrayGet(pBuf->pFree, i);
+    if ((int64_t)pi->length + length > INT32_MAX) {
+      continue;
     }
 
-    // no available recycle space, allocate new area in file
-    return pBuf->nextPos;
+    if (pi->offset + pi->length == offset || offset + length == pi->offset) {
+      offset = TMIN(offset, pi->offset);
+      length += pi->length;
+      taosArrayRemove(pBuf->pFree, i);
+      addFreeAreaInFile(pBuf, offset, length);
+      return;
+    }
   }
+
+  // the area is at the end of file, so the next page can be flushed here
+  if (offset + length == pBuf->nextPos) {
+    pBuf->nextPos = offset;
+    return;
+  }
+
+  SFreeListItem item = {.offset = offset, .length = length};
+  taosArrayPush(pBuf->pFree, &item);
 }
 
 static void setPageNotInBuf(SPageInfo* pPageInfo) { pPageInfo->pData = NULL; }
 
 static FORCE_INLINE size_t getAllocPageSize(int32_t pageSize) { return pageSize + POINTER_BYTES + 2; }
 
+// the node level budget is used up, so the pages of this buffer are spilled to disk instead of allocating new ones.
+static bool isMemBudgetExhausted(const SDiskbasedBuf* pBuf) {
+  int64_t budget = atomic_load_64(&dBufMemBudget);
+  if (budget < 0 || listNEles(pBuf->lruList) < DBUF_MIN_IN_MEM_PAGES) {
+    return false;
+  }
+
+  return atomic_load_64(&dBufMemUsed) + (int64_t)getAllocPageSize(pBuf->pageSize) > budget;
+}
+
+static void* allocPageMem(SDiskbasedBuf* pBuf) {
+  int64_t size = getAllocPageSize(pBuf->pageSize);
+  void*   p = taosMemoryCalloc(1, size);  // add extract bytes in case of zipped buffer increased.
+  if (p != NULL) {
+    pBuf->memSize += size;
+    atomic_add_fetch_64(&dBufMemUsed, size);
+  }
+
+  return p;
+}
+
+static void freePageMem(SDiskbasedBuf* pBuf, SPageInfo* pi) {
+  if (pi->pData != NULL) {
+    int64_t size = getAllocPageSize(pBuf->pageSize);
+    pBuf->memSize -= size;
+    atomic_sub_fetch_64(&dBufMemUsed, size);
+    taosMemoryFreeClear(pi->pData);
+  }
+}
+
+static void releaseAllPageMem(SDiskbasedBuf* pBuf) {
+  atomic_sub_fetch_64(&dBufMemUsed, pBuf->memSize);
+  pBuf->memSize = 0;
+}
+
 /**
  *   +--------------------------+-------------------+--------------+
  *   | PTR to SPageInfo (8bytes)| Payload (PageSize)| 2 Extra Bytes|
@@ -121,7 +160,7 @@ static char* doFlushPageToDisk(SDiskbasedBuf* pBuf, SPageInfo* pg) {
 
   int32_t size = pBuf->pageSize;
   char*   t = NULL;
-  if (pg->offset == -1 || pg->dirty) {
+  if (pg->dirty) {
     void* payload = GET_DATA_PAYLOAD(pg);
     t = doCompressData(payload, pBuf->pageSize, &size, pBuf);
     assert(size >= 0);
@@ -133,7 +172,6 @@ static char* doFlushPageToDisk(SDiskbasedBuf* pBuf, SPageInfo* pg) {
       assert(pg->dirty == true);
 
       pg->offset = allocatePositionInFile(pBuf, size);
-      pBuf->nextPos += size;
 
       int32_t ret = taosLSeekFile(pBuf->pFile, pg->offset, SEEK_SET);
       if (ret == -1) {
@@ -154,15 +192,16 @@ static char* doFlushPageToDisk(SDiskbasedBuf* pBuf, SPageInfo* pg) {
       pBuf->statis.flushBytes += size;
       pBuf->statis.flushPages += 1;
     } else {
-      // length becomes greater, current space is not enough, allocate new place, otherwise, do nothing
+      // length becomes greater, current space is not enough, allocate new place, otherwise, the remain space is
+      // returned to the free list
       if (pg->length < size) {
         // 1. add current space to free list
-        SPageDiskInfo dinfo = {.length = pg->length, .offset = pg->offset};
-        taosArrayPush(pBuf->pFree, &dinfo);
+        addFreeAreaInFile(pBuf, pg->offset, pg->length);
 
         // 2. allocate new position, and update the info
         pg->offset = allocatePositionInFile(pBuf, size);
-        pBuf->nextPos += size;
+      } else {
+        addFreeAreaInFile(pBuf, pg->offset + size, pg->length - size);
       }
 
       // 3. write to disk.
@@ -202,7 +241,7 @@ static char* doFlushPageToDisk(SDiskbasedBuf* pBuf, SPageInfo* pg) {
 
 static char* flushPageToDisk(SDiskbasedBuf* pBuf, SPageInfo* pg) {
   int32_t ret = TSDB_CODE_SUCCESS;
-  assert(((int64_t)pBuf->numOfPages * pBuf->pageSize) == pBuf->totalBufSize && pBuf->numOfPages >= pBuf->inMemPages);
+  assert(((int64_t)pBuf->numOfPages * pBuf->pageSize) == pBuf->totalBufSize);
 
   if (pBuf->pFile == NULL) {
     if ((ret = createDiskFile(pBuf)) != TSDB_CODE_SUCCESS) {
@@ -237,8 +276,7 @@ static int32_t loadPageFromDisk(SDiskbasedBuf* pBuf, SPageInfo* pg) {
   pBuf->statis.loadPages += 1;
 
   int32_t fullSize = 0;
-  doDecompressData(pPage, pg->length, &fullSize, pBuf);
-  return 0;
+  return doDecompressData(pPage, pg->length, &fullSize, pBuf);
 }
 
 static SPageInfo* registerPage(SDiskbasedBuf* pBuf, int32_t pageId) {
@@ -286,8 +324,10 @@ static char* evacOneDataPage(SDiskbasedBuf* pBuf) {
   if (pn == NULL) {
     int32_t prev = pBuf->inMemPages;
 
-    // increase by 50% of previous mem pages
-    pBuf->inMemPages = (int32_t)(pBuf->inMemPages * 1.5f);
+    // increase by 50% of previous mem pages, unless it is the node level budget that is used up
+    if (listNEles(pBuf->lruList) >= pBuf->inMemPages) {
+      pBuf->inMemPages = (int32_t)(pBuf->inMemPages * 1.5f);
+    }
 
     //    qWarn("%p in memory buf page not sufficient, expand from %d to %d, page size:%d", pBuf, prev,
     //          pBuf->inMemPages, pBuf->pageSize);
@@ -343,6 +383,7 @@ int32_t createDiskbasedBuf(SDiskbasedBuf** pBuf, int32_t pagesize, int32_t inMem
   pPBuf->fileSize = 0;
   pPBuf->pFree = taosArrayInit(4, sizeof(SFreeListItem));
   pPBuf->freePgList = tdListNew(POINTER_BYTES);
+  pPBuf->comp = true;
 
   // at least more than 2 pages must be in memory
   assert(inMemBufSize >= pagesize * 2);
@@ -402,7 +443,7 @@ void* getNewBufPage(SDiskbasedBuf* pBuf, int32_t* pageId) {
 
   // allocate buf
   if (availablePage == NULL) {
-    pi->pData = taosMemoryCalloc(1, getAllocPageSize(pBuf->pageSize));  // add extract bytes in case of zipped buffer increased.
+    pi->pData = allocPageMem(pBuf);
   } else {
     pi->pData = availablePage;
   }
@@ -443,13 +484,13 @@ void* getBufPage(SDiskbasedBuf* pBuf, int32_t id) {
     char* availablePage = NULL;
     if (NO_IN_MEM_AVAILABLE_PAGES(pBuf)) {
       availablePage = evacOneDataPage(pBuf);
-      if (availablePage == NULL) {
+      if (availablePage == NULL && terrno != 0) {
         return NULL;
       }
     }
 
     if (availablePage == NULL) {
-      (*pi)->pData = taosMemoryCalloc(1, getAllocPageSize(pBuf->pageSize));
+      (*pi)->pData = allocPageMem(pBuf);
     } else {
       (*pi)->pData = availablePage;
     }
@@ -464,6 +505,7 @@ void* getBufPage(SDiskbasedBuf* pBuf, int32_t id) {
     if ((*pi)->length > 0 && (*pi)->offset >= 0) {
       int32_t code = loadPageFromDisk(pBuf, *pi);
       if (code != 0) {
+        terrno = code;
         return NULL;
       }
     }
@@ -474,6 +516,17 @@ void* getBufPage(SDiskbasedBuf* pBuf, int32_t id) {
   }
 }
 
+void prefetchBufPage(SDiskbasedBuf* pBuf, int32_t id) {
+  SPageInfo** pi = taosHashGet(pBuf->all, &id, sizeof(int32_t));
+  if (pi == NULL || *pi == NULL || (*pi)->pData != NULL) {
+    return;
+  }
+
+  if ((*pi)->length > 0 && (*pi)->offset >= 0) {
+    taosPrefetchFile(pBuf->pFile, (*pi)->offset, (*pi)->length);
+  }
+}
+
 void releaseBufPage(SDiskbasedBuf* pBuf, void* page) {
   assert(pBuf != NULL && page != NULL);
   SPageInfo* ppi = getPageInfoFromPayload(page);
@@ -541,6 +594,7 @@ void destroyDiskbasedBuf(SDiskbasedBuf* pBuf) {
     taosMemoryFreeClear(pi);
   }
 
+  releaseAllPageMem(pBuf);
   taosArrayDestroy(pBuf->pIdList);
 
   tdListFree(pBuf->lruList);
@@ -588,15 +642,31 @@ void dBufSetBufPageRecycled(SDiskbasedBuf* pBuf, void* pPage) {
 
   // add this pageinfo into the free page info list
   SListNode* pNode = tdListPopNode(pBuf->lruList, ppi->pn);
-  taosMemoryFreeClear(ppi->pData);
+  freePageMem(pBuf, ppi);
   taosMemoryFreeClear(pNode);
   ppi->pn = NULL;
 
+  // the space in file is not needed any more
+  if (ppi->offset >= 0) {
+    addFreeAreaInFile(pBuf, ppi->offset, ppi->length);
+    ppi->offset = -1;
+    ppi->length = -1;
+  }
+
   tdListAppend(pBuf->freePgList, &ppi);
 }
 
 void dBufSetPrintInfo(SDiskbasedBuf* pBuf) { pBuf->printStatis = true; }
 
+void dBufSetMemBudget(int64_t bytes) { atomic_store_64(&dBufMemBudget, bytes); }
+
+int64_t dBufGetMemUsed() { return atomic_load_64(&dBufMemUsed); }
+
+bool dBufIsMemBudgetExceeded() {
+  int64_t budget = atomic_load_64(&dBufMemBudget);
+  return budget >= 0 && atomic_load_64(&dBufMemUsed) > budget;
+}
+
 SDiskbasedBufStatis getDBufStatis(const SDiskbasedBuf* pBuf) { return pBuf->statis; }
 
 void dBufPrintStatis(const SDiskbasedBuf* pBuf) {
@@ -630,6 +700,7 @@ void clearDiskbasedBuf(SDiskbasedBuf* pBuf) {
     taosMemoryFreeClear(pi);
   }
 
+  releaseAllPageMem(pBuf);
   taosArrayClear(pBuf->pIdList);
 
   tdListEmpty(pBuf->lruList);
@@ -644,4 +715,5 @@ void clearDiskbasedBuf(SDiskbasedBuf* pBuf) {
   pBuf->totalBufSize = 0;
   pBuf->allocateId = -1;
   pBuf->fileSize = 0;
+  pBuf->nextPos = 0;
 }
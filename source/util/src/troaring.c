@@ -0,0 +1,724 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define _DEFAULT_SOURCE
+#include "troaring.h"
+#include "taoserror.h"
+
+#define ROARING_ARRAY_MAX    4096
+#define ROARING_ARRAY_MIN    4
+#define ROARING_BITMAP_WORDS 1024
+#define ROARING_BITMAP_BYTES (ROARING_BITMAP_WORDS * sizeof(uint64_t))
+#define ROARING_CONT_HEAD    (sizeof(uint64_t) + sizeof(int32_t))
+
+#define ROARING_KEY(v) ((v) >> 16)
+#define ROARING_LOW(v) ((uint16_t)((v)&0xFFFF))
+
+struct SRoaringCont {
+  uint64_t key;   // high 48 bits
+  int32_t  card;  // number of values
+  int32_t  cap;   // capacity of an array container, 0 for a bitmap container
+  void    *data;  // uint16_t[cap] or uint64_t[ROARING_BITMAP_WORDS]
+};
+
+#define ROARING_IS_BITMAP(c) ((c)->cap == 0)
+
+static FORCE_INLINE int32_t rPopcnt(uint64_t v) {
+  v = v - ((v >> 1) & 0x5555555555555555ULL);
+  v = (v & 0x3333333333333333ULL) + ((v >> 2) & 0x3333333333333333ULL);
+  v = (v + (v >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+  return (int32_t)((v * 0x0101010101010101ULL) >> 56);
+}
+
+static int32_t rBitmapCard(const uint64_t *words) {
+  int32_t card = 0;
+  for (int32_t i = 0; i < ROARING_BITMAP_WORDS; ++i) {
+    card += rPopcnt(words[i]);
+  }
+  return card;
+}
+
+static FORCE_INLINE bool rBitmapGet(const uint64_t *words, uint16_t low) {
+  return (words[low >> 6] >> (low & 63)) & 1;
+}
+
+// first position in arr[0, n) not less than low
+static FORCE_INLINE int32_t rArrayLowerBound(const uint16_t *arr, int32_t n, uint16_t low) {
+  int32_t s = 0, e = n;
+  while (s < e) {
+    int32_t m = s + (e - s) / 2;
+    if (arr[m] < low) {
+      s = m + 1;
+    } else {
+      e = m;
+    }
+  }
+  return s;
+}
+
+static int32_t rContInitArray(SRoaringCont *pCont, uint64_t key, int32_t cap) {
+  pCont->data = taosMemoryMalloc(sizeof(uint16_t) * cap);
+  if (pCont->data == NULL) return TSDB_CODE_OUT_OF_MEMORY;
+  pCont->key = key;
+  pCont->card = 0;
+  pCont->cap = cap;
+  return 0;
+}
+
+static void rContDestroy(SRoaringCont *pCont) { taosMemoryFreeClear(pCont->data); }
+
+static int32_t rContToBitmap(SRoaringCont *pCont) {
+  uint64_t *words = taosMemoryCalloc(1, ROARING_BITMAP_BYTES);
+  if (words == NULL) return TSDB_CODE_OUT_OF_MEMORY;
+
+  uint16_t *arr = pCont->data;
+  for (int32_t i = 0; i < pCont->card; ++i) {
+    words[arr[i] >> 6] |= (1ULL << (arr[i] & 63));
+  }
+
+  taosMemoryFree(pCont->data);
+  pCont->data = words;
+  pCont->cap = 0;
+  return 0;
+}
+
+// shrink a sparse bitmap back to an array, keeps the bitmap if out of memory
+static void rContNormalize(SRoaringCont *pCont) {
+  if (!ROARING_IS_BITMAP(pCont) || pCont->card > ROARING_ARRAY_MAX) return;
+
+  int32_t   cap = TMAX(pCont->card, ROARING_ARRAY_MIN);
+  uint16_t *arr = taosMemoryMalloc(sizeof(uint16_t) * cap);
+  if (arr == NULL) return;
+
+  uint64_t *words = pCont->data;
+  int32_t   n = 0;
+  for (int32_t i = 0; i < ROARING_BITMAP_WORDS; ++i) {
+    uint64_t w = words[i];
+    while (w != 0) {
+      arr[n++] = (uint16_t)((i << 6) + BUILDIN_CTZL(w));
+      w &= (w - 1);
+    }
+  }
+
+  taosMemoryFree(pCont->data);
+  pCont->data = arr;
+  pCont->cap = cap;
+}
+
+static int32_t rContCopy(SRoaringCont *pDst, const SRoaringCont *pSrc) {
+  int32_t size = ROARING_IS_BITMAP(pSrc) ? ROARING_BITMAP_BYTES : sizeof(uint16_t) * pSrc->card;
+  int32_t cap = ROARING_IS_BITMAP(pSrc) ? 0 : TMAX(pSrc->card, ROARING_ARRAY_MIN);
+
+  pDst->data = taosMemoryMalloc(ROARING_IS_BITMAP(pSrc) ? size : sizeof(uint16_t) * cap);
+  if (pDst->data == NULL) return TSDB_CODE_OUT_OF_MEMORY;
+
+  memcpy(pDst->data, pSrc->data, size);
+  pDst->key = pSrc->key;
+  pDst->card = pSrc->card;
+  pDst->cap = cap;
+  return 0;
+}
+
+static int32_t rContAdd(SRoaringCont *pCont, uint16_t low) {
+  if (ROARING_IS_BITMAP(pCont)) {
+    uint64_t *words = pCont->data;
+    uint64_t  bit = 1ULL << (low & 63);
+    if ((words[low >> 6] & bit) == 0) {
+      words[low >> 6] |= bit;
+      pCont->card++;
+    }
+    return 0;
+  }
+
+  uint16_t *arr = pCont->data;
+  int32_t   pos = (pCont->card > 0 && arr[pCont->card - 1] < low) ? pCont->card : rArrayLowerBound(arr, pCont->card, low);
+  if (pos < pCont->card && arr[pos] == low) return 0;
+
+  if (pCont->card >= ROARING_ARRAY_MAX) {
+    int32_t code = rContToBitmap(pCont);
+    if (code != 0) return code;
+    return rContAdd(pCont, low);
+  }
+
+  if (pCont->card >= pCont->cap) {
+    int32_t cap = TMIN(pCont->cap * 2, ROARING_ARRAY_MAX);
+    void   *data = taosMemoryRealloc(pCont->data, sizeof(uint16_t) * cap);
+    if (data == NULL) return TSDB_CODE_OUT_OF_MEMORY;
+    pCont->data = data;
+    pCont->cap = cap;
+    arr = data;
+  }
+
+  if (pos < pCont->card) {
+    memmove(arr + pos + 1, arr + pos, sizeof(uint16_t) * (pCont->card - pos));
+  }
+  arr[pos] = low;
+  pCont->card++;
+  return 0;
+}
+
+static bool rContContains(const SRoaringCont *pCont, uint16_t low) {
+  if (ROARING_IS_BITMAP(pCont)) {
+    return rBitmapGet(pCont->data, low);
+  }
+  int32_t pos = rArrayLowerBound(pCont->data, pCont->card, low);
+  return pos < pCont->card && ((uint16_t *)pCont->data)[pos] == low;
+}
+
+static int32_t rContOr(SRoaringCont *pCont, const SRoaringCont *pSrc) {
+  if (!ROARING_IS_BITMAP(pCont) && !ROARING_IS_BITMAP(pSrc) && pCont->card + pSrc->card <= ROARING_ARRAY_MAX) {
+    const uint16_t *a = pCont->data;
+    const uint16_t *b = pSrc->data;
+    int32_t         cap = TMAX(pCont->card + pSrc->card, ROARING_ARRAY_MIN);
+    uint16_t       *arr = taosMemoryMalloc(sizeof(uint16_t) * cap);
+    if (arr == NULL) return TSDB_CODE_OUT_OF_MEMORY;
+
+    int32_t i = 0, j = 0, n = 0;
+    while (i < pCont->card && j < pSrc->card) {
+      if (a[i] < b[j]) {
+        arr[n++] = a[i++];
+      } else if (a[i] > b[j]) {
+        arr[n++] = b[j++];
+      } else {
+        arr[n++] = a[i++];
+        j++;
+      }
+    }
+    while (i < pCont->card) arr[n++] = a[i++];
+    while (j < pSrc->card) arr[n++] = b[j++];
+
+    taosMemoryFree(pCont->data);
+    pCont->data = arr;
+    pCont->card = n;
+    pCont->cap = cap;
+    return 0;
+  }
+
+  if (!ROARING_IS_BITMAP(pCont)) {
+    int32_t code = rContToBitmap(pCont);
+    if (code != 0) return code;
+  }
+
+  uint64_t *words = pCont->data;
+  if (ROARING_IS_BITMAP(pSrc)) {
+    const uint64_t *src = pSrc->data;
+    for (int32_t i = 0; i < ROARING_BITMAP_WORDS; ++i) {
+      words[i] |= src[i];
+    }
+  } else {
+    const uint16_t *src = pSrc->data;
+    for (int32_t i = 0; i < pSrc->card; ++i) {
+      words[src[i] >> 6] |= (1ULL << (src[i] & 63));
+    }
+  }
+  pCont->card = rBitmapCard(words);
+  rContNormalize(pCont);
+  return 0;
+}
+
+static int32_t rContAnd(SRoaringCont *pCont, const SRoaringCont *pSrc) {
+  if (ROARING_IS_BITMAP(pCont) && ROARING_IS_BITMAP(pSrc)) {
+    uint64_t       *words = pCont->data;
+    const uint64_t *src = pSrc->data;
+    for (int32_t i = 0; i < ROARING_BITMAP_WORDS; ++i) {
+      words[i] &= src[i];
+    }
+    pCont->card = rBitmapCard(words);
+    rContNormalize(pCont);
+    return 0;
+  }
+
+  if (ROARING_IS_BITMAP(pCont)) {
+    // the result can not be larger than the array
+    int32_t   cap = TMAX(pSrc->card, ROARING_ARRAY_MIN);
+    uint16_t *arr = taosMemoryMalloc(sizeof(uint16_t) * cap);
+    if (arr == NULL) return TSDB_CODE_OUT_OF_MEMORY;
+
+    const uint16_t *src = pSrc->data;
+    int32_t         n = 0;
+    for (int32_t i = 0; i < pSrc->card; ++i) {
+      if (rBitmapGet(pCont->data, src[i])) arr[n++] = src[i];
+    }
+
+    taosMemoryFree(pCont->data);
+    pCont->data = arr;
+    pCont->card = n;
+    pCont->cap = cap;
+    return 0;
+  }
+
+  uint16_t *arr = pCont->data;
+  int32_t   n = 0;
+  if (ROARING_IS_BITMAP(pSrc)) {
+    for (int32_t i = 0; i < pCont->card; ++i) {
+      if (rBitmapGet(pSrc->data, arr[i])) arr[n++] = arr[i];
+    }
+  } else {
+    const uint16_t *src = pSrc->data;
+    int32_t         i = 0, j = 0;
+    while (i < pCont->card && j < pSrc->card) {
+      if (arr[i] < src[j]) {
+        i++;
+      } else if (arr[i] > src[j]) {
+        j++;
+      } else {
+        arr[n++] = arr[i++];
+        j++;
+      }
+    }
+  }
+  pCont->card = n;
+  return 0;
+}
+
+static int32_t rContAndNot(SRoaringCont *pCont, const SRoaringCont *pSrc) {
+  if (ROARING_IS_BITMAP(pCont)) {
+    uint64_t *words = pCont->data;
+    if (ROARING_IS_BITMAP(pSrc)) {
+      const uint64_t *src = pSrc->data;
+      for (int32_t i = 0; i < ROARING_BITMAP_WORDS; ++i) {
+        words[i] &= ~src[i];
+      }
+    } else {
+      const uint16_t *src = pSrc->data;
+      for (int32_t i = 0; i < pSrc->card; ++i) {
+        words[src[i] >> 6] &= ~(1ULL << (src[i] & 63));
+      }
+    }
+    pCont->card = rBitmapCard(words);
+    rContNormalize(pCont);
+    return 0;
+  }
+
+  uint16_t *arr = pCont->data;
+  int32_t   n = 0;
+  if (ROARING_IS_BITMAP(pSrc)) {
+    for (int32_t i = 0; i < pCont->card; ++i) {
+      if (!rBitmapGet(pSrc->data, arr[i])) arr[n++] = arr[i];
+    }
+  } else {
+    const uint16_t *src = pSrc->data;
+    int32_t         i = 0, j = 0;
+    while (i < pCont->card) {
+      while (j < pSrc->card && src[j] < arr[i]) j++;
+      if (j >= pSrc->card || src[j] != arr[i]) {
+        arr[n++] = arr[i];
+      }
+      i++;
+    }
+  }
+  pCont->card = n;
+  return 0;
+}
+
+// index of the container with key, or -(insert position) - 1
+static int32_t rFindCont(const SRoaring *pRoaring, uint64_t key) {
+  int32_t size = pRoaring->size;
+  if (size == 0 || pRoaring->pConts[size - 1].key < key) return -size - 1;
+  if (pRoaring->pConts[size - 1].key == key) return size - 1;
+
+  int32_t s = 0, e = size - 1;
+  while (s <= e) {
+    int32_t  m = s + (e - s) / 2;
+    uint64_t k = pRoaring->pConts[m].key;
+    if (k == key) return m;
+    if (k < key) {
+      s = m + 1;
+    } else {
+      e = m - 1;
+    }
+  }
+  return -s - 1;
+}
+
+static int32_t rEnsureCap(SRoaring *pRoaring, int32_t size) {
+  if (size <= pRoaring->cap) return 0;
+
+  int32_t cap = TMAX(pRoaring->cap * 2, 4);
+  while (cap < size) cap *= 2;
+
+  void *pConts = taosMemoryRealloc(pRoaring->pConts, sizeof(SRoaringCont) * cap);
+  if (pConts == NULL) return TSDB_CODE_OUT_OF_MEMORY;
+
+  pRoaring->pConts = pConts;
+  pRoaring->cap = cap;
+  return 0;
+}
+
+SRoaring *tRoaringCreate() {
+  SRoaring *pRoaring = taosMemoryCalloc(1, sizeof(SRoaring));
+  if (pRoaring == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+  }
+  return pRoaring;
+}
+
+void tRoaringClear(SRoaring *pRoaring) {
+  if (pRoaring == NULL) return;
+  for (int32_t i = 0; i < pRoaring->size; ++i) {
+    rContDestroy(&pRoaring->pConts[i]);
+  }
+  pRoaring->size = 0;
+}
+
+void tRoaringDestroy(SRoaring *pRoaring) {
+  if (pRoaring == NULL) return;
+  tRoaringClear(pRoaring);
+  taosMemoryFree(pRoaring->pConts);
+  taosMemoryFree(pRoaring);
+}
+
+int32_t tRoaringAdd(SRoaring *pRoaring, uint64_t val) {
+  uint64_t key = ROARING_KEY(val);
+  int32_t  idx = rFindCont(pRoaring, key);
+  if (idx < 0) {
+    idx = -idx - 1;
+
+    int32_t code = rEnsureCap(pRoaring, pRoaring->size + 1);
+    if (code != 0) return code;
+
+    SRoaringCont cont = {0};
+    code = rContInitArray(&cont, key, ROARING_ARRAY_MIN);
+    if (code != 0) return code;
+
+    if (idx < pRoaring->size) {
+      memmove(&pRoaring->pConts[idx + 1], &pRoaring->pConts[idx], sizeof(SRoaringCont) * (pRoaring->size - idx));
+    }
+    pRoaring->pConts[idx] = cont;
+    pRoaring->size++;
+  }
+
+  return rContAdd(&pRoaring->pConts[idx], ROARING_LOW(val));
+}
+
+static int32_t rUint64Compare(const void *a, const void *b) {
+  uint64_t u1 = *(uint64_t *)a;
+  uint64_t u2 = *(uint64_t *)b;
+  if (u1 == u2) return 0;
+  return u1 < u2 ? -1 : 1;
+}
+
+int32_t tRoaringAddArray(SRoaring *pRoaring, const SArray *pVals) {
+  int32_t size = taosArrayGetSize(pVals);
+  bool    sorted = true;
+  for (int32_t i = 1; i < size && sorted; ++i) {
+    sorted = *(uint64_t *)taosArrayGet(pVals, i - 1) <= *(uint64_t *)taosArrayGet(pVals, i);
+  }
+
+  // sorted input always appends to the last container, random input would shift containers around
+  SArray *pSorted = NULL;
+  if (!sorted) {
+    pSorted = taosArrayDup(pVals);
+    if (pSorted == NULL) return TSDB_CODE_OUT_OF_MEMORY;
+    taosArraySort(pSorted, rUint64Compare);
+    pVals = pSorted;
+  }
+
+  int32_t code = 0;
+  for (int32_t i = 0; i < size; ++i) {
+    code = tRoaringAdd(pRoaring, *(uint64_t *)taosArrayGet(pVals, i));
+    if (code != 0) break;
+  }
+
+  taosArrayDestroy(pSorted);
+  return code;
+}
+
+bool tRoaringContains(const SRoaring *pRoaring, uint64_t val) {
+  int32_t idx = rFindCont(pRoaring, ROARING_KEY(val));
+  if (idx < 0) return false;
+  return rContContains(&pRoaring->pConts[idx], ROARING_LOW(val));
+}
+
+int64_t tRoaringCardinality(const SRoaring *pRoaring) {
+  int64_t card = 0;
+  for (int32_t i = 0; i < pRoaring->size; ++i) {
+    card += pRoaring->pConts[i].card;
+  }
+  return card;
+}
+
+int32_t tRoaringOr(SRoaring *pDst, const SRoaring *pSrc) {
+  if (pSrc == NULL || pSrc->size == 0) return 0;
+
+  int32_t       cap = pDst->size + pSrc->size;
+  SRoaringCont *pConts = taosMemoryCalloc(cap, sizeof(SRoaringCont));
+  if (pConts == NULL) return TSDB_CODE_OUT_OF_MEMORY;
+
+  int32_t code = 0;
+  int32_t i = 0, j = 0, n = 0;
+  while (i < pDst->size || j < pSrc->size) {
+    SRoaringCont *pCont = (i < pDst->size) ? &pDst->pConts[i] : NULL;
+    const SRoaringCont *pOther = (j < pSrc->size) ? &pSrc->pConts[j] : NULL;
+
+    if (pOther == NULL || (pCont != NULL && pCont->key < pOther->key)) {
+      pConts[n++] = *pCont;
+      i++;
+    } else if (pCont == NULL || pOther->key < pCont->key) {
+      code = rContCopy(&pConts[n], pOther);
+      if (code != 0) break;
+      n++;
+      j++;
+    } else {
+      pConts[n] = *pCont;
+      i++;
+      n++;
+      code = rContOr(&pConts[n - 1], pOther);
+      if (code != 0) break;
+      j++;
+    }
+  }
+
+  // keep the containers not merged yet, the result is partial when out of memory
+  for (; i < pDst->size; ++i) {
+    pConts[n++] = pDst->pConts[i];
+  }
+
+  taosMemoryFree(pDst->pConts);
+  pDst->pConts = pConts;
+  pDst->size = n;
+  pDst->cap = cap;
+  return code;
+}
+
+int32_t tRoaringAnd(SRoaring *pDst, const SRoaring *pSrc) {
+  int32_t code = 0;
+  int32_t j = 0, n = 0;
+  for (int32_t i = 0; i < pDst->size; ++i) {
+    SRoaringCont *pCont = &pDst->pConts[i];
+    while (pSrc != NULL && j < pSrc->size && pSrc->pConts[j].key < pCont->key) j++;
+
+    if (code == 0) {
+      if (pSrc == NULL || j >= pSrc->size || pSrc->pConts[j].key != pCont->key) {
+        pCont->card = 0;
+      } else {
+        code = rContAnd(pCont, &pSrc->pConts[j]);
+      }
+    }
+
+    if (pCont->card == 0) {
+      rContDestroy(pCont);
+    } else {
+      pDst->pConts[n++] = *pCont;
+    }
+  }
+
+  pDst->size = n;
+  return code;
+}
+
+int32_t tRoaringAndNot(SRoaring *pDst, const SRoaring *pSrc) {
+  if (pSrc == NULL || pSrc->size == 0) return 0;
+
+  int32_t j = 0, n = 0;
+  for (int32_t i = 0; i < pDst->size; ++i) {
+    SRoaringCont *pCont = &pDst->pConts[i];
+    while (j < pSrc->size && pSrc->pConts[j].key < pCont->key) j++;
+
+    if (j < pSrc->size && pSrc->pConts[j].key == pCont->key) {
+      (void)rContAndNot(pCont, &pSrc->pConts[j]);
+    }
+
+    if (pCont->card == 0) {
+      rContDestroy(pCont);
+    } else {
+      pDst->pConts[n++] = *pCont;
+    }
+  }
+
+  pDst->size = n;
+  return 0;
+}
+
+int32_t tRoaringToArray(const SRoaring *pRoaring, SArray *pVals) {
+  size_t start = taosArrayGetSize(pVals);
+  if (taosArrayEnsureCap(pVals, start + tRoaringCardinality(pRoaring)) != 0) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  uint64_t *out = (uint64_t *)pVals->pData + start;
+  int64_t   n = 0;
+  for (int32_t i = 0; i < pRoaring->size; ++i) {
+    const SRoaringCont *pCont = &pRoaring->pConts[i];
+    uint64_t            high = pCont->key << 16;
+
+    if (ROARING_IS_BITMAP(pCont)) {
+      const uint64_t *words = pCont->data;
+      for (int32_t k = 0; k < ROARING_BITMAP_WORDS; ++k) {
+        uint64_t w = words[k];
+        while (w != 0) {
+          out[n++] = high | (uint64_t)((k << 6) + BUILDIN_CTZL(w));
+          w &= (w - 1);
+        }
+      }
+    } else {
+      const uint16_t *arr = pCont->data;
+      for (int32_t k = 0; k < pCont->card; ++k) {
+        out[n++] = high | arr[k];
+      }
+    }
+  }
+
+  taosArraySetSize(pVals, start + n);
+  return 0;
+}
+
+/*
+ * |<--nCont-->|<--key-->|<--card-->|<--uint16_t[card] or uint64_t[1024]-->| ...
+ * |<-int32_t->|<uint64_t>|<-int32_t->|
+ */
+int32_t tRoaringSerialSize(const SRoaring *pRoaring) {
+  int32_t size = sizeof(int32_t);
+  for (int32_t i = 0; i < pRoaring->size; ++i) {
+    const SRoaringCont *pCont = &pRoaring->pConts[i];
+    size += ROARING_CONT_HEAD;
+    size += (pCont->card > ROARING_ARRAY_MAX) ? ROARING_BITMAP_BYTES : sizeof(uint16_t) * pCont->card;
+  }
+  return size;
+}
+
+int32_t tRoaringSerialize(const SRoaring *pRoaring, void *buf) {
+  char *p = buf;
+  memcpy(p, &pRoaring->size, sizeof(int32_t));
+  p += sizeof(int32_t);
+
+  for (int32_t i = 0; i < pRoaring->size; ++i) {
+    const SRoaringCont *pCont = &pRoaring->pConts[i];
+    memcpy(p, &pCont->key, sizeof(uint64_t));
+    p += sizeof(uint64_t);
+    memcpy(p, &pCont->card, sizeof(int32_t));
+    p += sizeof(int32_t);
+
+    if (pCont->card > ROARING_ARRAY_MAX) {
+      memcpy(p, pCont->data, ROARING_BITMAP_BYTES);
+      p += ROARING_BITMAP_BYTES;
+    } else if (ROARING_IS_BITMAP(pCont)) {
+      // a bitmap not normalized yet, write it as an array
+      const uint64_t *words = pCont->data;
+      for (int32_t k = 0; k < ROARING_BITMAP_WORDS; ++k) {
+        uint64_t w = words[k];
+        while (w != 0) {
+          uint16_t low = (uint16_t)((k << 6) + BUILDIN_CTZL(w));
+          memcpy(p, &low, sizeof(uint16_t));
+          p += sizeof(uint16_t);
+          w &= (w - 1);
+        }
+      }
+    } else {
+      memcpy(p, pCont->data, sizeof(uint16_t) * pCont->card);
+      p += sizeof(uint16_t) * pCont->card;
+    }
+  }
+
+  return (int32_t)(p - (char *)buf);
+}
+
+int32_t tRoaringDeserializeOr(SRoaring *pRoaring, const void *buf, int32_t len) {
+  const char *p = buf;
+  const char *end = p + len;
+  int32_t     nCont = 0;
+  int32_t     code = 0;
+
+  if (len < sizeof(int32_t)) return TSDB_CODE_FILE_CORRUPTED;
+  memcpy(&nCont, p, sizeof(int32_t));
+  p += sizeof(int32_t);
+  if (nCont < 0 || nCont > (len - sizeof(int32_t)) / ROARING_CONT_HEAD) return TSDB_CODE_FILE_CORRUPTED;
+
+  SRoaring decoded = {0};
+  code = rEnsureCap(&decoded, nCont);
+  if (code != 0) return code;
+
+  for (int32_t i = 0; i < nCont; ++i) {
+    SRoaringCont cont = {0};
+    if (end - p < ROARING_CONT_HEAD) {
+      code = TSDB_CODE_FILE_CORRUPTED;
+      break;
+    }
+    memcpy(&cont.key, p, sizeof(uint64_t));
+    p += sizeof(uint64_t);
+    memcpy(&cont.card, p, sizeof(int32_t));
+    p += sizeof(int32_t);
+
+    if (cont.card <= 0 || cont.card > 65536 || cont.key > ROARING_KEY(UINT64_MAX) ||
+        (i > 0 && cont.key <= decoded.pConts[i - 1].key)) {
+      code = TSDB_CODE_FILE_CORRUPTED;
+      break;
+    }
+
+    if (cont.card > ROARING_ARRAY_MAX) {
+      if (end - p < ROARING_BITMAP_BYTES) {
+        code = TSDB_CODE_FILE_CORRUPTED;
+        break;
+      }
+      cont.data = taosMemoryMalloc(ROARING_BITMAP_BYTES);
+      if (cont.data == NULL) {
+        code = TSDB_CODE_OUT_OF_MEMORY;
+        break;
+      }
+      memcpy(cont.data, p, ROARING_BITMAP_BYTES);
+      p += ROARING_BITMAP_BYTES;
+      cont.card = rBitmapCard(cont.data);
+      if (cont.card == 0) {
+        rContDestroy(&cont);
+        code = TSDB_CODE_FILE_CORRUPTED;
+        break;
+      }
+      rContNormalize(&cont);
+    } else {
+      int32_t size = sizeof(uint16_t) * cont.card;
+      if (end - p < size) {
+        code = TSDB_CODE_FILE_CORRUPTED;
+        break;
+      }
+      cont.cap = TMAX(cont.card, ROARING_ARRAY_MIN);
+      cont.data = taosMemoryMalloc(sizeof(uint16_t) * cont.cap);
+      if (cont.data == NULL) {
+        code = TSDB_CODE_OUT_OF_MEMORY;
+        break;
+      }
+      memcpy(cont.data, p, size);
+      p += size;
+
+      uint16_t *arr = cont.data;
+      for (int32_t k = 1; k < cont.card; ++k) {
+        if (arr[k] <= arr[k - 1]) {
+          code = TSDB_CODE_FILE_CORRUPTED;
+          break;
+        }
+      }
+    }
+
+    decoded.pConts[decoded.size++] = cont;
+    if (code != 0) break;
+  }
+
+  if (code == 0) {
+    if (pRoaring->size == 0) {
+      // take over the decoded containers directly
+      SRoaringCont *pConts = pRoaring->pConts;
+      pRoaring->pConts = decoded.pConts;
+      pRoaring->size = decoded.size;
+      pRoaring->cap = decoded.cap;
+      decoded.pConts = pConts;
+      decoded.size = 0;
+    } else {
+      code = tRoaringOr(pRoaring, &decoded);
+    }
+  }
+
+  tRoaringClear(&decoded);
+  taosMemoryFree(decoded.pConts);
+  return code;
+}
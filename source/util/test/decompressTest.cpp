@@ -0,0 +1,205 @@
+#include <gtest/gtest.h>
+#include <string>
+
+#include "tcompression.h"
+
+namespace {
+
+const int32_t kNumOfElems = 100000;
+
+void genIntData(int32_t mode, char type, char *data, int32_t n) {
+  for (int32_t i = 0; i < n; i++) {
+    int64_t v = 0;
+    switch (mode) {
+      case 0:  // small deltas, dense simple8b words
+        v = taosRand() % 3;
+        break;
+      case 1:  // signed deltas
+        v = (int64_t)(taosRand() % 1000) - 500;
+        break;
+      case 2:  // long runs of equal values
+        v = i / 7;
+        break;
+      default:  // random values, usually not compressible
+        v = taosRand();
+        break;
+    }
+
+    switch (type) {
+      case TSDB_DATA_TYPE_TINYINT:
+        ((int8_t *)data)[i] = (int8_t)v;
+        break;
+      case TSDB_DATA_TYPE_SMALLINT:
+        ((int16_t *)data)[i] = (int16_t)v;
+        break;
+      case TSDB_DATA_TYPE_INT:
+        ((int32_t *)data)[i] = (int32_t)v;
+        break;
+      case TSDB_DATA_TYPE_BIGINT:
+        ((int64_t *)data)[i] = v;
+        break;
+    }
+  }
+}
+
+void genTimestampData(int32_t mode, int64_t *data, int32_t n) {
+  for (int32_t i = 0; i < n; i++) {
+    switch (mode) {
+      case 0:  // regular interval
+        data[i] = 1600000000000 + i * 1000;
+        break;
+      case 1:  // interval with jitter
+        data[i] = 1600000000000 + i * 1000 + taosRand() % 10;
+        break;
+      default:  // out of order
+        data[i] = 1600000000000 + taosRand() % 100000;
+        break;
+    }
+  }
+}
+
+// the decoding time of each value in ns, recorded to the test output
+void recordNsPerValue(const char *name, int64_t us, int32_t loops) {
+  ::testing::Test::RecordProperty(std::string(name) + "_ns", std::to_string(us * 1000.0 / loops / kNumOfElems));
+}
+
+}  // namespace
+
+TEST(decompressTest, simple8b_identical) {
+  if (!tsDecompressAVX2Supported()) GTEST_SKIP() << "AVX2 decoders are not supported on this CPU";
+
+  char    types[] = {TSDB_DATA_TYPE_TINYINT, TSDB_DATA_TYPE_SMALLINT, TSDB_DATA_TYPE_INT, TSDB_DATA_TYPE_BIGINT};
+  int32_t aBytes[] = {CHAR_BYTES, SHORT_BYTES, INT_BYTES, LONG_BYTES};
+  char   *input = (char *)taosMemoryMalloc(sizeof(int64_t) * kNumOfElems);
+  char   *cmpr = (char *)taosMemoryMalloc(sizeof(int64_t) * kNumOfElems + 1);
+  char   *output1 = (char *)taosMemoryMalloc(sizeof(int64_t) * kNumOfElems);
+  char   *output2 = (char *)taosMemoryMalloc(sizeof(int64_t) * kNumOfElems);
+
+  for (int32_t mode = 0; mode < 4; mode++) {
+    for (int32_t t = 0; t < 4; t++) {
+      int32_t bytes = aBytes[t];
+      genIntData(mode, types[t], input, kNumOfElems);
+
+      for (int32_t n = 1; n <= kNumOfElems; n = (n < 64) ? n + 1 : n * 3) {
+        tsCompressINTImp(input, n, cmpr, types[t]);
+        ASSERT_EQ(tsDecompressINTImpScalar(cmpr, n, output1, types[t]), n * bytes);
+        ASSERT_EQ(tsDecompressINTImpAVX2(cmpr, n, output2, types[t]), n * bytes);
+        ASSERT_EQ(memcmp(input, output1, n * bytes), 0);
+        ASSERT_EQ(memcmp(output1, output2, n * bytes), 0);
+      }
+    }
+  }
+
+  taosMemoryFree(input);
+  taosMemoryFree(cmpr);
+  taosMemoryFree(output1);
+  taosMemoryFree(output2);
+}
+
+TEST(decompressTest, timestamp_identical) {
+  if (!tsDecompressAVX2Supported()) GTEST_SKIP() << "AVX2 decoders are not supported on this CPU";
+
+  int64_t *input = (int64_t *)taosMemoryMalloc(sizeof(int64_t) * kNumOfElems);
+  char    *cmpr = (char *)taosMemoryMalloc(sizeof(int64_t) * kNumOfElems + 1);
+  char    *output1 = (char *)taosMemoryMalloc(sizeof(int64_t) * kNumOfElems);
+  char    *output2 = (char *)taosMemoryMalloc(sizeof(int64_t) * kNumOfElems);
+
+  for (int32_t mode = 0; mode < 3; mode++) {
+    genTimestampData(mode, input, kNumOfElems);
+
+    for (int32_t n = 1; n <= kNumOfElems; n = (n < 64) ? n + 1 : n * 3) {
+      tsCompressTimestampImp((char *)input, n, cmpr);
+      ASSERT_EQ(tsDecompressTimestampImpScalar(cmpr, n, output1), (int32_t)(n * sizeof(int64_t)));
+      ASSERT_EQ(tsDecompressTimestampImpAVX2(cmpr, n, output2), (int32_t)(n * sizeof(int64_t)));
+      ASSERT_EQ(memcmp(input, output1, n * sizeof(int64_t)), 0);
+      ASSERT_EQ(memcmp(output1, output2, n * sizeof(int64_t)), 0);
+    }
+  }
+
+  taosMemoryFree(input);
+  taosMemoryFree(cmpr);
+  taosMemoryFree(output1);
+  taosMemoryFree(output2);
+}
+
+TEST(decompressTest, zstd_two_stage) {
+  int32_t size = sizeof(int64_t) * kNumOfElems;
+  char   *input = (char *)taosMemoryMalloc(size);
+  char   *cmpr = (char *)taosMemoryMalloc(size + COMP_OVERFLOW_BYTES);
+  char   *buffer = (char *)taosMemoryMalloc(size + COMP_OVERFLOW_BYTES);
+  char   *output = (char *)taosMemoryMalloc(size);
+
+  for (int32_t mode = 0; mode < 4; mode++) {
+    genIntData(mode, TSDB_DATA_TYPE_BIGINT, input, kNumOfElems);
+
+    int32_t len1 = tsCompressBigint(input, size, kNumOfElems, cmpr, size + COMP_OVERFLOW_BYTES, TWO_STAGE_COMP_ZSTD,
+                                    buffer, size + COMP_OVERFLOW_BYTES);
+    ASSERT_GT(len1, 0);
+    ASSERT_EQ(tsDecompressBigint(cmpr, len1, kNumOfElems, output, size, TWO_STAGE_COMP_ZSTD, buffer,
+                                 size + COMP_OVERFLOW_BYTES),
+              size);
+    ASSERT_EQ(memcmp(input, output, size), 0);
+
+    int32_t len2 = tsCompressBigint(input, size, kNumOfElems, cmpr, size + COMP_OVERFLOW_BYTES, TWO_STAGE_COMP,
+                                    buffer, size + COMP_OVERFLOW_BYTES);
+    RecordProperty("mode" + std::to_string(mode) + "_lz4_bytes", len2);
+    RecordProperty("mode" + std::to_string(mode) + "_zstd_bytes", len1);
+  }
+
+  // raw strings go through zstd directly
+  for (int32_t i = 0; i < size; i++) input[i] = 'a' + (i % 61) % 26;
+  int32_t len = tsCompressString(input, size, 1, cmpr, size + COMP_OVERFLOW_BYTES, TWO_STAGE_COMP_ZSTD, NULL, 0);
+  ASSERT_GT(len, 0);
+  ASSERT_LT(len, size);
+  ASSERT_EQ(tsDecompressString(cmpr, len, 1, output, size, TWO_STAGE_COMP_ZSTD, NULL, 0), size);
+  ASSERT_EQ(memcmp(input, output, size), 0);
+
+  taosMemoryFree(input);
+  taosMemoryFree(cmpr);
+  taosMemoryFree(buffer);
+  taosMemoryFree(output);
+}
+
+// micro benchmark, the AVX2 decoders fall back to the scalar ones when not compiled in
+TEST(decompressTest, benchmark) {
+  const int32_t loops = 200;
+  int64_t      *input = (int64_t *)taosMemoryMalloc(sizeof(int64_t) * kNumOfElems);
+  char         *cmpr = (char *)taosMemoryMalloc(sizeof(int64_t) * kNumOfElems + 1);
+  char         *output = (char *)taosMemoryMalloc(sizeof(int64_t) * kNumOfElems);
+
+  RecordProperty("avx2", tsDecompressAVX2Supported() ? "enabled" : "disabled");
+
+  genIntData(0, TSDB_DATA_TYPE_BIGINT, (char *)input, kNumOfElems);
+  tsCompressINTImp((char *)input, kNumOfElems, cmpr, TSDB_DATA_TYPE_BIGINT);
+
+  int64_t st = taosGetTimestampUs();
+  for (int32_t i = 0; i < loops; i++) tsDecompressINTImpScalar(cmpr, kNumOfElems, output, TSDB_DATA_TYPE_BIGINT);
+  int64_t et = taosGetTimestampUs();
+  recordNsPerValue("simple8b_bigint_scalar", et - st, loops);
+
+  if (tsDecompressAVX2Supported()) {
+    st = taosGetTimestampUs();
+    for (int32_t i = 0; i < loops; i++) tsDecompressINTImpAVX2(cmpr, kNumOfElems, output, TSDB_DATA_TYPE_BIGINT);
+    et = taosGetTimestampUs();
+    recordNsPerValue("simple8b_bigint_avx2", et - st, loops);
+  }
+
+  genTimestampData(1, input, kNumOfElems);
+  tsCompressTimestampImp((char *)input, kNumOfElems, cmpr);
+
+  st = taosGetTimestampUs();
+  for (int32_t i = 0; i < loops; i++) tsDecompressTimestampImpScalar(cmpr, kNumOfElems, output);
+  et = taosGetTimestampUs();
+  recordNsPerValue("timestamp_scalar", et - st, loops);
+
+  if (tsDecompressAVX2Supported()) {
+    st = taosGetTimestampUs();
+    for (int32_t i = 0; i < loops; i++) tsDecompressTimestampImpAVX2(cmpr, kNumOfElems, output);
+    et = taosGetTimestampUs();
+    recordNsPerValue("timestamp_avx2", et - st, loops);
+  }
+
+  taosMemoryFree(input);
+  taosMemoryFree(cmpr);
+  taosMemoryFree(output);
+}
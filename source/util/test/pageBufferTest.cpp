@@ -4,6 +4,7 @@
 
 #include "taos.h"
 #include "tpagedbuf.h"
+#include "tpagedbufInt.h"
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wunused-function"
@@ -11,9 +12,10 @@
 
 namespace {
 // simple test
-void simpleTest() {
+void simpleTest(bool comp) {
   SDiskbasedBuf* pBuf = NULL;
   int32_t ret = createDiskbasedBuf(&pBuf, 1024, 4096, "", TD_TMP_DIR_PATH);
+  setBufPageCompressOnDisk(pBuf, comp);
   
   int32_t pageId = 0;
   int32_t groupId = 0;
@@ -55,9 +57,10 @@ void simpleTest() {
   destroyDiskbasedBuf(pBuf);
 }
 
-void writeDownTest() {
+void writeDownTest(bool comp) {
   SDiskbasedBuf* pBuf = NULL;
   int32_t ret = createDiskbasedBuf(&pBuf, 1024, 4*1024, "1", TD_TMP_DIR_PATH);
+  setBufPageCompressOnDisk(pBuf, comp);
 
   int32_t pageId = 0;
   int32_t writePageId = 0;
@@ -104,9 +107,10 @@ void writeDownTest() {
   destroyDiskbasedBuf(pBuf);
 }
 
-void recyclePageTest() {
+void recyclePageTest(bool comp) {
   SDiskbasedBuf* pBuf = NULL;
   int32_t ret = createDiskbasedBuf(&pBuf, 1024, 4*1024, "1", TD_TMP_DIR_PATH);
+  setBufPageCompressOnDisk(pBuf, comp);
 
   int32_t pageId = 0;
   int32_t writePageId = 0;
@@ -157,14 +161,176 @@ void recyclePageTest() {
 
   destroyDiskbasedBuf(pBuf);
 }
+
+void memBudgetTest() {
+  // the node level budget only holds 4 pages, the rest of pages must be spilled to disk
+  const int64_t budget = 4 * (1024 + sizeof(void*) + 2);
+  dBufSetMemBudget(budget);
+
+  SDiskbasedBuf* pBuf = NULL;
+  int32_t ret = createDiskbasedBuf(&pBuf, 1024, 16*1024, "1", TD_TMP_DIR_PATH);
+
+  int32_t pageId = 0;
+  for (int32_t i = 0; i < 8; ++i) {
+    SFilePage* pBufPage = static_cast<SFilePage*>(getNewBufPage(pBuf, &pageId));
+    ASSERT_TRUE(pBufPage != NULL);
+    ASSERT_EQ(pageId, i);
+
+    *(int32_t*)(pBufPage->data) = i;
+    setBufPageDirty(pBufPage, true);
+    releaseBufPage(pBuf, pBufPage);
+    ASSERT_LE(dBufGetMemUsed(), budget);
+  }
+
+  ASSERT_FALSE(isAllDataInMemBuf(pBuf));
+  ASSERT_FALSE(dBufIsMemBudgetExceeded());
+
+  for (int32_t i = 0; i < 8; ++i) {
+    SFilePage* pBufPage = static_cast<SFilePage*>(getBufPage(pBuf, i));
+    ASSERT_TRUE(pBufPage != NULL);
+    ASSERT_EQ(*(int32_t*)(pBufPage->data), i);
+    releaseBufPage(pBuf, pBufPage);
+  }
+
+  destroyDiskbasedBuf(pBuf);
+  ASSERT_EQ(dBufGetMemUsed(), 0);
+  dBufSetMemBudget(-1);
+}
+
+SPageInfo* getPageInfo(SDiskbasedBuf* pBuf, int32_t pageId) {
+  return static_cast<SPageInfo*>(taosArrayGetP(getDataBufPagesIdList(pBuf), pageId));
+}
+
+void recyclePage(SDiskbasedBuf* pBuf, int32_t pageId) {
+  void* pPage = getBufPage(pBuf, pageId);
+  ASSERT_TRUE(pPage != NULL);
+  dBufSetBufPageRecycled(pBuf, pPage);
+}
+
+void freeAreaTest() {
+  SDiskbasedBuf* pBuf = NULL;
+  int32_t ret = createDiskbasedBuf(&pBuf, 1024, 2*1024, "1", TD_TMP_DIR_PATH);
+  setBufPageCompressOnDisk(pBuf, false);
+
+  // only two pages are kept in memory, so pages 0 - 5 are flushed to disk one after another
+  int32_t pageId = 0;
+  for (int32_t i = 0; i < 8; ++i) {
+    SFilePage* pBufPage = static_cast<SFilePage*>(getNewBufPage(pBuf, &pageId));
+    ASSERT_TRUE(pBufPage != NULL);
+    *(int32_t*)(pBufPage->data) = i;
+    setBufPageDirty(pBufPage, true);
+    releaseBufPage(pBuf, pBufPage);
+  }
+
+  for (int32_t i = 0; i < 6; ++i) {
+    ASSERT_EQ(getPageInfo(pBuf, i)->offset, i * 1024);
+  }
+  ASSERT_EQ(pBuf->nextPos, 6 * 1024);
+
+  // loading page 1 flushes page 6 to the end of file
+  recyclePage(pBuf, 1);
+  ASSERT_EQ(getPageInfo(pBuf, 6)->offset, 6 * 1024);
+  ASSERT_EQ(pBuf->nextPos, 7 * 1024);
+  ASSERT_EQ(taosArrayGetSize(pBuf->pFree), 1);
+
+  // the adjacent free areas of page 1 and page 2 are merged into one
+  recyclePage(pBuf, 2);
+  ASSERT_EQ(taosArrayGetSize(pBuf->pFree), 1);
+  SFreeListItem* pItem = static_cast<SFreeListItem*>(taosArrayGet(pBuf->pFree, 0));
+  ASSERT_EQ(pItem->offset, 1024);
+  ASSERT_EQ(pItem->length, 2 * 1024);
+
+  recyclePage(pBuf, 5);
+  ASSERT_EQ(taosArrayGetSize(pBuf->pFree), 2);
+  ASSERT_EQ(pBuf->nextPos, 7 * 1024);
+
+  // the area of page 6 is merged with the one of page 5, and they are at the end of file, so the file shrinks
+  recyclePage(pBuf, 6);
+  ASSERT_EQ(taosArrayGetSize(pBuf->pFree), 1);
+  ASSERT_EQ(pBuf->nextPos, 5 * 1024);
+
+  // the next flushed pages take the free area first, and then the end of file
+  for (int32_t i = 0; i < 4; ++i) {
+    SFilePage* pBufPage = static_cast<SFilePage*>(getNewBufPage(pBuf, &pageId));
+    ASSERT_TRUE(pBufPage != NULL);
+    *(int32_t*)(pBufPage->data) = pageId;
+    setBufPageDirty(pBufPage, true);
+    releaseBufPage(pBuf, pBufPage);
+  }
+
+  ASSERT_EQ(getPageInfo(pBuf, 7)->offset, 1024);
+  ASSERT_EQ(getPageInfo(pBuf, 1)->offset, 2 * 1024);
+  ASSERT_EQ(getPageInfo(pBuf, 2)->offset, 5 * 1024);
+  ASSERT_EQ(taosArrayGetSize(pBuf->pFree), 0);
+  ASSERT_EQ(pBuf->nextPos, 6 * 1024);
+
+  // the recycled page ids are reused, so each page still holds its own id
+  for (int32_t i = 0; i < 8; ++i) {
+    SFilePage* pBufPage = static_cast<SFilePage*>(getBufPage(pBuf, i));
+    ASSERT_TRUE(pBufPage != NULL);
+    ASSERT_EQ(*(int32_t*)(pBufPage->data), i);
+    releaseBufPage(pBuf, pBufPage);
+  }
+
+  destroyDiskbasedBuf(pBuf);
+}
+
+void largeFileTest(bool comp) {
+  SDiskbasedBuf* pBuf = NULL;
+  int32_t ret = createDiskbasedBuf(&pBuf, 1024, 2*1024, "1", TD_TMP_DIR_PATH);
+  setBufPageCompressOnDisk(pBuf, comp);
+
+  // start flushing beyond 2GB, the file is sparse so nothing is written before this position
+  const int64_t startPos = 3LL * 1024 * 1024 * 1024;
+  pBuf->nextPos = startPos;
+
+  int32_t pageId = 0;
+  for (int32_t i = 0; i < 6; ++i) {
+    SFilePage* pBufPage = static_cast<SFilePage*>(getNewBufPage(pBuf, &pageId));
+    ASSERT_TRUE(pBufPage != NULL);
+    for (int32_t j = 0; j < 128; ++j) {
+      ((int32_t*)pBufPage->data)[j] = i * j;
+    }
+    setBufPageDirty(pBufPage, true);
+    releaseBufPage(pBuf, pBufPage);
+  }
+
+  ASSERT_EQ(getPageInfo(pBuf, 0)->offset, startPos);
+  ASSERT_GT(getPageInfo(pBuf, 3)->offset, startPos);
+  ASSERT_GE(pBuf->fileSize, startPos);
+
+  for (int32_t i = 0; i < 6; ++i) {
+    SFilePage* pBufPage = static_cast<SFilePage*>(getBufPage(pBuf, i));
+    ASSERT_TRUE(pBufPage != NULL);
+    for (int32_t j = 0; j < 128; ++j) {
+      ASSERT_EQ(((int32_t*)pBufPage->data)[j], i * j);
+    }
+    releaseBufPage(pBuf, pBufPage);
+  }
+
+  destroyDiskbasedBuf(pBuf);
+}
 } // namespace
 
 
 TEST(testCase, resultBufferTest) {
   taosSeedRand(taosGetTimestampSec());
-  simpleTest();
-  writeDownTest();
-  recyclePageTest();
+  // pages are compressed on disk by default, and the buffers that turn it off are run as well
+  for (bool comp : {true, false}) {
+    simpleTest(comp);
+    writeDownTest(comp);
+    recyclePageTest(comp);
+  }
+  memBudgetTest();
+}
+
+TEST(testCase, freeAreaInFileTest) {
+  freeAreaTest();
+}
+
+TEST(testCase, largeFileTest) {
+  largeFileTest(true);
+  largeFileTest(false);
 }
 
 #pragma GCC diagnostic pop
\ No newline at end of file
@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+
+#include <regex.h>
+#include <thread>
+
+#include "tcompare.h"
+#include "ttypes.h"
+
+namespace {
+
+// REGEX_CACHE_SIZE in tcompare.c
+const int32_t kCacheSize = 16;
+
+class VarStr {
+ public:
+  explicit VarStr(const std::string &s) : buf_(VARSTR_HEADER_SIZE + s.size()) {
+    varDataSetLen(buf_.data(), s.size());
+    memcpy(varDataVal(buf_.data()), s.data(), s.size());
+  }
+  const void *get() const { return buf_.data(); }
+
+ private:
+  std::vector<char> buf_;
+};
+
+int32_t regexMatch(const std::string &str, const std::string &pattern) {
+  VarStr left(str), right(pattern);
+  return compareStrRegexCompMatch(left.get(), right.get());
+}
+
+// the result of regexec, which the cached and literal matches must agree with
+int32_t regexExpect(const std::string &str, const std::string &pattern) {
+  regex_t regex;
+  if (regcomp(&regex, pattern.c_str(), REG_EXTENDED) != 0) return 1;
+  int32_t ret = regexec(&regex, str.c_str(), 0, NULL, 0) == 0 ? 0 : 1;
+  regfree(&regex);
+  return ret;
+}
+
+const char *kStrs[] = {"", "a", "abc", "xabcx", "abcabc", "ab", "ABC", "c", "^abc", "abc$"};
+
+}  // namespace
+
+TEST(regexTest, literal_anchors) {
+  const char *patterns[] = {"", "^", "$", "^$", "abc", "^abc", "abc$", "^abc$", "a", "^a", "c$", "^c"};
+
+  for (const char *pattern : patterns) {
+    for (const char *str : kStrs) {
+      EXPECT_EQ(regexMatch(str, pattern), regexExpect(str, pattern)) << "str:" << str << " pattern:" << pattern;
+    }
+  }
+
+  EXPECT_EQ(regexMatch("abc", ""), 0);
+  EXPECT_EQ(regexMatch("", "^$"), 0);
+  EXPECT_EQ(regexMatch("a", "^$"), 1);
+  EXPECT_EQ(regexMatch("xabc", "^abc"), 1);
+  EXPECT_EQ(regexMatch("abcx", "abc$"), 1);
+  EXPECT_EQ(compareStrRegexCompNMatch(VarStr("abc").get(), VarStr("^ab").get()), 1);
+}
+
+TEST(regexTest, regex_patterns) {
+  const char *patterns[] = {"a.c", "^a.*c$", "(ab)+", "b|x", "[A-Z]+", "\\^abc", "abc\\$", "^ab?c"};
+
+  for (const char *pattern : patterns) {
+    for (const char *str : kStrs) {
+      EXPECT_EQ(regexMatch(str, pattern), regexExpect(str, pattern)) << "str:" << str << " pattern:" << pattern;
+    }
+  }
+
+  // never matches with an invalid pattern, neither when compiled nor when found in cache
+  EXPECT_EQ(regexMatch("abc", "(abc"), 1);
+  EXPECT_EQ(regexMatch("abc", "(abc"), 1);
+}
+
+TEST(regexTest, cache) {
+  // twice the cache size, so the patterns evict each other and are compiled again
+  std::vector<std::string> patterns;
+  for (int32_t i = 0; i < kCacheSize * 2; i++) {
+    patterns.push_back((i % 2) ? "^k" + std::to_string(i) + "$" : "k" + std::to_string(i) + "[0-9]*$");
+  }
+
+  for (int32_t round = 0; round < 3; round++) {
+    for (int32_t i = 0; i < (int32_t)patterns.size(); i++) {
+      std::string key = "k" + std::to_string(i);
+      EXPECT_EQ(regexMatch(key, patterns[i]), 0) << patterns[i];
+      EXPECT_EQ(regexMatch(key + "x", patterns[i]), 1) << patterns[i];
+      // hits the entry just cached
+      EXPECT_EQ(regexMatch(key, patterns[i]), 0) << patterns[i];
+    }
+  }
+
+  // patterns differing only in length or bytes after the end do not share an entry
+  EXPECT_EQ(regexMatch("ab", "^ab$"), 0);
+  EXPECT_EQ(regexMatch("ab", "^ab"), 0);
+  EXPECT_EQ(regexMatch("ab", "^abc"), 1);
+  EXPECT_EQ(regexMatch("ab", "^ab$"), 0);
+}
+
+TEST(regexTest, cache_per_thread) {
+  auto worker = [](int32_t id, int32_t *failed) {
+    for (int32_t i = 0; i < 1000; i++) {
+      std::string pattern = "^t" + std::to_string(id) + "_" + std::to_string(i % (kCacheSize + 3)) + "$";
+      std::string str = "t" + std::to_string(id) + "_" + std::to_string(i % (kCacheSize + 3));
+      if (regexMatch(str, pattern) != 0 || regexMatch(str + "_", pattern) != 1) (*failed)++;
+    }
+  };
+
+  int32_t     failed[4] = {0};
+  std::thread threads[4];
+  for (int32_t i = 0; i < 4; i++) threads[i] = std::thread(worker, i, &failed[i]);
+  for (int32_t i = 0; i < 4; i++) {
+    threads[i].join();
+    EXPECT_EQ(failed[i], 0);
+  }
+}
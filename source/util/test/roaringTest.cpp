@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <set>
+#include <vector>
+
+#include "troaring.h"
+
+using namespace std;
+
+static vector<uint64_t> roaringValues(SRoaring *pRoaring) {
+  SArray *pArr = taosArrayInit(8, sizeof(uint64_t));
+  tRoaringToArray(pRoaring, pArr);
+
+  vector<uint64_t> vals;
+  for (int32_t i = 0; i < taosArrayGetSize(pArr); i++) {
+    vals.push_back(*(uint64_t *)taosArrayGet(pArr, i));
+  }
+  taosArrayDestroy(pArr);
+  return vals;
+}
+
+static SRoaring *roaringFromSet(const set<uint64_t> &vals) {
+  SRoaring *pRoaring = tRoaringCreate();
+  for (auto v : vals) {
+    tRoaringAdd(pRoaring, v);
+  }
+  return pRoaring;
+}
+
+// values share a few containers, so arrays turn into bitmaps and back
+static set<uint64_t> genValues(int32_t num, int32_t seed) {
+  set<uint64_t> vals;
+  taosSeedRand(seed);
+  uint64_t base = 0x7FF0000000000000ULL;
+  for (int32_t i = 0; i < num; i++) {
+    vals.insert(base + (uint64_t)(taosRand() % 3) * 65536 + taosRand() % 65536);
+  }
+  return vals;
+}
+
+TEST(TD_UTIL_ROARING_TEST, add_contains) {
+  SRoaring *pRoaring = tRoaringCreate();
+  ASSERT_EQ(tRoaringCardinality(pRoaring), 0);
+
+  uint64_t vals[] = {5, 3, 65536, 3, UINT64_MAX, 1};
+  for (auto v : vals) {
+    ASSERT_EQ(tRoaringAdd(pRoaring, v), 0);
+  }
+
+  ASSERT_EQ(tRoaringCardinality(pRoaring), 5);
+  ASSERT_TRUE(tRoaringContains(pRoaring, 65536));
+  ASSERT_TRUE(tRoaringContains(pRoaring, UINT64_MAX));
+  ASSERT_FALSE(tRoaringContains(pRoaring, 2));
+
+  vector<uint64_t> expect = {1, 3, 5, 65536, UINT64_MAX};
+  ASSERT_EQ(roaringValues(pRoaring), expect);
+  tRoaringDestroy(pRoaring);
+}
+
+TEST(TD_UTIL_ROARING_TEST, set_operation) {
+  set<uint64_t> a = genValues(20000, 1);
+  set<uint64_t> b = genValues(3000, 2);
+
+  vector<uint64_t> uni, inter, diff;
+  set_union(a.begin(), a.end(), b.begin(), b.end(), back_inserter(uni));
+  set_intersection(a.begin(), a.end(), b.begin(), b.end(), back_inserter(inter));
+  set_difference(a.begin(), a.end(), b.begin(), b.end(), back_inserter(diff));
+
+  SRoaring *pA = roaringFromSet(a);
+  SRoaring *pB = roaringFromSet(b);
+
+  SRoaring *pRoaring = tRoaringCreate();
+  ASSERT_EQ(tRoaringOr(pRoaring, pA), 0);
+  ASSERT_EQ(tRoaringOr(pRoaring, pB), 0);
+  ASSERT_EQ(roaringValues(pRoaring), uni);
+
+  ASSERT_EQ(tRoaringAnd(pRoaring, pB), 0);
+  ASSERT_EQ(tRoaringAnd(pRoaring, pA), 0);
+  ASSERT_EQ(roaringValues(pRoaring), inter);
+
+  tRoaringClear(pRoaring);
+  ASSERT_EQ(tRoaringOr(pRoaring, pA), 0);
+  ASSERT_EQ(tRoaringAndNot(pRoaring, pB), 0);
+  ASSERT_EQ(roaringValues(pRoaring), diff);
+
+  tRoaringDestroy(pRoaring);
+  tRoaringDestroy(pA);
+  tRoaringDestroy(pB);
+}
+
+TEST(TD_UTIL_ROARING_TEST, serialize) {
+  set<uint64_t> a = genValues(10000, 3);
+  SRoaring     *pA = roaringFromSet(a);
+
+  int32_t size = tRoaringSerialSize(pA);
+  char   *buf = (char *)taosMemoryMalloc(size);
+  ASSERT_EQ(tRoaringSerialize(pA, buf), size);
+
+  SRoaring *pRoaring = tRoaringCreate();
+  ASSERT_EQ(tRoaringDeserializeOr(pRoaring, buf, size), 0);
+  ASSERT_EQ(roaringValues(pRoaring), vector<uint64_t>(a.begin(), a.end()));
+
+  // a truncated buffer is rejected and leaves the bitmap untouched
+  ASSERT_NE(tRoaringDeserializeOr(pRoaring, buf, size - 1), 0);
+  ASSERT_EQ(tRoaringCardinality(pRoaring), (int64_t)a.size());
+
+  taosMemoryFree(buf);
+  tRoaringDestroy(pRoaring);
+  tRoaringDestroy(pA);
+}
@@ -0,0 +1,93 @@
+###################################################################
+#           Copyright (c) 2016 by TAOS Technologies, Inc.
+#                     All rights reserved.
+#
+#  This file is proprietary and confidential to TAOS Technologies.
+#  No part of this file may be reproduced, stored, transmitted,
+#  disclosed or used in any form or by any means other than as
+#  expressly provided by the written permission from Jianhui Tao
+#
+###################################################################
+
+# -*- coding: utf-8 -*-
+
+import time
+
+from util.log import *
+from util.cases import *
+from util.sql import *
+from util.dnodes import *
+
+class TDTestCase:
+    # the file sets of one commit are shared by several commit workers
+    updatecfgDict = {'numOfCommitThreads': 4}
+
+    def init(self, conn, logSql):
+        tdLog.debug("start to execute %s" % __file__)
+        tdSql.init(conn.cursor(), logSql)
+        self.dbname = 'db_commit'
+        self.stbname = 'stb'
+        self.tables = 4
+        self.days = 20
+        self.rows = 100
+        self.updated = 10
+        self.day_ms = 86400000
+        self.start = (int(time.time() * 1000) // self.day_ms - self.days - 5) * self.day_ms
+        # the expected c1 of each row, indexed by table, day and row
+        self.values = {}
+
+    def insert_days(self, value_fn, rows):
+        for t in range(self.tables):
+            for d in range(self.days):
+                values = ''
+                for i in range(rows):
+                    v = value_fn(t, d, i)
+                    self.values[(t, d, i)] = v
+                    values += f'({self.start + d * self.day_ms + i * 1000}, {v}, {t}) '
+                tdSql.execute(f'insert into ct{t} values {values}')
+        # one day per file set, so a single commit writes all of them
+        tdSql.execute(f'flush database {self.dbname}')
+
+    def data_check(self):
+        tdSql.query(f'select count(*) from {self.stbname}')
+        tdSql.checkData(0, 0, self.tables * self.days * self.rows)
+        for d in range(self.days):
+            begin = self.start + d * self.day_ms
+            tdSql.query(f'select count(*), sum(c1) from {self.stbname} where ts >= {begin} and ts < {begin + self.day_ms}')
+            tdSql.checkData(0, 0, self.tables * self.rows)
+            tdSql.checkData(0, 1, sum(self.values[(t, d, i)] for t in range(self.tables) for i in range(self.rows)))
+        for t in range(self.tables):
+            tdSql.query(f'select first(c1), last(c1), sum(c2) from ct{t}')
+            tdSql.checkData(0, 0, self.values[(t, 0, 0)])
+            tdSql.checkData(0, 1, self.values[(t, self.days - 1, self.rows - 1)])
+            tdSql.checkData(0, 2, t * self.days * self.rows)
+
+    def commit_parallel(self):
+        tdSql.execute(f'drop database if exists {self.dbname}')
+        tdSql.execute(f'create database {self.dbname} vgroups 1 duration 1d keep 3650')
+        tdSql.execute(f'use {self.dbname}')
+        tdSql.execute(f'create stable {self.stbname} (ts timestamp, c1 int, c2 bigint) tags (t1 int)')
+        for t in range(self.tables):
+            tdSql.execute(f'create table ct{t} using {self.stbname} tags ({t})')
+
+        self.insert_days(lambda t, d, i: d * 1000 + i, self.rows)
+        self.data_check()
+
+        # the second commit merges the updated rows into the existing files of every file set
+        self.insert_days(lambda t, d, i: -(t * 1000 + d * 10 + i), self.updated)
+        self.data_check()
+
+    def run(self):
+        self.commit_parallel()
+        tdDnodes.stoptaosd(1)
+        tdDnodes.starttaosd(1)
+        tdSql.execute(f'use {self.dbname}')
+        self.data_check()
+        tdSql.execute(f'drop database {self.dbname}')
+
+    def stop(self):
+        tdSql.close()
+        tdLog.success("%s successfully executed" % __file__)
+
+tdCases.addWindows(__file__, TDTestCase())
+tdCases.addLinux(__file__, TDTestCase())
@@ -0,0 +1,100 @@
+###################################################################
+#           Copyright (c) 2016 by TAOS Technologies, Inc.
+#                     All rights reserved.
+#
+#  This file is proprietary and confidential to TAOS Technologies.
+#  No part of this file may be reproduced, stored, transmitted,
+#  disclosed or used in any form or by any means other than as
+#  expressly provided by the written permission from Jianhui Tao
+#
+###################################################################
+
+# -*- coding: utf-8 -*-
+
+import os
+import time
+
+from util.log import *
+from util.cases import *
+from util.sql import *
+from util.dnodes import *
+
+class TDTestCase:
+    def init(self, conn, logSql):
+        tdLog.debug("start to execute %s" % __file__)
+        tdSql.init(conn.cursor(), logSql)
+        self.dbname = 'db_compact'
+        self.ntbname = 'ntb'
+        self.ts = 1537146000000
+        self.rows = 100
+        self.rounds = 6
+        self.stt_trigger = 8
+        self.compact_timeout = 60
+
+    def insert_rounds(self):
+        # every round rewrites the same rows and adds a new one, and each flush leaves one more .stt file in the
+        # file set, which gets compacted once it holds half of stt_trigger files
+        for round in range(self.rounds):
+            values = ''
+            for i in range(self.rows):
+                values += f'({self.ts + i * 1000}, {round * 1000 + i}) '
+            values += f'({self.ts + (self.rows + round) * 1000}, {round * 1000 + self.rows + round})'
+            tdSql.execute(f'insert into {self.ntbname} values {values}')
+            tdSql.execute(f'flush database {self.dbname}')
+
+    def data_check(self):
+        last = (self.rounds - 1) * 1000
+        tdSql.query(f'select count(*) from {self.ntbname}')
+        tdSql.checkData(0, 0, self.rows + self.rounds - 10)
+        tdSql.query(f'select c1 from {self.ntbname} where ts = {self.ts + 10 * 1000}')
+        tdSql.checkData(0, 0, last + 10)
+        tdSql.query(f'select c1 from {self.ntbname} where ts = {self.ts + (self.rows - 1) * 1000}')
+        tdSql.checkData(0, 0, last + self.rows - 1)
+        tdSql.query(f'select c1 from {self.ntbname} where ts = {self.ts + self.rows * 1000}')
+        tdSql.checkData(0, 0, self.rows)
+        tdSql.query(f'select sum(c1) from {self.ntbname}')
+        total = sum(last + i for i in range(10, self.rows)) + sum(r * 1000 + self.rows + r for r in range(self.rounds))
+        tdSql.checkData(0, 0, total)
+
+    def wait_compaction(self):
+        # compaction runs in background after the commit, and once it is done the file set holds fewer .stt files
+        # than the number that triggers it
+        tdSql.query(f'show {self.dbname}.vgroups')
+        vgId = tdSql.queryResult[0][0]
+        tsdbDir = os.path.join(tdDnodes.dnodes[0].dataDir, 'vnode', f'vnode{vgId}', 'tsdb')
+
+        deadline = time.time() + self.compact_timeout
+        while True:
+            nStt = len([f for f in os.listdir(tsdbDir) if f.endswith('.stt')])
+            if nStt < self.stt_trigger // 2:
+                tdLog.debug(f'compaction done, {nStt} .stt files left')
+                return
+            if time.time() > deadline:
+                tdLog.exit(f'compaction not done in {self.compact_timeout}s, {nStt} .stt files left')
+            time.sleep(0.5)
+
+    def compact_data(self):
+        tdSql.execute(f'drop database if exists {self.dbname}')
+        tdSql.execute(f'create database {self.dbname} vgroups 1 stt_trigger {self.stt_trigger}')
+        tdSql.execute(f'use {self.dbname}')
+        tdSql.execute(f'create table {self.ntbname} (ts timestamp, c1 int)')
+        self.insert_rounds()
+        tdSql.execute(f'delete from {self.ntbname} where ts < {self.ts + 10 * 1000}')
+        tdSql.execute(f'flush database {self.dbname}')
+        self.wait_compaction()
+        self.data_check()
+
+    def run(self):
+        self.compact_data()
+        tdDnodes.stoptaosd(1)
+        tdDnodes.starttaosd(1)
+        tdSql.execute(f'use {self.dbname}')
+        self.data_check()
+        tdSql.execute(f'drop database {self.dbname}')
+
+    def stop(self):
+        tdSql.close()
+        tdLog.success("%s successfully executed" % __file__)
+
+tdCases.addWindows(__file__, TDTestCase())
+tdCases.addLinux(__file__, TDTestCase())
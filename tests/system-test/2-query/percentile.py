@@ -145,9 +145,35 @@ class TDTestCase:
                         tdSql.query(f'select percentile({k},{param}) from {self.stbname}_{i}')
                         tdSql.checkData(0,0,data_num)
         tdSql.execute(f'drop database {self.dbname}')            
+    def function_check_partition(self):
+        # each group keeps its own buckets, the result is the same as querying the group alone
+        tdSql.execute(f'create database {self.dbname}')
+        tdSql.execute(f'create table {self.ntbname} (ts timestamp, c1 int, c2 double, c3 int)')
+        groupData = {}
+        values = []
+        for i in range(3000):
+            group = i % 3
+            c1 = (i * 7919) % 10007 - 5000 * group
+            c2 = c1 * 1.5 + group
+            groupData.setdefault(group, ([], []))
+            groupData[group][0].append(c1)
+            groupData[group][1].append(c2)
+            values.append(f'({self.ts + i}, {c1}, {c2}, {group})')
+            if len(values) == 500:
+                tdSql.execute(f'insert into {self.ntbname} values {" ".join(values)}')
+                values = []
+        for param in self.param:
+            tdSql.query(f'select c3, percentile(c1, {param}), percentile(c2, {param}) from {self.ntbname} partition by c3')
+            tdSql.checkRows(len(groupData))
+            for row in tdSql.queryResult:
+                intData, floatData = groupData[row[0]]
+                tdSql.checkEqual(abs(row[1] - np.percentile(intData, param)) < 1e-6, True)
+                tdSql.checkEqual(abs(row[2] - np.percentile(floatData, param)) < 1e-6, True)
+        tdSql.execute(f'drop database {self.dbname}')
     def run(self):
         self.function_check_ntb()
         self.function_check_ctb()
+        self.function_check_partition()
         
     def stop(self):
         tdSql.close()
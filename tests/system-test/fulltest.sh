@@ -209,6 +209,8 @@ python3 ./test.py -f 2-query/varchar.py -R
 python3 ./test.py -f 1-insert/update_data.py
 
 python3 ./test.py -f 1-insert/delete_data.py
+python3 ./test.py -f 1-insert/compact_data.py
+python3 ./test.py -f 1-insert/commit_parallel.py
 
 python3 ./test.py -f 2-query/join2.py
 python3 ./test.py -f 2-query/union1.py